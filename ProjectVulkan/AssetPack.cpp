@@ -0,0 +1,182 @@
+#include "AssetPack.h"
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+// ƫƺʹСǷļΧ
+static bool inBounds(const MappedFile& file, uint64_t offset, uint64_t size) {
+    return offset <= file.size && size <= file.size - offset;
+}
+
+void openAssetPack(AssetPack& pack, const std::string& path) {
+    if (!mapFile(path, pack.file)) {
+        throw std::runtime_error("failed to open asset pack " + path);
+    }
+
+    const MappedFile& file = pack.file;
+    if (file.size < sizeof(PackHeader)) {
+        closeAssetPack(pack);
+        throw std::runtime_error("asset pack " + path + " is truncated");
+    }
+
+    // ӳַҳ룬ĴС 8 ıֱӵṹʹ
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(file.data);
+    if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION) {
+        closeAssetPack(pack);
+        throw std::runtime_error("asset pack " + path + " has an unknown format");
+    }
+    if ((header->indexSize != 2 && header->indexSize != 4) || header->vertexStride < ASSET_PACK_NORMAL_OFFSET + 4) {
+        closeAssetPack(pack);
+        throw std::runtime_error("asset pack " + path + " has an invalid vertex layout");
+    }
+
+    uint64_t tablesSize = sizeof(PackHeader)
+        + static_cast<uint64_t>(header->sectionCount) * sizeof(PackSection)
+        + static_cast<uint64_t>(header->meshCount) * sizeof(PackMesh)
+        + static_cast<uint64_t>(header->textureCount) * sizeof(PackTexture);
+    if (tablesSize > file.size) {
+        closeAssetPack(pack);
+        throw std::runtime_error("asset pack " + path + " is truncated");
+    }
+
+    pack.header = header;
+    pack.sections = reinterpret_cast<const PackSection*>(file.data + sizeof(PackHeader));
+    pack.meshes = reinterpret_cast<const PackMesh*>(pack.sections + header->sectionCount);
+    pack.textures = reinterpret_cast<const PackTexture*>(pack.meshes + header->meshCount);
+
+    for (uint32_t i = 0; i < header->sectionCount; i++) {
+        const PackSection& section = pack.sections[i];
+        if (section.offset % ASSET_PACK_SECTION_ALIGNMENT != 0 || !inBounds(file, section.offset, section.size)) {
+            closeAssetPack(pack);
+            throw std::runtime_error("asset pack " + path + " has a section out of bounds");
+        }
+    }
+
+    // õķΧڶӦĶڣ֮ƺϴʱټ
+    const PackSection* vertices = findPackSection(pack, PackSectionType::Vertices);
+    const PackSection* indices = findPackSection(pack, PackSectionType::Indices);
+    const PackSection* meshlets = findPackSection(pack, PackSectionType::Meshlets);
+    uint64_t vertexCount = vertices ? vertices->size / header->vertexStride : 0;
+    uint64_t indexCount = indices ? indices->size / header->indexSize : 0;
+    uint64_t meshletCount = meshlets ? meshlets->size / sizeof(PackMeshlet) : 0;
+    for (uint32_t i = 0; i < header->meshCount; i++) {
+        const PackMesh& mesh = pack.meshes[i];
+        if (mesh.name[sizeof(mesh.name) - 1] != '\0'
+            || mesh.vertexOffset < 0 || static_cast<uint64_t>(mesh.vertexOffset) + mesh.vertexCount > vertexCount
+            || static_cast<uint64_t>(mesh.firstIndex) + mesh.indexCount > indexCount
+            || static_cast<uint64_t>(mesh.firstMeshlet) + mesh.meshletCount > meshletCount) {
+            closeAssetPack(pack);
+            throw std::runtime_error("asset pack " + path + " has an invalid mesh entry");
+        }
+    }
+
+    const PackSection* textures = findPackSection(pack, PackSectionType::Textures);
+    for (uint32_t i = 0; i < header->textureCount; i++) {
+        const PackTexture& texture = pack.textures[i];
+        if (texture.name[sizeof(texture.name) - 1] != '\0' || !textures
+            || texture.offset > textures->size || texture.size > textures->size - texture.offset) {
+            closeAssetPack(pack);
+            throw std::runtime_error("asset pack " + path + " has an invalid texture entry");
+        }
+    }
+}
+
+void closeAssetPack(AssetPack& pack) {
+    unmapFile(pack.file);
+    pack.header = nullptr;
+    pack.sections = nullptr;
+    pack.meshes = nullptr;
+    pack.textures = nullptr;
+}
+
+const PackSection* findPackSection(const AssetPack& pack, PackSectionType type) {
+    for (uint32_t i = 0; i < pack.header->sectionCount; i++) {
+        if (pack.sections[i].type == static_cast<uint32_t>(type)) {
+            return &pack.sections[i];
+        }
+    }
+    return nullptr;
+}
+
+const uint8_t* getPackSectionData(const AssetPack& pack, const PackSection& section) {
+    return pack.file.data + section.offset;
+}
+
+VkIndexType getPackIndexType(const AssetPack& pack) {
+    return pack.header->indexSize == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+}
+
+std::vector<MeshRange> getPackMeshRanges(const AssetPack& pack) {
+    std::vector<MeshRange> ranges;
+    for (uint32_t i = 0; i < pack.header->meshCount; i++) {
+        const PackMesh& mesh = pack.meshes[i];
+        float distance = std::sqrt(mesh.center[0] * mesh.center[0] + mesh.center[1] * mesh.center[1] + mesh.center[2] * mesh.center[2]);
+        ranges.push_back({ mesh.indexCount, mesh.firstIndex, mesh.vertexOffset, distance + mesh.radius });
+    }
+    return ranges;
+}
+
+void getPackTextureMip(const PackTexture& texture, uint32_t level, uint64_t& offset, uint64_t& size) {
+    // Ŀǰֻ RGBA8 
+    offset = texture.offset;
+    uint32_t width = texture.width;
+    uint32_t height = texture.height;
+    for (uint32_t i = 0; ; i++) {
+        size = static_cast<uint64_t>(width) * height * 4;
+        if (i == level) {
+            return;
+        }
+        offset += (size + ASSET_PACK_MIP_ALIGNMENT - 1) / ASSET_PACK_MIP_ALIGNMENT * ASSET_PACK_MIP_ALIGNMENT;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+}
+
+void uploadPackSection(UploadContext& ctx, const AssetPack& pack, PackSectionType type, VkBufferUsageFlags usage, GpuBuffer& buffer) {
+    const PackSection* section = findPackSection(pack, type);
+    if (!section || section->size == 0) {
+        throw std::runtime_error("asset pack has no section of type " + std::to_string(static_cast<uint32_t>(type)));
+    }
+
+    createDeviceLocalBuffer(buffer, section->size, usage);
+    enqueueBufferUpload(ctx, buffer.buffer, 0, getPackSectionData(pack, *section), section->size);
+}
+
+void applyPackVertexInput(const AssetPack& pack, GraphicsPipelineDesc& desc) {
+    for (VkVertexInputBindingDescription& binding : desc.bindings) {
+        if (binding.binding == 0) {
+            binding.stride = pack.header->vertexStride;
+        }
+    }
+    for (VkVertexInputAttributeDescription& attribute : desc.attributes) {
+        if (attribute.binding == 0 && attribute.offset == 0) {
+            attribute.format = ASSET_PACK_POSITION_FORMAT;
+        }
+    }
+}
+
+void printAssetPackInfo(const AssetPack& pack) {
+    const PackHeader& header = *pack.header;
+    std::cout << "Asset pack: " << header.meshCount << " meshes, " << header.textureCount << " textures, "
+        << header.vertexStride << "-byte vertices, " << header.indexSize * 8 << "-bit indices";
+    if (header.flags & ASSET_PACK_FLAG_MESHLETS) {
+        const PackSection* meshlets = findPackSection(pack, PackSectionType::Meshlets);
+        std::cout << ", " << (meshlets ? meshlets->size / sizeof(PackMeshlet) : 0) << " meshlets";
+    }
+    std::cout << ", " << pack.file.size << " bytes mapped" << std::endl;
+
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        const PackMesh& mesh = pack.meshes[i];
+        std::cout << "  mesh " << mesh.name << ": " << mesh.vertexCount << " vertices, " << mesh.indexCount / 3 << " triangles";
+        if (mesh.meshletCount > 0) {
+            std::cout << ", " << mesh.meshletCount << " meshlets";
+        }
+        std::cout << std::endl;
+    }
+    for (uint32_t i = 0; i < header.textureCount; i++) {
+        const PackTexture& texture = pack.textures[i];
+        std::cout << "  texture " << texture.name << ": " << texture.width << "x" << texture.height
+            << ", " << texture.mipLevels << " mips" << std::endl;
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IndirectDraw.h"
+#include "MappedFile.h"
+#include "PipelineRegistry.h"
+#include "Upload.h"
+
+// Դļ pack_assets.py ɣͷ + α +  +  + 256 ֽڶݶΡ
+// ݶεĲ־ GPU ʹõĲ֣ʱӳڴֱӸƵݴ滺壬
+const uint32_t ASSET_PACK_MAGIC = 0x4B415041; // "APAK"
+const uint32_t ASSET_PACK_VERSION = 1;
+const uint32_t ASSET_PACK_SECTION_ALIGNMENT = 256;
+const uint32_t ASSET_PACK_MIP_ALIGNMENT = 16;
+
+// 㣺half4 λãw = 1+  snorm16x2 
+const VkFormat ASSET_PACK_POSITION_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+const VkFormat ASSET_PACK_NORMAL_FORMAT = VK_FORMAT_R16G16_SNORM;
+const uint32_t ASSET_PACK_NORMAL_OFFSET = 8;
+
+const uint32_t ASSET_PACK_FLAG_MESHLETS = 1;
+
+enum class PackSectionType : uint32_t {
+    Vertices = 1,
+    Indices = 2,
+    Meshlets = 3,           // PackMeshlet 
+    MeshletVertices = 4,    // uint32_tڵĶ
+    MeshletTriangles = 5,   // ÿ 3  uint8_t ֲÿ meshlet  4 ֽڶ
+    Textures = 6,           //  mip 
+};
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sectionCount;
+    uint32_t meshCount;
+    uint32_t textureCount;
+    uint32_t vertexStride;
+    uint32_t indexSize;     // 2  4
+    uint32_t flags;
+};
+
+struct PackSection {
+    uint32_t type;          // PackSectionType
+    uint32_t reserved;
+    uint64_t offset;        // ļͷ
+    uint64_t size;
+};
+
+struct PackMesh {
+    char name[32];          //  '\0' βԴļȥչ
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+    float center[3];        // Χ
+    float radius;
+};
+
+struct PackMeshlet {
+    uint32_t vertexOffset;  // MeshletVertices еԪ±
+    uint32_t triangleOffset; // MeshletTriangles еֽƫ
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+struct PackTexture {
+    char name[32];
+    uint32_t format;        // VkFormat
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevels;     // Уÿ ASSET_PACK_MIP_ALIGNMENT 
+    uint64_t offset;        // Textures ڵƫ
+    uint64_t size;
+};
+
+static_assert(sizeof(PackHeader) == 32, "PackHeader does not match pack_assets.py");
+static_assert(sizeof(PackSection) == 24, "PackSection does not match pack_assets.py");
+static_assert(sizeof(PackMesh) == 72, "PackMesh does not match pack_assets.py");
+static_assert(sizeof(PackMeshlet) == 16, "PackMeshlet does not match pack_assets.py");
+static_assert(sizeof(PackTexture) == 64, "PackTexture does not match pack_assets.py");
+
+// 򿪵Դֱָӳڴ棬رǰЧ
+struct AssetPack {
+    MappedFile file;
+    const PackHeader* header = nullptr;
+    const PackSection* sections = nullptr;
+    const PackMesh* meshes = nullptr;
+    const PackTexture* textures = nullptr;
+};
+
+// ֻͷ͸ı߽磻ļЧʱ׳쳣
+void openAssetPack(AssetPack& pack, const std::string& path);
+void closeAssetPack(AssetPack& pack);
+
+// Ҳʱ nullptr
+const PackSection* findPackSection(const AssetPack& pack, PackSectionType type);
+
+const uint8_t* getPackSectionData(const AssetPack& pack, const PackSection& section);
+
+VkIndexType getPackIndexType(const AssetPack& pack);
+
+// ɻƷΧΧ뾶ΪԭΪ
+std::vector<MeshRange> getPackMeshRanges(const AssetPack& pack);
+
+//  level  mip  Textures еƫƺֽ
+void getPackTextureMip(const PackTexture& texture, uint32_t level, uint64_t& offset, uint64_t& size);
+
+// Ϊδ DEVICE_LOCAL ѶεֱӴӳ临Ƶݴ滷Ŷϴ
+void uploadPackSection(UploadContext& ctx, const AssetPack& pack, PackSectionType type, VkBufferUsageFlags usage, GpuBuffer& buffer);
+
+// ѹ߰ 0 ĶʽĳԴĲ֣ɫֻȡ xy ʱͬã
+void applyPackVertexInput(const AssetPack& pack, GraphicsPipelineDesc& desc);
+
+void printAssetPackInfo(const AssetPack& pack);
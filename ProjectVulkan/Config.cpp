@@ -0,0 +1,283 @@
+#include "Config.h"
+#include "FrameRing.h"
+#include "IndirectDraw.h"
+#include "Particles.h"
+#include "Presenter.h"
+#include "Readback.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+AppConfig appConfig;
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+        << "  --headless            render offscreen without a window\n"
+        << "  --frames <n>          frames to render in headless mode (default 1000)\n"
+        << "  --warmup <n>          frames excluded from statistics (default 10)\n"
+        << "  --frames-in-flight <n> frames the CPU may record ahead of the GPU, 1-3 (default 2)\n"
+        << "  --record-threads <n>  record secondary command buffers on n threads (default 0 = inline)\n"
+        << "  --draws <n>           draw calls per frame (default 1)\n"
+        << "  --benchmark-recording measure recording time across thread and draw counts (headless)\n"
+        << "  --objects <n>         draw a scene of n objects instead of repeating the triangle (recorded inline)\n"
+        << "  --draw-mode <mode>    scene draw path: per-object, instanced or indirect (default indirect)\n"
+        << "  --zoom <f>            scene camera zoom, objects outside the view are culled (default 1)\n"
+        << "  --no-culling          skip frustum culling in the indirect draw path\n"
+        << "  --benchmark-draws     compare scene draw paths across object counts (headless)\n"
+        << "  --lod-error <px>      screen-space error allowed when picking scene mesh LODs, 0 = full detail (default 1)\n"
+        << "  --capture <dir>       read rendered frames back and write an image sequence to <dir> (headless)\n"
+        << "  --capture-format <f>  png, exr or raw (default png)\n"
+        << "  --capture-every <n>   read back every n-th frame (default 1)\n"
+        << "  --capture-buffers <n> persistently mapped readback buffers (default 8)\n"
+        << "  --capture-threads <n> encode and write threads (default 2)\n"
+        << "  --capture-wait        wait for a free readback buffer instead of dropping the frame's capture\n"
+        << "  --particles <n>       simulate n GPU particles and draw them in the main pass\n"
+        << "  --particles-serial    simulate particles in the graphics command buffer instead of on the compute queue\n"
+        << "  --benchmark-particles compare overlapped and serialized particle simulation at 1M+ particles (headless)\n"
+        << "  --present-mode <mode> fifo, mailbox, immediate or fifo-relaxed; falls back to fifo (default fifo)\n"
+        << "  --swapchain-images <n> swap chain image count (default 0 = 3 for mailbox, otherwise minimum + 1)\n"
+        << "  --target-fps <n>      pace frame starts to n per second before sampling input (default 0 = unpaced)\n"
+        << "  --resize-every <n>    headless: simulate a window resize every n frames to exercise recreation\n"
+        << "  --width <n>           render width (default 800)\n"
+        << "  --height <n>          render height (default 600)\n"
+        << "  --device <name>       pick the first device whose name contains <name>\n"
+        << "  --shader-dir <path>   directory searched for .spv files, repeatable (default . and ..)\n"
+        << "  --shader-archive <file> load shaders from a packed archive first\n"
+        << "  --pack <file>         load scene meshes from an asset pack instead of the built-in shapes\n"
+        << "  --pipeline-cache <path> pipeline cache file (default pipeline_cache.bin)\n"
+        << "  --no-pipeline-cache   do not load or save the pipeline cache (cold start)\n"
+        << "  --stream <path>       stream .obj meshes and .tga textures from a file or directory, repeatable\n"
+        << "                        (headless: render until everything is loaded, exit 1 if over budget)\n"
+        << "  --upload-budget <KB>  bytes submitted to the transfer queue per frame (default 1024)\n"
+        << "  --io-threads <n>      streaming I/O and decode threads (default 2)\n"
+        << "  --textures <path>     load .ktx2 (BCn/ASTC/uncompressed) and .tga textures from a file or directory, repeatable\n"
+        << "  --texture-budget <MB> memory for resident texture mip levels (default 256)\n"
+        << "  --texture-upload <KB> texture bytes uploaded per frame (default 4096)\n"
+        << "  --benchmark-resources create and destroy thousands of resources per frame, check counts and leaks (headless)\n"
+        << "  --trace <file>        profile CPU and GPU scopes and write a Chrome trace (chrome://tracing)\n"
+        << "  --pipeline-statistics also collect pipeline statistics counters (with --trace)\n"
+        << "  --help                show this message" << std::endl;
+}
+
+// 
+static bool parseFloat(const char* text, float& value) {
+    char* end = nullptr;
+    float parsed = strtof(text, &end);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+// ޷
+static bool parseUInt(const char* text, uint32_t& value) {
+    char* end = nullptr;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (end == text || *end != '\0') {
+        return false;
+    }
+
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+bool parseCommandLine(int argc, char** argv, AppConfig& config) {
+    bool customShaderPaths = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--headless") == 0) {
+            config.headless = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--benchmark-recording") == 0) {
+            config.benchmarkRecording = true;
+            config.headless = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--benchmark-draws") == 0) {
+            config.benchmarkDraws = true;
+            config.headless = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--benchmark-resources") == 0) {
+            config.benchmarkResources = true;
+            config.headless = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--capture-wait") == 0) {
+            config.captureWait = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--particles-serial") == 0) {
+            config.particlesSerial = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--benchmark-particles") == 0) {
+            config.benchmarkParticles = true;
+            config.headless = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--no-pipeline-cache") == 0) {
+            config.pipelineCachePath.clear();
+            continue;
+        }
+
+        if (strcmp(arg, "--no-culling") == 0) {
+            config.culling = false;
+            continue;
+        }
+
+        if (strcmp(arg, "--pipeline-statistics") == 0) {
+            config.pipelineStatistics = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--help") == 0) {
+            return false;
+        }
+
+        // ѡҪһֵ
+        if (next == nullptr) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        bool ok = true;
+        if (strcmp(arg, "--frames") == 0) {
+            ok = parseUInt(next, config.frameCount);
+        }
+        else if (strcmp(arg, "--warmup") == 0) {
+            ok = parseUInt(next, config.warmupFrames);
+        }
+        else if (strcmp(arg, "--frames-in-flight") == 0) {
+            ok = parseUInt(next, config.framesInFlight) && config.framesInFlight >= 1 && config.framesInFlight <= MAX_FRAMES_IN_FLIGHT;
+        }
+        else if (strcmp(arg, "--record-threads") == 0) {
+            ok = parseUInt(next, config.recordThreads) && config.recordThreads <= 64;
+        }
+        else if (strcmp(arg, "--draws") == 0) {
+            ok = parseUInt(next, config.drawCount) && config.drawCount > 0;
+        }
+        else if (strcmp(arg, "--objects") == 0) {
+            ok = parseUInt(next, config.objectCount);
+        }
+        else if (strcmp(arg, "--draw-mode") == 0) {
+            SceneDrawMode mode;
+            ok = parseSceneDrawMode(next, mode);
+            config.sceneDrawMode = next;
+        }
+        else if (strcmp(arg, "--present-mode") == 0) {
+            VkPresentModeKHR mode;
+            ok = parsePresentMode(next, mode);
+            config.presentMode = next;
+        }
+        else if (strcmp(arg, "--swapchain-images") == 0) {
+            ok = parseUInt(next, config.swapchainImages) && config.swapchainImages <= 8;
+        }
+        else if (strcmp(arg, "--target-fps") == 0) {
+            ok = parseUInt(next, config.targetFps) && config.targetFps <= 1000;
+        }
+        else if (strcmp(arg, "--resize-every") == 0) {
+            ok = parseUInt(next, config.resizeEvery);
+        }
+        else if (strcmp(arg, "--zoom") == 0) {
+            ok = parseFloat(next, config.cameraZoom) && config.cameraZoom > 0.0f;
+        }
+        else if (strcmp(arg, "--lod-error") == 0) {
+            ok = parseFloat(next, config.lodPixelError) && config.lodPixelError >= 0.0f;
+        }
+        else if (strcmp(arg, "--capture") == 0) {
+            config.captureDir = next;
+            config.headless = true;
+        }
+        else if (strcmp(arg, "--capture-format") == 0) {
+            ImageFileFormat format;
+            ok = parseImageFileFormat(next, format);
+            config.captureFormat = next;
+        }
+        else if (strcmp(arg, "--capture-every") == 0) {
+            ok = parseUInt(next, config.captureEvery) && config.captureEvery > 0;
+        }
+        else if (strcmp(arg, "--capture-buffers") == 0) {
+            ok = parseUInt(next, config.captureBuffers) && config.captureBuffers > 0 && config.captureBuffers <= 64;
+        }
+        else if (strcmp(arg, "--capture-threads") == 0) {
+            ok = parseUInt(next, config.captureThreads) && config.captureThreads > 0 && config.captureThreads <= 64;
+        }
+        else if (strcmp(arg, "--particles") == 0) {
+            ok = parseUInt(next, config.particleCount) && config.particleCount <= MAX_PARTICLES;
+        }
+        else if (strcmp(arg, "--width") == 0) {
+            ok = parseUInt(next, config.width) && config.width > 0;
+        }
+        else if (strcmp(arg, "--height") == 0) {
+            ok = parseUInt(next, config.height) && config.height > 0;
+        }
+        else if (strcmp(arg, "--device") == 0) {
+            config.deviceName = next;
+        }
+        else if (strcmp(arg, "--shader-dir") == 0) {
+            // һָʱ滻Ĭ·
+            if (!customShaderPaths) {
+                config.shaderSearchPaths.clear();
+                customShaderPaths = true;
+            }
+            config.shaderSearchPaths.push_back(next);
+        }
+        else if (strcmp(arg, "--shader-archive") == 0) {
+            config.shaderArchive = next;
+        }
+        else if (strcmp(arg, "--pack") == 0) {
+            config.packPath = next;
+        }
+        else if (strcmp(arg, "--pipeline-cache") == 0) {
+            config.pipelineCachePath = next;
+        }
+        else if (strcmp(arg, "--stream") == 0) {
+            config.streamPaths.push_back(next);
+        }
+        else if (strcmp(arg, "--upload-budget") == 0) {
+            ok = parseUInt(next, config.uploadBudgetKB) && config.uploadBudgetKB > 0;
+        }
+        else if (strcmp(arg, "--io-threads") == 0) {
+            ok = parseUInt(next, config.ioThreads) && config.ioThreads > 0 && config.ioThreads <= 16;
+        }
+        else if (strcmp(arg, "--textures") == 0) {
+            config.texturePaths.push_back(next);
+        }
+        else if (strcmp(arg, "--texture-budget") == 0) {
+            ok = parseUInt(next, config.textureBudgetMB) && config.textureBudgetMB > 0;
+        }
+        else if (strcmp(arg, "--texture-upload") == 0) {
+            ok = parseUInt(next, config.textureUploadKB) && config.textureUploadKB > 0;
+        }
+        else if (strcmp(arg, "--trace") == 0) {
+            config.tracePath = next;
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+
+        if (!ok) {
+            std::cerr << "Invalid value for " << arg << ": " << next << std::endl;
+            return false;
+        }
+        ++i;
+    }
+
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 
+struct AppConfig {
+    bool headless = false;              // ޴ȾȾũ / CI
+    uint32_t width = 800;
+    uint32_t height = 600;
+    uint32_t frameCount = 1000;         // ޴ģʽȾ֡
+    uint32_t warmupFrames = 10;         // ͳƵԤ֡
+    uint32_t framesInFlight = 2;        // CPU  GPU ֡1 ~ MAX_FRAMES_IN_FLIGHT
+    std::string presentMode = "fifo";   // fifo / mailbox / immediate / fifo-relaxed治֧ʱ˻ fifo
+    uint32_t swapchainImages = 0;       // ͼ0 ʾģʽԶѡ
+    uint32_t targetFps = 0;             // ֡Ŀ꣬0 ʾ
+    uint32_t resizeEvery = 0;           // ޴ģʽÿ n ֡ģһδڴСı䣨ؽ·
+    uint32_t recordThreads = 0;         // ¼ƶ߳0 ʾֱ¼Ƶ
+    uint32_t drawCount = 1;             // ÿ֡ƴ¼ƿ
+    uint32_t objectCount = 0;           // Ϊ 0 ʱ sceneDrawMode Ƴظ
+    std::string sceneDrawMode = "indirect"; // per-object / instanced / indirect
+    float cameraZoom = 1.0f;            // ţ 1 ʱ׶ⱻ޳
+    bool culling = true;                // ģʽüɫ׶޳
+    bool benchmarkDraws = false;        // ȽϸƷʽڲͬµĿ --headless
+    bool benchmarkRecording = false;    // ߳ͻ¼ʱ䣬 --headless
+    float lodPixelError = 1.0f;         // 尴ͶӰСѡ LOD ʱĻأ0 ʾԭ
+    std::string captureDir;             // ΪʱȾزдͼУ --headless
+    std::string captureFormat = "png";  // png / exr / raw
+    uint32_t captureEvery = 1;          // ÿ n ֡һ
+    uint32_t captureBuffers = 8;        // ־ӳĶػ
+    uint32_t captureThreads = 2;        // дļ߳
+    bool captureWait = false;           // ûпжػʱȴ̣߳Ƿһ֡Ķ
+    uint32_t particleCount = 0;         // GPU Ϊ 0 ʱͨл
+    bool particlesSerial = false;       // ģ¼ͼУʹ첽
+    bool benchmarkParticles = false;    // Ƚһʱ첽봮ģ֡ʱ䣬 --headless
+    std::string deviceName;             // Ӵѡ豸 "llvmpipe"
+    std::vector<std::string> shaderSearchPaths = { ".", ".." }; // ˳ .spv
+    std::string shaderArchive;          // ɫpack_shaders.py ɣ·
+    std::string packPath;               // Դpack_assets.py ɣΪʱõ
+    std::string pipelineCachePath = "pipeline_cache.bin"; // Ϊʱд̻
+    std::vector<std::string> streamPaths; // ʽصļĿ¼.obj / .tga޴ģʽȾȫ
+    uint32_t uploadBudgetKB = 1024;     // ʽÿ֡ύеֽ
+    uint32_t ioThreads = 2;             // ʽص I/O ߳
+    std::vector<std::string> texturePaths; // ļĿ¼.ktx2 / .tgaеʹ뻻 mip 
+    uint32_t textureBudgetMB = 256;     // פԴ
+    uint32_t textureUploadKB = 4096;    // ÿ֡ϴֽ
+    bool benchmarkResources = false;    // ÿ֡ǧԴй© --headless
+    std::string tracePath;              // Ϊʱܷ˳ǰд Chrome trace
+    bool pipelineStatistics = false;    // ܷʱͬʱռͳƣҪ豸֧֣
+};
+
+extern AppConfig appConfig;
+
+void printUsage(const char* program);
+bool parseCommandLine(int argc, char** argv, AppConfig& config);
@@ -0,0 +1,292 @@
+#include "Descriptors.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+void queryDescriptorIndexing(VkPhysicalDevice physicalDevice, bool physicalDeviceProperties2, DescriptorIndexingSupport& support) {
+    support = DescriptorIndexingSupport();
+    if (!physicalDeviceProperties2) {
+        return;
+    }
+
+    auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2KHR"));
+    auto getProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2KHR>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties2KHR"));
+    if (getFeatures2 == nullptr || getProperties2 == nullptr) {
+        return;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2KHR features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features.pNext = &indexingFeatures;
+    getFeatures2(physicalDevice, &features);
+
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties = {};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2KHR properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+    properties.pNext = &indexingProperties;
+    getProperties2(physicalDevice, &properties);
+
+    // ֻõ⼸һ±ʱ顢ְ󶨺Ͳͼİ󶨺
+    if (!indexingFeatures.shaderSampledImageArrayNonUniformIndexing || !indexingFeatures.runtimeDescriptorArray
+        || !indexingFeatures.descriptorBindingPartiallyBound
+        || !indexingFeatures.descriptorBindingSampledImageUpdateAfterBind) {
+        return;
+    }
+
+    // ͼͬʱͼͲƣÿ׶εԴɹ߲емϹ
+    // ΪļϣļϺͳ BINDLESS_RESERVED_RESOURCES 
+    uint32_t perStageResources = indexingProperties.maxPerStageUpdateAfterBindResources;
+    perStageResources = perStageResources > BINDLESS_RESERVED_RESOURCES ? perStageResources - BINDLESS_RESERVED_RESOURCES : 0;
+    support.supported = true;
+    support.maxTextures = std::min({ perStageResources,
+        indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+        indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+        indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+        indexingProperties.maxDescriptorSetUpdateAfterBindSamplers });
+
+    support.features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    support.features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    support.features.runtimeDescriptorArray = VK_TRUE;
+    support.features.descriptorBindingPartiallyBound = VK_TRUE;
+    support.features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+}
+
+static VkSampler createDefaultSampler() {
+    VkSamplerCreateInfo samplerInfo = {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.maxLod = 1000.0f;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+
+    VkSampler sampler;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create default sampler!");
+    }
+    return sampler;
+}
+
+void createBindlessTable(BindlessTable& table, const DescriptorIndexingSupport& support) {
+    if (!support.supported) {
+        return;
+    }
+
+    table.textureCapacity = std::min(BINDLESS_MAX_TEXTURES, support.maxTextures);
+    if (table.textureCapacity == 0) {
+        return;
+    }
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = BINDLESS_TEXTURE_BINDING;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = table.textureCapacity;
+    binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+    const VkDescriptorBindingFlagsEXT bindingFlags =
+        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flagsInfo = {};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    flagsInfo.bindingCount = 1;
+    flagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &table.setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create bindless descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = table.textureCapacity;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &table.pool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create bindless descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = table.pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &table.setLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &table.set) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate bindless descriptor set!");
+    }
+
+    table.defaultSampler = createDefaultSampler();
+    table.enabled = true;
+}
+
+void destroyBindlessTable(BindlessTable& table) {
+    if (table.defaultSampler != VK_NULL_HANDLE) {
+        vkDestroySampler(device, table.defaultSampler, nullptr);
+    }
+    if (table.pool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, table.pool, nullptr);
+    }
+    if (table.setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, table.setLayout, nullptr);
+    }
+    table = BindlessTable();
+}
+
+// ȸͷŵ±꣬ʵʹõķΧֽ
+static BindlessIndex allocateIndex(std::vector<BindlessIndex>& freeList, uint32_t& next, uint32_t capacity) {
+    if (!freeList.empty()) {
+        BindlessIndex index = freeList.back();
+        freeList.pop_back();
+        return index;
+    }
+    if (next >= capacity) {
+        return INVALID_BINDLESS_INDEX;
+    }
+    return next++;
+}
+
+BindlessIndex registerBindlessTexture(BindlessTable& table, VkImageView view, VkSampler sampler) {
+    if (!table.enabled) {
+        return INVALID_BINDLESS_INDEX;
+    }
+
+    BindlessIndex index = allocateIndex(table.freeTextures, table.nextTexture, table.textureCapacity);
+    if (index == INVALID_BINDLESS_INDEX) {
+        return index;
+    }
+
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = sampler != VK_NULL_HANDLE ? sampler : table.defaultSampler;
+    imageInfo.imageView = view;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = table.set;
+    write.dstBinding = BINDLESS_TEXTURE_BINDING;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+
+    table.stats.textures++;
+    table.stats.peakTextures = std::max(table.stats.peakTextures, table.stats.textures);
+    table.stats.descriptorWrites++;
+    return index;
+}
+
+// ְ󶨵±ʧЧֻҪɫٷͷʱҪд
+void releaseBindlessTexture(BindlessTable& table, BindlessIndex index) {
+    if (index == INVALID_BINDLESS_INDEX) {
+        return;
+    }
+    table.freeTextures.push_back(index);
+    table.stats.textures--;
+}
+
+void bindBindlessTable(const BindlessTable& table, VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+    VkPipelineLayout layout, uint32_t set) {
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, set, 1, &table.set, 0, nullptr);
+}
+
+void printBindlessStats(const BindlessTable& table) {
+    if (!table.enabled) {
+        std::cout << "Bindless descriptors: not supported (VK_EXT_descriptor_indexing)" << std::endl;
+        return;
+    }
+
+    const BindlessStats& stats = table.stats;
+    std::cout << "Bindless descriptors: " << stats.textures << "/" << table.textureCapacity << " textures (peak "
+        << stats.peakTextures << "), " << stats.descriptorWrites << " descriptor writes" << std::endl;
+}
+
+static VkDescriptorPool createArenaPool() {
+    // ÿƣĳʱʧܣһ
+    const VkDescriptorPoolSize poolSizes[] = {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, DESCRIPTOR_ARENA_SETS_PER_POOL * 2 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, DESCRIPTOR_ARENA_SETS_PER_POOL },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, DESCRIPTOR_ARENA_SETS_PER_POOL * 2 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, DESCRIPTOR_ARENA_SETS_PER_POOL * 2 },
+    };
+
+    //  FREE_DESCRIPTOR_SET_BITֻһãԷ
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = DESCRIPTOR_ARENA_SETS_PER_POOL;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(sizeof(poolSizes) / sizeof(poolSizes[0]));
+    poolInfo.pPoolSizes = poolSizes;
+
+    VkDescriptorPool pool;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create frame descriptor pool!");
+    }
+    return pool;
+}
+
+void destroyDescriptorArena(DescriptorArena& arena) {
+    for (VkDescriptorPool pool : arena.pools) {
+        vkDestroyDescriptorPool(device, pool, nullptr);
+    }
+    arena = DescriptorArena();
+}
+
+VkDescriptorSet allocateArenaDescriptorSet(DescriptorArena& arena, VkDescriptorSetLayout setLayout) {
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &setLayout;
+
+    // ǰʱ໻һΣ³طʧ˵ϳ˳صĴС
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (arena.currentPool == arena.pools.size()) {
+            arena.pools.push_back(createArenaPool());
+        }
+
+        allocInfo.descriptorPool = arena.pools[arena.currentPool];
+        VkDescriptorSet set;
+        VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &set);
+        if (result == VK_SUCCESS) {
+            arena.allocatedSets++;
+            arena.peakSets = std::max(arena.peakSets, arena.allocatedSets);
+            return set;
+        }
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY_KHR && result != VK_ERROR_FRAGMENTED_POOL) {
+            break;
+        }
+        arena.currentPool++;
+    }
+
+    throw std::runtime_error("failed to allocate frame descriptor set!");
+}
+
+void resetDescriptorArena(DescriptorArena& arena) {
+    // ֻб֡ùĳҪ
+    uint32_t usedPools = std::min(arena.currentPool + 1, static_cast<uint32_t>(arena.pools.size()));
+    for (uint32_t i = 0; i < usedPools; i++) {
+        vkResetDescriptorPool(device, arena.pools[i], 0);
+    }
+    arena.currentPool = 0;
+    arena.allocatedSets = 0;
+}
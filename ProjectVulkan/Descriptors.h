@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+// ȫްͬһbinding 0ֻ֡һΣ
+// ɫ±ʣʱƵİ󶨿
+//  VK_EXT_descriptor_indexing  UPDATE_AFTER_BIND  PARTIALLY_BOUND
+// ;֡ʹøʱҲде±꣬ûд±겻ҪЧ
+// Ĺ߰ table.setLayout ׷ӵУ¼ʱ vkCmdBindDescriptorSets  table.set
+const uint32_t BINDLESS_TEXTURE_BINDING = 0;
+const uint32_t BINDLESS_MAX_TEXTURES = 4096;
+
+// ÿ׶ update-after-bind Դͬһ
+const uint32_t BINDLESS_RESERVED_RESOURCES = 32;
+
+typedef uint32_t BindlessIndex;
+const BindlessIndex INVALID_BINDLESS_INDEX = UINT32_MAX;
+
+// ÿ֡ÿص
+const uint32_t DESCRIPTOR_ARENA_SETS_PER_POOL = 256;
+
+// 豸ǰѯ֧֣features  VkDeviceCreateInfo 
+struct DescriptorIndexingSupport {
+    bool supported = false;
+    uint32_t maxTextures = 0;   // һ update-after-bind ͼޣÿ׶κÿнСߣ
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT features = {};
+};
+
+struct BindlessStats {
+    uint32_t textures = 0;          // ǰע
+    uint32_t peakTextures = 0;
+    uint64_t descriptorWrites = 0;
+};
+
+struct BindlessTable {
+    bool enabled = false;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    VkSampler defaultSampler = VK_NULL_HANDLE;  // עʱûָʹԹˣظѰַ
+    uint32_t textureCapacity = 0;
+
+    // ͷŵ±ȸã next ʼ
+    std::vector<BindlessIndex> freeTextures;
+    uint32_t nextTexture = 0;
+    BindlessStats stats;
+};
+
+// ÿ֡أֻڱ֡ʹãͷţ֡ʼʱгһá
+// ǰʱһأû½صȶڵ֡ķֵ
+struct DescriptorArena {
+    std::vector<VkDescriptorPool> pools;
+    uint32_t currentPool = 0;   // ֮ǰĳض
+    uint32_t allocatedSets = 0; // ֡ļ
+    uint32_t peakSets = 0;
+};
+
+// physicalDeviceProperties2 ʾʵ VK_KHR_get_physical_device_properties2
+// 豸չ VK_EXT_descriptor_indexing  VK_KHR_maintenance3 ɵ߼鲢
+void queryDescriptorIndexing(VkPhysicalDevice physicalDevice, bool physicalDeviceProperties2, DescriptorIndexingSupport& support);
+
+// ֧ʱֽãעǷ INVALID_BINDLESS_INDEXʧʱ׳쳣
+void createBindlessTable(BindlessTable& table, const DescriptorIndexingSupport& support);
+void destroyBindlessTable(BindlessTable& table);
+
+// ɫʹõ±꣬ʱ INVALID_BINDLESS_INDEX
+// ͼ񲼾ֱ SHADER_READ_ONLY_OPTIMALsampler Ϊ VK_NULL_HANDLE ʱʹĬϲ
+BindlessIndex registerBindlessTexture(BindlessTable& table, VkImageView view, VkSampler sampler);
+
+// ±Աã豣֤;֡ٷעеͼʱŹ黹±꣩
+void releaseBindlessTexture(BindlessTable& table, BindlessIndex index);
+
+// ѱ󶨵ֵ߲ĵ set иλñ table.setLayout
+// в䣬ÿһΣ֮òּݵĹ߲Ҫ°
+void bindBindlessTable(const BindlessTable& table, VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+    VkPipelineLayout layout, uint32_t set);
+
+void printBindlessStats(const BindlessTable& table);
+
+void destroyDescriptorArena(DescriptorArena& arena);
+
+// ӱ֡ĳзһϣʧʱ׳쳣
+VkDescriptorSet allocateArenaDescriptorSet(DescriptorArena& arena, VkDescriptorSetLayout setLayout);
+
+// ֡ GPU ɺãbeginFrame  fence ã
+void resetDescriptorArena(DescriptorArena& arena);
@@ -0,0 +1,223 @@
+#include "FrameRing.h"
+#include "FrameStats.h"
+#include "VulkanContext.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+static VkFence createSignaledFence() {
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    VkFence fence;
+    if (vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create fence!");
+    }
+    return fence;
+}
+
+void createFrameRing(FrameRing& ring, uint32_t frameCount, uint32_t queueFamilyIndex, uint32_t recordingThreadCount) {
+    if (frameCount == 0 || frameCount > MAX_FRAMES_IN_FLIGHT) {
+        throw std::runtime_error("invalid number of frames in flight!");
+    }
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits = queueFamilyIndex < queueFamilyCount ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+    bool timestampsSupported = validBits != 0 && props.limits.timestampPeriod != 0.0f;
+    if (timestampsSupported) {
+        ring.timestampPeriodNs = props.limits.timestampPeriod;
+        ring.timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+    }
+    else {
+        std::cerr << "Timestamp queries not supported, GPU frame times unavailable" << std::endl;
+    }
+
+    ring.frames.resize(frameCount);
+    ring.currentFrame = 0;
+    ring.frameNumber = 0;
+
+    createUniformRing(ring.uniforms, frameCount, UNIFORM_RING_FRAME_SIZE);
+
+    for (FrameContext& frame : ring.frames) {
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT; // ÿ֡¼
+        poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create command pool!");
+        }
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = frame.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate command buffer!");
+        }
+
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create semaphores!");
+        }
+
+        // ʼ״̬Ϊźţһ beginFrame 
+        frame.inFlightFence = createSignaledFence();
+
+        // زܱ߳ͬʱʹãÿ¼߳һ
+        frame.threadPools.resize(recordingThreadCount);
+        for (ThreadCommandPool& threadPool : frame.threadPools) {
+            if (vkCreateCommandPool(device, &poolInfo, nullptr, &threadPool.commandPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create recording thread command pool!");
+            }
+        }
+
+        if (timestampsSupported) {
+            VkQueryPoolCreateInfo queryPoolInfo = {};
+            queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryPoolInfo.queryCount = 2;
+
+            if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &frame.timestampQueryPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create timestamp query pool!");
+            }
+        }
+    }
+}
+
+// ֡ fence Ѿȡʱ
+static void retireFrame(FrameRing& ring, FrameContext& frame, FrameStats* stats) {
+    if (frame.timestampsWritten && frame.measureGpu && stats != nullptr) {
+        uint64_t timestamps[2] = {};
+        VkResult result = vkGetQueryPoolResults(device, frame.timestampQueryPool, 0, 2, sizeof(timestamps), timestamps,
+            sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+        if (result == VK_SUCCESS) {
+            uint64_t ticks = (timestamps[1] - timestamps[0]) & ring.timestampMask;
+            stats->gpuFrameMs.push_back(ticks * ring.timestampPeriodNs / 1000000.0);
+        }
+    }
+    frame.timestampsWritten = false;
+    frame.measureGpu = false;
+}
+
+FrameContext& beginFrame(FrameRing& ring, FrameStats* stats) {
+    FrameContext& frame = ring.frames[ring.currentFrame];
+
+    // ֻе GPU  CPU  frames.size() ֡ʱŻ
+    auto waitStart = std::chrono::high_resolution_clock::now();
+    vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
+    auto waitEnd = std::chrono::high_resolution_clock::now();
+
+    if (stats != nullptr) {
+        stats->stallMs.push_back(std::chrono::duration<double, std::milli>(waitEnd - waitStart).count());
+    }
+
+    retireFrame(ring, frame, stats);
+
+    vkResetCommandPool(device, frame.commandPool, 0);
+    for (ThreadCommandPool& threadPool : frame.threadPools) {
+        vkResetCommandPool(device, threadPool.commandPool, 0);
+        threadPool.usedSecondaryBuffers = 0;
+    }
+    beginUniformRingFrame(ring.uniforms, ring.currentFrame);
+    resetDescriptorArena(frame.descriptorArena);
+    frame.measureGpu = stats != nullptr;
+    return frame;
+}
+
+void endFrame(FrameRing& ring) {
+    ring.currentFrame = (ring.currentFrame + 1) % static_cast<uint32_t>(ring.frames.size());
+    ring.frameNumber++;
+}
+
+void submitFrame(FrameContext& frame, VkQueue queue, const VkSubmitInfo& submitInfo) {
+    vkResetFences(device, 1, &frame.inFlightFence);
+    if (vkQueueSubmit(queue, 1, &submitInfo, frame.inFlightFence) == VK_SUCCESS) {
+        return;
+    }
+
+    // ʧܵύᴥ fenceҲ޷һµ
+    vkDestroyFence(device, frame.inFlightFence, nullptr);
+    frame.inFlightFence = VK_NULL_HANDLE;
+    frame.inFlightFence = createSignaledFence();
+    throw std::runtime_error("failed to submit draw command buffer!");
+}
+
+void waitForAllFrames(FrameRing& ring, FrameStats* stats) {
+    // ύ֡ʼ֤ GPU ʱ䰴ύ˳¼
+    uint32_t frameCount = static_cast<uint32_t>(ring.frames.size());
+    for (uint32_t i = 0; i < frameCount; i++) {
+        FrameContext& frame = ring.frames[(ring.currentFrame + i) % frameCount];
+        vkWaitForFences(device, 1, &frame.inFlightFence, VK_TRUE, UINT64_MAX);
+        retireFrame(ring, frame, stats);
+    }
+}
+
+void writeFrameStartTimestamp(FrameContext& frame) {
+    if (frame.timestampQueryPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdResetQueryPool(frame.commandBuffer, frame.timestampQueryPool, 0, 2);
+    vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestampQueryPool, 0);
+}
+
+void writeFrameEndTimestamp(FrameContext& frame) {
+    if (frame.timestampQueryPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampQueryPool, 1);
+    frame.timestampsWritten = true;
+}
+
+VkCommandBuffer acquireSecondaryCommandBuffer(FrameContext& frame, uint32_t threadIndex) {
+    ThreadCommandPool& threadPool = frame.threadPools[threadIndex];
+
+    if (threadPool.usedSecondaryBuffers == threadPool.secondaryBuffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = threadPool.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate secondary command buffer!");
+        }
+        threadPool.secondaryBuffers.push_back(commandBuffer);
+    }
+
+    return threadPool.secondaryBuffers[threadPool.usedSecondaryBuffers++];
+}
+
+void destroyFrameRing(FrameRing& ring) {
+    for (FrameContext& frame : ring.frames) {
+        if (frame.timestampQueryPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, frame.timestampQueryPool, nullptr);
+        }
+        for (ThreadCommandPool& threadPool : frame.threadPools) {
+            vkDestroyCommandPool(device, threadPool.commandPool, nullptr);
+        }
+        destroyDescriptorArena(frame.descriptorArena);
+        vkDestroyFence(device, frame.inFlightFence, nullptr);
+        vkDestroySemaphore(device, frame.imageAvailableSemaphore, nullptr);
+        vkDestroyCommandPool(device, frame.commandPool, nullptr);
+    }
+    destroyUniformRing(ring.uniforms);
+
+    ring = FrameRing();
+}
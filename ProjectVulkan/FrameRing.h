@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Descriptors.h"
+#include "MemoryAllocator.h"
+#include "UniformRing.h"
+
+struct FrameStats;
+
+// ͬʱ GPU ִе֡
+const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+// ¼߳ĳ;֡жռأڷ
+struct ThreadCommandPool {
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> secondaryBuffers;  // ֡ʼʱһã֮
+    uint32_t usedSecondaryBuffers = 0;
+};
+
+// ÿ;֡ռԴCPU ¼Ƶ N+1 ֡ʱ GPU Լִе N ֡
+struct FrameContext {
+    VkCommandPool commandPool = VK_NULL_HANDLE;     // ֡ʼʱ
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;  // ɵźڽͼ񣬼 Presenter
+    VkFence inFlightFence = VK_NULL_HANDLE;
+    VkQueryPool timestampQueryPool = VK_NULL_HANDLE; // ֡ GPU ֹʱ
+    bool timestampsWritten = false;
+    bool measureGpu = false;                         // fence Ƿ GPU ʱͳ
+    DescriptorArena descriptorArena;                 // ֡֡ʼʱ
+    std::vector<ThreadCommandPool> threadPools;      // ±Ϊ JobSystem ̱߳
+};
+
+struct FrameRing {
+    std::vector<FrameContext> frames;
+    uint32_t currentFrame = 0;
+    uint64_t frameNumber = 0;
+    double timestampPeriodNs = 0.0;
+    uint64_t timestampMask = 0;
+    UniformRing uniforms;       // ;֡õʱÿ֡ʼʱ黹òλһ֡Ŀռ
+};
+
+// recordingThreadCount Ϊÿ֡׼¼߳0 ʾֻ¼ƣ
+void createFrameRing(FrameRing& ring, uint32_t frameCount, uint32_t queueFamilyIndex, uint32_t recordingThreadCount);
+void destroyFrameRing(FrameRing& ring);
+
+// ȴǰλһύɣʱ stats->stallMs䳣ռ䲢ء
+// ֡ͷŵԴ ResourceRegistry ͬһλӳ٣beginRegistryFrame
+FrameContext& beginFrame(FrameRing& ring, FrameStats* stats);
+void endFrame(FrameRing& ring);
+
+// ύ֡岢 fence ɡfence ύǰãύʧʱһѴ fence
+// ׳쳣֮ beginFrame ʱĵȴῨ
+void submitFrame(FrameContext& frame, VkQueue queue, const VkSubmitInfo& submitInfo);
+
+// ȴ;֡ɣռδȡ GPU ʱ
+void waitForAllFrames(FrameRing& ring, FrameStats* stats);
+
+// 忪ͷ/βд GPU ʱ豸֧ʱʱκ£
+void writeFrameStartTimestamp(FrameContext& frame);
+void writeFrameEndTimestamp(FrameContext& frame);
+
+//  threadIndex ̵߳ȡһ壬ֻڸ߳ϵáʧʱ׳쳣
+// ڹ߳ʱ parallelFor ת̣߳
+VkCommandBuffer acquireSecondaryCommandBuffer(FrameContext& frame, uint32_t threadIndex);
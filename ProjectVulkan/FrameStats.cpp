@@ -0,0 +1,54 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    // ȷ ceil(p/100 * n) 
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    size_t index = rank == 0 ? 0 : std::min(rank - 1, samples.size() - 1);
+
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static void printTimingRow(const char* label, const std::vector<double>& samples) {
+    std::cout << std::left << std::setw(12) << label << ": ";
+    if (samples.empty()) {
+        std::cout << "n/a" << std::endl;
+        return;
+    }
+
+    std::cout << "p50 " << std::setw(9) << percentile(samples, 50.0) << " ms   "
+        << "p99 " << std::setw(9) << percentile(samples, 99.0) << " ms" << std::endl;
+}
+
+void printFrameStats(const FrameStats& stats) {
+    double fps = stats.totalSeconds > 0.0 ? stats.frameCount / stats.totalSeconds : 0.0;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Frames      : " << stats.frameCount << std::endl;
+    std::cout << "Frames/sec  : " << fps << std::endl;
+    printTimingRow("CPU frame", stats.cpuFrameMs);
+    printTimingRow("Recording", stats.recordMs);
+    printTimingRow("GPU frame", stats.gpuFrameMs);
+    printTimingRow("CPU stall", stats.stallMs);
+
+    double totalStallMs = 0.0;
+    for (double ms : stats.stallMs) {
+        totalStallMs += ms;
+    }
+    double wallMs = stats.totalSeconds * 1000.0;
+    std::cout << "Stall total : " << totalStallMs << " ms";
+    if (wallMs > 0.0) {
+        std::cout << " (" << 100.0 * totalStallMs / wallMs << "% of wall time)";
+    }
+    std::cout << std::endl;
+    std::cout << std::defaultfloat;
+}
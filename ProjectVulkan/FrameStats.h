@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ֡ʱͳƣ룩
+struct FrameStats {
+    std::vector<double> cpuFrameMs;     // ÿ֡¼ + ύ CPU ʱ
+    std::vector<double> recordMs;       // ¼ʱ
+    std::vector<double> gpuFrameMs;     // ʱѯõ GPU ʱ
+    std::vector<double> stallMs;        // ÿ֡ȴ;֡ fence  CPU ʱ
+    double totalSeconds = 0.0;          // ͳƵ֡ܺʱ
+    uint32_t frameCount = 0;
+};
+
+// p ȡֵ [0, 100]Ϊʱ 0
+double percentile(std::vector<double> samples, double p);
+
+void printFrameStats(const FrameStats& stats);
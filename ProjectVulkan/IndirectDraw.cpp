@@ -0,0 +1,342 @@
+#include "IndirectDraw.h"
+#include "ShaderInterface.h"
+#include "ShaderReflection.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+static_assert(sizeof(SceneObject) == 32, "SceneObject must match build_draws.comp");
+static_assert(sizeof(InstanceData) == ShaderReflection::InstancedInstanceStride, "InstanceData does not match instanced.vert inputs");
+
+// build_draws.comp  local_size_x
+static const uint32_t BUILD_DRAWS_GROUP_SIZE = 64;
+
+//  build_draws.comp е BuildParams һ
+struct BuildParams {
+    float frustumPlanes[6][4];
+    uint32_t objectCount;
+    uint32_t cullingEnabled;
+};
+
+static_assert(sizeof(BuildParams) == 104, "BuildParams must match build_draws.comp");
+
+static void createBuildPipeline(IndirectScene& scene, VkShaderModule buildShader) {
+    scene.buildLayout = createPipelineLayout(ShaderReflection::BuildDraws, scene.setLayouts);
+    scene.buildPipeline = createComputePipeline(buildShader, scene.buildLayout);
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 4;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &scene.descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create indirect draw descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = scene.descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &scene.setLayouts[0];
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &scene.descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate indirect draw descriptor set!");
+    }
+
+    // ˳ build_draws.comp һ
+    const GpuBuffer* buffers[] = { &scene.objectBuffer, &scene.drawCommands, &scene.gpuInstances, &scene.drawCount };
+    VkDescriptorBufferInfo bufferInfos[4];
+    VkWriteDescriptorSet writes[4] = {};
+    for (uint32_t i = 0; i < 4; i++) {
+        bufferInfos[i].buffer = buffers[i]->buffer;
+        bufferInfos[i].offset = 0;
+        bufferInfos[i].range = VK_WHOLE_SIZE;
+
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = scene.descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(device, 4, writes, 0, nullptr);
+}
+
+void createIndirectScene(IndirectScene& scene, UploadContext& upload, const std::vector<MeshRange>& meshes,
+    const std::vector<SceneObject>& objects, const IndirectDrawFeatures& features, VkShaderModule buildShader,
+    uint32_t frameCount) {
+    if (meshes.empty() || objects.empty()) {
+        throw std::runtime_error("indirect scene needs at least one mesh and one object!");
+    }
+
+    scene.features = features;
+    scene.meshes = meshes;
+    scene.objectCount = static_cast<uint32_t>(objects.size());
+
+    // õÿʵе䣻CPU · GPU ·ʹͬ
+    uint32_t meshCount = static_cast<uint32_t>(meshes.size());
+    scene.meshInstanceCounts.assign(meshCount, 0);
+    for (const SceneObject& object : objects) {
+        if (object.mesh >= meshCount) {
+            throw std::runtime_error("scene object references a missing mesh!");
+        }
+        scene.meshInstanceCounts[object.mesh]++;
+    }
+
+    // źΧ򣬷Ǿȡϴ
+    std::vector<SceneObject> bounded = objects;
+    for (SceneObject& object : bounded) {
+        float scale = std::max(std::fabs(object.transform[2]), std::fabs(object.transform[3]));
+        object.radius = meshes[object.mesh].radius * scale;
+    }
+
+    scene.meshFirstInstances.assign(meshCount, 0);
+    for (uint32_t mesh = 1; mesh < meshCount; mesh++) {
+        scene.meshFirstInstances[mesh] = scene.meshFirstInstances[mesh - 1] + scene.meshInstanceCounts[mesh - 1];
+    }
+
+    std::vector<InstanceData> sorted(objects.size());
+    std::vector<uint32_t> cursor = scene.meshFirstInstances;
+    for (const SceneObject& object : objects) {
+        InstanceData& instance = sorted[cursor[object.mesh]++];
+        for (int i = 0; i < 4; i++) {
+            instance.transform[i] = object.transform[i];
+        }
+    }
+
+    std::vector<VkDrawIndexedIndirectCommand> commands(meshCount);
+    for (uint32_t mesh = 0; mesh < meshCount; mesh++) {
+        commands[mesh].indexCount = meshes[mesh].indexCount;
+        commands[mesh].instanceCount = 0;
+        commands[mesh].firstIndex = meshes[mesh].firstIndex;
+        commands[mesh].vertexOffset = meshes[mesh].vertexOffset;
+        commands[mesh].firstInstance = scene.meshFirstInstances[mesh];
+    }
+
+    VkDeviceSize objectBytes = sizeof(SceneObject) * objects.size();
+    VkDeviceSize instanceBytes = sizeof(InstanceData) * objects.size();
+    VkDeviceSize commandBytes = sizeof(VkDrawIndexedIndirectCommand) * meshCount;
+
+    createDeviceLocalBuffer(scene.objectBuffer, objectBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    createDeviceLocalBuffer(scene.sortedInstances, instanceBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    createDeviceLocalBuffer(scene.commandTemplate, commandBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    createDeviceLocalBuffer(scene.drawCommands, commandBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    createDeviceLocalBuffer(scene.drawCount, sizeof(DrawCounts),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    createDeviceLocalBuffer(scene.gpuInstances, instanceBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+
+    scene.countReadbacks.resize(frameCount);
+    for (GpuBuffer& readback : scene.countReadbacks) {
+        createBuffer(readback, sizeof(DrawCounts), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+    scene.readbackPending.assign(frameCount, false);
+
+    enqueueBufferUpload(upload, scene.objectBuffer.buffer, 0, bounded.data(), objectBytes);
+    enqueueBufferUpload(upload, scene.sortedInstances.buffer, 0, sorted.data(), instanceBytes);
+    enqueueBufferUpload(upload, scene.commandTemplate.buffer, 0, commands.data(), commandBytes);
+
+    createBuildPipeline(scene, buildShader);
+}
+
+void destroyIndirectScene(IndirectScene& scene) {
+    if (scene.descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, scene.descriptorPool, nullptr);
+    }
+    if (scene.buildPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, scene.buildPipeline, nullptr);
+    }
+    if (scene.buildLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, scene.buildLayout, nullptr);
+    }
+    for (VkDescriptorSetLayout setLayout : scene.setLayouts) {
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    }
+
+    for (GpuBuffer& readback : scene.countReadbacks) {
+        destroyBuffer(readback);
+    }
+    destroyBuffer(scene.gpuInstances);
+    destroyBuffer(scene.drawCount);
+    destroyBuffer(scene.drawCommands);
+    destroyBuffer(scene.commandTemplate);
+    destroyBuffer(scene.sortedInstances);
+    destroyBuffer(scene.objectBuffer);
+
+    scene = IndirectScene();
+}
+
+static void memoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+    VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void setSceneView(IndirectScene& scene, const Mat4& viewProjection) {
+    extractFrustumPlanes(viewProjection, scene.frustumPlanes);
+}
+
+void recordBuildDraws(IndirectScene& scene, VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    VkBufferCopy region = {};
+    region.size = scene.commandTemplate.size;
+    vkCmdCopyBuffer(commandBuffer, scene.commandTemplate.buffer, scene.drawCommands.buffer, 1, &region);
+    vkCmdFillBuffer(commandBuffer, scene.drawCount.buffer, 0, sizeof(DrawCounts), 0);
+
+    memoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scene.buildPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, scene.buildLayout, 0, 1, &scene.descriptorSet, 0, nullptr);
+
+    BuildParams params;
+    memcpy(params.frustumPlanes, scene.frustumPlanes, sizeof(params.frustumPlanes));
+    params.objectCount = scene.objectCount;
+    params.cullingEnabled = scene.culling ? 1 : 0;
+    vkCmdPushConstants(commandBuffer, scene.buildLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+    vkCmdDispatch(commandBuffer, (scene.objectCount + BUILD_DRAWS_GROUP_SIZE - 1) / BUILD_DRAWS_GROUP_SIZE, 1, 1);
+
+    // λĶػ壬ȸ֡ fence ٶ
+    // ӻƵɵߣ֡ͼ
+    if (frameIndex < scene.countReadbacks.size()) {
+        memoryBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+        region.size = sizeof(DrawCounts);
+        vkCmdCopyBuffer(commandBuffer, scene.drawCount.buffer, scene.countReadbacks[frameIndex].buffer, 1, &region);
+        memoryBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+        scene.readbackPending[frameIndex] = true;
+    }
+}
+
+void readCullingCounts(IndirectScene& scene, uint32_t frameIndex) {
+    if (frameIndex >= scene.readbackPending.size() || !scene.readbackPending[frameIndex]) {
+        return;
+    }
+    scene.readbackPending[frameIndex] = false;
+
+    DrawCounts counts;
+    memcpy(&counts, scene.countReadbacks[frameIndex].mapped, sizeof(counts));
+
+    CullingStats& stats = scene.cullingStats;
+    stats.frames++;
+    stats.visible += counts.visibleCount;
+    stats.culled += scene.objectCount - std::min(counts.visibleCount, scene.objectCount);
+    stats.lastVisible = counts.visibleCount;
+}
+
+void printCullingStats(const IndirectScene& scene) {
+    const CullingStats& stats = scene.cullingStats;
+    if (stats.frames == 0) {
+        return;
+    }
+
+    std::cout << "Culling: " << stats.visible / stats.frames << " visible, "
+        << stats.culled / stats.frames << " culled of " << scene.objectCount
+        << " objects per frame (" << stats.frames << " frames)" << std::endl;
+}
+
+SceneDrawMode resolveSceneDrawMode(const IndirectScene& scene, SceneDrawMode mode) {
+    // ÿʵ firstInstance ʼ֧ʱֻ CPU ·
+    if (mode == SceneDrawMode::Indirect && !scene.features.drawIndirectFirstInstance) {
+        return SceneDrawMode::Instanced;
+    }
+    return mode;
+}
+
+uint32_t recordSceneDraws(IndirectScene& scene, VkCommandBuffer commandBuffer, SceneDrawMode mode) {
+    mode = resolveSceneDrawMode(scene, mode);
+    uint32_t meshCount = static_cast<uint32_t>(scene.meshes.size());
+
+    VkDeviceSize offset = 0;
+    VkBuffer instanceBuffer = mode == SceneDrawMode::Indirect ? scene.gpuInstances.buffer : scene.sortedInstances.buffer;
+    vkCmdBindVertexBuffers(commandBuffer, 1, 1, &instanceBuffer, &offset);
+
+    uint32_t drawCalls = 0;
+    switch (mode) {
+    case SceneDrawMode::PerObject:
+        for (uint32_t mesh = 0; mesh < meshCount; mesh++) {
+            const MeshRange& range = scene.meshes[mesh];
+            uint32_t first = scene.meshFirstInstances[mesh];
+            for (uint32_t i = 0; i < scene.meshInstanceCounts[mesh]; i++) {
+                vkCmdDrawIndexed(commandBuffer, range.indexCount, 1, range.firstIndex, range.vertexOffset, first + i);
+            }
+            drawCalls += scene.meshInstanceCounts[mesh];
+        }
+        break;
+
+    case SceneDrawMode::Instanced:
+        for (uint32_t mesh = 0; mesh < meshCount; mesh++) {
+            if (scene.meshInstanceCounts[mesh] == 0) {
+                continue;
+            }
+            const MeshRange& range = scene.meshes[mesh];
+            vkCmdDrawIndexed(commandBuffer, range.indexCount, scene.meshInstanceCounts[mesh], range.firstIndex,
+                range.vertexOffset, scene.meshFirstInstances[mesh]);
+            drawCalls++;
+        }
+        break;
+
+    case SceneDrawMode::Indirect: {
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        if (scene.features.drawIndexedIndirectCount != nullptr) {
+            // ɼɫCPU ֻ
+            scene.features.drawIndexedIndirectCount(commandBuffer, scene.drawCommands.buffer, 0,
+                scene.drawCount.buffer, 0, meshCount, stride);
+            drawCalls++;
+        }
+        else if (scene.features.multiDrawIndirect) {
+            // ûбõ instanceCount Ϊ 0ύҲ
+            vkCmdDrawIndexedIndirect(commandBuffer, scene.drawCommands.buffer, 0, meshCount, stride);
+            drawCalls++;
+        }
+        else {
+            // ֧ multiDrawIndirect ʱÿһμӻ
+            for (uint32_t mesh = 0; mesh < meshCount; mesh++) {
+                vkCmdDrawIndexedIndirect(commandBuffer, scene.drawCommands.buffer, mesh * stride, 1, stride);
+                drawCalls++;
+            }
+        }
+        break;
+    }
+    }
+
+    return drawCalls;
+}
+
+const char* sceneDrawModeName(SceneDrawMode mode) {
+    switch (mode) {
+    case SceneDrawMode::PerObject:
+        return "per-object";
+    case SceneDrawMode::Instanced:
+        return "instanced";
+    case SceneDrawMode::Indirect:
+        return "indirect";
+    }
+    return "unknown";
+}
+
+bool parseSceneDrawMode(const std::string& name, SceneDrawMode& mode) {
+    const SceneDrawMode modes[] = { SceneDrawMode::PerObject, SceneDrawMode::Instanced, SceneDrawMode::Indirect };
+    for (SceneDrawMode candidate : modes) {
+        if (name == sceneDrawModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SimdMath.h"
+#include "Upload.h"
+
+// еһ
+struct MeshRange {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    float radius;           // ԭΪĵİΧ뾶ֲռ䣩
+};
+
+//  build_draws.comp е SceneObject һ£std43032 ֽڣ
+struct SceneObject {
+    float transform[4];     // xy ƫƣzw 
+    uint32_t mesh;
+    float radius;           // ռΧ뾶 createIndirectScene 뾶ż
+    uint32_t padding[2];
+};
+
+// ÿʵĶԣinstanced.vert  instanceTransform
+struct InstanceData {
+    float transform[4];
+};
+
+enum class SceneDrawMode {
+    PerObject,      // ÿһ vkCmdDrawIndexed׼
+    Instanced,      // ÿһʵƣʵڼʱź
+    Indirect,       // ɫʵݺͼӻһ vkCmdDrawIndexedIndirectCount
+};
+
+// 豸ԼӻƵ֧豸ʱд
+struct IndirectDrawFeatures {
+    bool multiDrawIndirect = false;             // һμӵö
+    bool drawIndirectFirstInstance = false;     //  firstInstance ԲΪ 0
+    PFN_vkCmdDrawIndexedIndirectCountKHR drawIndexedIndirectCount = nullptr; // VK_KHR_draw_indirect_count
+};
+
+// ׶޳Ŀɼÿ֡ GPU أӳ;֡֡
+struct CullingStats {
+    uint64_t frames = 0;
+    uint64_t visible = 0;
+    uint64_t culled = 0;
+    uint32_t lastVisible = 0;   // һζصĿɼ
+};
+
+//  build_draws.comp е DrawCount һ
+struct DrawCounts {
+    uint32_t drawCount;
+    uint32_t visibleCount;
+};
+
+struct IndirectScene {
+    IndirectDrawFeatures features;
+    std::vector<MeshRange> meshes;
+    std::vector<uint32_t> meshInstanceCounts;   // CPU ·ÿʵ
+    std::vector<uint32_t> meshFirstInstances;
+    uint32_t objectCount = 0;
+
+    GpuBuffer objectBuffer;         // SceneObject[objectCount]
+    GpuBuffer sortedInstances;      // CPU ·źõ InstanceData[objectCount]
+    GpuBuffer commandTemplate;      // VkDrawIndexedIndirectCommand[meshCount]instanceCount Ϊ 0
+    GpuBuffer drawCommands;         // ɫÿ֡ۼ instanceCount
+    GpuBuffer drawCount;            // DrawCountsʵύͿɼ
+    GpuBuffer gpuInstances;         // ɫдĿɼ InstanceData
+
+    // ׶޳ֻڼģʽ½УCPU ·ǻ壩
+    bool culling = true;
+    float frustumPlanes[6][4] = {}; // xyz ָ׶ڲĵλߣw Ϊ
+    std::vector<GpuBuffer> countReadbacks;  // ÿ;֡һ HOST_VISIBLE  DrawCounts 
+    std::vector<bool> readbackPending;
+    CullingStats cullingStats;
+
+    std::vector<VkDescriptorSetLayout> setLayouts;
+    VkPipelineLayout buildLayout = VK_NULL_HANDLE;
+    VkPipeline buildPipeline = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+};
+
+// ϴݺͻģ壨Ŷӵ upload߸ flushUploads
+// buildShader Ϊ build_draws.comp õģ飬frameCount Ϊ FrameRing ;֡
+void createIndirectScene(IndirectScene& scene, UploadContext& upload, const std::vector<MeshRange>& meshes,
+    const std::vector<SceneObject>& objects, const IndirectDrawFeatures& features, VkShaderModule buildShader,
+    uint32_t frameCount);
+void destroyIndirectScene(IndirectScene& scene);
+
+//  viewProjection ȡ޳õ׶ƽ棨üռ z  [0, w]
+void setSceneView(IndirectScene& scene, const Mat4& viewProjection);
+
+// ģʽȾ֮ͨǰ¼ƣ޳ͼɫѱ֡ļ
+// frameIndex λĶػ塣֮ǰ֮Ļ֮ɵ߲루֡ͼ "Scene draws" Դ
+void recordBuildDraws(IndirectScene& scene, VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+//  beginFrame ֮ãλ fence Ѿۼϴʹøòλ֡޳
+void readCullingCounts(IndirectScene& scene, uint32_t frameIndex);
+void printCullingStats(const IndirectScene& scene);
+
+// Ⱦͨ¼ƳơѾʵߡ㻺壨 0壬
+// ʵ壨 1 mode ύƣ¼ƵĻƵ
+uint32_t recordSceneDraws(IndirectScene& scene, VkCommandBuffer commandBuffer, SceneDrawMode mode);
+
+// 豸ּ֧ģʽҪʱ˻ʵ
+SceneDrawMode resolveSceneDrawMode(const IndirectScene& scene, SceneDrawMode mode);
+
+const char* sceneDrawModeName(SceneDrawMode mode);
+
+//  "per-object" / "instanced" / "indirect"޷ʶʱ false
+bool parseSceneDrawMode(const std::string& name, SceneDrawMode& mode);
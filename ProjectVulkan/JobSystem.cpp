@@ -0,0 +1,150 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// һ parallelFor δɵĶκ͵һ쳣 jobs.mutex 
+struct JobBatch {
+    uint32_t pending = 0;
+    std::exception_ptr error;
+};
+
+// ִһβ¼쳣뿪̣߳ std::terminate
+static void runJob(JobSystem& jobs, Job& job, uint32_t threadIndex) {
+    std::exception_ptr error;
+    try {
+        job.fn(threadIndex);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    if (job.batch == nullptr) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        if (error && !job.batch->error) {
+            job.batch->error = error;
+        }
+        job.batch->pending--;
+    }
+    jobs.jobFinished.notify_all();
+}
+
+static void workerLoop(JobSystem& jobs, uint32_t threadIndex) {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobs.mutex);
+            jobs.jobAvailable.wait(lock, [&jobs] { return jobs.stopping || !jobs.jobs.empty(); });
+            if (jobs.jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.jobs.front());
+            jobs.jobs.pop_front();
+        }
+
+        runJob(jobs, job, threadIndex);
+    }
+}
+
+void createJobSystem(JobSystem& jobs, uint32_t workerCount) {
+    jobs.stopping = false;
+    for (uint32_t i = 0; i < workerCount; i++) {
+        jobs.workers.emplace_back(workerLoop, std::ref(jobs), i);
+    }
+}
+
+void destroyJobSystem(JobSystem& jobs) {
+    {
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        jobs.stopping = true;
+    }
+    jobs.jobAvailable.notify_all();
+
+    for (std::thread& worker : jobs.workers) {
+        worker.join();
+    }
+    jobs.workers.clear();
+    jobs.jobs.clear();
+}
+
+uint32_t getJobThreadCount(const JobSystem& jobs) {
+    return static_cast<uint32_t>(jobs.workers.size()) + 1;
+}
+
+void submitJob(JobSystem& jobs, std::function<void(uint32_t threadIndex)> fn) {
+    if (jobs.workers.empty()) {
+        fn(static_cast<uint32_t>(jobs.workers.size()));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        jobs.jobs.push_back({ std::move(fn), nullptr });
+    }
+    jobs.jobAvailable.notify_one();
+}
+
+void parallelFor(JobSystem& jobs, uint32_t count, uint32_t chunkCount,
+    const std::function<void(uint32_t begin, uint32_t end, uint32_t chunkIndex, uint32_t threadIndex)>& fn) {
+    chunkCount = std::max(1u, std::min(chunkCount, count));
+    const uint32_t callerThread = static_cast<uint32_t>(jobs.workers.size());
+
+    auto chunkBegin = [count, chunkCount](uint32_t chunk) {
+        return static_cast<uint32_t>(static_cast<uint64_t>(count) * chunk / chunkCount);
+    };
+
+    if (chunkCount == 1 || jobs.workers.empty()) {
+        for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+            fn(chunkBegin(chunk), chunkBegin(chunk + 1), chunk, callerThread);
+        }
+        return;
+    }
+
+    //  0 ཻ̣߳߳
+    JobBatch batch;
+    {
+        std::lock_guard<std::mutex> lock(jobs.mutex);
+        for (uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+            uint32_t begin = chunkBegin(chunk);
+            uint32_t end = chunkBegin(chunk + 1);
+            jobs.jobs.push_back({ [&fn, begin, end, chunk](uint32_t threadIndex) { fn(begin, end, chunk, threadIndex); }, &batch });
+        }
+        batch.pending = chunkCount - 1;
+    }
+    jobs.jobAvailable.notify_all();
+
+    std::exception_ptr error;
+    try {
+        fn(chunkBegin(0), chunkBegin(1), 0, callerThread);
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // ߳̿ڱߣûȡߵĶɵ߳ԼִУں̨Ŷ
+    std::unique_lock<std::mutex> lock(jobs.mutex);
+    while (batch.pending > 0) {
+        auto own = std::find_if(jobs.jobs.begin(), jobs.jobs.end(), [&batch](const Job& job) { return job.batch == &batch; });
+        if (own == jobs.jobs.end()) {
+            jobs.jobFinished.wait(lock);
+            continue;
+        }
+
+        Job job = std::move(*own);
+        jobs.jobs.erase(own);
+        lock.unlock();
+        runJob(jobs, job, callerThread);
+        lock.lock();
+    }
+
+    if (!error) {
+        error = batch.error;
+    }
+    lock.unlock();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct JobBatch;
+
+struct Job {
+    std::function<void(uint32_t)> fn;
+    JobBatch* batch = nullptr;      // parallelFor ĶڵߵΣ̨Ϊ nullptr
+};
+
+// Ψһ̳߳أÿ֡¼ơ£ parallelFor߱Ⱥ̨ submitJob
+// ̱߳Ϊ 0 ~ workers.size() - 1 parallelFor ̱߳Ϊ workers.size()
+// ÿ߳ԴҪ׼ getJobThreadCount() 
+struct JobSystem {
+    std::vector<std::thread> workers;
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+    bool stopping = false;
+};
+
+void createJobSystem(JobSystem& jobs, uint32_t workerCount);
+
+// ȴʣִ߳
+void destroyJobSystem(JobSystem& jobs);
+
+uint32_t getJobThreadCount(const JobSystem& jobs);
+
+// ĳ߳첽ִ fn(threadIndex)ȴɣûй߳ʱֱڵִ߳С
+// fn ׳쳣֪ͨɵԼ
+void submitJob(JobSystem& jobs, std::function<void(uint32_t threadIndex)> fn);
+
+//  [0, count) ֳ chunkCount βִ fn(begin, end, chunkIndex, threadIndex)ʱȫɡ
+// ߳ҲִеĶΣ̶߳æ̨ʱɵִ߳ʣĶΡ
+// ĳ׳쳣жνڵ߳׳жʱֻһͬһʱֻһ̵߳
+void parallelFor(JobSystem& jobs, uint32_t count, uint32_t chunkCount,
+    const std::function<void(uint32_t begin, uint32_t end, uint32_t chunkIndex, uint32_t threadIndex)>& fn);
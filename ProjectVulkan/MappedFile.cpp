@@ -0,0 +1,110 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+bool mapFile(const std::string& path, MappedFile& file) {
+    file = MappedFile();
+
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    file.fileHandle = handle;
+    file.size = static_cast<size_t>(size.QuadPart);
+    if (file.size == 0) {
+        return true; // ļܴӳ
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        unmapFile(file);
+        return false;
+    }
+    file.mappingHandle = mapping;
+
+    file.data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (file.data == nullptr) {
+        unmapFile(file);
+        return false;
+    }
+
+    return true;
+}
+
+void unmapFile(MappedFile& file) {
+    if (file.data != nullptr) {
+        UnmapViewOfFile(file.data);
+    }
+    if (file.mappingHandle != nullptr) {
+        CloseHandle(file.mappingHandle);
+    }
+    if (file.fileHandle != nullptr) {
+        CloseHandle(file.fileHandle);
+    }
+
+    file = MappedFile();
+}
+
+#else
+
+bool mapFile(const std::string& path, MappedFile& file) {
+    file = MappedFile();
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+
+    file.fd = fd;
+    file.size = static_cast<size_t>(st.st_size);
+    if (file.size == 0) {
+        return true;
+    }
+
+    void* data = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        unmapFile(file);
+        return false;
+    }
+    file.data = static_cast<const uint8_t*>(data);
+
+    return true;
+}
+
+void unmapFile(MappedFile& file) {
+    if (file.data != nullptr) {
+        munmap(const_cast<uint8_t*>(file.data), file.size);
+    }
+    if (file.fd >= 0) {
+        close(file.fd);
+    }
+
+    file = MappedFile();
+}
+
+#endif
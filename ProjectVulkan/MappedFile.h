@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ֻڴӳļӳַҳ룬ֱӵ uint32_t ʹ
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    void* fileHandle = nullptr;     // Windows: HANDLE
+    void* mappingHandle = nullptr;  // Windows: ļӳ
+    int fd = -1;                    // POSIX
+};
+
+// ļڻ޷ӳʱ falseļӳɹ data Ϊ
+bool mapFile(const std::string& path, MappedFile& file);
+void unmapFile(MappedFile& file);
@@ -0,0 +1,296 @@
+#include "MemoryAllocator.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+static VkDeviceSize nextPowerOfTwo(VkDeviceSize value) {
+    VkDeviceSize result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+static uint32_t log2Of(VkDeviceSize value) {
+    uint32_t result = 0;
+    while ((value >> result) > 1) {
+        result++;
+    }
+    return result;
+}
+
+void createAllocator(GpuAllocator& allocator) {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &allocator.memoryProperties);
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    allocator.bufferImageGranularity = props.limits.bufferImageGranularity;
+
+    // 鰴С룺ֻҪС鲻С granularityڵĻͼͲͬһ granularity ҳ
+    allocator.separateKinds = allocator.bufferImageGranularity > MIN_BLOCK_SIZE;
+
+    allocator.pools.resize(allocator.memoryProperties.memoryTypeCount * 2);
+    for (uint32_t type = 0; type < allocator.memoryProperties.memoryTypeCount; type++) {
+        const VkMemoryType& memoryType = allocator.memoryProperties.memoryTypes[type];
+        VkDeviceSize heapSize = allocator.memoryProperties.memoryHeaps[memoryType.heapIndex].size;
+
+        // Сѣ 256MB  BAR ڴ棩ʹýСҳһҳռ̫
+        VkDeviceSize pageSize = DEFAULT_PAGE_SIZE;
+        while (pageSize > MIN_PAGE_SIZE && pageSize > heapSize / 8) {
+            pageSize /= 2;
+        }
+
+        for (uint32_t kind = 0; kind < 2; kind++) {
+            MemoryPool& pool = allocator.pools[type * 2 + kind];
+            pool.pageSize = pageSize;
+            pool.hostVisible = (memoryType.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+        }
+    }
+}
+
+static void destroyPage(GpuAllocator& allocator, MemoryPage& page) {
+    vkFreeMemory(device, page.memory, nullptr);
+
+    allocator.stats.pageCount--;
+    allocator.stats.reservedBytes -= page.size;
+    allocator.stats.vkAllocationCount--;
+}
+
+void destroyAllocator(GpuAllocator& allocator) {
+    for (MemoryPool& pool : allocator.pools) {
+        for (auto& page : pool.pages) {
+            if (page->allocationCount != 0) {
+                std::cerr << "Memory page destroyed with " << page->allocationCount << " live allocation(s)" << std::endl;
+            }
+            destroyPage(allocator, *page);
+        }
+    }
+
+    allocator = GpuAllocator();
+}
+
+static MemoryPage* createPage(GpuAllocator& allocator, MemoryPool& pool, uint32_t memoryType) {
+    VkMemoryAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = pool.pageSize;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    std::unique_ptr<MemoryPage> page(new MemoryPage());
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &page->memory) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate memory page!");
+    }
+
+    // HOST_VISIBLE ҳӳһΣӷֱʹƫƺĵַ
+    if (pool.hostVisible) {
+        if (vkMapMemory(device, page->memory, 0, VK_WHOLE_SIZE, 0, &page->mapped) != VK_SUCCESS) {
+            vkFreeMemory(device, page->memory, nullptr);
+            throw std::runtime_error("failed to map memory page!");
+        }
+    }
+
+    page->size = pool.pageSize;
+    page->maxOrder = log2Of(pool.pageSize / MIN_BLOCK_SIZE);
+    page->freeBlocks.resize(page->maxOrder + 1);
+    page->freeBlocks[page->maxOrder].insert(0);
+    page->freeBytes = pool.pageSize;
+
+    allocator.stats.pageCount++;
+    allocator.stats.reservedBytes += pool.pageSize;
+    allocator.stats.vkAllocationCount++;
+
+    pool.pages.push_back(std::move(page));
+    return pool.pages.back().get();
+}
+
+// ȡһ order ׵Ŀ飬ҪʱָĿ
+static bool buddyAllocate(MemoryPage& page, uint32_t order, VkDeviceSize& offset) {
+    uint32_t found = order;
+    while (found <= page.maxOrder && page.freeBlocks[found].empty()) {
+        found++;
+    }
+    if (found > page.maxOrder) {
+        return false;
+    }
+
+    offset = *page.freeBlocks[found].begin();
+    page.freeBlocks[found].erase(page.freeBlocks[found].begin());
+
+    // ֣ÿһĺһŻؿб
+    while (found > order) {
+        found--;
+        page.freeBlocks[found].insert(offset + (MIN_BLOCK_SIZE << found));
+    }
+
+    page.freeBytes -= MIN_BLOCK_SIZE << order;
+    return true;
+}
+
+// ͷſ飬еĻ𼶺ϲ
+static void buddyFree(MemoryPage& page, VkDeviceSize offset, uint32_t order) {
+    page.freeBytes += MIN_BLOCK_SIZE << order;
+
+    while (order < page.maxOrder) {
+        VkDeviceSize buddy = offset ^ (MIN_BLOCK_SIZE << order);
+        if (page.freeBlocks[order].erase(buddy) == 0) {
+            break;
+        }
+        offset = std::min(offset, buddy);
+        order++;
+    }
+
+    page.freeBlocks[order].insert(offset);
+}
+
+void allocateMemory(GpuAllocator& allocator, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+    ResourceKind kind, Allocation& allocation) {
+    uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+    uint32_t poolIndex = memoryType * 2 + (allocator.separateKinds && kind == ResourceKind::Optimal ? 1 : 0);
+    MemoryPool& pool = allocator.pools[poolIndex];
+
+    allocation = Allocation();
+    allocation.size = requirements.size;
+    allocation.memoryType = memoryType;
+    allocation.poolIndex = poolIndex;
+
+    // ƫǿС鲻С alignment Ҫ
+    VkDeviceSize blockSize = nextPowerOfTwo(std::max(std::max(requirements.size, requirements.alignment), MIN_BLOCK_SIZE));
+
+    if (blockSize > pool.pageSize / 2) {
+        // ԴȫȾĿ꣩䣬ҳ˷һռ
+        VkMemoryAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = requirements.size;
+        allocInfo.memoryTypeIndex = memoryType;
+
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &allocation.memory) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate dedicated memory!");
+        }
+        if (pool.hostVisible) {
+            if (vkMapMemory(device, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.mapped) != VK_SUCCESS) {
+                vkFreeMemory(device, allocation.memory, nullptr);
+                throw std::runtime_error("failed to map dedicated memory!");
+            }
+        }
+
+        allocator.stats.allocationCount++;
+        allocator.stats.usedBytes += requirements.size;
+        allocator.stats.dedicatedCount++;
+        allocator.stats.dedicatedBytes += requirements.size;
+        allocator.stats.reservedBytes += requirements.size;
+        allocator.stats.vkAllocationCount++;
+        return;
+    }
+
+    uint32_t order = log2Of(blockSize / MIN_BLOCK_SIZE);
+
+    MemoryPage* page = nullptr;
+    VkDeviceSize offset = 0;
+    for (auto& candidate : pool.pages) {
+        if (candidate->freeBytes >= blockSize && buddyAllocate(*candidate, order, offset)) {
+            page = candidate.get();
+            break;
+        }
+    }
+    if (page == nullptr) {
+        page = createPage(allocator, pool, memoryType);
+        buddyAllocate(*page, order, offset);
+    }
+
+    page->allocationCount++;
+
+    allocation.memory = page->memory;
+    allocation.offset = offset;
+    allocation.page = page;
+    allocation.order = order;
+    if (page->mapped != nullptr) {
+        allocation.mapped = static_cast<uint8_t*>(page->mapped) + offset;
+    }
+
+    allocator.stats.allocationCount++;
+    allocator.stats.usedBytes += requirements.size;
+    allocator.stats.wastedBytes += blockSize - requirements.size;
+}
+
+void freeMemory(GpuAllocator& allocator, Allocation& allocation) {
+    if (allocation.memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    allocator.stats.allocationCount--;
+    allocator.stats.usedBytes -= allocation.size;
+
+    if (allocation.page == nullptr) {
+        vkFreeMemory(device, allocation.memory, nullptr);
+
+        allocator.stats.dedicatedCount--;
+        allocator.stats.dedicatedBytes -= allocation.size;
+        allocator.stats.reservedBytes -= allocation.size;
+        allocator.stats.vkAllocationCount--;
+        allocation = Allocation();
+        return;
+    }
+
+    MemoryPage* page = allocation.page;
+    allocator.stats.wastedBytes -= (MIN_BLOCK_SIZE << allocation.order) - allocation.size;
+    buddyFree(*page, allocation.offset, allocation.order);
+    page->allocationCount--;
+
+    // ҳ黹ÿرһҳⷴͷ
+    MemoryPool& pool = allocator.pools[allocation.poolIndex];
+    if (page->allocationCount == 0 && pool.pages.size() > 1) {
+        for (size_t i = 0; i < pool.pages.size(); i++) {
+            if (pool.pages[i].get() == page) {
+                destroyPage(allocator, *page);
+                pool.pages.erase(pool.pages.begin() + i);
+                break;
+            }
+        }
+    }
+
+    allocation = Allocation();
+}
+
+AllocatorStats getAllocatorStats(const GpuAllocator& allocator) {
+    AllocatorStats stats = allocator.stats;
+    stats.freeBytes = 0;
+    stats.largestFreeBlock = 0;
+
+    uint64_t fragmentedBytes = 0;
+    for (const MemoryPool& pool : allocator.pools) {
+        for (const auto& page : pool.pages) {
+            VkDeviceSize largest = 0;
+            for (uint32_t order = page->maxOrder + 1; order-- > 0;) {
+                if (!page->freeBlocks[order].empty()) {
+                    largest = MIN_BLOCK_SIZE << order;
+                    break;
+                }
+            }
+
+            stats.freeBytes += page->freeBytes;
+            stats.largestFreeBlock = std::max<uint64_t>(stats.largestFreeBlock, largest);
+            fragmentedBytes += page->freeBytes - largest;
+        }
+    }
+
+    stats.fragmentation = stats.freeBytes > 0 ? static_cast<double>(fragmentedBytes) / stats.freeBytes : 0.0;
+    return stats;
+}
+
+void printAllocatorStats(const GpuAllocator& allocator) {
+    AllocatorStats stats = getAllocatorStats(allocator);
+    const double MB = 1024.0 * 1024.0;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "GPU memory  : " << stats.reservedBytes / MB << " MB reserved in "
+        << stats.vkAllocationCount << " vkAllocateMemory block(s), " << stats.pageCount << " page(s)" << std::endl;
+    std::cout << "Allocations : " << stats.allocationCount << " (" << stats.dedicatedCount << " dedicated, "
+        << stats.dedicatedBytes / MB << " MB)" << std::endl;
+    std::cout << "Used        : " << stats.usedBytes / MB << " MB" << std::endl;
+    std::cout << "Wasted      : " << stats.wastedBytes / MB << " MB" << std::endl;
+    std::cout << "Free        : " << stats.freeBytes / MB << " MB, largest block "
+        << stats.largestFreeBlock / MB << " MB, fragmentation " << 100.0 * stats.fragmentation << "%" << std::endl;
+    std::cout << std::defaultfloat;
+}
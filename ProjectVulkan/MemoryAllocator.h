@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+// ÿڴͰҳһ vkAllocateMemory룬ҳû㷨з
+const VkDeviceSize DEFAULT_PAGE_SIZE = 64ull * 1024 * 1024;
+const VkDeviceSize MIN_PAGE_SIZE = 1ull * 1024 * 1024;
+const VkDeviceSize MIN_BLOCK_SIZE = 256;
+
+// ԴзʽǷ bufferImageGranularity Լ
+enum class ResourceKind {
+    Linear,     // LINEAR ͼ
+    Optimal,    // OPTIMAL ͼ
+};
+
+struct MemoryPage {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;
+    uint32_t maxOrder = 0;                              // ҳӦĽ
+    std::vector<std::set<VkDeviceSize>> freeBlocks;     // ±ΪףС = MIN_BLOCK_SIZE << 
+    VkDeviceSize freeBytes = 0;
+    uint32_t allocationCount = 0;
+};
+
+// ͬһڴͬ͡һзʽҳ
+struct MemoryPool {
+    std::vector<std::unique_ptr<MemoryPage>> pages;
+    VkDeviceSize pageSize = 0;
+    bool hostVisible = false;
+};
+
+struct Allocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;          // ĴС
+    void* mapped = nullptr;         // HOST_VISIBLE ڴӳַѼ offset
+    uint32_t memoryType = 0;
+    MemoryPage* page = nullptr;     // Ϊձʾ
+    uint32_t poolIndex = 0;
+    uint32_t order = 0;
+};
+
+struct AllocatorStats {
+    uint64_t pageCount = 0;
+    uint64_t reservedBytes = 0;     // ҳͶܴС
+    uint64_t usedBytes = 0;         // ֽ
+    uint64_t wastedBytes = 0;       // ͻȡɵ˷
+    uint64_t allocationCount = 0;
+    uint64_t dedicatedCount = 0;
+    uint64_t dedicatedBytes = 0;
+    uint64_t vkAllocationCount = 0; // ǰڵ VkDeviceMemory 
+    uint64_t freeBytes = 0;         // ҳڿֽ
+    uint64_t largestFreeBlock = 0;
+    double fragmentation = 0.0;     // ҳڿпռвڸҳпı
+};
+
+struct GpuAllocator {
+    VkPhysicalDeviceMemoryProperties memoryProperties = {};
+    VkDeviceSize bufferImageGranularity = 1;
+    bool separateKinds = false;     // granularity Сʱͼڲͬҳ
+    std::vector<MemoryPool> pools;  // ±Ϊ memoryType * 2 + kind
+    AllocatorStats stats;
+};
+
+void createAllocator(GpuAllocator& allocator);
+void destroyAllocator(GpuAllocator& allocator);
+
+//  requirements ڴ棬ҳʹö
+void allocateMemory(GpuAllocator& allocator, const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+    ResourceKind kind, Allocation& allocation);
+void freeMemory(GpuAllocator& allocator, Allocation& allocation);
+
+// ͳƵǰĿп飨ڹƬ̶ȣ
+AllocatorStats getAllocatorStats(const GpuAllocator& allocator);
+void printAllocatorStats(const GpuAllocator& allocator);
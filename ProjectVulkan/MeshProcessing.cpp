@@ -0,0 +1,805 @@
+#include "MeshProcessing.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// ---- 㻺 ----
+
+// Forsyth 㷨ģ LRU СʵӲһЩЧã
+const uint32_t FORSYTH_CACHE_SIZE = 32;
+
+static float forsythVertexScore(int32_t cachePosition, uint32_t remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // ù̶ͬһƽ
+        if (cachePosition < 3) {
+            score = 0.75f;
+        }
+        else {
+            float scale = 1.0f - static_cast<float>(cachePosition - 3) / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(scale, 1.5f);
+        }
+    }
+    // ʣٵĶȣ
+    return score + 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0) {
+        return;
+    }
+
+    //  -> δΣÿбǰ remaining[v] Ч
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (uint32_t index : indices) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        for (uint32_t k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = t;
+        }
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = forsythVertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    uint32_t bestTriangle = 0;
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+        if (triangleScore[t] > triangleScore[bestTriangle]) {
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> newCache;
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    uint32_t cursor = 0;
+
+    while (result.size() < indices.size()) {
+        // еĶûʣʱͷҵһδ
+        if (bestTriangle == UINT32_MAX) {
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            bestTriangle = cursor;
+        }
+
+        uint32_t triangle = bestTriangle;
+        emitted[triangle] = 1;
+        const uint32_t* corners = &indices[triangle * 3];
+        result.insert(result.end(), corners, corners + 3);
+
+        newCache.clear();
+        for (uint32_t k = 0; k < 3; k++) {
+            uint32_t v = corners[k];
+            uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t j = 0; j < remaining[v]; j++) {
+                if (list[j] == triangle) {
+                    std::swap(list[j], list[remaining[v] - 1]);
+                    remaining[v]--;
+                    break;
+                }
+            }
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) {
+                newCache.push_back(v);
+            }
+        }
+        for (uint32_t v : cache) {
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) {
+                newCache.push_back(v);
+            }
+        }
+
+        // Ķ㱻ҲҪ
+        for (uint32_t i = 0; i < newCache.size(); i++) {
+            uint32_t v = newCache[i];
+            cachePosition[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = forsythVertexScore(cachePosition[v], remaining[v]);
+        }
+
+        bestTriangle = UINT32_MAX;
+        float bestScore = -FLT_MAX;
+        for (uint32_t v : newCache) {
+            const uint32_t* list = &adjacency[offsets[v]];
+            for (uint32_t j = 0; j < remaining[v]; j++) {
+                uint32_t t = list[j];
+                float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triangleScore[t] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (newCache.size() > FORSYTH_CACHE_SIZE) {
+            newCache.resize(FORSYTH_CACHE_SIZE);
+        }
+        cache.swap(newCache);
+    }
+
+    indices.swap(result);
+}
+
+float analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize) {
+    if (indices.size() < 3) {
+        return 0.0f;
+    }
+
+    // FIFO뻺ʱʱ֮ٽ cacheSize ͱ
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (uint32_t index : indices) {
+        if (time - timestamps[index] > cacheSize) {
+            timestamps[index] = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / (indices.size() / 3);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount) {
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t next = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    for (uint32_t& target : remap) {
+        if (target == UINT32_MAX) {
+            target = next++;
+        }
+    }
+    return remap;
+}
+
+// ----  ----
+
+// Գ 4x4 ǣ[p 1] Q [p 1]^T Ϊ p ƽƽļȨͣweight ΪȨ֮
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+    double weight = 0;
+};
+
+// ƽ np + d = 0n Ϊλ
+static void addPlane(Quadric& q, const Vec3& n, float d, double weight) {
+    double a = n.x, b = n.y, c = n.z, w = d;
+    q.a00 += weight * a * a; q.a01 += weight * a * b; q.a02 += weight * a * c; q.a03 += weight * a * w;
+    q.a11 += weight * b * b; q.a12 += weight * b * c; q.a13 += weight * b * w;
+    q.a22 += weight * c * c; q.a23 += weight * c * w;
+    q.a33 += weight * w * w;
+    q.weight += weight;
+}
+
+static void addQuadric(Quadric& q, const Quadric& r) {
+    q.a00 += r.a00; q.a01 += r.a01; q.a02 += r.a02; q.a03 += r.a03;
+    q.a11 += r.a11; q.a12 += r.a12; q.a13 += r.a13;
+    q.a22 += r.a22; q.a23 += r.a23;
+    q.a33 += r.a33;
+    q.weight += r.weight;
+}
+
+// ƽƽļȨƽ
+static double evaluateQuadric(const Quadric& q, const Vec3& p) {
+    double x = p.x, y = p.y, z = p.z;
+    double result = q.a00 * x * x + 2 * q.a01 * x * y + 2 * q.a02 * x * z + 2 * q.a03 * x
+        + q.a11 * y * y + 2 * q.a12 * y * z + 2 * q.a13 * y
+        + q.a22 * z * z + 2 * q.a23 * z
+        + q.a33;
+    return q.weight > 0.0 ? std::max(result, 0.0) / q.weight : 0.0;
+}
+
+Vec3 triangleNormal(const Vec3& a, const Vec3& b, const Vec3& c) {
+    return vec3Cross(vec3Sub(b, a), vec3Sub(c, a));
+}
+
+static uint64_t edgeKey(uint32_t a, uint32_t b) {
+    return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+}
+
+// EricsonReal-Time Collision Detection 5.1.5
+float pointTriangleDistance(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c) {
+    Vec3 ab = vec3Sub(b, a), ac = vec3Sub(c, a), ap = vec3Sub(p, a);
+    float d1 = vec3Dot(ab, ap), d2 = vec3Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return vec3Length(ap);
+    }
+    Vec3 bp = vec3Sub(p, b);
+    float d3 = vec3Dot(ab, bp), d4 = vec3Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return vec3Length(bp);
+    }
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        float v = d1 / (d1 - d3);
+        return vec3Length(vec3Sub(p, vec3Add(a, vec3Scale(ab, v))));
+    }
+    Vec3 cp = vec3Sub(p, c);
+    float d5 = vec3Dot(ab, cp), d6 = vec3Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return vec3Length(cp);
+    }
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        float w = d2 / (d2 - d6);
+        return vec3Length(vec3Sub(p, vec3Add(a, vec3Scale(ac, w))));
+    }
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return vec3Length(vec3Sub(p, vec3Add(b, vec3Scale(vec3Sub(c, b), w))));
+    }
+    float denominator = 1.0f / (va + vb + vc);
+    float v = vb * denominator, w = vc * denominator;
+    return vec3Length(vec3Sub(p, vec3Add(a, vec3Add(vec3Scale(ab, v), vec3Scale(ac, w)))));
+}
+
+// ԭб۵Ķ㵽롣ΰΧзŽ
+// ÿڸȦңֱҵľ벻δ
+static float measureSimplifiedDistance(const std::vector<Vec3>& positions, const std::vector<uint32_t>& original,
+    const std::vector<uint32_t>& simplified) {
+    uint32_t triangleCount = static_cast<uint32_t>(simplified.size() / 3);
+    if (triangleCount == 0) {
+        return 0.0f;
+    }
+
+    std::vector<uint8_t> kept(positions.size(), 0);
+    Vec3 minimum = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vec3 maximum = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t index : simplified) {
+        kept[index] = 1;
+        const Vec3& p = positions[index];
+        minimum = { std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+        maximum = { std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+    }
+
+    // ÿƽԼһ
+    Vec3 size = vec3Sub(maximum, minimum);
+    float extent = std::max(size.x, std::max(size.y, size.z));
+    float cell = std::max(extent / std::max(1.0f, std::cbrt(static_cast<float>(triangleCount))), 1e-6f);
+    int32_t dims[3] = {
+        std::max(1, static_cast<int32_t>(size.x / cell) + 1),
+        std::max(1, static_cast<int32_t>(size.y / cell) + 1),
+        std::max(1, static_cast<int32_t>(size.z / cell) + 1),
+    };
+    auto cellCoord = [&](float value, float origin, int32_t dim) {
+        return std::min(std::max(static_cast<int32_t>((value - origin) / cell), 0), dim - 1);
+    };
+
+    uint32_t cellCount = static_cast<uint32_t>(dims[0] * dims[1] * dims[2]);
+    std::vector<std::vector<uint32_t>> cells(cellCount);
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        const Vec3& a = positions[simplified[t * 3]];
+        const Vec3& b = positions[simplified[t * 3 + 1]];
+        const Vec3& c = positions[simplified[t * 3 + 2]];
+        int32_t lo[3] = {
+            cellCoord(std::min(a.x, std::min(b.x, c.x)), minimum.x, dims[0]),
+            cellCoord(std::min(a.y, std::min(b.y, c.y)), minimum.y, dims[1]),
+            cellCoord(std::min(a.z, std::min(b.z, c.z)), minimum.z, dims[2]),
+        };
+        int32_t hi[3] = {
+            cellCoord(std::max(a.x, std::max(b.x, c.x)), minimum.x, dims[0]),
+            cellCoord(std::max(a.y, std::max(b.y, c.y)), minimum.y, dims[1]),
+            cellCoord(std::max(a.z, std::max(b.z, c.z)), minimum.z, dims[2]),
+        };
+        for (int32_t z = lo[2]; z <= hi[2]; z++) {
+            for (int32_t y = lo[1]; y <= hi[1]; y++) {
+                for (int32_t x = lo[0]; x <= hi[0]; x++) {
+                    cells[(z * dims[1] + y) * dims[0] + x].push_back(t);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> visited(triangleCount, UINT32_MAX);
+    int32_t maxRing = std::max(dims[0], std::max(dims[1], dims[2]));
+    float result = 0.0f;
+
+    for (uint32_t index : original) {
+        if (kept[index]) {
+            continue;
+        }
+        kept[index] = 1;    // ÿֻһ
+
+        const Vec3& p = positions[index];
+        int32_t center[3] = { cellCoord(p.x, minimum.x, dims[0]), cellCoord(p.y, minimum.y, dims[1]), cellCoord(p.z, minimum.z, dims[2]) };
+        float nearest = FLT_MAX;
+        for (int32_t ring = 0; ring <= maxRing; ring++) {
+            for (int32_t z = std::max(center[2] - ring, 0); z <= std::min(center[2] + ring, dims[2] - 1); z++) {
+                for (int32_t y = std::max(center[1] - ring, 0); y <= std::min(center[1] + ring, dims[1] - 1); y++) {
+                    for (int32_t x = std::max(center[0] - ring, 0); x <= std::min(center[0] + ring, dims[0] - 1); x++) {
+                        if (std::max({ std::abs(x - center[0]), std::abs(y - center[1]), std::abs(z - center[2]) }) != ring) {
+                            continue;
+                        }
+                        for (uint32_t t : cells[(z * dims[1] + y) * dims[0] + x]) {
+                            if (visited[t] == index) {
+                                continue;
+                            }
+                            visited[t] = index;
+                            nearest = std::min(nearest, pointTriangleDistance(p,
+                                positions[simplified[t * 3]], positions[simplified[t * 3 + 1]], positions[simplified[t * 3 + 2]]));
+                        }
+                    }
+                }
+            }
+            //  ring Ȧ֮ĸ p  ring * cell
+            if (nearest <= ring * cell) {
+                break;
+            }
+        }
+        result = std::max(result, nearest);
+    }
+    return result;
+}
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+// from ϲ to from Χ toǷзת˻һߵ
+static bool collapseFlips(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& adjacency, uint32_t from, uint32_t to) {
+    for (uint32_t j = offsets[from]; j < offsets[from + 1]; j++) {
+        const uint32_t* corners = &indices[adjacency[j] * 3];
+        if (corners[0] == to || corners[1] == to || corners[2] == to) {
+            continue;
+        }
+
+        Vec3 before[3];
+        Vec3 after[3];
+        for (uint32_t k = 0; k < 3; k++) {
+            before[k] = positions[corners[k]];
+            after[k] = positions[corners[k] == from ? to : corners[k]];
+        }
+        Vec3 n0 = triangleNormal(before[0], before[1], before[2]);
+        Vec3 n1 = triangleNormal(after[0], after[1], after[2]);
+        if (vec3Dot(n0, n1) <= 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<uint32_t> simplifyMesh(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    uint32_t targetIndexCount, float targetError, float* resultError) {
+    uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        if (indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i] != indices[i + 2]) {
+            result.insert(result.end(), indices.begin() + i, indices.begin() + i + 3);
+        }
+    }
+
+    // ÿۼڵƽ
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        Vec3 n = triangleNormal(positions[result[i]], positions[result[i + 1]], positions[result[i + 2]]);
+        float length = vec3Length(n);
+        if (length <= 0.0f) {
+            continue;
+        }
+        n = vec3Scale(n, 1.0f / length);
+        float d = -vec3Dot(n, positions[result[i]]);
+        for (uint32_t k = 0; k < 3; k++) {
+            addPlane(quadrics[result[i + k]], n, d, length * 0.5);
+        }
+    }
+
+    // ߽ټһߡֱεƽ棬ʹ߽綥뿪ԭʱд
+    std::vector<uint64_t> keys;
+    keys.reserve(result.size());
+    for (size_t i = 0; i < result.size(); i += 3) {
+        for (uint32_t k = 0; k < 3; k++) {
+            keys.push_back(edgeKey(result[i + k], result[i + (k + 1) % 3]));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < result.size(); i += 3) {
+        Vec3 n = vec3Normalize(triangleNormal(positions[result[i]], positions[result[i + 1]], positions[result[i + 2]]));
+        for (uint32_t k = 0; k < 3; k++) {
+            uint32_t a = result[i + k];
+            uint32_t b = result[i + (k + 1) % 3];
+            auto range = std::equal_range(keys.begin(), keys.end(), edgeKey(a, b));
+            if (range.second - range.first != 1) {
+                continue;
+            }
+            Vec3 edge = vec3Sub(positions[b], positions[a]);
+            Vec3 side = vec3Cross(edge, n);
+            if (vec3Length(side) <= 0.0f) {
+                continue;
+            }
+            side = vec3Normalize(side);
+            float d = -vec3Dot(side, positions[a]);
+            double weight = vec3Dot(edge, edge);
+            addPlane(quadrics[a], side, d, weight);
+            addPlane(quadrics[b], side, d, weight);
+        }
+    }
+
+    uint32_t targetTriangles = targetIndexCount / 3;
+    double errorLimit = static_cast<double>(targetError) * targetError;
+
+    std::vector<uint8_t> boundary(vertexCount);
+    std::vector<uint8_t> locked(vertexCount);
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::vector<uint32_t> offsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> candidates;
+
+    // ÿһְ۴С۵ڵıߣȻؽڽӹϵ
+    bool relaxPass = false;
+    while (result.size() / 3 > targetTriangles) {
+        uint32_t triangleCount = static_cast<uint32_t>(result.size() / 3);
+
+        keys.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (uint32_t k = 0; k < 3; k++) {
+                keys.push_back(edgeKey(result[i + k], result[i + (k + 1) % 3]));
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+
+        // ֻһεıǱ߽
+        std::vector<uint64_t> edges;
+        std::vector<uint8_t> edgeBoundary;
+        std::fill(boundary.begin(), boundary.end(), 0);
+        for (size_t i = 0; i < keys.size();) {
+            size_t j = i;
+            while (j < keys.size() && keys[j] == keys[i]) {
+                j++;
+            }
+            bool isBoundary = j - i == 1;
+            edges.push_back(keys[i]);
+            edgeBoundary.push_back(isBoundary ? 1 : 0);
+            if (isBoundary) {
+                boundary[keys[i] >> 32] = 1;
+                boundary[keys[i] & 0xffffffffu] = 1;
+            }
+            i = j;
+        }
+
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (uint32_t index : result) {
+            offsets[index + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        adjacency.resize(result.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            for (uint32_t k = 0; k < 3; k++) {
+                adjacency[fill[result[t * 3 + k]]++] = t;
+            }
+        }
+
+        // ߽綥ֻر߽۵
+        candidates.clear();
+        for (size_t e = 0; e < edges.size(); e++) {
+            uint32_t a = static_cast<uint32_t>(edges[e] >> 32);
+            uint32_t b = static_cast<uint32_t>(edges[e] & 0xffffffffu);
+            Quadric q = quadrics[a];
+            addQuadric(q, quadrics[b]);
+
+            bool aToB = !boundary[a] || edgeBoundary[e];
+            bool bToA = !boundary[b] || edgeBoundary[e];
+            double costAToB = aToB ? evaluateQuadric(q, positions[b]) : DBL_MAX;
+            double costBToA = bToA ? evaluateQuadric(q, positions[a]) : DBL_MAX;
+            if (!aToB && !bToA) {
+                continue;
+            }
+            if (costAToB <= costBToA) {
+                candidates.push_back({ a, b, costAToB });
+            }
+            else {
+                candidates.push_back({ b, a, costBToA });
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& x, const Collapse& y) {
+            return x.cost != y.cost ? x.cost < y.cost : (x.from != y.from ? x.from < y.from : x.to < y.to);
+        });
+
+        std::fill(locked.begin(), locked.end(), 0);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            collapseTo[v] = v;
+        }
+
+        // һֻ͵һ۵ԼﵽĿҪ۸ߵ۵
+        // һֲܽеĵʹ۵֮ǰһ޷۵ʱſ
+        double passLimit = errorLimit;
+        if (!relaxPass && !candidates.empty()) {
+            size_t needed = std::min<size_t>((triangleCount - targetTriangles + 1) / 2, candidates.size());
+            passLimit = std::min(errorLimit, candidates[std::max<size_t>(needed, 1) - 1].cost * 1.5);
+        }
+
+        uint32_t removed = 0;
+        uint32_t collapses = 0;
+        for (const Collapse& collapse : candidates) {
+            if (collapse.cost > passLimit) {
+                break;
+            }
+            if (locked[collapse.from] || locked[collapse.to]) {
+                continue;
+            }
+            if (collapseFlips(positions, result, offsets, adjacency, collapse.from, collapse.to)) {
+                continue;
+            }
+
+            // from ΧαѾı䣬Щ㱾ֲٲ۵
+            for (uint32_t j = offsets[collapse.from]; j < offsets[collapse.from + 1]; j++) {
+                const uint32_t* corners = &result[adjacency[j] * 3];
+                locked[corners[0]] = locked[corners[1]] = locked[corners[2]] = 1;
+                if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+                    removed++;
+                }
+            }
+
+            collapseTo[collapse.from] = collapse.to;
+            addQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+            collapses++;
+
+            if (removed >= triangleCount - targetTriangles) {
+                break;
+            }
+        }
+
+        if (collapses == 0) {
+            if (relaxPass || passLimit >= errorLimit) {
+                break;
+            }
+            relaxPass = true;
+            continue;
+        }
+        relaxPass = false;
+
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t a = collapseTo[result[i]];
+            uint32_t b = collapseTo[result[i + 1]];
+            uint32_t c = collapseTo[result[i + 2]];
+            if (a != b && b != c && a != c) {
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+        }
+        result.resize(write);
+    }
+
+    // ƽļȨƽֻƣʵʲľ
+    if (resultError != nullptr) {
+        *resultError = measureSimplifiedDistance(positions, indices, result);
+    }
+    return result;
+}
+
+std::vector<MeshLod> buildMeshLods(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    uint32_t maxLevels, float ratio, std::vector<uint32_t>& lodIndices) {
+    uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+    std::vector<MeshLod> lods;
+    lodIndices.clear();
+
+    std::vector<uint32_t> level = indices;
+    optimizeVertexCache(level, vertexCount);
+    lods.push_back({ 0, static_cast<uint32_t>(level.size()), 0.0f });
+    lodIndices.insert(lodIndices.end(), level.begin(), level.end());
+
+    // ÿԭ򻯣ֱԭ
+    float error = 0.0f;
+    size_t previous = indices.size();
+    for (uint32_t l = 1; l < maxLevels; l++) {
+        uint32_t target = static_cast<uint32_t>(previous / 3 * ratio) * 3;
+        float levelError = 0.0f;
+        level = simplifyMesh(positions, indices, target, FLT_MAX, &levelError);
+        if (level.empty() || level.size() > previous * 9 / 10) {
+            break;
+        }
+
+        optimizeVertexCache(level, vertexCount);
+        error = std::max(error, levelError);
+        lods.push_back({ static_cast<uint32_t>(lodIndices.size()), static_cast<uint32_t>(level.size()), error });
+        lodIndices.insert(lodIndices.end(), level.begin(), level.end());
+        previous = level.size();
+    }
+    return lods;
+}
+
+uint32_t selectMeshLod(const std::vector<MeshLod>& lods, float pixelsPerUnit, float pixelError) {
+    if (pixelError <= 0.0f) {
+        return 0;
+    }
+
+    uint32_t level = 0;
+    for (uint32_t l = 1; l < lods.size(); l++) {
+        if (lods[l].error * pixelsPerUnit > pixelError) {
+            break;
+        }
+        level = l;
+    }
+    return level;
+}
+
+float perspectivePixelsPerUnit(float distance, float fovY, float viewportHeight) {
+    return viewportHeight / (2.0f * std::max(distance, 1e-6f) * std::tan(fovY * 0.5f));
+}
+
+// ---- Meshlet ----
+
+static MeshletBounds computeMeshletBounds(const std::vector<Vec3>& positions, const MeshletData& data, const Meshlet& meshlet) {
+    MeshletBounds bounds;
+
+    Vec3 minimum = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vec3 maximum = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        const Vec3& p = positions[data.vertices[meshlet.vertexOffset + i]];
+        minimum = { std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+        maximum = { std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+    }
+    bounds.center = vec3Scale(vec3Add(minimum, maximum), 0.5f);
+    bounds.radius = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        bounds.radius = std::max(bounds.radius, vec3Length(vec3Sub(positions[data.vertices[meshlet.vertexOffset + i]], bounds.center)));
+    }
+
+    // ׶ΪηߵƽŽнķ߾
+    std::vector<Vec3> normals;
+    std::vector<Vec3> corners;
+    Vec3 axis = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+        const uint8_t* local = &data.triangles[meshlet.triangleOffset + t * 3];
+        const Vec3& a = positions[data.vertices[meshlet.vertexOffset + local[0]]];
+        const Vec3& b = positions[data.vertices[meshlet.vertexOffset + local[1]]];
+        const Vec3& c = positions[data.vertices[meshlet.vertexOffset + local[2]]];
+        Vec3 n = triangleNormal(a, b, c);
+        float length = vec3Length(n);
+        if (length <= 0.0f) {
+            continue;
+        }
+        n = vec3Scale(n, 1.0f / length);
+        normals.push_back(n);
+        corners.push_back(a);
+        axis = vec3Add(axis, n);
+    }
+
+    bounds.coneApex = bounds.center;
+    bounds.coneAxis = { 0.0f, 0.0f, 1.0f };
+    bounds.coneCutoff = 1.0f;
+    if (normals.empty() || vec3Length(axis) <= 1e-6f) {
+        return bounds;
+    }
+    axis = vec3Normalize(axis);
+
+    float minDot = 1.0f;
+    for (const Vec3& n : normals) {
+        minDot = std::min(minDot, vec3Dot(n, axis));
+    }
+    if (minDot <= 0.1f) {
+        return bounds;
+    }
+
+    // ׶˵ƽıһ࣬ʹ׶ڵĶǱ
+    float maxT = 0.0f;
+    for (size_t i = 0; i < normals.size(); i++) {
+        float t = vec3Dot(vec3Sub(bounds.center, corners[i]), normals[i]) / vec3Dot(axis, normals[i]);
+        maxT = std::max(maxT, t);
+    }
+    bounds.coneApex = vec3Sub(bounds.center, vec3Scale(axis, maxT));
+    bounds.coneAxis = axis;
+    bounds.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    return bounds;
+}
+
+void buildMeshlets(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    uint32_t maxVertices, uint32_t maxTriangles, MeshletData& out) {
+    out = MeshletData();
+    maxVertices = std::min(maxVertices, 256u);  // ֲ±Ϊ uint8_t
+
+    std::vector<int32_t> local(positions.size(), -1);
+    Meshlet current = { 0, 0, 0, 0 };
+
+    auto finish = [&]() {
+        if (current.triangleCount == 0) {
+            return;
+        }
+        for (uint32_t i = 0; i < current.vertexCount; i++) {
+            local[out.vertices[current.vertexOffset + i]] = -1;
+        }
+        out.meshlets.push_back(current);
+        out.bounds.push_back(computeMeshletBounds(positions, out, current));
+        while (out.triangles.size() % 4 != 0) {
+            out.triangles.push_back(0);
+        }
+        current = { static_cast<uint32_t>(out.vertices.size()), static_cast<uint32_t>(out.triangles.size()), 0, 0 };
+    };
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const uint32_t* corners = &indices[i];
+        uint32_t newVertices = 0;
+        for (uint32_t k = 0; k < 3; k++) {
+            bool repeated = (k > 0 && corners[k] == corners[0]) || (k > 1 && corners[k] == corners[1]);
+            if (local[corners[k]] < 0 && !repeated) {
+                newVertices++;
+            }
+        }
+        if (current.vertexCount + newVertices > maxVertices || current.triangleCount + 1 > maxTriangles) {
+            finish();
+        }
+
+        for (uint32_t k = 0; k < 3; k++) {
+            uint32_t v = corners[k];
+            if (local[v] < 0) {
+                local[v] = static_cast<int32_t>(current.vertexCount++);
+                out.vertices.push_back(v);
+            }
+            out.triangles.push_back(static_cast<uint8_t>(local[v]));
+        }
+        current.triangleCount++;
+    }
+    finish();
+}
+
+bool isMeshletBackfacing(const MeshletBounds& bounds, const Vec3& camera) {
+    if (bounds.coneCutoff >= 1.0f) {
+        return false;
+    }
+    Vec3 direction = vec3Sub(bounds.coneApex, camera);
+    float length = vec3Length(direction);
+    return length > 0.0f && vec3Dot(direction, bounds.coneAxis) >= bounds.coneCutoff * length;
+}
+
+void buildDiscMesh(float radius, uint32_t rings, uint32_t segments, std::vector<Vec3>& positions, std::vector<uint32_t>& indices) {
+    positions.clear();
+    indices.clear();
+
+    positions.push_back({ 0.0f, 0.0f, 0.0f });
+    for (uint32_t r = 1; r <= rings; r++) {
+        float ringRadius = radius * r / rings;
+        for (uint32_t s = 0; s < segments; s++) {
+            float angle = 6.2831853f * s / segments;
+            positions.push_back({ ringRadius * std::cos(angle), ringRadius * std::sin(angle), 0.0f });
+        }
+    }
+
+    //  r Ȧ 1 ʼ s 
+    auto ring = [&](uint32_t r, uint32_t s) {
+        return 1 + (r - 1) * segments + s % segments;
+    };
+    for (uint32_t s = 0; s < segments; s++) {
+        indices.insert(indices.end(), { 0u, ring(1, s), ring(1, s + 1) });
+    }
+    for (uint32_t r = 1; r < rings; r++) {
+        for (uint32_t s = 0; s < segments; s++) {
+            indices.insert(indices.end(), { ring(r, s), ring(r + 1, s), ring(r + 1, s + 1) });
+            indices.insert(indices.end(), { ring(r, s), ring(r + 1, s + 1), ring(r, s + 1) });
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "SimdMath.h"
+
+// б㻺Ͷȡ˳ŻQEM۵ LOD 
+// з meshlet Χͱ޳׶ԼʱͶӰСѡ LOD
+// ֻλã豸Դʱͼʱ
+
+// analyzeVertexCache ģ FIFO 任С
+const uint32_t VERTEX_CACHE_SIZE = 16;
+
+//  pack_assets.py  meshlet һ
+const uint32_t MESHLET_MAX_VERTICES = 64;
+const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// ΣʹڵξڻеĶ㣨Forsyth ʱ㷨
+// μϺÿε򲻱
+void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+// ƽÿҪ任ĶACMRԽСԽãԼΪ 0.5
+float analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = VERTEX_CACHE_SIZE);
+
+// ״α˳±ţûõĶ󣩲д indices
+// ؾ±굽±ӳ䡣 remapVertices ͬӳ
+std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+template <typename T>
+std::vector<T> remapVertices(const std::vector<T>& vertices, const std::vector<uint32_t>& remap) {
+    std::vector<T> result(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        result[remap[i]] = vertices[i];
+    }
+    return result;
+}
+
+// ۵򻯣ÿΰһϲڶϣ¶㣬㻺ڸ LOD 乲ã
+// Ϊϲ󶥵㵽ԭƽľ루Ȩľ߽磨ֻһεıߣϵĶ
+// ֻر߽۵ʹηת۵ܾ targetIndexCount / 3 »һ۵
+// ۳ targetError ʱֹͣresultError ʵʲԭ񶥵㵽루ֲռ䣩
+std::vector<uint32_t> simplifyMesh(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    uint32_t targetIndexCount, float targetError, float* resultError);
+
+struct MeshLod {
+    uint32_t firstIndex;    //  buildMeshLods еλ
+    uint32_t indexCount;
+    float error;            // ԭֲռľ룩 0 Ϊ 0
+};
+
+//  LOD  0 ԭ֮ÿԭ򻯵һ ratio
+// ֱ maxLevels ٲ 10%׷ӵ lodIndicesÿ˶㻺Ż
+std::vector<MeshLod> buildMeshLods(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    uint32_t maxLevels, float ratio, std::vector<uint32_t>& lodIndices);
+
+// pixelsPerUnitֲռһλͶӰĻϵţ
+// ͶӰ󲻳 pixelError صһpixelError Ϊ 0 ʱǷص 0 
+uint32_t selectMeshLod(const std::vector<MeshLod>& lods, float pixelsPerUnit, float pixelError);
+
+// ͸ͶӰ£ distance һλ
+float perspectivePixelsPerUnit(float distance, float fovY, float viewportHeight);
+
+//  PackMeshlet Ĳһ
+struct Meshlet {
+    uint32_t vertexOffset;  // MeshletData::vertices е±
+    uint32_t triangleOffset; // MeshletData::triangles еֽƫ
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+};
+
+// λ camera dot(normalize(coneApex - camera), coneAxis) >= coneCutoff ʱ meshlet 
+// ζǱ档߷ֲ̫ɢʱ coneCutoff Ϊ 1޳
+struct MeshletBounds {
+    Vec3 center;
+    float radius;
+    Vec3 coneApex;
+    Vec3 coneAxis;
+    float coneCutoff;
+};
+
+struct MeshletData {
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletBounds> bounds;
+    std::vector<uint32_t> vertices;     // Ķ±
+    std::vector<uint8_t> triangles;     // ÿ 3 ֲ±꣬ÿ meshlet  4 ֽڶ
+};
+
+// ˳㻺ŻЧãװ meshletʱʼµһ
+void buildMeshlets(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices,
+    uint32_t maxVertices, uint32_t maxTriangles, MeshletData& out);
+
+bool isMeshletBackfacing(const MeshletBounds& bounds, const Vec3& camera);
+
+// z = 0 ƽϡԭΪԲĵԲ̣泯 +zһ㣬rings ȦÿȦ segments 
+void buildDiscMesh(float radius, uint32_t rings, uint32_t segments, std::vector<Vec3>& positions, std::vector<uint32_t>& indices);
+
+// δһ淨ߣΪʱ
+Vec3 triangleNormal(const Vec3& a, const Vec3& b, const Vec3& c);
+
+// 㵽Σڲ
+float pointTriangleDistance(const Vec3& p, const Vec3& a, const Vec3& b, const Vec3& c);
@@ -0,0 +1,92 @@
+#include "Offscreen.h"
+#include "VulkanContext.h"
+
+#include <stdexcept>
+
+VkFormat chooseOffscreenFormat(VkFormat preferred) {
+    const VkFormat candidates[] = { preferred, VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_R8G8B8A8_UNORM };
+
+    for (VkFormat format : candidates) {
+        VkFormatProperties props;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+
+        const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_TRANSFER_SRC_BIT;
+        if ((props.optimalTilingFeatures & required) == required) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error("failed to find a supported offscreen color format!");
+}
+
+void createOffscreenTarget(OffscreenTarget& target, VkFormat format, VkExtent2D extent, VkRenderPass pass) {
+    target.format = format;
+    target.extent = extent;
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = format;
+    imageInfo.extent = { extent.width, extent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    // TRANSFER_SRC ֮Ⱦ
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &target.image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create offscreen image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, target.image, &memRequirements);
+
+    allocateMemory(gpuAllocator, memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal, target.allocation);
+    vkBindImageMemory(device, target.image, target.allocation.memory, target.allocation.offset);
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = target.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &target.view) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create offscreen image view!");
+    }
+
+    VkFramebufferCreateInfo framebufferInfo = {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = pass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &target.view;
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &target.framebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create offscreen framebuffer!");
+    }
+}
+
+void destroyOffscreenTarget(OffscreenTarget& target) {
+    if (target.framebuffer != VK_NULL_HANDLE) {
+        vkDestroyFramebuffer(device, target.framebuffer, nullptr);
+    }
+    if (target.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, target.view, nullptr);
+    }
+    if (target.image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, target.image, nullptr);
+    }
+    freeMemory(gpuAllocator, target.allocation);
+
+    target = OffscreenTarget();
+}
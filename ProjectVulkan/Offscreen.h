@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "MemoryAllocator.h"
+
+// ɫĿ꣨޴ģʽ´潻ͼ
+struct OffscreenTarget {
+    VkImage image = VK_NULL_HANDLE;
+    Allocation allocation;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {};
+};
+
+// ѡһ֧ɫĸʽʹ preferred
+VkFormat chooseOffscreenFormat(VkFormat preferred);
+
+void createOffscreenTarget(OffscreenTarget& target, VkFormat format, VkExtent2D extent, VkRenderPass pass);
+void destroyOffscreenTarget(OffscreenTarget& target);
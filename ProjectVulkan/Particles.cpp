@@ -0,0 +1,474 @@
+#include "Particles.h"
+#include "MemoryAllocator.h"
+#include "ShaderInterface.h"
+#include "ShaderReflection.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+static_assert(sizeof(GpuParticle) == 32, "GpuParticle must match particle_*.comp");
+static_assert(sizeof(ParticleParams) == 80, "ParticleParams must match particle_*.comp");
+
+// particle_*.comp  local_size_xҲͰĸ
+static const uint32_t PARTICLE_GROUP_SIZE = 256;
+static const uint32_t PARTICLE_DEPTH_BUCKETS = 256;
+
+//  particle_*.comp е Counters һ
+struct ParticleCounters {
+    uint32_t emitted;
+    uint32_t alive;
+    uint32_t padding[2];
+    uint32_t histogram[PARTICLE_DEPTH_BUCKETS];
+    uint32_t offsets[PARTICLE_DEPTH_BUCKETS];
+};
+
+// ͼ岻ͬʱжʣʹ CONCURRENT ʡȥȨת
+static void createParticleBuffer(ParticleSystem& system, GpuBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = system.sharingFamilies.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+    bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(system.sharingFamilies.size());
+    bufferInfo.pQueueFamilyIndices = system.sharingFamilies.data();
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer.buffer, &memRequirements);
+    allocateMemory(gpuAllocator, memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear, buffer.allocation);
+    vkBindBufferMemory(device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+    buffer.size = size;
+}
+
+static VkSemaphore createTimeline() {
+    VkSemaphoreTypeCreateInfoKHR typeInfo = {};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    VkSemaphore semaphore;
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle timeline semaphore!");
+    }
+    return semaphore;
+}
+
+static void createParticlePipelines(ParticleSystem& system, VkShaderModule simulateShader, VkShaderModule scanShader,
+    VkShaderModule compactShader) {
+    system.layout = createPipelineLayout(ShaderReflection::ParticleSimulate, system.setLayouts);
+    system.simulatePipeline = createComputePipeline(simulateShader, system.layout);
+    system.scanPipeline = createComputePipeline(scanShader, system.layout);
+    system.compactPipeline = createComputePipeline(compactShader, system.layout);
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 4 * PARTICLE_OUTPUT_COUNT;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = PARTICLE_OUTPUT_COUNT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &system.descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create particle descriptor pool!");
+    }
+
+    // ÿһӳغͼڸ֮乲
+    for (ParticleOutput& output : system.outputs) {
+        VkDescriptorSetAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = system.descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &system.setLayouts[0];
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, &output.descriptorSet) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate particle descriptor set!");
+        }
+
+        // ˳ particle_*.comp һ
+        VkDescriptorBufferInfo bufferInfos[4] = {
+            { system.particles.buffer, 0, VK_WHOLE_SIZE },
+            { system.counters.buffer, 0, VK_WHOLE_SIZE },
+            { output.buffer.buffer, PARTICLE_INSTANCE_OFFSET, VK_WHOLE_SIZE },
+            { output.buffer.buffer, 0, sizeof(VkDrawIndexedIndirectCommand) },
+        };
+        VkWriteDescriptorSet writes[4] = {};
+        for (uint32_t i = 0; i < 4; i++) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = output.descriptorSet;
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vkUpdateDescriptorSets(device, 4, writes, 0, nullptr);
+    }
+}
+
+void createParticleSystem(ParticleSystem& system, uint32_t particleCount, const MeshRange& mesh,
+    VkQueue computeQueue, uint32_t computeFamily, uint32_t graphicsFamily, bool sharedQueue, bool timelineSemaphores,
+    VkShaderModule simulateShader, VkShaderModule scanShader, VkShaderModule compactShader) {
+    if (particleCount == 0 || particleCount > MAX_PARTICLES) {
+        throw std::runtime_error("particle count out of range!");
+    }
+
+    system.particleCount = particleCount;
+    system.computeQueue = computeQueue;
+    system.computeFamily = computeFamily;
+    system.sharedQueue = sharedQueue;
+    if (computeFamily != graphicsFamily) {
+        system.sharingFamilies = { graphicsFamily, computeFamily };
+    }
+
+    // ƽ 1.5 룬ÿķԤȶӳ
+    ParticleParams& params = system.params;
+    params = {};
+    params.emitter[1] = -0.25f;
+    params.emitter[2] = 0.5f;
+    params.emitter[3] = 0.05f;
+    params.gravity[1] = 0.6f;
+    params.gravity[3] = 0.3f;
+    params.deltaTime = 1.0f / 60.0f;
+    params.lifetime = 1.5f;
+    params.speed = 0.5f;
+    params.size = 0.01f;
+    params.depthMin = 0.0f;
+    params.depthScale = static_cast<float>(PARTICLE_DEPTH_BUCKETS);
+    params.particleCount = particleCount;
+    params.emitBudget = std::max(particleCount / 60, 1u);
+    params.indexCount = mesh.indexCount;
+    params.firstIndex = mesh.firstIndex;
+    params.vertexOffset = mesh.vertexOffset;
+
+    createParticleBuffer(system, system.particles, static_cast<VkDeviceSize>(particleCount) * sizeof(GpuParticle),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    createParticleBuffer(system, system.counters, sizeof(ParticleCounters),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    for (ParticleOutput& output : system.outputs) {
+        createParticleBuffer(system, output.buffer,
+            PARTICLE_INSTANCE_OFFSET + static_cast<VkDeviceSize>(particleCount) * sizeof(InstanceData),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    }
+
+    createParticlePipelines(system, simulateShader, scanShader, compactShader);
+
+    if (timelineSemaphores) {
+        system.getSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+            vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+        system.waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+    }
+
+    // ûʱźʱеĽ޷ֵȴֻܴ
+    if (system.getSemaphoreCounterValue != nullptr && system.waitSemaphores != nullptr) {
+        system.computeTimeline = createTimeline();
+        system.graphicsTimeline = createTimeline();
+
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = computeFamily;
+
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &system.commandPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create particle command pool!");
+        }
+
+        VkCommandBuffer commandBuffers[PARTICLE_OUTPUT_COUNT];
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = system.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = PARTICLE_OUTPUT_COUNT;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate particle command buffers!");
+        }
+        for (uint32_t i = 0; i < PARTICLE_OUTPUT_COUNT; i++) {
+            system.outputs[i].computeCommands = commandBuffers[i];
+        }
+        system.mode = ParticleQueueMode::Async;
+    }
+
+    system.enabled = true;
+}
+
+void destroyParticleSystem(ParticleSystem& system) {
+    if (system.commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, system.commandPool, nullptr);
+    }
+    if (system.computeTimeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device, system.computeTimeline, nullptr);
+    }
+    if (system.graphicsTimeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device, system.graphicsTimeline, nullptr);
+    }
+    if (system.descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, system.descriptorPool, nullptr);
+    }
+    VkPipeline pipelines[] = { system.simulatePipeline, system.scanPipeline, system.compactPipeline };
+    for (VkPipeline pipeline : pipelines) {
+        if (pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, pipeline, nullptr);
+        }
+    }
+    if (system.layout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, system.layout, nullptr);
+    }
+    for (VkDescriptorSetLayout setLayout : system.setLayouts) {
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    }
+
+    for (ParticleOutput& output : system.outputs) {
+        destroyBuffer(output.buffer);
+    }
+    destroyBuffer(system.counters);
+    destroyBuffer(system.particles);
+
+    system = ParticleSystem();
+}
+
+static void waitTimeline(ParticleSystem& system, VkSemaphore semaphore, uint64_t value) {
+    VkSemaphoreWaitInfoKHR waitInfo = {};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+    if (system.waitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error("failed to wait for particle timeline!");
+    }
+}
+
+ParticleQueueMode setParticleQueueMode(ParticleSystem& system, ParticleQueueMode mode) {
+    if (mode == ParticleQueueMode::Async && system.computeTimeline == VK_NULL_HANDLE) {
+        mode = ParticleQueueMode::Serialized;
+    }
+    waitForParticles(system);
+    system.mode = mode;
+    return mode;
+}
+
+static void memoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+    VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+// ¼һģ⣬д outputIndex һ
+static void recordSimulationStep(ParticleSystem& system, VkCommandBuffer commandBuffer, uint32_t outputIndex) {
+    // ͬһϵһд֮㣻е˳ʱź֤
+    memoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    if (!system.stateCleared) {
+        vkCmdFillBuffer(commandBuffer, system.particles.buffer, 0, VK_WHOLE_SIZE, 0);
+        system.stateCleared = true;
+    }
+    vkCmdFillBuffer(commandBuffer, system.counters.buffer, 0, VK_WHOLE_SIZE, 0);
+    memoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    system.params.time = static_cast<float>(system.step) * system.params.deltaTime;
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, system.layout, 0, 1,
+        &system.outputs[outputIndex].descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, system.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ParticleParams), &system.params);
+
+    uint32_t groupCount = (system.particleCount + PARTICLE_GROUP_SIZE - 1) / PARTICLE_GROUP_SIZE;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, system.simulatePipeline);
+    vkCmdDispatch(commandBuffer, groupCount, 1, 1);
+
+    memoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, system.scanPipeline);
+    vkCmdDispatch(commandBuffer, 1, 1, 1);
+
+    memoryBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, system.compactPipeline);
+    vkCmdDispatch(commandBuffer, groupCount, 1, 1);
+}
+
+// ѵ step ύСȴһɣͼζϴִеģ
+// Լһζȡͼ֡ step - N + 1 ֡ύɺͼʱΪ step - N + 2
+static void submitAsyncStep(ParticleSystem& system) {
+    uint64_t step = system.step;
+    uint32_t outputIndex = static_cast<uint32_t>(step % PARTICLE_OUTPUT_COUNT);
+    ParticleOutput& output = system.outputs[outputIndex];
+
+    // һڵ step - N ʹãͨɣֻ GPU ʱ
+    if (step >= PARTICLE_OUTPUT_COUNT) {
+        uint64_t value = step - PARTICLE_OUTPUT_COUNT + 1;
+        uint64_t completed = 0;
+        system.getSemaphoreCounterValue(device, system.computeTimeline, &completed);
+        if (completed < value) {
+            auto start = std::chrono::high_resolution_clock::now();
+            waitTimeline(system, system.computeTimeline, value);
+            system.stats.computeWaits++;
+            system.stats.computeWaitMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(output.computeCommands, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to begin recording particle command buffer!");
+    }
+    recordSimulationStep(system, output.computeCommands, outputIndex);
+    if (vkEndCommandBuffer(output.computeCommands) != VK_SUCCESS) {
+        throw std::runtime_error("failed to record particle command buffer!");
+    }
+
+    VkSemaphore waitSemaphores[2];
+    uint64_t waitValues[2];
+    VkPipelineStageFlags waitStages[2];
+    uint32_t waitCount = 0;
+    if (step > 0) {
+        waitSemaphores[waitCount] = system.computeTimeline;
+        waitValues[waitCount] = step;
+        waitStages[waitCount] = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        waitCount++;
+    }
+    if (step + 2 > PARTICLE_OUTPUT_COUNT) {
+        waitSemaphores[waitCount] = system.graphicsTimeline;
+        waitValues[waitCount] = step + 2 - PARTICLE_OUTPUT_COUNT;
+        waitStages[waitCount] = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        waitCount++;
+    }
+    uint64_t signalValue = step + 1;
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.waitSemaphoreValueCount = waitCount;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitSemaphores;
+    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &output.computeCommands;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &system.computeTimeline;
+
+    if (vkQueueSubmit(system.computeQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit particle simulation!");
+    }
+    system.stats.asyncSteps++;
+}
+
+void beginParticleStep(ParticleSystem& system) {
+    if (!system.enabled) {
+        return;
+    }
+
+    system.stepStarted = true;
+    if (system.mode == ParticleQueueMode::Async) {
+        submitAsyncStep(system);
+        system.drawReady = system.step > 0;
+        system.drawOutput = static_cast<uint32_t>((system.step + PARTICLE_OUTPUT_COUNT - 1) % PARTICLE_OUTPUT_COUNT);
+    }
+    else {
+        system.drawReady = true;
+        system.drawOutput = static_cast<uint32_t>(system.step % PARTICLE_OUTPUT_COUNT);
+    }
+}
+
+bool needsParticleSimulationPass(const ParticleSystem& system) {
+    return system.enabled && system.mode == ParticleQueueMode::Serialized;
+}
+
+void recordParticleSimulation(ParticleSystem& system, VkCommandBuffer commandBuffer) {
+    if (!system.stepStarted || system.mode != ParticleQueueMode::Serialized) {
+        return;
+    }
+    recordSimulationStep(system, commandBuffer, system.drawOutput);
+    system.stats.serializedSteps++;
+}
+
+uint32_t getParticleWaits(const ParticleSystem& system, VkSemaphore* semaphores, uint64_t* values, VkPipelineStageFlags* stages) {
+    if (!system.stepStarted || system.computeTimeline == VK_NULL_HANDLE || system.step == 0) {
+        return 0;
+    }
+
+    // 첽һĽУһһ״̬ģ⣬һڼ
+    semaphores[0] = system.computeTimeline;
+    values[0] = system.step;
+    stages[0] = system.mode == ParticleQueueMode::Async
+        ? VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+        : VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    return 1;
+}
+
+uint32_t getParticleSignals(const ParticleSystem& system, VkSemaphore* semaphores, uint64_t* values) {
+    if (!system.stepStarted || system.graphicsTimeline == VK_NULL_HANDLE) {
+        return 0;
+    }
+
+    // ģʽһͼζɣͬƽʱߣ֮л첽ʱֱӵȴ
+    semaphores[0] = system.graphicsTimeline;
+    values[0] = system.step + 1;
+    if (system.mode == ParticleQueueMode::Async) {
+        return 1;
+    }
+    semaphores[1] = system.computeTimeline;
+    values[1] = system.step + 1;
+    return 2;
+}
+
+void endParticleStep(ParticleSystem& system) {
+    if (!system.stepStarted) {
+        return;
+    }
+    system.stepStarted = false;
+    system.step++;
+}
+
+bool recordParticleDraw(ParticleSystem& system, VkCommandBuffer commandBuffer) {
+    if (!system.enabled || !system.drawReady) {
+        return false;
+    }
+
+    const GpuBuffer& buffer = system.outputs[system.drawOutput].buffer;
+    VkDeviceSize offset = PARTICLE_INSTANCE_OFFSET;
+    vkCmdBindVertexBuffers(commandBuffer, 1, 1, &buffer.buffer, &offset);
+    vkCmdDrawIndexedIndirect(commandBuffer, buffer.buffer, 0, 1, sizeof(VkDrawIndexedIndirectCommand));
+    return true;
+}
+
+void waitForParticles(ParticleSystem& system) {
+    if (system.computeTimeline != VK_NULL_HANDLE && system.step > 0) {
+        waitTimeline(system, system.computeTimeline, system.step);
+    }
+}
+
+void printParticleStats(const ParticleSystem& system) {
+    const ParticleStats& stats = system.stats;
+    std::cout << "Particles: " << system.particleCount << " particles, " << stats.asyncSteps << " async and "
+        << stats.serializedSteps << " serialized step(s), " << stats.computeWaits << " compute wait(s) ("
+        << stats.computeWaitMs << " ms)" << std::endl;
+}
+
+const char* particleQueueModeName(ParticleQueueMode mode) {
+    return mode == ParticleQueueMode::Async ? "overlapped" : "serialized";
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "FrameRing.h"
+#include "IndirectDraw.h"
+#include "Upload.h"
+
+// GPU ӣ̶Сӳأÿڼɫз䡢֡ȷͰ򲢰Ѵӽյд
+// ʵ壬ӻƵʵҲɼɫд룬CPU κν
+// жļкʱźʱģύУͼζصִУ s ֡Ƶ s - 1 Ľ
+// ͬʱе s 򣨻ָʱģ¼ͼУͬһĽ
+
+// ʵ + ķͼζһͼζ MAX_FRAMES_IN_FLIGHT ֡;
+const uint32_t PARTICLE_OUTPUT_COUNT = MAX_FRAMES_IN_FLIGHT + 1;
+
+// ʵݵƫƣminStorageBufferOffsetAlignment ޣ
+const VkDeviceSize PARTICLE_INSTANCE_OFFSET = 256;
+
+// һɷ 65535  256 ̵߳Ĺ
+const uint32_t MAX_PARTICLES = 16 * 1024 * 1024;
+
+//  particle_*.comp е Particle һ
+struct GpuParticle {
+    float positionAge[4];   // xyz λãw Ѵʱ
+    float velocityLife[4];  // xyz ٶȣw 0 ʾ
+};
+
+//  particle_*.comp е ParticleParams һ
+struct ParticleParams {
+    float emitter[4];       // xyz 㣬w 뾶
+    float gravity[4];       // xyz ٶȣw ÿٶ
+    float deltaTime;
+    float time;
+    float lifetime;
+    float speed;
+    float size;
+    float depthMin;
+    float depthScale;
+    uint32_t particleCount;
+    uint32_t emitBudget;
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+};
+
+enum class ParticleQueueMode {
+    Serialized,     // ¼ͼУȾִ
+    Async,          // ύУʱźͼζͬ
+};
+
+struct ParticleOutput {
+    GpuBuffer buffer;                       // ڿͷʵݴ PARTICLE_INSTANCE_OFFSET ʼ
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkCommandBuffer computeCommands = VK_NULL_HANDLE;   // 첽ģʽһļ
+};
+
+struct ParticleStats {
+    uint64_t serializedSteps = 0;
+    uint64_t asyncSteps = 0;
+    uint64_t computeWaits = 0;  // üǰҪȴĴ
+    double computeWaitMs = 0.0;
+};
+
+struct ParticleSystem {
+    bool enabled = false;
+    uint32_t particleCount = 0;
+    ParticleParams params = {};
+    ParticleQueueMode mode = ParticleQueueMode::Serialized;
+
+    VkQueue computeQueue = VK_NULL_HANDLE;
+    uint32_t computeFamily = 0;
+    bool sharedQueue = false;               // оͼζУ첽ύҲص
+    std::vector<uint32_t> sharingFamilies;  // ͼ岻ͬʱ乲
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+
+    // ʱߣ s ɺΪ s + 1ͼʱߣƵ s ֡ύɺΪ s + 1֧ʱΪ
+    VkSemaphore computeTimeline = VK_NULL_HANDLE;
+    VkSemaphore graphicsTimeline = VK_NULL_HANDLE;
+    PFN_vkGetSemaphoreCounterValueKHR getSemaphoreCounterValue = nullptr;
+    PFN_vkWaitSemaphoresKHR waitSemaphores = nullptr;
+
+    uint64_t step = 0;                      // ǰbeginParticleStep ֮endParticleStep ֮ǰ
+    bool stepStarted = false;
+    bool stateCleared = false;              // ӳڵһ֮ǰ㣨ȫУ
+    bool drawReady = false;                 // ֡пɻƵ
+    uint32_t drawOutput = 0;
+
+    GpuBuffer particles;                    // GpuParticle[particleCount]
+    GpuBuffer counters;                     // ֱͼ͸Ͱʼλ
+    ParticleOutput outputs[PARTICLE_OUTPUT_COUNT];
+
+    std::vector<VkDescriptorSetLayout> setLayouts;
+    VkPipelineLayout layout = VK_NULL_HANDLE;   // ɫԴͳͬһ
+    VkPipeline simulatePipeline = VK_NULL_HANDLE;
+    VkPipeline scanPipeline = VK_NULL_HANDLE;
+    VkPipeline compactPipeline = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+
+    ParticleStats stats;
+};
+
+// mesh Ϊÿõʵ߹ö壩computeQueue ͼζͬʱ
+// Ȼ֧첽ģʽύ˳򣬵ûصtimelineSemaphores Ϊ false ʱֻܴ
+void createParticleSystem(ParticleSystem& system, uint32_t particleCount, const MeshRange& mesh,
+    VkQueue computeQueue, uint32_t computeFamily, uint32_t graphicsFamily, bool sharedQueue, bool timelineSemaphores,
+    VkShaderModule simulateShader, VkShaderModule scanShader, VkShaderModule compactShader);
+
+// ǰ豸ѿ
+void destroyParticleSystem(ParticleSystem& system);
+
+// лģʽ֧첽ʱִУʵʵģʽǰ֡ɣwaitForAllFrames
+ParticleQueueMode setParticleQueueMode(ParticleSystem& system, ParticleQueueMode mode);
+
+// ÿ֡ȡĿͼ֮¼֮ǰã첽ģʽ¼Ʋύһģ⣨֡һĽ
+// ģʽֻѡģ recordParticleSimulation ¼
+void beginParticleStep(ParticleSystem& system);
+
+// ģʽǷҪͼ¼ģ⣨֡ͼ "Simulate particles" ͨ
+bool needsParticleSimulationPass(const ParticleSystem& system);
+
+// ͼ¼һģ⡣֮󵽼ӻƺͶɵ߲
+void recordParticleSimulation(ParticleSystem& system, VkCommandBuffer commandBuffer);
+
+// ͼύҪ׷ӵʱߵȴʹд鲢ظ 1 ȴ2 
+uint32_t getParticleWaits(const ParticleSystem& system, VkSemaphore* semaphores, uint64_t* values, VkPipelineStageFlags* stages);
+uint32_t getParticleSignals(const ParticleSystem& system, VkSemaphore* semaphores, uint64_t* values);
+
+// ͼύ֮
+void endParticleStep(ParticleSystem& system);
+
+// Ⱦͨ¼ӻƣѾʵߡ㻺壨 0ͻƳ
+// ʵ壨 1ύһμӻơûпɻƵʱ false
+bool recordParticleDraw(ParticleSystem& system, VkCommandBuffer commandBuffer);
+
+// ȴύеģȫ
+void waitForParticles(ParticleSystem& system);
+
+void printParticleStats(const ParticleSystem& system);
+
+const char* particleQueueModeName(ParticleQueueMode mode);
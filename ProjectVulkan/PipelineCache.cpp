@@ -0,0 +1,171 @@
+#include "PipelineCache.h"
+#include "VulkanContext.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+static uint64_t hashBytes(const uint8_t* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// ļͷǷڵǰ豸ʧʱԭ
+static const char* validateCacheFile(const std::vector<uint8_t>& file, const VkPhysicalDeviceProperties& props) {
+    if (file.size() < sizeof(PipelineCacheFileHeader)) {
+        return "file too small";
+    }
+
+    PipelineCacheFileHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != PIPELINE_CACHE_MAGIC || header.version != PIPELINE_CACHE_FILE_VERSION) {
+        return "unknown file format";
+    }
+    if (header.vendorID != props.vendorID || header.deviceID != props.deviceID) {
+        return "different device";
+    }
+    if (header.driverVersion != props.driverVersion) {
+        return "different driver version";
+    }
+    if (memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return "different pipeline cache UUID";
+    }
+    if (header.dataSize != file.size() - sizeof(header)) {
+        return "truncated";
+    }
+
+    const uint8_t* data = file.data() + sizeof(header);
+    if (hashBytes(data, static_cast<size_t>(header.dataSize)) != header.dataHash) {
+        return "checksum mismatch";
+    }
+
+    // ԴͷVkPipelineCacheHeaderVersionOneҲҪһ£һԼ
+    VkPipelineCacheHeaderVersionOne driverHeader;
+    if (header.dataSize < sizeof(driverHeader)) {
+        return "driver header missing";
+    }
+    memcpy(&driverHeader, data, sizeof(driverHeader));
+
+    if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        driverHeader.vendorID != props.vendorID || driverHeader.deviceID != props.deviceID ||
+        memcmp(driverHeader.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        return "driver header mismatch";
+    }
+
+    return nullptr;
+}
+
+VkPipelineCache loadPipelineCache(const std::string& path, size_t& loadedBytes) {
+    loadedBytes = 0;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+    std::vector<uint8_t> file;
+    if (!path.empty()) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (in) {
+            file.resize(static_cast<size_t>(in.tellg()));
+            in.seekg(0);
+            in.read(reinterpret_cast<char*>(file.data()), file.size());
+            if (!in) {
+                file.clear();
+            }
+        }
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo = {};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+    if (!file.empty()) {
+        const char* reason = validateCacheFile(file, props);
+        if (reason == nullptr) {
+            cacheInfo.initialDataSize = file.size() - sizeof(PipelineCacheFileHeader);
+            cacheInfo.pInitialData = file.data() + sizeof(PipelineCacheFileHeader);
+        }
+        else {
+            std::cerr << "Discarding pipeline cache " << path << ": " << reason << std::endl;
+        }
+    }
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    VkResult result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache);
+    if (result != VK_SUCCESS && cacheInfo.initialDataSize != 0) {
+        // ܾݣ˻صջ
+        std::cerr << "Driver rejected pipeline cache " << path << std::endl;
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(device, &cacheInfo, nullptr, &cache);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+
+    loadedBytes = cacheInfo.initialDataSize;
+    return cache;
+}
+
+bool savePipelineCache(VkPipelineCache cache, const std::string& path) {
+    if (cache == VK_NULL_HANDLE || path.empty()) {
+        return false;
+    }
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(device, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> file(sizeof(PipelineCacheFileHeader) + dataSize);
+    uint8_t* data = file.data() + sizeof(PipelineCacheFileHeader);
+    if (vkGetPipelineCacheData(device, cache, &dataSize, data) != VK_SUCCESS) {
+        return false;
+    }
+    file.resize(sizeof(PipelineCacheFileHeader) + dataSize);
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+    PipelineCacheFileHeader header = {};
+    header.magic = PIPELINE_CACHE_MAGIC;
+    header.version = PIPELINE_CACHE_FILE_VERSION;
+    header.vendorID = props.vendorID;
+    header.deviceID = props.deviceID;
+    header.driverVersion = props.driverVersion;
+    memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = dataSize;
+    header.dataHash = hashBytes(data, dataSize);
+    memcpy(file.data(), &header, sizeof(header));
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), file.size());
+        out.close();
+        if (!out) {
+            std::cerr << "Failed to write pipeline cache " << tempPath << std::endl;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    // std::filesystem::rename 滻ѴڵĿļWindows ͬã
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::cerr << "Failed to replace pipeline cache " << path << ": " << ec.message() << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
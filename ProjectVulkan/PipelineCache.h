@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+
+// ̻ļͷλص֮ǰ
+// Դͷֻ vendorID / deviceID / pipelineCacheUUID¼汾У
+struct PipelineCacheFileHeader {
+    uint32_t magic;             // PIPELINE_CACHE_MAGIC
+    uint32_t version;           // PIPELINE_CACHE_FILE_VERSION
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;          // ֮ݵֽ
+    uint64_t dataHash;          // ݵ FNV-1a ϣ
+};
+
+const uint32_t PIPELINE_CACHE_MAGIC = 0x43505056; // "VPPC"
+const uint32_t PIPELINE_CACHE_FILE_VERSION = 1;
+
+// Ӵ̼ع߻棻ļڡ豸/ʱջ档
+// loadedBytes ʵʹõݴС0 ʾ
+VkPipelineCache loadPipelineCache(const std::string& path, size_t& loadedBytes);
+
+// ѻдʱļ֤;˳ʱ°ļ
+bool savePipelineCache(VkPipelineCache cache, const std::string& path);
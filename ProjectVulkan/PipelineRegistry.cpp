@@ -0,0 +1,274 @@
+#include "PipelineRegistry.h"
+#include "JobSystem.h"
+#include "VulkanContext.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+template <typename T>
+static void appendKey(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// лֽڴͬ״̬õͬļȥ
+static std::string makePipelineKey(const GraphicsPipelineDesc& desc) {
+    std::string key;
+    key.reserve(256);
+
+    appendKey(key, desc.vertexShader);
+    appendKey(key, desc.fragmentShader);
+
+    appendKey(key, static_cast<uint32_t>(desc.bindings.size()));
+    for (const VkVertexInputBindingDescription& binding : desc.bindings) {
+        appendKey(key, binding.binding);
+        appendKey(key, binding.stride);
+        appendKey(key, binding.inputRate);
+    }
+    appendKey(key, static_cast<uint32_t>(desc.attributes.size()));
+    for (const VkVertexInputAttributeDescription& attribute : desc.attributes) {
+        appendKey(key, attribute.location);
+        appendKey(key, attribute.binding);
+        appendKey(key, attribute.format);
+        appendKey(key, attribute.offset);
+    }
+    appendKey(key, desc.topology);
+
+    appendKey(key, desc.polygonMode);
+    appendKey(key, desc.cullMode);
+    appendKey(key, desc.frontFace);
+    appendKey(key, desc.samples);
+
+    appendKey(key, desc.depthTest);
+    appendKey(key, desc.depthWrite);
+    appendKey(key, desc.depthCompareOp);
+
+    appendKey(key, desc.blendEnable);
+    if (desc.blendEnable) {
+        appendKey(key, desc.srcColorBlendFactor);
+        appendKey(key, desc.dstColorBlendFactor);
+        appendKey(key, desc.colorBlendOp);
+        appendKey(key, desc.srcAlphaBlendFactor);
+        appendKey(key, desc.dstAlphaBlendFactor);
+        appendKey(key, desc.alphaBlendOp);
+    }
+    appendKey(key, desc.colorWriteMask);
+
+    appendKey(key, desc.layout);
+    appendKey(key, desc.renderPass);
+    appendKey(key, desc.subpass);
+    return key;
+}
+
+static uint64_t hashKey(const std::string& key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// ڹִ߳СpipelineCache ڲͬԱ߳ͬʱʹ
+static VkResult compileGraphicsPipeline(const GraphicsPipelineDesc& desc, VkPipeline& pipeline) {
+    VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = desc.vertexShader;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = desc.fragmentShader;
+    shaderStages[1].pName = "main";
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(desc.bindings.size());
+    vertexInputInfo.pVertexBindingDescriptions = desc.bindings.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.attributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = desc.attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = desc.topology;
+
+    // ӿںͲü¼ʱãڴС仯Ҫؽ
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = desc.polygonMode;
+    rasterizer.cullMode = desc.cullMode;
+    rasterizer.frontFace = desc.frontFace;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = desc.samples;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = desc.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = desc.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = desc.depthCompareOp;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+    colorBlendAttachment.blendEnable = desc.blendEnable ? VK_TRUE : VK_FALSE;
+    colorBlendAttachment.srcColorBlendFactor = desc.srcColorBlendFactor;
+    colorBlendAttachment.dstColorBlendFactor = desc.dstColorBlendFactor;
+    colorBlendAttachment.colorBlendOp = desc.colorBlendOp;
+    colorBlendAttachment.srcAlphaBlendFactor = desc.srcAlphaBlendFactor;
+    colorBlendAttachment.dstAlphaBlendFactor = desc.dstAlphaBlendFactor;
+    colorBlendAttachment.alphaBlendOp = desc.alphaBlendOp;
+    colorBlendAttachment.colorWriteMask = desc.colorWriteMask;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending = {};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = desc.layout;
+    pipelineInfo.renderPass = desc.renderPass;
+    pipelineInfo.subpass = desc.subpass;
+
+    return vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+}
+
+void createPipelineRegistry(PipelineRegistry& registry, JobSystem& jobs) {
+    registry.jobs = &jobs;
+}
+
+void destroyPipelineRegistry(PipelineRegistry& registry) {
+    waitForPipelines(registry);
+
+    for (PipelineEntry& entry : registry.entries) {
+        VkPipeline pipeline = entry.pipeline.load();
+        if (pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, pipeline, nullptr);
+        }
+    }
+    registry.entries.clear();
+    registry.lookup.clear();
+    registry.stats = PipelineRegistryStats();
+    registry.jobs = nullptr;
+}
+
+PipelineHandle requestGraphicsPipeline(PipelineRegistry& registry, const GraphicsPipelineDesc& desc) {
+    std::string key = makePipelineKey(desc);
+
+    std::unique_lock<std::mutex> lock(registry.mutex);
+    registry.stats.requests++;
+
+    auto found = registry.lookup.find(key);
+    if (found != registry.lookup.end()) {
+        registry.stats.hits++;
+        return found->second;
+    }
+
+    PipelineHandle handle = static_cast<PipelineHandle>(registry.entries.size());
+    registry.entries.emplace_back();
+    PipelineEntry* entry = &registry.entries.back();
+    entry->desc = desc;
+    entry->hash = hashKey(key);
+    registry.lookup.emplace(std::move(key), handle);
+
+    registry.pendingJobs++;
+
+    // ûй߳ʱִͬУٴμ
+    lock.unlock();
+    submitJob(*registry.jobs, [&registry, entry](uint32_t) {
+        auto start = std::chrono::high_resolution_clock::now();
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkResult result = compileGraphicsPipeline(entry->desc, pipeline);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        entry->compileMs = std::chrono::duration<double, std::milli>(end - start).count();
+        if (result == VK_SUCCESS) {
+            entry->pipeline.store(pipeline);
+            entry->state.store(PipelineState::Ready);
+        }
+        else {
+            std::cerr << "Failed to create graphics pipeline " << std::hex << entry->hash << std::dec
+                << " (VkResult " << result << ")" << std::endl;
+            entry->state.store(PipelineState::Failed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.stats.compileMs += entry->compileMs;
+            if (result == VK_SUCCESS) {
+                registry.stats.compiled++;
+            }
+            else {
+                registry.stats.failed++;
+            }
+            registry.pendingJobs--;
+        }
+        registry.jobFinished.notify_all();
+    });
+
+    return handle;
+}
+
+static PipelineEntry* findEntry(PipelineRegistry& registry, PipelineHandle handle) {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return handle < registry.entries.size() ? &registry.entries[handle] : nullptr;
+}
+
+VkPipeline getPipeline(PipelineRegistry& registry, PipelineHandle handle, PipelineHandle fallback) {
+    PipelineEntry* entry = findEntry(registry, handle);
+    if (entry != nullptr && entry->state.load() == PipelineState::Ready) {
+        return entry->pipeline.load();
+    }
+
+    // δʹߣͬһɫļ򻯰汾
+    PipelineEntry* fallbackEntry = findEntry(registry, fallback);
+    if (fallbackEntry != nullptr && fallbackEntry->state.load() == PipelineState::Ready) {
+        return fallbackEntry->pipeline.load();
+    }
+
+    return VK_NULL_HANDLE;
+}
+
+PipelineState getPipelineState(PipelineRegistry& registry, PipelineHandle handle) {
+    PipelineEntry* entry = findEntry(registry, handle);
+    return entry != nullptr ? entry->state.load() : PipelineState::Failed;
+}
+
+void waitForPipelines(PipelineRegistry& registry) {
+    std::unique_lock<std::mutex> lock(registry.mutex);
+    registry.jobFinished.wait(lock, [&registry] { return registry.pendingJobs == 0; });
+}
+
+void printPipelineRegistryStats(PipelineRegistry& registry) {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Pipelines   : " << registry.stats.requests << " requested, "
+        << registry.stats.hits << " deduplicated, "
+        << registry.stats.compiled << " compiled, "
+        << registry.stats.failed << " failed on " << (registry.jobs != nullptr ? getJobThreadCount(*registry.jobs) - 1 : 0) << " worker thread(s), "
+        << registry.stats.compileMs << " ms compile time" << std::endl;
+    std::cout << std::defaultfloat;
+}
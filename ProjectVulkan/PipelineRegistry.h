@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ͼιߵ״̬ӿںͲüǶ̬״̬ϣ
+struct GraphicsPipelineDesc {
+    VkShaderModule vertexShader = VK_NULL_HANDLE;
+    VkShaderModule fragmentShader = VK_NULL_HANDLE;
+
+    std::vector<VkVertexInputBindingDescription> bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+
+    bool depthTest = false;
+    bool depthWrite = false;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+    bool blendEnable = false;
+    VkBlendFactor srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    VkBlendFactor dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    VkBlendOp colorBlendOp = VK_BLEND_OP_ADD;
+    VkBlendFactor srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    VkBlendFactor dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    VkBlendOp alphaBlendOp = VK_BLEND_OP_ADD;
+    VkColorComponentFlags colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+};
+
+typedef uint32_t PipelineHandle;
+const PipelineHandle INVALID_PIPELINE = UINT32_MAX;
+
+enum class PipelineState {
+    Pending,
+    Ready,
+    Failed,
+};
+
+struct JobSystem;
+
+struct PipelineEntry {
+    GraphicsPipelineDesc desc;
+    uint64_t hash = 0;
+    std::atomic<VkPipeline> pipeline{ VK_NULL_HANDLE };
+    std::atomic<PipelineState> state{ PipelineState::Pending };
+    double compileMs = 0.0;
+};
+
+struct PipelineRegistryStats {
+    uint64_t requests = 0;
+    uint64_t hits = 0;              // ѴڵĿڱеģ
+    uint64_t compiled = 0;
+    uint64_t failed = 0;
+    double compileMs = 0.0;         // бʱ̲֮ͣ߳ʱǽʱ䣩
+};
+
+// ע״̬ϣȥأδʱΪ̨ JobSystem Ĺ߳ϱ
+struct PipelineRegistry {
+    std::deque<PipelineEntry> entries;                      // deque ֤Ŀַ
+    std::unordered_map<std::string, PipelineHandle> lookup; // Ϊ״̬лֽ
+    std::mutex mutex;
+
+    JobSystem* jobs = nullptr;
+    std::condition_variable jobFinished;
+    uint32_t pendingJobs = 0;
+
+    PipelineRegistryStats stats;
+};
+
+// ύ jobs¼ƹõ̳߳أjobs ע
+void createPipelineRegistry(PipelineRegistry& registry, JobSystem& jobs);
+
+// ȴбɺȫ
+void destroyPipelineRegistry(PipelineRegistry& registry);
+
+// Ӧľdesc еɫģ뱣Чֱ߱
+PipelineHandle requestGraphicsPipeline(PipelineRegistry& registry, const GraphicsPipelineDesc& desc);
+
+// Ѿʱعߣ򷵻 fallback Ĺߣ߶ʱ VK_NULL_HANDLEӦû
+VkPipeline getPipeline(PipelineRegistry& registry, PipelineHandle handle, PipelineHandle fallback = INVALID_PIPELINE);
+PipelineState getPipelineState(PipelineRegistry& registry, PipelineHandle handle);
+
+// ֱĹ߱
+void waitForPipelines(PipelineRegistry& registry);
+
+void printPipelineRegistryStats(PipelineRegistry& registry);
@@ -0,0 +1,450 @@
+#include "Presenter.h"
+#include "FrameStats.h"
+#include "ResourceRegistry.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+static const struct {
+    const char* name;
+    VkPresentModeKHR mode;
+} presentModeNames[] = {
+    { "fifo", VK_PRESENT_MODE_FIFO_KHR },
+    { "mailbox", VK_PRESENT_MODE_MAILBOX_KHR },
+    { "immediate", VK_PRESENT_MODE_IMMEDIATE_KHR },
+    { "fifo-relaxed", VK_PRESENT_MODE_FIFO_RELAXED_KHR },
+};
+
+bool parsePresentMode(const std::string& name, VkPresentModeKHR& mode) {
+    for (const auto& entry : presentModeNames) {
+        if (name == entry.name) {
+            mode = entry.mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* presentModeName(VkPresentModeKHR mode) {
+    for (const auto& entry : presentModeNames) {
+        if (entry.mode == mode) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& available, VkPresentModeKHR requested) {
+    if (std::find(available.begin(), available.end(), requested) != available.end()) {
+        return requested;
+    }
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+uint32_t chooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities, VkPresentModeKHR mode, uint32_t requested) {
+    uint32_t count = requested;
+    if (count == 0) {
+        count = mode == VK_PRESENT_MODE_MAILBOX_KHR ? 3 : capabilities.minImageCount + 1;
+    }
+
+    // maxImageCount Ϊ 0 ʾû
+    count = std::max(count, capabilities.minImageCount);
+    if (capabilities.maxImageCount > 0) {
+        count = std::min(count, capabilities.maxImageCount);
+    }
+    return count;
+}
+
+VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, VkExtent2D framebufferSize) {
+    if (capabilities.currentExtent.width != UINT32_MAX) {
+        return capabilities.currentExtent;
+    }
+
+    VkExtent2D extent;
+    extent.width = std::clamp(framebufferSize.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+    extent.height = std::clamp(framebufferSize.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+    return extent;
+}
+
+VkSurfaceFormatKHR chooseSurfaceFormat(VkPhysicalDevice physDev, VkSurfaceKHR surface) {
+    uint32_t formatCount = 0;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physDev, surface, &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physDev, surface, &formatCount, formats.data());
+
+    if (formats.empty()) {
+        throw std::runtime_error("failed to find a surface format!");
+    }
+
+    for (const VkSurfaceFormatKHR& format : formats) {
+        if (format.format == VK_FORMAT_B8G8R8A8_SRGB && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+            return format;
+        }
+    }
+    return formats[0];
+}
+
+static VkFramebuffer createPresenterFramebuffer(VkRenderPass renderPass, VkImageView view, VkExtent2D extent) {
+    VkFramebufferCreateInfo framebufferInfo = {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = renderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &view;
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+
+    VkFramebuffer framebuffer;
+    if (vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create swap chain framebuffer!");
+    }
+    return framebuffer;
+}
+
+static void createSwapchainResources(Presenter& presenter, VkExtent2D framebufferSize, VkSwapchainKHR oldSwapchain) {
+    VkSurfaceCapabilitiesKHR capabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, presenter.surface, &capabilities);
+
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, presenter.surface, &modeCount, nullptr);
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, presenter.surface, &modeCount, modes.data());
+
+    presenter.presentMode = choosePresentMode(modes, presenter.requestedMode);
+    presenter.extent = chooseSwapExtent(capabilities, framebufferSize);
+
+    VkSwapchainCreateInfoKHR createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    createInfo.surface = presenter.surface;
+    createInfo.minImageCount = chooseImageCount(capabilities, presenter.presentMode, presenter.requestedImageCount);
+    createInfo.imageFormat = presenter.format;
+    createInfo.imageColorSpace = presenter.colorSpace;
+    createInfo.imageExtent = presenter.extent;
+    createInfo.imageArrayLayers = 1;
+    // ֧ʱΪԴڶسֵĻ
+    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
+    // ͼ岻ͬʱͼ֡ͼϲҪȨת
+    if (presenter.queueFamilies.size() > 1 && presenter.queueFamilies[0] != presenter.queueFamilies[1]) {
+        createInfo.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
+        createInfo.queueFamilyIndexCount = static_cast<uint32_t>(presenter.queueFamilies.size());
+        createInfo.pQueueFamilyIndices = presenter.queueFamilies.data();
+    }
+    else {
+        createInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    createInfo.preTransform = capabilities.currentTransform;
+    // Ȳ͸ȡֵ֧λ
+    VkCompositeAlphaFlagsKHR alpha = capabilities.supportedCompositeAlpha;
+    createInfo.compositeAlpha = (alpha & VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR) != 0 ? VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR
+        : static_cast<VkCompositeAlphaFlagBitsKHR>(alpha & (~alpha + 1));
+    createInfo.presentMode = presenter.presentMode;
+    createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = oldSwapchain;
+
+    if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &presenter.swapchain) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create swap chain!");
+    }
+
+    uint32_t imageCount = 0;
+    vkGetSwapchainImagesKHR(device, presenter.swapchain, &imageCount, nullptr);
+    presenter.images.resize(imageCount);
+    vkGetSwapchainImagesKHR(device, presenter.swapchain, &imageCount, presenter.images.data());
+
+    for (VkImage image : presenter.images) {
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = presenter.format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        VkImageView view;
+        if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create swap chain image view!");
+        }
+        presenter.views.push_back(view);
+        presenter.framebuffers.push_back(createPresenterFramebuffer(presenter.renderPass, view, presenter.extent));
+
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        VkSemaphore semaphore;
+        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create render finished semaphore!");
+        }
+        presenter.renderFinished.push_back(semaphore);
+    }
+}
+
+static void createOffscreenResources(Presenter& presenter, uint32_t imageCount, VkExtent2D extent) {
+    presenter.extent = extent;
+    presenter.targets.resize(imageCount);
+    for (OffscreenTarget& target : presenter.targets) {
+        createOffscreenTarget(target, presenter.format, extent, presenter.renderPass);
+    }
+    presenter.images.clear();
+    for (const OffscreenTarget& target : presenter.targets) {
+        presenter.images.push_back(target.image);
+    }
+    presenter.nextTarget = 0;
+}
+
+// һĿ꣩ӵеĶ
+struct PresenterResources {
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    std::vector<VkImageView> views;
+    std::vector<VkFramebuffer> framebuffers;
+    std::vector<VkSemaphore> renderFinished;
+    std::vector<OffscreenTarget> targets;
+};
+
+static PresenterResources takeResources(Presenter& presenter) {
+    PresenterResources resources;
+    resources.swapchain = presenter.swapchain;
+    resources.views = std::move(presenter.views);
+    resources.framebuffers = std::move(presenter.framebuffers);
+    resources.renderFinished = std::move(presenter.renderFinished);
+    resources.targets = std::move(presenter.targets);
+
+    presenter.swapchain = VK_NULL_HANDLE;
+    presenter.images.clear();
+    presenter.views.clear();
+    presenter.framebuffers.clear();
+    presenter.renderFinished.clear();
+    presenter.targets.clear();
+    return resources;
+}
+
+static void destroyResources(PresenterResources& resources) {
+    for (VkFramebuffer framebuffer : resources.framebuffers) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+    for (VkImageView view : resources.views) {
+        vkDestroyImageView(device, view, nullptr);
+    }
+    for (VkSemaphore semaphore : resources.renderFinished) {
+        vkDestroySemaphore(device, semaphore, nullptr);
+    }
+    for (OffscreenTarget& target : resources.targets) {
+        destroyOffscreenTarget(target);
+    }
+    if (resources.swapchain != VK_NULL_HANDLE) {
+        vkDestroySwapchainKHR(device, resources.swapchain, nullptr);
+    }
+    resources = PresenterResources();
+}
+
+void createSwapchainPresenter(Presenter& presenter, VkSurfaceKHR surface, VkSurfaceFormatKHR format,
+    VkPresentModeKHR mode, uint32_t imageCount, const std::vector<uint32_t>& queueFamilies,
+    VkExtent2D framebufferSize, VkRenderPass renderPass) {
+    presenter = Presenter();
+    presenter.kind = PresenterKind::Swapchain;
+    presenter.surface = surface;
+    presenter.renderPass = renderPass;
+    presenter.format = format.format;
+    presenter.colorSpace = format.colorSpace;
+    presenter.requestedMode = mode;
+    presenter.requestedImageCount = imageCount;
+    presenter.queueFamilies = queueFamilies;
+
+    createSwapchainResources(presenter, framebufferSize, VK_NULL_HANDLE);
+}
+
+void createOffscreenPresenter(Presenter& presenter, VkFormat format, uint32_t imageCount, VkExtent2D extent, VkRenderPass renderPass) {
+    presenter = Presenter();
+    presenter.kind = PresenterKind::Offscreen;
+    presenter.renderPass = renderPass;
+    presenter.format = format;
+    presenter.requestedImageCount = imageCount;
+
+    createOffscreenResources(presenter, imageCount, extent);
+}
+
+void destroyPresenter(Presenter& presenter) {
+    PresenterResources resources = takeResources(presenter);
+    destroyResources(resources);
+    presenter = Presenter();
+}
+
+bool acquirePresenterImage(Presenter& presenter, VkSemaphore imageAvailable, uint32_t& imageIndex) {
+    if (presenter.kind == PresenterKind::Offscreen) {
+        if (presenter.simulateOutOfDateEvery > 0 && presenter.acquiresSinceRecreate >= presenter.simulateOutOfDateEvery) {
+            presenter.stats.outOfDate++;
+            return false;
+        }
+
+        imageIndex = presenter.nextTarget;
+        presenter.nextTarget = (presenter.nextTarget + 1) % static_cast<uint32_t>(presenter.targets.size());
+    }
+    else {
+        VkResult result = vkAcquireNextImageKHR(device, presenter.swapchain, UINT64_MAX, imageAvailable, VK_NULL_HANDLE, &imageIndex);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            presenter.stats.outOfDate++;
+            return false;
+        }
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+            throw std::runtime_error("failed to acquire swap chain image!");
+        }
+
+        // ŵͼȻԳ֣źѾڵȴУ֮ؽ
+        if (result == VK_SUBOPTIMAL_KHR) {
+            presenter.needsRecreate = true;
+        }
+    }
+
+    presenter.acquiresSinceRecreate++;
+    presenter.stats.acquires++;
+    return true;
+}
+
+VkSemaphore getPresenterRenderFinished(const Presenter& presenter, uint32_t imageIndex) {
+    return presenter.kind == PresenterKind::Offscreen ? VK_NULL_HANDLE : presenter.renderFinished.at(imageIndex);
+}
+
+void presentPresenterImage(Presenter& presenter, VkQueue queue, uint32_t imageIndex) {
+    presenter.stats.presents++;
+    if (presenter.kind == PresenterKind::Offscreen) {
+        return;
+    }
+
+    VkPresentInfoKHR presentInfo = {};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &presenter.renderFinished[imageIndex];
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &presenter.swapchain;
+    presentInfo.pImageIndices = &imageIndex;
+
+    VkResult result = vkQueuePresentKHR(queue, &presentInfo);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        presenter.stats.outOfDate++;
+        presenter.needsRecreate = true;
+    }
+    else if (result == VK_SUBOPTIMAL_KHR) {
+        presenter.stats.suboptimal++;
+        presenter.needsRecreate = true;
+    }
+    else if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to present swap chain image!");
+    }
+}
+
+void recreatePresenter(Presenter& presenter, VkExtent2D framebufferSize, ResourceRegistry& registry) {
+    VkSwapchainKHR oldSwapchain = presenter.swapchain;
+    auto retired = std::make_shared<PresenterResources>(takeResources(presenter));
+    deferRegistryRelease(registry, [retired]() { destroyResources(*retired); });
+
+    if (presenter.kind == PresenterKind::Swapchain) {
+        createSwapchainResources(presenter, framebufferSize, oldSwapchain);
+    }
+    else {
+        createOffscreenResources(presenter, presenter.requestedImageCount, framebufferSize);
+    }
+
+    presenter.needsRecreate = false;
+    presenter.acquiresSinceRecreate = 0;
+    presenter.stats.recreations++;
+}
+
+VkImage getPresenterImage(const Presenter& presenter, uint32_t imageIndex) {
+    return presenter.images.at(imageIndex);
+}
+
+VkFramebuffer getPresenterFramebuffer(const Presenter& presenter, uint32_t imageIndex) {
+    return presenter.kind == PresenterKind::Offscreen ? presenter.targets.at(imageIndex).framebuffer
+        : presenter.framebuffers.at(imageIndex);
+}
+
+uint32_t getPresenterImageCount(const Presenter& presenter) {
+    return static_cast<uint32_t>(presenter.images.size());
+}
+
+void printPresenterInfo(const Presenter& presenter) {
+    std::cout << "Presenter: ";
+    if (presenter.kind == PresenterKind::Offscreen) {
+        std::cout << "offscreen, " << presenter.targets.size() << " targets";
+        if (presenter.simulateOutOfDateEvery > 0) {
+            std::cout << ", simulated resize every " << presenter.simulateOutOfDateEvery << " frames";
+        }
+    }
+    else {
+        std::cout << "swapchain, " << presenter.images.size() << " images, " << presentModeName(presenter.presentMode);
+        if (presenter.presentMode != presenter.requestedMode) {
+            std::cout << " (" << presentModeName(presenter.requestedMode) << " not supported)";
+        }
+    }
+    std::cout << ", " << presenter.extent.width << "x" << presenter.extent.height << std::endl;
+}
+
+void printPresenterStats(const Presenter& presenter) {
+    const PresenterStats& stats = presenter.stats;
+    std::cout << "Presenter: " << stats.presents << " presents, " << stats.recreations << " recreations ("
+        << stats.outOfDate << " out of date, " << stats.suboptimal << " suboptimal), final size "
+        << presenter.extent.width << "x" << presenter.extent.height << std::endl;
+}
+
+void initFramePacer(FramePacer& pacer, uint32_t targetFps) {
+    pacer = FramePacer();
+    pacer.targetMs = targetFps > 0 ? 1000.0 / targetFps : 0.0;
+}
+
+void paceFrame(FramePacer& pacer) {
+    using Clock = std::chrono::high_resolution_clock;
+    Clock::time_point now = Clock::now();
+
+    if (pacer.targetMs > 0.0) {
+        Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(pacer.targetMs));
+        if (!pacer.started) {
+            pacer.deadline = now;
+        }
+        else if (now < pacer.deadline) {
+            // sleep_until ֻͨȷ 1 ms ңһСóʱƬȴ
+            Clock::time_point sleepStart = now;
+            Clock::time_point spinFrom = pacer.deadline - std::chrono::milliseconds(1);
+            if (now < spinFrom) {
+                std::this_thread::sleep_until(spinFrom);
+            }
+            while (Clock::now() < pacer.deadline) {
+                std::this_thread::yield();
+            }
+            now = Clock::now();
+            pacer.sleptMs += std::chrono::duration<double, std::milli>(now - sleepStart).count();
+        }
+        else if (now - pacer.deadline > period / 2) {
+            // Ѿ󣬴¼ƻ֡˯׷
+            pacer.lateFrames++;
+            pacer.deadline = now;
+        }
+        pacer.deadline += period;
+    }
+
+    if (pacer.started) {
+        pacer.intervalMs.push_back(std::chrono::duration<double, std::milli>(now - pacer.lastStart).count());
+    }
+    pacer.lastStart = now;
+    pacer.started = true;
+}
+
+void printFramePacerStats(const FramePacer& pacer) {
+    std::cout << std::fixed << std::setprecision(3) << "Frame pacing: ";
+    if (pacer.targetMs > 0.0) {
+        std::cout << "target " << pacer.targetMs << " ms, ";
+    }
+    else {
+        std::cout << "unpaced, ";
+    }
+    std::cout << "interval p50 " << percentile(pacer.intervalMs, 50.0) << " ms, p99 " << percentile(pacer.intervalMs, 99.0) << " ms";
+    if (pacer.targetMs > 0.0) {
+        std::cout << ", " << pacer.lateFrames << " late frames, " << pacer.sleptMs << " ms slept";
+    }
+    std::cout << std::endl << std::defaultfloat;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Offscreen.h"
+
+struct ResourceRegistry;
+
+// Ŀ꣺ģʽǽ޴ģʽһͼߵĻȡ//ؽͬ
+// CI Ͽ --resize-every ģⴰڴСı䣩ؽ·
+enum class PresenterKind {
+    Swapchain,
+    Offscreen,
+};
+
+struct PresenterStats {
+    uint64_t acquires = 0;
+    uint64_t presents = 0;
+    uint64_t recreations = 0;
+    uint64_t outOfDate = 0;         // ȡַ VK_ERROR_OUT_OF_DATE_KHRģĹڣ
+    uint64_t suboptimal = 0;        // ַ VK_SUBOPTIMAL_KHR
+};
+
+struct Presenter {
+    PresenterKind kind = PresenterKind::Offscreen;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkColorSpaceKHR colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    VkPresentModeKHR requestedMode = VK_PRESENT_MODE_FIFO_KHR;
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    uint32_t requestedImageCount = 0;   // 0 ʾģʽԶѡ
+    std::vector<uint32_t> queueFamilies; // ͼͳ岻ͬʱͼ߼乲
+    VkExtent2D extent = {};
+
+    VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+    std::vector<VkImage> images;
+    std::vector<VkImageView> views;     // ͼͼĿԴͼ
+    std::vector<VkFramebuffer> framebuffers;
+    std::vector<VkSemaphore> renderFinished; // ÿŽͼһֵȴʱͬһ֡λѾȾһͼ
+    std::vector<OffscreenTarget> targets;
+
+    uint32_t nextTarget = 0;            // ˳ʹĿ
+    uint32_t simulateOutOfDateEvery = 0; // ÿȡôαһιڣ0 ʾģ
+    uint32_t acquiresSinceRecreate = 0;
+    bool needsRecreate = false;         // ϴγַعڻţһ֡ȡǰؽ
+    PresenterStats stats;
+};
+
+// ģʽƣfifo / mailbox / immediate / fifo-relaxed
+bool parsePresentMode(const std::string& name, VkPresentModeKHR& mode);
+const char* presentModeName(VkPresentModeKHR mode);
+
+// ֧ģʽʱʹ˻ʵֵֶ֧ FIFO
+VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR>& available, VkPresentModeKHR requested);
+
+// requested Ϊ 0 ʱ MAILBOX  3 ţһʾһŶӡһȾģʽ minImageCount + 1
+// ڱֵ֧ķΧ
+uint32_t chooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities, VkPresentModeKHR mode, uint32_t requested);
+
+// 涨˴СʱʹѴڵ֡Сֵ֧ķΧ
+VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, VkExtent2D framebufferSize);
+
+//  B8G8R8A8_SRGB + SRGB_NONLINEARûʱʹñгĵһʽ
+VkSurfaceFormatKHR chooseSurfaceFormat(VkPhysicalDevice physicalDevice, VkSurfaceKHR surface);
+
+// ÿͼͼ֡塣format  renderPass ɫһ£
+// ʧʱ׳쳣
+void createSwapchainPresenter(Presenter& presenter, VkSurfaceKHR surface, VkSurfaceFormatKHR format,
+    VkPresentModeKHR mode, uint32_t imageCount, const std::vector<uint32_t>& queueFamilies,
+    VkExtent2D framebufferSize, VkRenderPass renderPass);
+
+//  imageCount Ŀ꣬˳ʹãimageCount ;֡ʱÿ֡ռһ
+void createOffscreenPresenter(Presenter& presenter, VkFormat format, uint32_t imageCount, VkExtent2D extent, VkRenderPass renderPass);
+
+void destroyPresenter(Presenter& presenter);
+
+// ȡһͼ񡣽ڣģڣʱ falseӦؽԡ
+// ģʽ imageAvailable ͼʱģʽ²ʹź
+bool acquirePresenterImage(Presenter& presenter, VkSemaphore imageAvailable, uint32_t& imageIndex);
+
+// Ⱦ imageIndex ύҪźֵȴģʽΪ VK_NULL_HANDLE
+VkSemaphore getPresenterRenderFinished(const Presenter& presenter, uint32_t imageIndex);
+
+// ͼģʽֻȴͼ renderFinished źعڻʱ needsRecreate
+void presentPresenterImage(Presenter& presenter, VkQueue queue, uint32_t imageIndex);
+
+// µĴСؽȴ豸УɵĽΪ oldSwapchain ½ɵͼ֡塢ź
+// Ŀ꣩Ǽǵעĵǰ֡λϣһ֡ fence ֮ǰύ֡Ҳɣ١
+//  beginRegistryFrame ֮󡢱֡ύ֮ǰ
+void recreatePresenter(Presenter& presenter, VkExtent2D framebufferSize, ResourceRegistry& registry);
+
+VkImage getPresenterImage(const Presenter& presenter, uint32_t imageIndex);
+VkFramebuffer getPresenterFramebuffer(const Presenter& presenter, uint32_t imageIndex);
+uint32_t getPresenterImageCount(const Presenter& presenter);
+
+void printPresenterInfo(const Presenter& presenter);
+void printPresenterStats(const Presenter& presenter);
+
+// ࣺ֡ڲ롢ʼһ֮֡ǰ˯һ֡ʼʱ䣬 CPU ʾ̫֡
+// 뵽ʾӳٸͣͬʱ֡ȶĿΪ 0 ʱֻͳ֡
+struct FramePacer {
+    double targetMs = 0.0;
+    std::chrono::high_resolution_clock::time_point deadline;
+    std::chrono::high_resolution_clock::time_point lastStart;
+    bool started = false;
+    uint64_t lateFrames = 0;        // ʼʱȼƻ֡ϵ֡ƻ֮¶룩
+    double sleptMs = 0.0;
+    std::vector<double> intervalMs; // ֡ʼʱļ
+};
+
+void initFramePacer(FramePacer& pacer, uint32_t targetFps);
+void paceFrame(FramePacer& pacer);
+void printFramePacerStats(const FramePacer& pacer);
@@ -0,0 +1,424 @@
+#include "Profiler.h"
+#include "FrameStats.h"
+#include "VulkanContext.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+// ¼ޣԼ 100 /֡ʱԼ¼һ֡
+static const size_t MAX_TRACE_EVENTS = 1000000;
+
+static const char* statisticNames[PIPELINE_STATISTIC_COUNT] = {
+    "vertices",
+    "primitives",
+    "vertexInvocations",
+    "clippingInvocations",
+    "clippingPrimitives",
+    "fragmentInvocations",
+    "computeInvocations",
+};
+
+// ̱߳Ŵ 0 ʼ״μ¼˳䣬Chrome trace ÿ߳һ
+static uint32_t currentThreadId() {
+    static std::atomic<uint32_t> nextThreadId(0);
+    thread_local uint32_t threadId = nextThreadId++;
+    return threadId;
+}
+
+void createProfiler(Profiler& profiler, uint32_t frameCount, uint32_t queueFamilyIndex, bool pipelineStatistics, bool inheritedQueries) {
+    profiler.enabled = true;
+    profiler.pipelineStatistics = pipelineStatistics;
+    profiler.inheritedQueries = pipelineStatistics && inheritedQueries;
+    profiler.epoch = std::chrono::high_resolution_clock::now();
+    profiler.maxEvents = MAX_TRACE_EVENTS;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits = queueFamilyIndex < queueFamilyCount ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+    bool timestampsSupported = validBits != 0 && props.limits.timestampPeriod != 0.0f;
+    if (timestampsSupported) {
+        profiler.timestampPeriodNs = props.limits.timestampPeriod;
+        profiler.timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+    }
+    else {
+        std::cerr << "Profiler: timestamp queries not supported, recording CPU scopes only" << std::endl;
+        profiler.pipelineStatistics = false;
+        profiler.inheritedQueries = false;
+    }
+
+    profiler.frames.resize(frameCount);
+    for (ProfilerFrame& frame : profiler.frames) {
+        frame.scopes.reserve(MAX_GPU_SCOPES_PER_FRAME);
+        if (!timestampsSupported) {
+            continue;
+        }
+
+        VkQueryPoolCreateInfo queryPoolInfo = {};
+        queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = MAX_GPU_SCOPES_PER_FRAME * 2;
+
+        if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &frame.timestampPool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create profiler timestamp query pool!");
+        }
+
+        if (profiler.pipelineStatistics) {
+            queryPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            queryPoolInfo.queryCount = MAX_STATISTICS_SCOPES_PER_FRAME;
+            queryPoolInfo.pipelineStatistics = PROFILER_PIPELINE_STATISTICS;
+
+            if (vkCreateQueryPool(device, &queryPoolInfo, nullptr, &frame.statisticsPool) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create profiler pipeline statistics query pool!");
+            }
+        }
+    }
+}
+
+void destroyProfiler(Profiler& profiler) {
+    for (ProfilerFrame& frame : profiler.frames) {
+        if (frame.statisticsPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, frame.statisticsPool, nullptr);
+        }
+        if (frame.timestampPool != VK_NULL_HANDLE) {
+            vkDestroyQueryPool(device, frame.timestampPool, nullptr);
+        }
+    }
+    profiler.frames.clear();
+    profiler.enabled = false;
+}
+
+double profilerNowUs(const Profiler& profiler) {
+    return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - profiler.epoch).count();
+}
+
+// һ֡ĲѯתΪ GPU ¼ʱ֡ fence Ѿ
+// ʹ VK_QUERY_RESULT_WAIT_BITʱһ֡
+static void readFrameQueries(Profiler& profiler, ProfilerFrame& frame) {
+    if (!frame.recorded) {
+        return;
+    }
+    frame.recorded = false;
+
+    uint32_t scopeCount = static_cast<uint32_t>(frame.scopes.size());
+    if (scopeCount == 0 || frame.timestampPool == VK_NULL_HANDLE) {
+        return;
+    }
+
+    // δûдʱβѯΪ
+    for (const GpuScope& scope : frame.scopes) {
+        if (!scope.closed) {
+            profiler.stats.unavailableFrames++;
+            return;
+        }
+    }
+
+    uint64_t timestamps[MAX_GPU_SCOPES_PER_FRAME * 2];
+    if (vkGetQueryPoolResults(device, frame.timestampPool, 0, scopeCount * 2, scopeCount * 2 * sizeof(uint64_t), timestamps,
+        sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        profiler.stats.unavailableFrames++;
+        return;
+    }
+
+    PipelineStatistics statistics[MAX_STATISTICS_SCOPES_PER_FRAME];
+    if (frame.statisticsCount > 0 &&
+        vkGetQueryPoolResults(device, frame.statisticsPool, 0, frame.statisticsCount, frame.statisticsCount * sizeof(PipelineStatistics),
+            statistics, sizeof(PipelineStatistics), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        profiler.stats.unavailableFrames++;
+        return;
+    }
+
+    // һȿʼû VK_EXT_calibrated_timestamps ʱ޷ȷ㣬
+    //  GPU ʱ᲻ڶӦ֡ʼ¼Ƶ CPU ʱ䣬ƫֻ
+    uint64_t base = timestamps[0] & profiler.timestampMask;
+    double usPerTick = profiler.timestampPeriodNs / 1000.0;
+    double baseUs = base * usPerTick;
+    if (!profiler.gpuCalibrated || baseUs + profiler.gpuOffsetUs < frame.recordUs) {
+        profiler.gpuOffsetUs = frame.recordUs - baseUs;
+        profiler.gpuCalibrated = true;
+    }
+
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    for (uint32_t i = 0; i < scopeCount; i++) {
+        const GpuScope& scope = frame.scopes[i];
+        if (profiler.events.size() >= profiler.maxEvents) {
+            profiler.stats.droppedScopes += scopeCount - i;
+            break;
+        }
+
+        uint64_t begin = (timestamps[2 * i] - base) & profiler.timestampMask;
+        uint64_t end = (timestamps[2 * i + 1] - base) & profiler.timestampMask;
+
+        TraceEvent event;
+        event.name = scope.name;
+        event.thread = 0;
+        event.gpu = true;
+        event.startUs = baseUs + profiler.gpuOffsetUs + begin * usPerTick;
+        event.durationUs = end >= begin ? (end - begin) * usPerTick : 0.0;
+        event.frameNumber = frame.frameNumber;
+        event.statistics = -1;
+
+        if (scope.statisticsQuery != INVALID_SCOPE) {
+            event.statistics = static_cast<int32_t>(profiler.statistics.size());
+            profiler.statistics.push_back(statistics[scope.statisticsQuery]);
+        }
+
+        profiler.events.push_back(event);
+        profiler.stats.gpuScopes++;
+    }
+}
+
+void profilerBeginFrame(Profiler& profiler, uint32_t frameIndex, uint64_t frameNumber) {
+    if (!profiler.enabled) {
+        return;
+    }
+
+    ProfilerFrame& frame = profiler.frames[frameIndex];
+    readFrameQueries(profiler, frame);
+
+    frame.scopes.clear();
+    frame.statisticsCount = 0;
+    frame.frameNumber = frameNumber;
+    frame.recordUs = profilerNowUs(profiler);
+
+    profiler.currentFrame = frameIndex;
+    profiler.openScopes = 0;
+    profiler.statisticsOpen = false;
+}
+
+void profilerResetQueries(Profiler& profiler, VkCommandBuffer commandBuffer) {
+    if (!profiler.enabled) {
+        return;
+    }
+
+    ProfilerFrame& frame = profiler.frames[profiler.currentFrame];
+    if (frame.timestampPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, frame.timestampPool, 0, MAX_GPU_SCOPES_PER_FRAME * 2);
+    }
+    if (frame.statisticsPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, frame.statisticsPool, 0, MAX_STATISTICS_SCOPES_PER_FRAME);
+    }
+    frame.recorded = true;
+}
+
+uint32_t beginGpuScope(Profiler& profiler, VkCommandBuffer commandBuffer, const char* name, bool statistics) {
+    if (!profiler.enabled) {
+        return INVALID_SCOPE;
+    }
+
+    ProfilerFrame& frame = profiler.frames[profiler.currentFrame];
+    if (frame.timestampPool == VK_NULL_HANDLE) {
+        return INVALID_SCOPE;
+    }
+    if (frame.scopes.size() == MAX_GPU_SCOPES_PER_FRAME) {
+        profiler.stats.droppedScopes++;
+        return INVALID_SCOPE;
+    }
+
+    uint32_t index = static_cast<uint32_t>(frame.scopes.size());
+    GpuScope scope;
+    scope.name = name;
+    scope.depth = profiler.openScopes++;
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestampPool, 2 * index);
+
+    if (statistics && profiler.pipelineStatistics && !profiler.statisticsOpen &&
+        frame.statisticsCount < MAX_STATISTICS_SCOPES_PER_FRAME) {
+        scope.statisticsQuery = frame.statisticsCount++;
+        profiler.statisticsOpen = true;
+        vkCmdBeginQuery(commandBuffer, frame.statisticsPool, scope.statisticsQuery, 0);
+    }
+
+    frame.scopes.push_back(scope);
+    return index;
+}
+
+void endGpuScope(Profiler& profiler, VkCommandBuffer commandBuffer, uint32_t scope) {
+    if (!profiler.enabled || scope == INVALID_SCOPE) {
+        return;
+    }
+
+    ProfilerFrame& frame = profiler.frames[profiler.currentFrame];
+    GpuScope& gpuScope = frame.scopes[scope];
+
+    if (gpuScope.statisticsQuery != INVALID_SCOPE) {
+        vkCmdEndQuery(commandBuffer, frame.statisticsPool, gpuScope.statisticsQuery);
+        profiler.statisticsOpen = false;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestampPool, 2 * scope + 1);
+    gpuScope.closed = true;
+    profiler.openScopes--;
+}
+
+VkQueryPipelineStatisticFlags getInheritedStatistics(const Profiler& profiler) {
+    return profiler.enabled && profiler.statisticsOpen ? PROFILER_PIPELINE_STATISTICS : 0;
+}
+
+void flushProfiler(Profiler& profiler) {
+    if (!profiler.enabled) {
+        return;
+    }
+
+    // ֡˳أ GPU ¼
+    std::map<uint64_t, ProfilerFrame*> pending;
+    for (ProfilerFrame& frame : profiler.frames) {
+        if (frame.recorded) {
+            pending[frame.frameNumber] = &frame;
+        }
+    }
+    for (auto& entry : pending) {
+        readFrameQueries(profiler, *entry.second);
+    }
+}
+
+void recordCpuScope(Profiler& profiler, const char* name, double startUs, double endUs) {
+    if (!profiler.enabled) {
+        return;
+    }
+
+    TraceEvent event;
+    event.name = name;
+    event.thread = currentThreadId();
+    event.gpu = false;
+    event.startUs = startUs;
+    event.durationUs = endUs - startUs;
+    event.frameNumber = 0;
+    event.statistics = -1;
+
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+    if (profiler.events.size() >= profiler.maxEvents) {
+        profiler.stats.droppedScopes++;
+        return;
+    }
+    profiler.events.push_back(event);
+    profiler.stats.cpuScopes++;
+}
+
+ProfileScope::ProfileScope(Profiler& profiler, const char* name)
+    : profiler(profiler), name(name), startUs(profiler.enabled ? profilerNowUs(profiler) : 0.0) {
+}
+
+ProfileScope::~ProfileScope() {
+    if (profiler.enabled) {
+        recordCpuScope(profiler, name, startUs, profilerNowUs(profiler));
+    }
+}
+
+// ԴеַֻҪתźͷб
+static void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+bool exportChromeTrace(Profiler& profiler, const std::string& path) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to write trace " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+
+    for (const TraceEvent& event : profiler.events) {
+        out << ",\n{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"ph\":\"X\",\"pid\":" << (event.gpu ? 2 : 1) << ",\"tid\":" << event.thread
+            << ",\"ts\":" << event.startUs << ",\"dur\":" << event.durationUs;
+
+        if (event.gpu) {
+            out << ",\"args\":{\"frame\":" << event.frameNumber;
+            if (event.statistics >= 0) {
+                const PipelineStatistics& statistics = profiler.statistics[event.statistics];
+                for (uint32_t i = 0; i < PIPELINE_STATISTIC_COUNT; i++) {
+                    out << ",\"" << statisticNames[i] << "\":" << statistics[i];
+                }
+            }
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        std::cerr << "Failed to write trace " << path << std::endl;
+        return false;
+    }
+
+    std::cout << "Trace       : " << profiler.events.size() << " events written to " << path << std::endl;
+    return true;
+}
+
+void printProfilerStats(Profiler& profiler) {
+    if (!profiler.enabled) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(profiler.mutex);
+
+    struct ScopeSummary {
+        std::vector<double> ms;
+        PipelineStatistics statistics = {};
+        uint64_t statisticsSamples = 0;
+    };
+
+    // ַܣͬԲַͬ
+    std::map<std::string, ScopeSummary> scopes;
+    for (const TraceEvent& event : profiler.events) {
+        if (!event.gpu) {
+            continue;
+        }
+
+        ScopeSummary& summary = scopes[event.name];
+        summary.ms.push_back(event.durationUs / 1000.0);
+        if (event.statistics >= 0) {
+            const PipelineStatistics& statistics = profiler.statistics[event.statistics];
+            for (uint32_t i = 0; i < PIPELINE_STATISTIC_COUNT; i++) {
+                summary.statistics[i] += statistics[i];
+            }
+            summary.statisticsSamples++;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Profiler    : " << profiler.stats.gpuScopes << " GPU scope(s), "
+        << profiler.stats.cpuScopes << " CPU scope(s), "
+        << profiler.stats.droppedScopes << " dropped, "
+        << profiler.stats.unavailableFrames << " frame(s) unavailable" << std::endl;
+
+    for (auto& entry : scopes) {
+        ScopeSummary& summary = entry.second;
+        std::cout << "  GPU " << std::left << std::setw(16) << entry.first
+            << " p50 " << std::setw(9) << percentile(summary.ms, 50.0) << " ms   "
+            << "p99 " << std::setw(9) << percentile(summary.ms, 99.0) << " ms" << std::endl;
+
+        if (summary.statisticsSamples > 0) {
+            std::cout << "      per frame:";
+            for (uint32_t i = 0; i < PIPELINE_STATISTIC_COUNT; i++) {
+                std::cout << " " << statisticNames[i] << "=" << summary.statistics[i] / summary.statisticsSamples;
+            }
+            std::cout << std::endl;
+        }
+    }
+    std::cout << std::defaultfloat << std::right;
+}
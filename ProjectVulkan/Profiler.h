@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ÿ֡ GPU ÿʱ
+const uint32_t MAX_GPU_SCOPES_PER_FRAME = 64;
+
+// ÿ֡ĹͳƲѯ
+const uint32_t MAX_STATISTICS_SCOPES_PER_FRAME = 8;
+
+// ռĹͳƼλӵ͵
+const VkQueryPipelineStatisticFlags PROFILER_PIPELINE_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+const uint32_t PIPELINE_STATISTIC_COUNT = 7;
+
+typedef std::array<uint64_t, PIPELINE_STATISTIC_COUNT> PipelineStatistics;
+
+const uint32_t INVALID_SCOPE = UINT32_MAX;
+
+struct GpuScope {
+    const char* name = nullptr;         // Ǿַ̬ʱŶȡ
+    uint32_t depth = 0;
+    uint32_t statisticsQuery = INVALID_SCOPE;
+    bool closed = false;
+};
+
+// ÿ;֡һѯأ FrameRing ĲλһһӦ
+struct ProfilerFrame {
+    VkQueryPool timestampPool = VK_NULL_HANDLE;     //  i ʹʱ 2i  2i+1
+    VkQueryPool statisticsPool = VK_NULL_HANDLE;
+    std::vector<GpuScope> scopes;
+    uint32_t statisticsCount = 0;
+    uint64_t frameNumber = 0;
+    double recordUs = 0.0;      // ʼ¼Ƶ CPU ʱ䣬ڰ GPU ʱ뵽 CPU ʱ
+    bool recorded = false;      // δصĲѯ
+};
+
+struct TraceEvent {
+    const char* name;
+    uint32_t thread;            // CPU ¼̱߳ţGPU ¼ͬһ
+    bool gpu;
+    double startUs;
+    double durationUs;
+    uint64_t frameNumber;
+    int32_t statistics;         // Profiler::statistics ±꣬-1 ʾû
+};
+
+struct ProfilerStats {
+    uint64_t gpuScopes = 0;
+    uint64_t cpuScopes = 0;
+    uint64_t droppedScopes = 0;     // ÿ֡޻¼
+    uint64_t unavailableFrames = 0; // ʱѯ
+};
+
+// ܷCPU ֱӼʱ䣬GPU дʱѡͳƣѯ
+// ڸ֡ fence أԵΪ Chrome tracechrome://tracing
+struct Profiler {
+    bool enabled = false;
+    bool pipelineStatistics = false;    // 豸֧ pipelineStatisticsQuery
+    bool inheritedQueries = false;      // ͳƲѯԿԽ
+    std::vector<ProfilerFrame> frames;
+    uint32_t currentFrame = 0;
+    uint32_t openScopes = 0;            // ǰ֡δ GPU 
+    bool statisticsOpen = false;        // ͬһʱֻһͳƲѯڻ״̬
+
+    double timestampPeriodNs = 0.0;
+    uint64_t timestampMask = 0;
+    double gpuOffsetUs = 0.0;           // GPU ʱ + ƫ = CPU ʱ
+    bool gpuCalibrated = false;
+
+    std::chrono::high_resolution_clock::time_point epoch;
+
+    std::mutex mutex;                   // ³ԱCPU ڹ߳Ͻ
+    std::vector<TraceEvent> events;
+    std::vector<PipelineStatistics> statistics;
+    size_t maxEvents = 0;
+    ProfilerStats stats;
+};
+
+// frameCount  FrameRing ;֡ͬ豸֧ʱʱֻ¼ CPU 
+void createProfiler(Profiler& profiler, uint32_t frameCount, uint32_t queueFamilyIndex, bool pipelineStatistics, bool inheritedQueries);
+void destroyProfiler(Profiler& profiler);
+
+//  beginFrame ֮ãλ fence Ѿϴʹøòλ֡Ĳѯ
+void profilerBeginFrame(Profiler& profiler, uint32_t frameIndex, uint64_t frameNumber);
+
+// 忪ͷκ֮ǰñ֡ĲѯȾ֮ͨ⣩
+void profilerResetQueries(Profiler& profiler, VkCommandBuffer commandBuffer);
+
+// GPU ֻдУǶסstatistics Ϊ true ʱͬʱռͳƣ
+// ͳƲѯǶףȾͨΪʱҪ inheritedQueries
+uint32_t beginGpuScope(Profiler& profiler, VkCommandBuffer commandBuffer, const char* name, bool statistics = false);
+void endGpuScope(Profiler& profiler, VkCommandBuffer commandBuffer, uint32_t scope);
+
+// ڻͳƲѯִʱҪڼ̳ϢиͳƱ־
+VkQueryPipelineStatisticFlags getInheritedStatistics(const Profiler& profiler);
+
+// ;֡waitForAllFramesãʣĲѯ
+void flushProfiler(Profiler& profiler);
+
+double profilerNowUs(const Profiler& profiler);
+
+// ¼һ CPU 򣬿κ̵߳
+void recordCpuScope(Profiler& profiler, const char* name, double startUs, double endUs);
+
+// ʱʼʱ CPU 
+struct ProfileScope {
+    Profiler& profiler;
+    const char* name;
+    double startUs;
+
+    ProfileScope(Profiler& profiler, const char* name);
+    ~ProfileScope();
+};
+
+bool exportChromeTrace(Profiler& profiler, const std::string& path);
+
+// ƻ GPU ʱ͹ͳ
+void printProfilerStats(Profiler& profiler);
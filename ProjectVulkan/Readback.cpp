@@ -0,0 +1,838 @@
+#include "Readback.h"
+#include "FrameRing.h"
+#include "ResourceRegistry.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+bool parseImageFileFormat(const std::string& name, ImageFileFormat& format) {
+    if (name == "png") {
+        format = ImageFileFormat::Png;
+    }
+    else if (name == "exr") {
+        format = ImageFileFormat::Exr;
+    }
+    else if (name == "raw") {
+        format = ImageFileFormat::Raw;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+const char* imageFileExtension(ImageFileFormat format) {
+    switch (format) {
+    case ImageFileFormat::Png: return "png";
+    case ImageFileFormat::Exr: return "exr";
+    case ImageFileFormat::Raw: return "rgba";
+    }
+    return "bin";
+}
+
+bool isReadbackFormatSupported(VkFormat format) {
+    return format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB
+        || format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB;
+}
+
+static bool isSrgbFormat(VkFormat format) {
+    return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+}
+
+static bool isBgraFormat(VkFormat format) {
+    return format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB;
+}
+
+// ---------------------------------------------------------------------------
+// У
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)initialized;
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t adler32(const uint8_t* data, size_t size) {
+    const uint32_t MOD = 65521;
+    uint32_t a = 1;
+    uint32_t b = 0;
+    // ÿ 5552 ֽȡһģڼۼӲ 32 λ
+    while (size > 0) {
+        size_t block = std::min<size_t>(size, 5552);
+        size -= block;
+        for (size_t i = 0; i < block; i++) {
+            a += *data++;
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+    }
+    return (b << 16) | a;
+}
+
+static void putBigEndian32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// ---------------------------------------------------------------------------
+// deflateLZ77ϣң+ ̶룬һ zlib 
+// ȾƬͬ򽥱򾭹 PNG ˺ҪظĶУ̶Ѿѹò
+// ʡͳƵʺʹ䶯̬Ŀ
+
+const uint32_t DEFLATE_WINDOW = 32768;
+const uint32_t DEFLATE_HASH_BITS = 15;
+const uint32_t DEFLATE_MAX_CHAIN = 32;
+const uint32_t DEFLATE_MIN_MATCH = 3;
+const uint32_t DEFLATE_MAX_MATCH = 258;
+
+static const uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// deflate λÿֽڵλʼ
+struct BitWriter {
+    std::vector<uint8_t>& out;
+    uint32_t bits = 0;
+    uint32_t count = 0;
+
+    explicit BitWriter(std::vector<uint8_t>& output) : out(output) {}
+
+    // n  16
+    void put(uint32_t value, uint32_t n) {
+        bits |= value << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back(static_cast<uint8_t>(bits));
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    void flush() {
+        if (count > 0) {
+            out.push_back(static_cast<uint8_t>(bits));
+        }
+        bits = 0;
+        count = 0;
+    }
+};
+
+static uint32_t reverseBits(uint32_t value, uint32_t n) {
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        result = (result << 1) | ((value >> i) & 1);
+    }
+    return result;
+}
+
+// ̶Ѱλ˳ת
+struct FixedHuffman {
+    uint16_t literalCode[288];
+    uint8_t literalBits[288];
+    uint8_t distanceCode[30];
+    uint8_t lengthSymbol[DEFLATE_MAX_MATCH + 1];    // ȶӦ LENGTH_BASE ±
+
+    FixedHuffman() {
+        for (uint32_t symbol = 0; symbol < 288; symbol++) {
+            uint32_t code;
+            uint32_t bits;
+            if (symbol < 144) {
+                code = 0x30 + symbol;
+                bits = 8;
+            }
+            else if (symbol < 256) {
+                code = 0x190 + symbol - 144;
+                bits = 9;
+            }
+            else if (symbol < 280) {
+                code = symbol - 256;
+                bits = 7;
+            }
+            else {
+                code = 0xC0 + symbol - 280;
+                bits = 8;
+            }
+            literalCode[symbol] = static_cast<uint16_t>(reverseBits(code, bits));
+            literalBits[symbol] = static_cast<uint8_t>(bits);
+        }
+        for (uint32_t symbol = 0; symbol < 30; symbol++) {
+            distanceCode[symbol] = static_cast<uint8_t>(reverseBits(symbol, 5));
+        }
+        uint32_t index = 0;
+        for (uint32_t length = DEFLATE_MIN_MATCH; length <= DEFLATE_MAX_MATCH; length++) {
+            while (index + 1 < 29 && LENGTH_BASE[index + 1] <= length) {
+                index++;
+            }
+            lengthSymbol[length] = static_cast<uint8_t>(index);
+        }
+    }
+};
+
+static const FixedHuffman& fixedHuffman() {
+    static const FixedHuffman table;
+    return table;
+}
+
+static uint32_t distanceSymbol(uint32_t distance) {
+    return static_cast<uint32_t>(std::upper_bound(DISTANCE_BASE, DISTANCE_BASE + 30, distance) - DISTANCE_BASE) - 1;
+}
+
+static uint32_t hash3(const uint8_t* p) {
+    uint32_t value = p[0] | (p[1] << 8) | (p[2] << 16);
+    return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+}
+
+static void zlibCompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    const FixedHuffman& huffman = fixedHuffman();
+
+    // CMFdeflate32 KB ڣFLG ʹ (CMF * 256 + FLG) Ϊ 31 ı
+    out.push_back(0x78);
+    out.push_back(0x01);
+
+    BitWriter writer(out);
+    writer.put(1, 1);   // BFINALֻһ
+    writer.put(1, 2);   // BTYPE = 01̶
+
+    auto putLiteral = [&](uint32_t symbol) {
+        writer.put(huffman.literalCode[symbol], huffman.literalBits[symbol]);
+    };
+
+    std::vector<int32_t> head(size_t(1) << DEFLATE_HASH_BITS, -1);
+    std::vector<int32_t> prev(DEFLATE_WINDOW, -1);
+    auto insert = [&](size_t position) {
+        uint32_t h = hash3(data + position);
+        prev[position & (DEFLATE_WINDOW - 1)] = head[h];
+        head[h] = static_cast<int32_t>(position);
+    };
+
+    size_t position = 0;
+    while (position < size) {
+        uint32_t bestLength = 0;
+        uint32_t bestDistance = 0;
+
+        if (position + DEFLATE_MIN_MATCH <= size) {
+            uint32_t maxLength = static_cast<uint32_t>(std::min<size_t>(DEFLATE_MAX_MATCH, size - position));
+            int32_t candidate = head[hash3(data + position)];
+            uint32_t chain = DEFLATE_MAX_CHAIN;
+            // ε prev ѱµλøǣѡλñϸݼڴ
+            while (candidate >= 0 && position - candidate <= DEFLATE_WINDOW && chain-- > 0) {
+                const uint8_t* a = data + candidate;
+                const uint8_t* b = data + position;
+                if (a[bestLength] == b[bestLength]) {
+                    uint32_t length = 0;
+                    while (length < maxLength && a[length] == b[length]) {
+                        length++;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = static_cast<uint32_t>(position - candidate);
+                        if (length == maxLength) {
+                            break;
+                        }
+                    }
+                }
+                int32_t next = prev[candidate & (DEFLATE_WINDOW - 1)];
+                if (next >= candidate) {
+                    break;
+                }
+                candidate = next;
+            }
+        }
+
+        if (bestLength >= DEFLATE_MIN_MATCH) {
+            uint32_t lengthIndex = huffman.lengthSymbol[bestLength];
+            putLiteral(257 + lengthIndex);
+            writer.put(bestLength - LENGTH_BASE[lengthIndex], LENGTH_EXTRA[lengthIndex]);
+
+            uint32_t distanceIndex = distanceSymbol(bestDistance);
+            writer.put(huffman.distanceCode[distanceIndex], 5);
+            writer.put(bestDistance - DISTANCE_BASE[distanceIndex], DISTANCE_EXTRA[distanceIndex]);
+
+            size_t end = position + bestLength;
+            for (; position < end; position++) {
+                if (position + DEFLATE_MIN_MATCH <= size) {
+                    insert(position);
+                }
+            }
+        }
+        else {
+            putLiteral(data[position]);
+            if (position + DEFLATE_MIN_MATCH <= size) {
+                insert(position);
+            }
+            position++;
+        }
+    }
+
+    putLiteral(256);    // 
+    writer.flush();
+    putBigEndian32(out, adler32(data, size));
+}
+
+// ---------------------------------------------------------------------------
+// PNG
+
+uint8_t paethPredictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return static_cast<uint8_t>(a);
+    }
+    return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// ÿ 5 ֹ˷ʽѡֵֵ֮Сһ֣libpng ʽ
+static void filterPngRows(const uint8_t* pixels, uint32_t width, uint32_t height, std::vector<uint8_t>& filtered) {
+    const size_t BPP = 4;
+    size_t rowBytes = size_t(width) * BPP;
+    filtered.resize((rowBytes + 1) * height);
+
+    std::vector<uint8_t> candidates[5];
+    for (std::vector<uint8_t>& candidate : candidates) {
+        candidate.resize(rowBytes);
+    }
+    std::vector<uint8_t> zeroRow(rowBytes, 0);
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = pixels + y * rowBytes;
+        const uint8_t* up = y > 0 ? row - rowBytes : zeroRow.data();
+
+        uint64_t bestCost = UINT64_MAX;
+        uint32_t bestFilter = 0;
+        for (uint32_t filter = 0; filter < 5; filter++) {
+            uint8_t* out = candidates[filter].data();
+            uint64_t cost = 0;
+            for (size_t i = 0; i < rowBytes; i++) {
+                int a = i >= BPP ? row[i - BPP] : 0;
+                int b = up[i];
+                int c = i >= BPP ? up[i - BPP] : 0;
+                uint8_t predicted = 0;
+                switch (filter) {
+                case 1: predicted = static_cast<uint8_t>(a); break;
+                case 2: predicted = static_cast<uint8_t>(b); break;
+                case 3: predicted = static_cast<uint8_t>((a + b) / 2); break;
+                case 4: predicted = paethPredictor(a, b, c); break;
+                }
+                out[i] = static_cast<uint8_t>(row[i] - predicted);
+                cost += std::abs(static_cast<int8_t>(out[i]));
+            }
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestFilter = filter;
+            }
+        }
+
+        uint8_t* dst = filtered.data() + y * (rowBytes + 1);
+        dst[0] = static_cast<uint8_t>(bestFilter);
+        memcpy(dst + 1, candidates[bestFilter].data(), rowBytes);
+    }
+}
+
+static void putPngChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t size) {
+    putBigEndian32(out, static_cast<uint32_t>(size));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+    putBigEndian32(out, crc32(out.data() + start, size + 4));
+}
+
+void encodePng(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& out) {
+    static const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.insert(out.end(), SIGNATURE, SIGNATURE + 8);
+
+    std::vector<uint8_t> header;
+    putBigEndian32(header, width);
+    putBigEndian32(header, height);
+    header.push_back(8);    // λ
+    header.push_back(6);    // RGBA
+    header.push_back(0);    // deflate
+    header.push_back(0);    // Ӧ
+    header.push_back(0);    // 
+    putPngChunk(out, "IHDR", header.data(), header.size());
+
+    if (srgb) {
+        const uint8_t intent = 0;   // ֪
+        putPngChunk(out, "sRGB", &intent, 1);
+    }
+
+    std::vector<uint8_t> filtered;
+    filterPngRows(pixels, width, height, filtered);
+    std::vector<uint8_t> compressed;
+    compressed.reserve(filtered.size() / 2);
+    zlibCompress(filtered.data(), filtered.size(), compressed);
+    putPngChunk(out, "IDAT", compressed.data(), compressed.size());
+
+    putPngChunk(out, "IEND", nullptr, 0);
+}
+
+// ---------------------------------------------------------------------------
+// OpenEXRɨļѹÿһУͨABGR
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t biased = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (biased == 0xFF) {
+        return static_cast<uint16_t>(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+    }
+
+    int32_t exponent = static_cast<int32_t>(biased) - 127 + 15;
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+
+    // Ϊǹλƣ뵽ż
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // βλʱȻָϣֵλõ
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return static_cast<uint16_t>(half);
+}
+
+static float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static void putLittleEndian(std::vector<uint8_t>& out, const void* value, size_t size) {
+    // ֻСƽ̨ϱ루x86 / ARMֱӰڴ沼д
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+static void putExrAttribute(std::vector<uint8_t>& out, const char* name, const char* type, const void* data, uint32_t size) {
+    out.insert(out.end(), name, name + strlen(name) + 1);
+    out.insert(out.end(), type, type + strlen(type) + 1);
+    putLittleEndian(out, &size, sizeof(size));
+    putLittleEndian(out, data, size);
+}
+
+void encodeExr(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& out) {
+    // 8 λֻ 256 ȡֵԤת
+    uint16_t colorToHalf[256];
+    uint16_t alphaToHalf[256];
+    for (uint32_t i = 0; i < 256; i++) {
+        float value = i / 255.0f;
+        colorToHalf[i] = floatToHalf(srgb ? srgbToLinear(value) : value);
+        alphaToHalf[i] = floatToHalf(value);
+    }
+
+    const uint32_t magic = 20000630;
+    const uint32_t version = 2;     // ɨߣޱ־λ
+    putLittleEndian(out, &magic, sizeof(magic));
+    putLittleEndian(out, &version, sizeof(version));
+
+    // chlistơͣ1 = HALFpLinear3 ֽڱx/y Կƽ
+    std::vector<uint8_t> channels;
+    for (const char* name : { "A", "B", "G", "R" }) {
+        channels.push_back(static_cast<uint8_t>(name[0]));
+        channels.push_back(0);
+        const int32_t pixelType = 1;
+        const int32_t sampling = 1;
+        putLittleEndian(channels, &pixelType, sizeof(pixelType));
+        channels.insert(channels.end(), 4, 0);
+        putLittleEndian(channels, &sampling, sizeof(sampling));
+        putLittleEndian(channels, &sampling, sizeof(sampling));
+    }
+    channels.push_back(0);
+
+    const uint8_t compression = 0;
+    const int32_t window[4] = { 0, 0, static_cast<int32_t>(width) - 1, static_cast<int32_t>(height) - 1 };
+    const uint8_t lineOrder = 0;    // ϵ
+    const float pixelAspectRatio = 1.0f;
+    const float screenWindowCenter[2] = { 0.0f, 0.0f };
+    const float screenWindowWidth = 1.0f;
+
+    putExrAttribute(out, "channels", "chlist", channels.data(), static_cast<uint32_t>(channels.size()));
+    putExrAttribute(out, "compression", "compression", &compression, sizeof(compression));
+    putExrAttribute(out, "dataWindow", "box2i", window, sizeof(window));
+    putExrAttribute(out, "displayWindow", "box2i", window, sizeof(window));
+    putExrAttribute(out, "lineOrder", "lineOrder", &lineOrder, sizeof(lineOrder));
+    putExrAttribute(out, "pixelAspectRatio", "float", &pixelAspectRatio, sizeof(pixelAspectRatio));
+    putExrAttribute(out, "screenWindowCenter", "v2f", screenWindowCenter, sizeof(screenWindowCenter));
+    putExrAttribute(out, "screenWindowWidth", "float", &screenWindowWidth, sizeof(screenWindowWidth));
+    out.push_back(0);
+
+    // ƫƱ֮ÿһ飺yֽͨһ
+    uint32_t lineBytes = width * 4 * sizeof(uint16_t);
+    uint64_t blockOffset = out.size() + uint64_t(height) * sizeof(uint64_t);
+    for (uint32_t y = 0; y < height; y++) {
+        putLittleEndian(out, &blockOffset, sizeof(blockOffset));
+        blockOffset += 8 + lineBytes;
+    }
+
+    // ļеĿ鲻֤ 2 ֽڶ룬ڶʱת帴
+    std::vector<uint16_t> channelRows(size_t(width) * 4);
+    size_t start = out.size();
+    out.resize(start + size_t(height) * (8 + lineBytes));
+    uint8_t* block = out.data() + start;
+    for (uint32_t y = 0; y < height; y++) {
+        int32_t line = static_cast<int32_t>(y);
+        memcpy(block, &line, 4);
+        memcpy(block + 4, &lineBytes, 4);
+
+        uint16_t* a = channelRows.data();
+        uint16_t* b = a + width;
+        uint16_t* g = b + width;
+        uint16_t* r = g + width;
+        const uint8_t* row = pixels + size_t(y) * width * 4;
+        for (uint32_t x = 0; x < width; x++) {
+            r[x] = colorToHalf[row[x * 4 + 0]];
+            g[x] = colorToHalf[row[x * 4 + 1]];
+            b[x] = colorToHalf[row[x * 4 + 2]];
+            a[x] = alphaToHalf[row[x * 4 + 3]];
+        }
+        memcpy(block + 8, channelRows.data(), lineBytes);
+        block += 8 + lineBytes;
+    }
+}
+
+uint64_t writeImageFile(const std::string& path, ImageFileFormat format, const uint8_t* pixels,
+    uint32_t width, uint32_t height, bool srgb) {
+    std::vector<uint8_t> encoded;
+    const uint8_t* data = pixels;
+    size_t size = size_t(width) * height * 4;
+
+    if (format == ImageFileFormat::Png) {
+        encodePng(pixels, width, height, srgb, encoded);
+    }
+    else if (format == ImageFileFormat::Exr) {
+        encodeExr(pixels, width, height, srgb, encoded);
+    }
+    if (format != ImageFileFormat::Raw) {
+        data = encoded.data();
+        size = encoded.size();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return 0;
+    }
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    file.close();
+    return file ? size : 0;
+}
+
+// ---------------------------------------------------------------------------
+// ػغͱ߳
+
+static void encodeThreadMain(FrameReadback* readback) {
+    std::vector<uint8_t> swizzled;
+
+    for (;;) {
+        uint32_t slotIndex;
+        {
+            std::unique_lock<std::mutex> lock(readback->mutex);
+            readback->encodeAvailable.wait(lock, [readback] { return readback->stopping || !readback->encodeQueue.empty(); });
+            // ֹͣǰдѾ֡
+            if (readback->encodeQueue.empty()) {
+                return;
+            }
+            slotIndex = readback->encodeQueue.front();
+            readback->encodeQueue.pop_front();
+        }
+
+        // λ Encoding ״̬Ⱦ̲߳Ķ
+        const ReadbackSlot& slot = readback->slots[slotIndex];
+        auto start = std::chrono::high_resolution_clock::now();
+
+        uint32_t width = slot.extent.width;
+        uint32_t height = slot.extent.height;
+        const uint8_t* pixels = static_cast<const uint8_t*>(slot.buffer.mapped);
+        if (isBgraFormat(slot.format)) {
+            swizzled.resize(size_t(width) * height * 4);
+            for (size_t i = 0; i < swizzled.size(); i += 4) {
+                swizzled[i + 0] = pixels[i + 2];
+                swizzled[i + 1] = pixels[i + 1];
+                swizzled[i + 2] = pixels[i + 0];
+                swizzled[i + 3] = pixels[i + 3];
+            }
+            pixels = swizzled.data();
+        }
+
+        char name[64];
+        if (readback->format == ImageFileFormat::Raw) {
+            snprintf(name, sizeof(name), "frame_%06llu_%ux%u.%s", static_cast<unsigned long long>(slot.frameNumber),
+                width, height, imageFileExtension(readback->format));
+        }
+        else {
+            snprintf(name, sizeof(name), "frame_%06llu.%s", static_cast<unsigned long long>(slot.frameNumber),
+                imageFileExtension(readback->format));
+        }
+        std::string path = (std::filesystem::path(readback->directory) / name).string();
+        uint64_t bytes = writeImageFile(path, readback->format, pixels, width, height, isSrgbFormat(slot.format));
+
+        auto end = std::chrono::high_resolution_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(readback->mutex);
+            ReadbackStats& stats = readback->stats;
+            if (bytes != 0) {
+                stats.written++;
+                stats.bytesWritten += bytes;
+            }
+            else {
+                stats.failed++;
+                std::cerr << "Readback: failed to write " << path << std::endl;
+            }
+            stats.encodeMs += std::chrono::duration<double, std::milli>(end - start).count();
+            stats.lastWrite = end;
+            readback->slots[slotIndex].state = ReadbackSlotState::Free;
+        }
+        readback->slotFreed.notify_all();
+    }
+}
+
+void createFrameReadback(FrameReadback& readback, const std::string& directory, ImageFileFormat format,
+    uint32_t interval, uint32_t slotCount, uint32_t workerCount, bool waitForSlot) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        throw std::runtime_error("failed to create capture directory " + directory + "!");
+    }
+
+    readback.directory = directory;
+    readback.format = format;
+    readback.interval = std::max(interval, 1u);
+    readback.waitForSlot = waitForSlot;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    readback.atomSize = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+
+    // ػ CPU ˳ȡ HOST_CACHEDδڴһ
+    const VkMemoryPropertyFlags cached = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    readback.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    for (uint32_t i = 0; i < gpuAllocator.memoryProperties.memoryTypeCount; i++) {
+        if ((gpuAllocator.memoryProperties.memoryTypes[i].propertyFlags & cached) == cached) {
+            readback.memoryProperties = cached;
+            break;
+        }
+    }
+
+    // ¼ʱ໹ MAX_FRAMES_IN_FLIGHT - 1 λڵȴ fenceٶһŲڵȴʱ
+    readback.slots.resize(std::max(slotCount, MAX_FRAMES_IN_FLIGHT));
+    readback.stopping = false;
+    readback.stats = ReadbackStats();
+    for (uint32_t i = 0; i < std::max(workerCount, 1u); i++) {
+        readback.workers.emplace_back(encodeThreadMain, &readback);
+    }
+    readback.enabled = true;
+}
+
+void destroyFrameReadback(FrameReadback& readback) {
+    {
+        std::lock_guard<std::mutex> lock(readback.mutex);
+        readback.stopping = true;
+    }
+    readback.encodeAvailable.notify_all();
+    for (std::thread& worker : readback.workers) {
+        worker.join();
+    }
+
+    for (ReadbackSlot& slot : readback.slots) {
+        destroyBuffer(slot.buffer);
+    }
+
+    readback.workers.clear();
+    readback.slots.clear();
+    readback.encodeQueue.clear();
+    readback.enabled = false;
+}
+
+static uint32_t findFreeSlot(const FrameReadback& readback) {
+    for (uint32_t i = 0; i < readback.slots.size(); i++) {
+        if (readback.slots[i].state == ReadbackSlotState::Free) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+static bool hasEncodingSlot(const FrameReadback& readback) {
+    for (const ReadbackSlot& slot : readback.slots) {
+        if (slot.state == ReadbackSlotState::Encoding) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ֡ fence Ⱦ߳ϵãɼ߳
+static void handOffReadbackSlot(FrameReadback& readback, uint32_t slotIndex) {
+    ReadbackSlot& slot = readback.slots[slotIndex];
+
+    if (!slot.coherent) {
+        // ƫƺʹС 2 ҲС 256ԭӴСȡ󲻻ᳬ
+        VkMappedMemoryRange range = {};
+        range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = slot.buffer.allocation.memory;
+        range.offset = slot.buffer.allocation.offset;
+        range.size = slot.buffer.allocation.page == nullptr ? VK_WHOLE_SIZE
+            : (slot.buffer.allocation.size + readback.atomSize - 1) / readback.atomSize * readback.atomSize;
+        vkInvalidateMappedMemoryRanges(device, 1, &range);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(readback.mutex);
+        slot.state = ReadbackSlotState::Encoding;
+        readback.encodeQueue.push_back(slotIndex);
+    }
+    readback.encodeAvailable.notify_one();
+}
+
+bool recordFrameReadback(FrameReadback& readback, ResourceRegistry& registry, VkCommandBuffer commandBuffer,
+    VkImage image, VkFormat format, VkExtent2D extent, uint64_t frameNumber) {
+    if (frameNumber % readback.interval != 0) {
+        return false;
+    }
+    if (!isReadbackFormatSupported(format)) {
+        throw std::runtime_error("unsupported readback format!");
+    }
+
+    uint32_t slotIndex;
+    {
+        std::unique_lock<std::mutex> lock(readback.mutex);
+        slotIndex = findFreeSlot(readback);
+
+        // ֻбеĲλﱻ黹඼ڵ fence ʱȴû
+        if (slotIndex == UINT32_MAX && readback.waitForSlot && hasEncodingSlot(readback)) {
+            auto waitStart = std::chrono::high_resolution_clock::now();
+            readback.slotFreed.wait(lock, [&readback, &slotIndex] {
+                slotIndex = findFreeSlot(readback);
+                return slotIndex != UINT32_MAX || !hasEncodingSlot(readback);
+            });
+            readback.stats.slotWaits++;
+            readback.stats.waitMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - waitStart).count();
+        }
+
+        if (slotIndex == UINT32_MAX) {
+            readback.stats.dropped++;
+            return false;
+        }
+
+        readback.slots[slotIndex].state = ReadbackSlotState::Copying;
+        if (readback.stats.captured == 0) {
+            readback.stats.firstCapture = std::chrono::high_resolution_clock::now();
+        }
+        readback.stats.captured++;
+    }
+
+    ReadbackSlot& slot = readback.slots[slotIndex];
+    slot.frameNumber = frameNumber;
+    slot.extent = extent;
+    slot.format = format;
+
+    // 尴Ҫߴ紴λʱ GPU ͱ̶߳ʹþɻ壬ֱؽ
+    VkDeviceSize size = VkDeviceSize(extent.width) * extent.height * 4;
+    if (slot.buffer.size < size) {
+        destroyBuffer(slot.buffer);
+        createBuffer(slot.buffer, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, readback.memoryProperties);
+        VkMemoryPropertyFlags flags = gpuAllocator.memoryProperties.memoryTypes[slot.buffer.allocation.memoryType].propertyFlags;
+        slot.coherent = (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    }
+
+    VkBufferImageCopy region = {};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { extent.width, extent.height, 1 };
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer.buffer, 1, &region);
+
+    // fence ֻ֤豸ϵдɣȡҪ
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = slot.buffer.buffer;
+    barrier.offset = 0;
+    barrier.size = size;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+        0, nullptr, 1, &barrier, 0, nullptr);
+
+    FrameReadback* owner = &readback;
+    deferRegistryRelease(registry, [owner, slotIndex]() {
+        handOffReadbackSlot(*owner, slotIndex);
+    });
+    return true;
+}
+
+void flushFrameReadback(FrameReadback& readback) {
+    std::unique_lock<std::mutex> lock(readback.mutex);
+    readback.slotFreed.wait(lock, [&readback] { return !hasEncodingSlot(readback); });
+}
+
+void printReadbackStats(FrameReadback& readback) {
+    std::lock_guard<std::mutex> lock(readback.mutex);
+    const ReadbackStats& stats = readback.stats;
+
+    double seconds = stats.written > 0 ? std::chrono::duration<double>(stats.lastWrite - stats.firstCapture).count() : 0.0;
+    double megabytes = stats.bytesWritten / (1024.0 * 1024.0);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Readback: " << stats.written << " " << imageFileExtension(readback.format) << " frames written to "
+        << readback.directory << " (" << stats.dropped << " dropped, " << stats.failed << " failed), "
+        << readback.slots.size() << " buffers, " << readback.workers.size() << " encode threads" << std::endl;
+    if (seconds > 0.0) {
+        std::cout << "  sustained " << stats.written / seconds << " frames/s, " << megabytes / seconds << " MB/s to disk over "
+            << seconds << " s" << std::endl;
+    }
+    if (stats.written + stats.failed > 0) {
+        std::cout << "  encode " << stats.encodeMs / (stats.written + stats.failed) << " ms/frame, "
+            << megabytes / std::max<uint64_t>(stats.written, 1) << " MB/frame" << std::endl;
+    }
+    if (stats.slotWaits > 0) {
+        std::cout << "  render thread waited " << stats.slotWaits << " times (" << stats.waitMs << " ms) for a free buffer" << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Upload.h"
+
+struct ResourceRegistry;
+
+// ֡غͼеȾһ־ӳ壬֡ fence Ẓ̌߳
+// ̲߳д PNG / EXR / ԭʼļûплʱĬ϶һ֡Ķأ
+// Ⱦ̺߳ GPU ȴ
+
+enum class ImageFileFormat {
+    Png,    // 8 λ RGBAdeflate ѹ̶ + LZ77sRGB Ŀд sRGB 
+    Exr,    // 뾫 RGBAѹɨߣsRGB ĿȽΪ
+    Raw,    // 8 λ RGBA ԭʼأļϿ
+};
+
+bool parseImageFileFormat(const std::string& name, ImageFileFormat& format);
+const char* imageFileExtension(ImageFileFormat format);
+
+// ֶ֧صɫʽR8G8B8A8 / B8G8R8A8  UNORM  SRGB
+bool isReadbackFormatSupported(VkFormat format);
+
+enum class ReadbackSlotState {
+    Free,
+    Copying,    // ¼ƣȴ֡ fence
+    Encoding,   // ѽ̣߳Ŷӻдļ
+};
+
+struct ReadbackSlot {
+    GpuBuffer buffer;
+    bool coherent = true;           //  HOST_COHERENT ʱȡǰҪʹʧЧ
+    ReadbackSlotState state = ReadbackSlotState::Free;
+    uint64_t frameNumber = 0;
+    VkExtent2D extent = {};
+    VkFormat format = VK_FORMAT_UNDEFINED;
+};
+
+struct ReadbackStats {
+    uint64_t captured = 0;          // ¼˿֡
+    uint64_t dropped = 0;           // ûплص֡
+    uint64_t written = 0;
+    uint64_t failed = 0;            // ļдʧ
+    uint64_t bytesWritten = 0;
+    uint64_t slotWaits = 0;         // waitForSlot ʱȾ̵߳ȴлĴ
+    double waitMs = 0.0;            // Ⱦ̵߳ȴлʱ
+    double encodeMs = 0.0;          // ߳תѹдļʱ
+    std::chrono::high_resolution_clock::time_point firstCapture;
+    std::chrono::high_resolution_clock::time_point lastWrite;
+};
+
+struct FrameReadback {
+    bool enabled = false;
+    std::string directory;
+    ImageFileFormat format = ImageFileFormat::Png;
+    uint32_t interval = 1;          // ÿ֡һ
+    bool waitForSlot = false;       // ûплʱȴ̣߳֡ GPU ˿У
+    VkMemoryPropertyFlags memoryProperties = 0;
+    VkDeviceSize atomSize = 1;      // nonCoherentAtomSize
+
+    std::vector<ReadbackSlot> slots;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;               // ³ԱԼλ state
+    std::condition_variable encodeAvailable;
+    std::condition_variable slotFreed;
+    std::deque<uint32_t> encodeQueue;
+    bool stopping = false;
+    ReadbackStats stats;
+};
+
+// slotCount ػ壨һʹʱ֡С֡ʱؽworkerCount ̡߳
+// Ŀ¼ʱʧʱ׳쳣
+void createFrameReadback(FrameReadback& readback, const std::string& directory, ImageFileFormat format,
+    uint32_t interval, uint32_t slotCount, uint32_t workerCount, bool waitForSlot);
+
+// ȴѽ֡д겢ٻ塣ڵǼǵĽӶִУflushRegistryDeletions  destroyResourceRegistry֮
+void destroyFrameReadback(FrameReadback& readback);
+
+// ֡ĩβ¼ imageTRANSFER_SRC_OPTIMAL֮ǰдѶԴȡɼлĿ
+// Ǽǵעĵǰ֡λϣfence 󽻸̡߳ڶؼϻ򱻶ʱ false
+bool recordFrameReadback(FrameReadback& readback, ResourceRegistry& registry, VkCommandBuffer commandBuffer,
+    VkImage image, VkFormat format, VkExtent2D extent, uint64_t frameNumber);
+
+// ȴѽ֡ȫд꣨Ӱ֮أ
+void flushFrameReadback(FrameReadback& readback);
+
+// д֡ͳÿ֡ / ֽӵһζصһļд꣩
+void printReadbackStats(FrameReadback& readback);
+
+// 뺯pixels Ϊе 8 λ RGBA׷ӵ out
+void encodePng(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& out);
+void encodeExr(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& out);
+
+// ʽ벢д pathдֽʧʱ 0
+uint64_t writeImageFile(const std::string& path, ImageFileFormat format, const uint8_t* pixels,
+    uint32_t width, uint32_t height, bool srgb);
+
+// õУͣPNG  CRC-32  zlib  Adler-32crc Ϊ֮ǰεĽ
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0);
+uint32_t adler32(const uint8_t* data, size_t size);
+
+// PNG ˷ʽ 4 Ԥֵa / b / c Ϊϡϵֽ
+uint8_t paethPredictor(int a, int b, int c);
+
+// 뵽żΪ󣬹СֵΪǹ 0
+uint16_t floatToHalf(float value);
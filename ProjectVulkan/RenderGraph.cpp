@@ -0,0 +1,626 @@
+#include "RenderGraph.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+static const VkAccessFlags WRITE_ACCESS = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+    | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+// һʹöӦͬ״̬
+struct UsageInfo {
+    VkPipelineStageFlags stages;
+    VkAccessFlags access;
+    VkImageLayout layout;
+    VkImageUsageFlags imageUsage;
+    bool write;
+    bool reads;             // ֮ǰݣֻдʹԴ
+};
+
+static UsageInfo getUsageInfo(RGUsage usage) {
+    switch (usage) {
+    case RGUsage::ColorAttachment:
+        return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true, true };
+    case RGUsage::DepthAttachment:
+        return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, true, true };
+    case RGUsage::SampledRead:
+        return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, false, true };
+    case RGUsage::StorageRead:
+        return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, false, true };
+    case RGUsage::StorageWrite:
+        return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, true, true };
+    case RGUsage::TransferRead:
+        return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false, true };
+    case RGUsage::TransferWrite:
+        return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, true, false };
+    case RGUsage::IndirectRead:
+    default:
+        return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+            VK_IMAGE_LAYOUT_UNDEFINED, 0, false, true };
+    }
+}
+
+static bool isDepthFormat(VkFormat format) {
+    return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT
+        || format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+static VkImageAspectFlags getAspect(VkFormat format) {
+    if (format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT) {
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    return isDepthFormat(format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+}
+
+RGResourceHandle importImage(RenderGraph& graph, const std::string& name, VkImage image, VkFormat format,
+    const RGState& initialState, const RGState& finalState) {
+    RGResource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.exported = finalState.layout != VK_IMAGE_LAYOUT_UNDEFINED;
+    resource.image = image;
+    resource.desc.format = format;
+    resource.initialState = initialState;
+    resource.finalState = finalState;
+    graph.resources.push_back(resource);
+    return static_cast<RGResourceHandle>(graph.resources.size() - 1);
+}
+
+RGResourceHandle importBuffer(RenderGraph& graph, const std::string& name, VkBuffer buffer, bool persistent) {
+    RGResource resource;
+    resource.name = name;
+    resource.isImage = false;
+    resource.imported = true;
+    resource.persistent = persistent;
+    resource.buffer = buffer;
+    graph.resources.push_back(resource);
+    return static_cast<RGResourceHandle>(graph.resources.size() - 1);
+}
+
+RGResourceHandle createTransientImage(RenderGraph& graph, const std::string& name, const RGImageDesc& desc) {
+    RGResource resource;
+    resource.name = name;
+    resource.desc = desc;
+    graph.resources.push_back(resource);
+    return static_cast<RGResourceHandle>(graph.resources.size() - 1);
+}
+
+void setImportedImage(RenderGraph& graph, RGResourceHandle resource, VkImage image) {
+    graph.resources[resource].image = image;
+}
+
+uint32_t addPass(RenderGraph& graph, const std::string& name, std::function<void(VkCommandBuffer)> record) {
+    if (graph.compiled) {
+        throw std::runtime_error("cannot add pass " + name + " to a compiled render graph!");
+    }
+    RGPass pass;
+    pass.name = name;
+    pass.record = std::move(record);
+    graph.passes.push_back(std::move(pass));
+    return static_cast<uint32_t>(graph.passes.size() - 1);
+}
+
+void useResource(RenderGraph& graph, uint32_t pass, RGResourceHandle resource, RGUsage usage) {
+    const RGResource& target = graph.resources[resource];
+    bool imageOnly = usage == RGUsage::ColorAttachment || usage == RGUsage::DepthAttachment || usage == RGUsage::SampledRead;
+    if ((imageOnly && !target.isImage) || (usage == RGUsage::IndirectRead && target.isImage)) {
+        throw std::runtime_error("pass " + graph.passes[pass].name + " uses " + target.name + " in an unsupported way!");
+    }
+    graph.passes[pass].uses.push_back({ resource, usage });
+}
+
+void setPassSideEffects(RenderGraph& graph, uint32_t pass) {
+    graph.passes[pass].sideEffects = true;
+}
+
+// Ӻǰиûд֮ᱻ򵼳ԴͨҪִУԴ֮ΪҪ
+// ͨǣTransferWriteԴ֮ǰд붼Ҫ
+static void cullPasses(RenderGraph& graph) {
+    std::vector<bool> needed(graph.resources.size(), false);
+    for (size_t i = 0; i < graph.resources.size(); i++) {
+        needed[i] = graph.resources[i].exported;
+    }
+
+    for (size_t p = graph.passes.size(); p-- > 0;) {
+        RGPass& pass = graph.passes[p];
+        bool live = pass.sideEffects;
+        for (const RGUse& use : pass.uses) {
+            if (getUsageInfo(use.usage).write && needed[use.resource]) {
+                live = true;
+            }
+        }
+        pass.culled = !live;
+        if (!live) {
+            continue;
+        }
+
+        for (const RGUse& use : pass.uses) {
+            if (getUsageInfo(use.usage).write) {
+                needed[use.resource] = false;
+            }
+        }
+        for (const RGUse& use : pass.uses) {
+            if (getUsageInfo(use.usage).reads) {
+                needed[use.resource] = true;
+            }
+        }
+    }
+}
+
+static void computeLifetimes(RenderGraph& graph) {
+    for (uint32_t p = 0; p < graph.passes.size(); p++) {
+        const RGPass& pass = graph.passes[p];
+        if (pass.culled) {
+            continue;
+        }
+        for (const RGUse& use : pass.uses) {
+            RGResource& resource = graph.resources[use.resource];
+            resource.firstPass = std::min(resource.firstPass, p);
+            resource.lastPass = std::max(resource.lastPass, p);
+            resource.usage |= getUsageInfo(use.usage).imageUsage;
+        }
+    }
+}
+
+static void queryTransientRequirements(RenderGraph& graph, const RGRequirementsFn& getRequirements) {
+    for (RGResource& resource : graph.resources) {
+        if (resource.imported || resource.firstPass == UINT32_MAX) {
+            continue;
+        }
+        resource.requirements = getRequirements(resource);
+    }
+}
+
+// compileRenderGraph  getRequirementsͼ񲢷ʵʵڴ
+static VkMemoryRequirements createResourceImage(RGResource& resource) {
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = resource.desc.format;
+    imageInfo.extent = { resource.desc.extent.width, resource.desc.extent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = resource.usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create transient image " + resource.name + "!");
+    }
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device, resource.image, &requirements);
+    return requirements;
+}
+
+static bool memoryOverlaps(const RGResource& a, VkDeviceSize offset, VkDeviceSize size) {
+    return offset < a.memoryOffset + a.requirements.size && a.memoryOffset < offset + size;
+}
+
+// СӴСãÿͼڲκصѷͼͻƫƴ
+static void placeTransientImages(RenderGraph& graph) {
+    std::vector<RGResourceHandle> order;
+    for (RGResourceHandle i = 0; i < graph.resources.size(); i++) {
+        if (!graph.resources[i].imported && graph.resources[i].firstPass != UINT32_MAX) {
+            order.push_back(i);
+        }
+    }
+    if (order.empty()) {
+        return;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](RGResourceHandle a, RGResourceHandle b) {
+        return graph.resources[a].requirements.size > graph.resources[b].requirements.size;
+    });
+
+    VkMemoryRequirements total = {};
+    total.alignment = 1;
+    total.memoryTypeBits = UINT32_MAX;
+    std::vector<RGResourceHandle> placed;
+    for (RGResourceHandle handle : order) {
+        RGResource& resource = graph.resources[handle];
+        const VkMemoryRequirements& requirements = resource.requirements;
+
+        // ѡƫƣ0 ÿѷͼĩβ
+        std::vector<VkDeviceSize> candidates = { 0 };
+        for (RGResourceHandle other : placed) {
+            const RGResource& o = graph.resources[other];
+            VkDeviceSize end = o.memoryOffset + o.requirements.size;
+            candidates.push_back((end + requirements.alignment - 1) / requirements.alignment * requirements.alignment);
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (VkDeviceSize offset : candidates) {
+            bool fits = true;
+            for (RGResourceHandle other : placed) {
+                const RGResource& o = graph.resources[other];
+                bool lifetimeOverlaps = resource.firstPass <= o.lastPass && o.firstPass <= resource.lastPass;
+                if (lifetimeOverlaps && memoryOverlaps(o, offset, requirements.size)) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) {
+                resource.memoryOffset = offset;
+                break;
+            }
+        }
+
+        // ڴͼһصȽһһǰ
+        for (RGResourceHandle other : placed) {
+            RGResource& o = graph.resources[other];
+            if (memoryOverlaps(o, resource.memoryOffset, requirements.size)) {
+                if (o.lastPass < resource.firstPass) {
+                    resource.aliases.push_back(other);
+                }
+                else {
+                    o.aliases.push_back(handle);
+                }
+            }
+        }
+        placed.push_back(handle);
+
+        total.size = std::max(total.size, resource.memoryOffset + requirements.size);
+        total.alignment = std::max(total.alignment, requirements.alignment);
+        total.memoryTypeBits &= requirements.memoryTypeBits;
+        graph.stats.transientImages++;
+        graph.stats.transientBytes += requirements.size;
+    }
+
+    if (total.memoryTypeBits == 0) {
+        throw std::runtime_error("transient images have no common memory type!");
+    }
+    graph.transientRequirements = total;
+    graph.stats.allocatedBytes = total.size;
+}
+
+static void bindTransientImages(RenderGraph& graph) {
+    if (graph.transientRequirements.size == 0) {
+        return;
+    }
+    allocateMemory(gpuAllocator, graph.transientRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal, graph.transientMemory);
+
+    for (RGResource& resource : graph.resources) {
+        if (resource.image == VK_NULL_HANDLE || resource.imported) {
+            continue;
+        }
+        vkBindImageMemory(device, resource.image, graph.transientMemory.memory, graph.transientMemory.offset + resource.memoryOffset);
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = resource.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = resource.desc.format;
+        viewInfo.subresourceRange.aspectMask = getAspect(resource.desc.format);
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(device, &viewInfo, nullptr, &resource.view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create transient image view " + resource.name + "!");
+        }
+    }
+}
+
+// Դͬ٣һд֮ĶԼһдѾЩ׶κͷʿɼ
+struct ResourceTrack {
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags writeStages = 0;
+    VkAccessFlags writeAccess = 0;
+    VkPipelineStageFlags readStages = 0;
+    VkPipelineStageFlags visibleStages = 0;
+    VkAccessFlags visibleAccess = 0;
+};
+
+static ResourceTrack trackFromState(const RGState& state) {
+    ResourceTrack track;
+    track.layout = state.layout;
+    if (state.access & WRITE_ACCESS) {
+        track.writeStages = state.stages;
+        track.writeAccess = state.access & WRITE_ACCESS;
+    }
+    else {
+        track.readStages = state.stages;
+    }
+    return track;
+}
+
+static void addImageBarrier(RGBarrierBatch& batch, const RGResource& resource, RGResourceHandle handle,
+    VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.subresourceRange.aspectMask = getAspect(resource.desc.format);
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    batch.imageBarriers.push_back(barrier);
+    batch.images.push_back(handle);
+}
+
+// һͨһԴģϲģʹãҪʱϼ batch¸״̬
+static void applyUse(RGBarrierBatch& batch, const RGResource& resource, RGResourceHandle handle, ResourceTrack& track,
+    VkPipelineStageFlags stages, VkAccessFlags access, VkImageLayout layout, bool write) {
+    bool transition = resource.isImage && layout != track.layout;
+
+    if (transition || write) {
+        // תдҪ֮ǰзʽдֻҪִ
+        VkPipelineStageFlags srcStages = track.writeStages | track.readStages;
+        if (resource.isImage && (transition || srcStages != 0)) {
+            addImageBarrier(batch, resource, handle, track.layout, layout, track.writeAccess, access);
+            batch.srcStages |= srcStages;
+            batch.dstStages |= stages;
+        }
+        else if (!resource.isImage && srcStages != 0) {
+            batch.srcStages |= srcStages;
+            batch.dstStages |= stages;
+            if (track.writeAccess != 0) {
+                batch.srcAccess |= track.writeAccess;
+                batch.dstAccess |= access;
+            }
+        }
+
+        // תҲһд֮׶εĶҪת֮
+        track.layout = resource.isImage ? layout : VK_IMAGE_LAYOUT_UNDEFINED;
+        track.writeStages = stages;
+        track.writeAccess = write ? access & WRITE_ACCESS : 0;
+        track.readStages = write ? 0 : stages;
+        track.visibleStages = write ? 0 : stages;
+        track.visibleAccess = write ? 0 : access;
+        return;
+    }
+
+    // Ҫͬдֻд뻹ûжЩ׶οɼʱҪ
+    bool visible = (stages & ~track.visibleStages) == 0 && (access & ~track.visibleAccess) == 0;
+    if (track.writeStages != 0 && !visible) {
+        if (resource.isImage) {
+            addImageBarrier(batch, resource, handle, layout, layout, track.writeAccess, access);
+        }
+        else if (track.writeAccess != 0) {
+            batch.srcAccess |= track.writeAccess;
+            batch.dstAccess |= access;
+        }
+        batch.srcStages |= track.writeStages;
+        batch.dstStages |= stages;
+        track.visibleStages |= stages;
+        track.visibleAccess |= access;
+    }
+    track.readStages |= stages;
+}
+
+// previous Ϊһִнʱĸ״̬һģʱΪգ
+static void simulateBarriers(RenderGraph& graph, std::vector<ResourceTrack>& tracks, const std::vector<ResourceTrack>* previous) {
+    for (uint32_t p = 0; p < graph.passes.size(); p++) {
+        RGPass& pass = graph.passes[p];
+        pass.barriers = RGBarrierBatch();
+        if (pass.culled) {
+            continue;
+        }
+
+        // ͬһԴһͨеĶʹúϲһ
+        std::vector<RGResourceHandle> handled;
+        for (const RGUse& first : pass.uses) {
+            if (std::find(handled.begin(), handled.end(), first.resource) != handled.end()) {
+                continue;
+            }
+            handled.push_back(first.resource);
+
+            const RGResource& resource = graph.resources[first.resource];
+            VkPipelineStageFlags stages = 0;
+            VkAccessFlags access = 0;
+            bool write = false;
+            VkImageLayout layout = getUsageInfo(first.usage).layout;
+            for (const RGUse& use : pass.uses) {
+                if (use.resource != first.resource) {
+                    continue;
+                }
+                UsageInfo info = getUsageInfo(use.usage);
+                if (resource.isImage && info.layout != layout) {
+                    throw std::runtime_error("pass " + pass.name + " uses " + resource.name + " in two different layouts!");
+                }
+                stages |= info.stages;
+                access |= info.access;
+                write = write || info.write;
+            }
+
+            // ˲̬ͼһʹʱδ壬Ҫȴͬһڴǰν
+            ResourceTrack& track = tracks[first.resource];
+            if (!resource.imported && p == resource.firstPass) {
+                track = ResourceTrack();
+                for (RGResourceHandle alias : resource.aliases) {
+                    track.writeStages |= tracks[alias].writeStages | tracks[alias].readStages;
+                    track.writeAccess |= tracks[alias].writeAccess;
+                }
+                // ;һ֡ʹͬһ˲̬ڴ棺Ҫȴڴͼ񣨰Լ
+                if (previous != nullptr) {
+                    for (RGResourceHandle other = 0; other < graph.resources.size(); other++) {
+                        const RGResource& o = graph.resources[other];
+                        if (o.imported || o.firstPass == UINT32_MAX || !memoryOverlaps(o, resource.memoryOffset, resource.requirements.size)) {
+                            continue;
+                        }
+                        track.writeStages |= (*previous)[other].writeStages | (*previous)[other].readStages;
+                        track.writeAccess |= (*previous)[other].writeAccess;
+                    }
+                }
+            }
+            applyUse(pass.barriers, resource, first.resource, track, stages, access, layout, write);
+        }
+    }
+
+    graph.finalBarriers = RGBarrierBatch();
+    for (RGResourceHandle i = 0; i < graph.resources.size(); i++) {
+        const RGResource& resource = graph.resources[i];
+        if (!resource.exported || !resource.isImage || tracks[i].layout == resource.finalState.layout) {
+            continue;
+        }
+        ResourceTrack& track = tracks[i];
+        addImageBarrier(graph.finalBarriers, resource, i, track.layout, resource.finalState.layout, track.writeAccess, resource.finalState.access);
+        graph.finalBarriers.srcStages |= track.writeStages | track.readStages;
+        graph.finalBarriers.dstStages |= resource.finalState.stages;
+        track = trackFromState(resource.finalState);
+    }
+}
+
+static void buildBarriers(RenderGraph& graph) {
+    std::vector<ResourceTrack> tracks(graph.resources.size());
+    for (size_t i = 0; i < graph.resources.size(); i++) {
+        tracks[i] = trackFromState(graph.resources[i].initialState);
+    }
+
+    // ־Դĳʼ״̬һִнʱ״̬˲̬ͼһʹǰҪһִжͬһڴķʣ
+    // ģһõ״̬
+    bool dependsOnPrevious = false;
+    for (const RGResource& resource : graph.resources) {
+        dependsOnPrevious = dependsOnPrevious || resource.persistent || (!resource.imported && resource.firstPass != UINT32_MAX);
+    }
+    if (!dependsOnPrevious) {
+        simulateBarriers(graph, tracks, nullptr);
+        return;
+    }
+
+    std::vector<ResourceTrack> previous = tracks;
+    simulateBarriers(graph, previous, nullptr);
+    for (size_t i = 0; i < graph.resources.size(); i++) {
+        if (graph.resources[i].persistent) {
+            tracks[i] = previous[i];
+            tracks[i].visibleStages = 0;
+            tracks[i].visibleAccess = 0;
+        }
+    }
+    simulateBarriers(graph, tracks, &previous);
+}
+
+static bool isEmpty(const RGBarrierBatch& batch) {
+    return batch.srcStages == 0 && batch.imageBarriers.empty();
+}
+
+static void countBatch(RenderGraphStats& stats, const RGBarrierBatch& batch) {
+    if (isEmpty(batch)) {
+        return;
+    }
+    stats.barrierBatches++;
+    stats.imageBarriers += static_cast<uint32_t>(batch.imageBarriers.size());
+    stats.memoryBarriers += batch.srcAccess != 0 ? 1 : 0;
+}
+
+void planRenderGraph(RenderGraph& graph, const RGRequirementsFn& getRequirements) {
+    if (graph.compiled) {
+        throw std::runtime_error("render graph is already compiled!");
+    }
+
+    graph.stats = RenderGraphStats();
+    cullPasses(graph);
+    computeLifetimes(graph);
+    queryTransientRequirements(graph, getRequirements);
+    placeTransientImages(graph);
+    buildBarriers(graph);
+
+    graph.stats.passCount = static_cast<uint32_t>(graph.passes.size());
+    for (const RGPass& pass : graph.passes) {
+        graph.stats.culledPasses += pass.culled ? 1 : 0;
+        countBatch(graph.stats, pass.barriers);
+    }
+    countBatch(graph.stats, graph.finalBarriers);
+}
+
+void compileRenderGraph(RenderGraph& graph) {
+    planRenderGraph(graph, createResourceImage);
+    bindTransientImages(graph);
+    graph.compiled = true;
+}
+
+static void recordBatch(const RenderGraph& graph, RGBarrierBatch& batch, VkCommandBuffer commandBuffer) {
+    if (isEmpty(batch)) {
+        return;
+    }
+
+    for (size_t i = 0; i < batch.imageBarriers.size(); i++) {
+        batch.imageBarriers[i].image = graph.resources[batch.images[i]].image;
+    }
+
+    VkMemoryBarrier memoryBarrier = {};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = batch.srcAccess;
+    memoryBarrier.dstAccessMask = batch.dstAccess;
+
+    vkCmdPipelineBarrier(commandBuffer,
+        batch.srcStages ? batch.srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        batch.dstStages ? batch.dstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+        batch.srcAccess ? 1 : 0, &memoryBarrier, 0, nullptr,
+        static_cast<uint32_t>(batch.imageBarriers.size()), batch.imageBarriers.data());
+}
+
+void executeRenderGraph(RenderGraph& graph, VkCommandBuffer commandBuffer) {
+    if (!graph.compiled) {
+        throw std::runtime_error("render graph must be compiled before execution!");
+    }
+
+    for (RGPass& pass : graph.passes) {
+        if (pass.culled) {
+            continue;
+        }
+        recordBatch(graph, pass.barriers, commandBuffer);
+        pass.record(commandBuffer);
+    }
+    recordBatch(graph, graph.finalBarriers, commandBuffer);
+}
+
+VkImageView getRenderGraphImageView(const RenderGraph& graph, RGResourceHandle resource) {
+    return graph.resources[resource].view;
+}
+
+void destroyRenderGraph(RenderGraph& graph) {
+    for (RGResource& resource : graph.resources) {
+        if (resource.imported) {
+            continue;
+        }
+        if (resource.view != VK_NULL_HANDLE) {
+            vkDestroyImageView(device, resource.view, nullptr);
+        }
+        if (resource.image != VK_NULL_HANDLE) {
+            vkDestroyImage(device, resource.image, nullptr);
+        }
+    }
+    if (graph.transientMemory.memory != VK_NULL_HANDLE) {
+        freeMemory(gpuAllocator, graph.transientMemory);
+    }
+
+    graph = RenderGraph();
+}
+
+void printRenderGraph(const RenderGraph& graph) {
+    const RenderGraphStats& stats = graph.stats;
+    std::cout << "Render graph: " << stats.passCount << " passes (" << stats.culledPasses << " culled), "
+        << stats.barrierBatches << " barrier batches (" << stats.imageBarriers << " image, " << stats.memoryBarriers << " memory)";
+    if (stats.transientImages > 0) {
+        std::cout << std::fixed << std::setprecision(2) << ", " << stats.transientImages << " transient images "
+            << stats.transientBytes / (1024.0 * 1024.0) << " MB -> " << stats.allocatedBytes / (1024.0 * 1024.0) << " MB"
+            << std::defaultfloat;
+    }
+    std::cout << std::endl;
+
+    for (const RGPass& pass : graph.passes) {
+        std::cout << "  " << (pass.culled ? "(culled) " : "") << pass.name;
+        if (!pass.culled && !isEmpty(pass.barriers)) {
+            std::cout << " <- " << pass.barriers.imageBarriers.size() << " image barriers";
+            if (pass.barriers.srcAccess != 0) {
+                std::cout << " + memory barrier";
+            }
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MemoryAllocator.h"
+
+// ȾͼͨдԴʱ޳ûбʹõͨٵϺͲת
+// ڲص˲̬ͼڴ档¼ʱͨ˳ϲͨ¼ƺ
+// ͼһΡִжΣ;֡ͬһ˲̬ڴ棬˲̬ͼһʹǰȴһִжڴķʣ
+// ˲̬ͼ destroyRenderGraphGPU кʱ
+
+typedef uint32_t RGResourceHandle;
+const RGResourceHandle INVALID_RG_RESOURCE = UINT32_MAX;
+
+// Դһʹ÷ʽͬĽ׶Ρͺͼ񲼾
+enum class RGUsage {
+    ColorAttachment,        // ɫдȾͨ initialLayout/finalLayout ӦΪ COLOR_ATTACHMENT_OPTIMAL
+    DepthAttachment,        // ȸд
+    SampledRead,            // Ƭɫ
+    StorageRead,            // ɫ
+    StorageWrite,           // ɫд
+    TransferRead,
+    TransferWrite,          // Դ֮ǰд޳
+    IndirectRead,           // ӻƲʵݣ룩
+};
+
+// Դĳһʱ̵ͬ״̬
+struct RGState {
+    VkPipelineStageFlags stages = 0;
+    VkAccessFlags access = 0;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+struct RGImageDesc {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {};
+};
+
+struct RGResource {
+    std::string name;
+    bool isImage = true;
+    bool imported = false;
+    bool persistent = false;    // Դÿ֡ͬһͼʹãʼ״̬ȡͼһʹú״̬
+    bool exported = false;      // ͼִԱʹã֣дͨᱻ޳
+    VkImage image = VK_NULL_HANDLE;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    RGImageDesc desc;           // ˲̬ͼ
+    RGState initialState;       // Դͼʼʱ״̬
+    RGState finalState;         // ͼִнʱתĲֺ֮ʹý׶
+
+    // 
+    VkImageUsageFlags usage = 0;
+    VkImageView view = VK_NULL_HANDLE;
+    uint32_t firstPass = UINT32_MAX;
+    uint32_t lastPass = 0;
+    VkMemoryRequirements requirements = {};
+    VkDeviceSize memoryOffset = 0;          // ˲̬ڴеƫ
+    std::vector<RGResourceHandle> aliases;  // ֮ڴ桢֮ǰԴ
+};
+
+struct RGUse {
+    RGResourceHandle resource;
+    RGUsage usage;
+};
+
+// ͨʼǰһ vkCmdPipelineBarrier
+struct RGBarrierBatch {
+    VkPipelineStageFlags srcStages = 0;
+    VkPipelineStageFlags dstStages = 0;
+    VkAccessFlags srcAccess = 0;            // ϲһȫڴ
+    VkAccessFlags dstAccess = 0;
+    std::vector<VkImageMemoryBarrier> imageBarriers;    // image ִʱ
+    std::vector<RGResourceHandle> images;
+};
+
+struct RGPass {
+    std::string name;
+    std::vector<RGUse> uses;
+    bool sideEffects = false;   // ʹûбʹҲҪִУص
+    std::function<void(VkCommandBuffer)> record;
+
+    bool culled = false;
+    RGBarrierBatch barriers;
+};
+
+struct RenderGraphStats {
+    uint32_t passCount = 0;
+    uint32_t culledPasses = 0;
+    uint32_t barrierBatches = 0;        // ÿִе vkCmdPipelineBarrier Ĵ
+    uint32_t imageBarriers = 0;
+    uint32_t memoryBarriers = 0;
+    uint32_t transientImages = 0;
+    VkDeviceSize transientBytes = 0;    // ÿ˲̬ͼ񵥶ʱҪڴ
+    VkDeviceSize allocatedBytes = 0;    // ʵʷڴ
+};
+
+struct RenderGraph {
+    std::vector<RGResource> resources;
+    std::vector<RGPass> passes;
+    RGBarrierBatch finalBarriers;       // Դת finalState
+    VkMemoryRequirements transientRequirements = {};    // ˲̬ͼõһڴ
+    Allocation transientMemory;
+    bool compiled = false;
+    RenderGraphStats stats;
+};
+
+// ͼⴴͼinitialState Ϊͼʼʱ״̬Ϊ UNDEFINED ʾԭݣ
+// finalState ĲֲΪ UNDEFINED ʱԴִнʱתò
+RGResourceHandle importImage(RenderGraph& graph, const std::string& name, VkImage image, VkFormat format,
+    const RGState& initialState, const RGState& finalState);
+
+// 뻺persistent ʾÿִжʹͬһʼ״̬ȡһִнʱ״̬
+RGResourceHandle importBuffer(RenderGraph& graph, const std::string& name, VkBuffer buffer, bool persistent);
+
+// ͼڲͼɱʱڴܺ˲̬ͼ
+RGResourceHandle createTransientImage(RenderGraph& graph, const std::string& name, const RGImageDesc& desc);
+
+// ÿ֡ͼ罻ͼ񣩣ʽ״̬
+void setImportedImage(RenderGraph& graph, RGResourceHandle resource, VkImage image);
+
+uint32_t addPass(RenderGraph& graph, const std::string& name, std::function<void(VkCommandBuffer)> record);
+void useResource(RenderGraph& graph, uint32_t pass, RGResourceHandle resource, RGUsage usage);
+void setPassSideEffects(RenderGraph& graph, uint32_t pass);
+
+// ˲̬ͼڴ󣬵ʱ resource.usage Ѿϲʹ÷ʽ
+typedef std::function<VkMemoryRequirements(RGResource& resource)> RGRequirementsFn;
+
+// вҪ豸Ĳ֣޳ͨ getRequirements ĴСã˲̬ͼ񡢼Ϻͳơ
+// ֮ͼִУ compileRenderGraph
+void planRenderGraph(RenderGraph& graph, const RGRequirementsFn& getRequirements);
+
+// ô˲̬ͼʵִ planRenderGraphٷ䣨ڴ桢󶨲ͼʧʱ׳쳣
+void compileRenderGraph(RenderGraph& graph);
+void executeRenderGraph(RenderGraph& graph, VkCommandBuffer commandBuffer);
+
+// ˲̬ͼͼЧ
+VkImageView getRenderGraphImageView(const RenderGraph& graph, RGResourceHandle resource);
+
+void destroyRenderGraph(RenderGraph& graph);
+
+void printRenderGraph(const RenderGraph& graph);
@@ -0,0 +1,218 @@
+#include "ResourceRegistry.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+void createResourceRegistry(ResourceRegistry& registry, uint32_t frameCount) {
+    registry.deletionQueues.assign(std::max(frameCount, 1u), DeletionQueue());
+    registry.currentFrame = 0;
+    registry.pending = 0;
+    registry.stats = RegistryStats();
+}
+
+static void destroyRegisteredImage(ResourceRegistry& registry, RegisteredImage& image) {
+    if (image.bindlessIndex != INVALID_BINDLESS_INDEX) {
+        releaseBindlessTexture(*registry.bindless, image.bindlessIndex);
+    }
+    if (image.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, image.view, nullptr);
+    }
+    if (image.image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, image.image, nullptr);
+    }
+    freeMemory(gpuAllocator, image.memory);
+    image = RegisteredImage();
+}
+
+static void flushDeletionQueue(ResourceRegistry& registry, DeletionQueue& queue) {
+    for (GpuBuffer& buffer : queue.buffers) {
+        destroyBuffer(buffer);
+    }
+    for (RegisteredImage& image : queue.images) {
+        destroyRegisteredImage(registry, image);
+    }
+    for (auto& release : queue.releases) {
+        release();
+    }
+
+    uint32_t count = static_cast<uint32_t>(queue.buffers.size() + queue.images.size());
+    registry.stats.buffersDestroyed += queue.buffers.size();
+    registry.stats.imagesDestroyed += queue.images.size();
+    registry.pending -= count;
+
+    // ȶ״̬Ӳٷڴ
+    queue.buffers.clear();
+    queue.images.clear();
+    queue.releases.clear();
+}
+
+void destroyResourceRegistry(ResourceRegistry& registry) {
+    flushRegistryDeletions(registry);
+
+    // ûбʽٵԴҲҪͷţʱڴҳԱռ
+    registry.stats.leaked = getPoolSize(registry.buffers) + getPoolSize(registry.images);
+    if (registry.stats.leaked > 0) {
+        std::cerr << "Resource registry: " << getPoolSize(registry.buffers) << " buffer(s) and "
+            << getPoolSize(registry.images) << " image(s) still registered at shutdown" << std::endl;
+    }
+    for (GpuBuffer& buffer : registry.buffers.items) {
+        destroyBuffer(buffer);
+    }
+    for (RegisteredImage& image : registry.images.items) {
+        destroyRegisteredImage(registry, image);
+    }
+
+    registry.buffers = DensePool<GpuBuffer>();
+    registry.images = DensePool<RegisteredImage>();
+    registry.deletionQueues.clear();
+}
+
+ResourceHandle createRegistryBuffer(ResourceRegistry& registry, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags properties) {
+    GpuBuffer buffer;
+    createBuffer(buffer, size, usage, properties);
+    registry.stats.buffersCreated++;
+    return insertPoolItem(registry.buffers, buffer);
+}
+
+ResourceHandle createRegistryImage(ResourceRegistry& registry, VkFormat format, VkExtent2D extent, uint32_t mipLevels,
+    VkImageUsageFlags usage) {
+    RegisteredImage image;
+    image.format = format;
+    image.extent = extent;
+    image.mipLevels = std::max(mipLevels, 1u);
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = format;
+    imageInfo.extent = { extent.width, extent.height, 1 };
+    imageInfo.mipLevels = image.mipLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create registry image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, image.image, &memRequirements);
+    allocateMemory(gpuAllocator, memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal, image.memory);
+    vkBindImageMemory(device, image.image, image.memory.memory, image.memory.offset);
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = image.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.levelCount = image.mipLevels;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+        destroyRegisteredImage(registry, image);
+        throw std::runtime_error("failed to create registry image view!");
+    }
+
+    registry.stats.imagesCreated++;
+    return insertPoolItem(registry.images, image);
+}
+
+ResourceHandle adoptRegistryBuffer(ResourceRegistry& registry, const GpuBuffer& buffer) {
+    registry.stats.buffersCreated++;
+    return insertPoolItem(registry.buffers, buffer);
+}
+
+ResourceHandle adoptRegistryImage(ResourceRegistry& registry, const RegisteredImage& image) {
+    registry.stats.imagesCreated++;
+    return insertPoolItem(registry.images, image);
+}
+
+BindlessIndex registerRegistryImageBindless(ResourceRegistry& registry, ResourceHandle handle, VkSampler sampler) {
+    RegisteredImage* image = getPoolItem(registry.images, handle);
+    if (image == nullptr) {
+        registry.stats.staleHandles++;
+        return INVALID_BINDLESS_INDEX;
+    }
+    if (registry.bindless == nullptr || image->view == VK_NULL_HANDLE || image->bindlessIndex != INVALID_BINDLESS_INDEX) {
+        return image->bindlessIndex;
+    }
+
+    image->bindlessIndex = registerBindlessTexture(*registry.bindless, image->view, sampler);
+    return image->bindlessIndex;
+}
+
+const GpuBuffer* getRegistryBuffer(ResourceRegistry& registry, ResourceHandle handle) {
+    const GpuBuffer* buffer = getPoolItem(registry.buffers, handle);
+    if (buffer == nullptr) {
+        registry.stats.staleHandles++;
+    }
+    return buffer;
+}
+
+const RegisteredImage* getRegistryImage(ResourceRegistry& registry, ResourceHandle handle) {
+    const RegisteredImage* image = getPoolItem(registry.images, handle);
+    if (image == nullptr) {
+        registry.stats.staleHandles++;
+    }
+    return image;
+}
+
+static void notePending(ResourceRegistry& registry) {
+    registry.pending++;
+    registry.stats.peakPending = std::max(registry.stats.peakPending, registry.pending);
+}
+
+bool destroyRegistryBuffer(ResourceRegistry& registry, ResourceHandle handle) {
+    GpuBuffer buffer;
+    if (!removePoolItem(registry.buffers, handle, buffer)) {
+        registry.stats.staleHandles++;
+        return false;
+    }
+    registry.deletionQueues[registry.currentFrame].buffers.push_back(buffer);
+    notePending(registry);
+    return true;
+}
+
+bool destroyRegistryImage(ResourceRegistry& registry, ResourceHandle handle) {
+    RegisteredImage image;
+    if (!removePoolItem(registry.images, handle, image)) {
+        registry.stats.staleHandles++;
+        return false;
+    }
+    registry.deletionQueues[registry.currentFrame].images.push_back(image);
+    notePending(registry);
+    return true;
+}
+
+void deferRegistryRelease(ResourceRegistry& registry, std::function<void()> release) {
+    registry.deletionQueues[registry.currentFrame].releases.push_back(std::move(release));
+}
+
+void beginRegistryFrame(ResourceRegistry& registry, uint32_t slot) {
+    // ʱǵʱʼ֡ĶУ֮֡ǰ¼ƵЩ
+    // λ fence ٴδʱǶִ
+    registry.currentFrame = slot % static_cast<uint32_t>(registry.deletionQueues.size());
+    flushDeletionQueue(registry, registry.deletionQueues[registry.currentFrame]);
+}
+
+void flushRegistryDeletions(ResourceRegistry& registry) {
+    for (DeletionQueue& queue : registry.deletionQueues) {
+        flushDeletionQueue(registry, queue);
+    }
+}
+
+void printRegistryStats(const ResourceRegistry& registry) {
+    std::cout << "Resource registry: " << getPoolSize(registry.buffers) << " buffers and "
+        << getPoolSize(registry.images) << " images live, "
+        << registry.stats.buffersCreated << "/" << registry.stats.buffersDestroyed << " buffers and "
+        << registry.stats.imagesCreated << "/" << registry.stats.imagesDestroyed << " images created/destroyed, "
+        << registry.pending << " pending (peak " << registry.stats.peakPending << "), "
+        << registry.stats.staleHandles << " stale handle use(s)" << std::endl;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "Descriptors.h"
+#include "MemoryAllocator.h"
+#include "Upload.h"
+
+// ж̬ٵĻͼþãɲλ±ʹɣλͷʱһ
+// Դľɾ鲻κζָ֮ͬһλԴ
+// Դܴڸ͵ĳУɾʱһλղλ
+// ʱʧЧVulkan 뵱ǰ֡ɾУȸ֡ fence һֵ֡λ
+// ٣ǰ¼ƵȻʹǣͷԴҪ vkDeviceWaitIdle
+// עĶ۵ĽػĽӣҲԵǼһͷŲͬʱִ
+
+//  32 λΪλ±꣬ 32 λΪ 1 ʼ0 Ч
+typedef uint64_t ResourceHandle;
+const ResourceHandle INVALID_RESOURCE = 0;
+
+inline uint32_t resourceHandleSlot(ResourceHandle handle) {
+    return static_cast<uint32_t>(handle);
+}
+
+inline uint32_t resourceHandleGeneration(ResourceHandle handle) {
+    return static_cast<uint32_t>(handle >> 32);
+}
+
+inline ResourceHandle makeResourceHandle(uint32_t slot, uint32_t generation) {
+    return (static_cast<ResourceHandle>(generation) << 32) | slot;
+}
+
+// ʵĽܳءitems  itemSlots һһӦslotItems Ϊλ items ±ӳ䡣
+// вλͷ˳ãFIFOͬһλٴʹ
+template <typename T>
+struct DensePool {
+    std::vector<T> items;
+    std::vector<uint32_t> itemSlots;
+    std::vector<uint32_t> slotItems;
+    std::vector<uint32_t> generations;  // λǰĴ
+    std::deque<uint32_t> freeSlots;
+};
+
+template <typename T>
+ResourceHandle insertPoolItem(DensePool<T>& pool, const T& item) {
+    uint32_t slot;
+    if (!pool.freeSlots.empty()) {
+        slot = pool.freeSlots.front();
+        pool.freeSlots.pop_front();
+    }
+    else {
+        slot = static_cast<uint32_t>(pool.generations.size());
+        pool.generations.push_back(1);
+        pool.slotItems.push_back(0);
+    }
+
+    pool.slotItems[slot] = static_cast<uint32_t>(pool.items.size());
+    pool.items.push_back(item);
+    pool.itemSlots.push_back(slot);
+    return makeResourceHandle(slot, pool.generations[slot]);
+}
+
+// ʧЧԴɾأʱؿ
+template <typename T>
+T* getPoolItem(DensePool<T>& pool, ResourceHandle handle) {
+    uint32_t slot = resourceHandleSlot(handle);
+    if (handle == INVALID_RESOURCE || slot >= pool.generations.size() || pool.generations[slot] != resourceHandleGeneration(handle)) {
+        return nullptr;
+    }
+    return &pool.items[pool.slotItems[slot]];
+}
+
+// ԴƳزʹʧЧʧЧʱ false
+template <typename T>
+bool removePoolItem(DensePool<T>& pool, ResourceHandle handle, T& item) {
+    if (getPoolItem(pool, handle) == nullptr) {
+        return false;
+    }
+
+    uint32_t slot = resourceHandleSlot(handle);
+    uint32_t index = pool.slotItems[slot];
+    uint32_t last = static_cast<uint32_t>(pool.items.size()) - 1;
+    item = pool.items[index];
+    if (index != last) {
+        pool.items[index] = pool.items[last];
+        pool.itemSlots[index] = pool.itemSlots[last];
+        pool.slotItems[pool.itemSlots[index]] = index;
+    }
+    pool.items.pop_back();
+    pool.itemSlots.pop_back();
+
+    // ʱ 0֤Ч INVALID_RESOURCE
+    uint32_t& generation = pool.generations[slot];
+    generation = generation == UINT32_MAX ? 1 : generation + 1;
+    pool.freeSlots.push_back(slot);
+    return true;
+}
+
+template <typename T>
+uint32_t getPoolSize(const DensePool<T>& pool) {
+    return static_cast<uint32_t>(pool.items.size());
+}
+
+//  2D ͼͼΪգ
+struct RegisteredImage {
+    VkImage image = VK_NULL_HANDLE;
+    Allocation memory;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent2D extent = {};
+    uint32_t mipLevels = 0;
+    BindlessIndex bindlessIndex = INVALID_BINDLESS_INDEX;  // ͼʱŹ黹;֡Կͨ
+};
+
+// һ֡λϵȴٵĶ
+struct DeletionQueue {
+    std::vector<GpuBuffer> buffers;
+    std::vector<RegisteredImage> images;
+    std::vector<std::function<void()>> releases;    // deferRegistryRelease ǼǵĲ pending
+};
+
+struct RegistryStats {
+    uint64_t buffersCreated = 0;
+    uint64_t imagesCreated = 0;
+    uint64_t buffersDestroyed = 0;      // Ѵɾٵ
+    uint64_t imagesDestroyed = 0;
+    uint64_t staleHandles = 0;          // ʧЧľһٵĴ
+    uint32_t peakPending = 0;           // ɾͬʱȴ
+    uint32_t leaked = 0;                // עʱȻڵԴ
+};
+
+struct ResourceRegistry {
+    DensePool<GpuBuffer> buffers;
+    DensePool<RegisteredImage> images;
+    BindlessTable* bindless = nullptr;          // Ϊʱͼעᵽް
+
+    std::vector<DeletionQueue> deletionQueues;  // ±Ϊ֡еĲλ
+    uint32_t currentFrame = 0;                  // һ beginRegistryFrame ĲλٵĶĶ
+    uint32_t pending = 0;
+
+    RegistryStats stats;
+};
+
+// frameCount Ϊ֡Ĳλ
+void createResourceRegistry(ResourceRegistry& registry, uint32_t frameCount);
+
+// ǰ豸ѿУɾУȻڵԴһٲ stats.leaked
+void destroyResourceRegistry(ResourceRegistry& registry);
+
+// ʧʱ׳쳣
+ResourceHandle createRegistryBuffer(ResourceRegistry& registry, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags properties);
+
+// ɫͼ OPTIMAL ͼλ DEVICE_LOCAL ڴ档ʧʱ׳쳣
+ResourceHandle createRegistryImage(ResourceRegistry& registry, VkFormat format, VkExtent2D extent, uint32_t mipLevels,
+    VkImageUsageFlags usage);
+
+// ѾõĻͼ񽻸ע干Դֻ֮ͨ
+ResourceHandle adoptRegistryBuffer(ResourceRegistry& registry, const GpuBuffer& buffer);
+ResourceHandle adoptRegistryImage(ResourceRegistry& registry, const RegisteredImage& image);
+
+// ͼͼ sampler עᵽ registry.bindless±ͼһӳͷţѾעʱԭ±ꡣ
+// ûпõް󶨱ͼûͼʧЧʱ INVALID_BINDLESS_INDEX
+BindlessIndex registerRegistryImageBindless(ResourceRegistry& registry, ResourceHandle handle, VkSampler sampler);
+
+// ʧЧʱؿաָһδͬԴʧЧҪ
+const GpuBuffer* getRegistryBuffer(ResourceRegistry& registry, ResourceHandle handle);
+const RegisteredImage* getRegistryImage(ResourceRegistry& registry, ResourceHandle handle);
+
+// ʧЧڵǰ֡λһοʼʱ١ʧЧظ٣ʱ false
+bool destroyRegistryBuffer(ResourceRegistry& registry, ResourceHandle handle);
+bool destroyRegistryImage(ResourceRegistry& registry, ResourceHandle handle);
+
+// release ڵǰ֡λһοʼʱ flushRegistryDeletions УִУǰύ
+void deferRegistryRelease(ResourceRegistry& registry, std::function<void()> release);
+
+// ÿ֡ beginFrame ֮ãslot һύѾɣɾеĶִеǼǵͷŲ
+void beginRegistryFrame(ResourceRegistry& registry, uint32_t slot);
+
+// 豸УwaitForAllFramesãɾ
+void flushRegistryDeletions(ResourceRegistry& registry);
+
+void printRegistryStats(const ResourceRegistry& registry);
@@ -0,0 +1,469 @@
+#include "Scene.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+static const uint32_t componentSizes[SceneComponentCount] = {
+    sizeof(LocalTransform),
+    sizeof(Mat4),
+    sizeof(Entity),
+    sizeof(uint32_t),
+    sizeof(MaterialKey),
+    sizeof(Bounds),
+    sizeof(Bounds),
+};
+
+// ÿ鰴 16 ֽڶ루Mat4 Ҫ
+const uint32_t CHUNK_ARRAY_ALIGNMENT = 16;
+
+static uint32_t alignChunkOffset(uint32_t offset) {
+    return (offset + CHUNK_ARRAY_ALIGNMENT - 1) / CHUNK_ARRAY_ALIGNMENT * CHUNK_ARRAY_ALIGNMENT;
+}
+
+static uint32_t findOrCreateArchetype(SceneWorld& world, ComponentMask mask, uint32_t depth) {
+    for (uint32_t i = 0; i < world.archetypes.size(); i++) {
+        if (world.archetypes[i].mask == mask && world.archetypes[i].depth == depth) {
+            return i;
+        }
+    }
+
+    Archetype archetype;
+    archetype.mask = mask;
+    archetype.depth = depth;
+
+    // ȰÿʵֽԤÿĶ䣩Ų
+    uint32_t bytesPerEntity = sizeof(Entity) + sizeof(uint8_t);
+    uint32_t arrayCount = 2;
+    for (uint32_t c = 0; c < SceneComponentCount; c++) {
+        if (mask & (1u << c)) {
+            bytesPerEntity += componentSizes[c];
+            arrayCount++;
+        }
+    }
+    archetype.capacity = (SCENE_CHUNK_BYTES - arrayCount * CHUNK_ARRAY_ALIGNMENT) / bytesPerEntity;
+
+    uint32_t offset = 0;
+    for (uint32_t c = 0; c < SceneComponentCount; c++) {
+        if (mask & (1u << c)) {
+            archetype.offsets[c] = offset;
+            offset = alignChunkOffset(offset + componentSizes[c] * archetype.capacity);
+        }
+    }
+    archetype.entityOffset = offset;
+    offset = alignChunkOffset(offset + sizeof(Entity) * archetype.capacity);
+    archetype.flagsOffset = offset;
+
+    world.archetypes.push_back(std::move(archetype));
+    return static_cast<uint32_t>(world.archetypes.size() - 1);
+}
+
+static const EntityRecord* findRecord(const SceneWorld& world, Entity entity) {
+    if (entity.index >= world.records.size()) {
+        return nullptr;
+    }
+    const EntityRecord& record = world.records[entity.index];
+    if (record.archetype == UINT32_MAX || record.generation != entity.generation) {
+        return nullptr;
+    }
+    return &record;
+}
+
+void destroySceneWorld(SceneWorld& world) {
+    world = SceneWorld();
+}
+
+Entity createEntity(SceneWorld& world, ComponentMask components, Entity parent) {
+    uint32_t depth = 0;
+    const EntityRecord* parentRecord = findRecord(world, parent);
+    if (parentRecord != nullptr) {
+        depth = world.archetypes[parentRecord->archetype].depth + 1;
+        components |= componentBit(SceneComponentParent);
+    }
+    else {
+        components &= ~componentBit(SceneComponentParent);
+    }
+
+    uint32_t archetypeIndex = findOrCreateArchetype(world, components, depth);
+    Archetype& archetype = world.archetypes[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity) {
+        SceneChunk chunk;
+        chunk.memory.reset(new SceneChunkMemory);
+        archetype.chunks.push_back(std::move(chunk));
+    }
+
+    uint32_t chunkIndex = static_cast<uint32_t>(archetype.chunks.size() - 1);
+    SceneChunk& chunk = archetype.chunks[chunkIndex];
+    uint32_t row = chunk.count++;
+
+    Entity entity;
+    if (!world.freeIndices.empty()) {
+        entity.index = world.freeIndices.back();
+        world.freeIndices.pop_back();
+    }
+    else {
+        entity.index = static_cast<uint32_t>(world.records.size());
+        world.records.push_back(EntityRecord());
+    }
+    EntityRecord& record = world.records[entity.index];
+    entity.generation = record.generation;
+    record.archetype = archetypeIndex;
+    record.chunk = chunkIndex;
+    record.row = row;
+
+    for (uint32_t c = 0; c < SceneComponentCount; c++) {
+        if (components & (1u << c)) {
+            memset(chunk.memory->bytes + archetype.offsets[c] + componentSizes[c] * row, 0, componentSizes[c]);
+        }
+    }
+    if (hasComponent(archetype, SceneComponentLocalTransform)) {
+        chunkArray<LocalTransform>(archetype, chunk, SceneComponentLocalTransform)[row] = { { 0.0f, 0.0f, 0.0f }, quatIdentity(), { 1.0f, 1.0f, 1.0f } };
+    }
+    if (hasComponent(archetype, SceneComponentWorldTransform)) {
+        chunkArray<Mat4>(archetype, chunk, SceneComponentWorldTransform)[row] = mat4Identity();
+    }
+    if (hasComponent(archetype, SceneComponentParent)) {
+        chunkArray<Entity>(archetype, chunk, SceneComponentParent)[row] = parent;
+    }
+    chunkEntities(archetype, chunk)[row] = entity;
+    chunkFlags(archetype, chunk)[row] = SceneEntityDirty;
+
+    world.entityCount++;
+    world.maxDepth = std::max(world.maxDepth, depth);
+    return entity;
+}
+
+void destroyEntity(SceneWorld& world, Entity entity) {
+    const EntityRecord* found = findRecord(world, entity);
+    if (found == nullptr) {
+        return;
+    }
+
+    EntityRecord& record = world.records[entity.index];
+    Archetype& archetype = world.archetypes[record.archetype];
+    SceneChunk& chunk = archetype.chunks[record.chunk];
+    SceneChunk& last = archetype.chunks.back();
+    uint32_t lastRow = last.count - 1;
+
+    // ԭ͵һʵƵλϣֻ֤һ鲻
+    if (&chunk != &last || record.row != lastRow) {
+        for (uint32_t c = 0; c < SceneComponentCount; c++) {
+            if (archetype.mask & (1u << c)) {
+                memcpy(chunk.memory->bytes + archetype.offsets[c] + componentSizes[c] * record.row,
+                    last.memory->bytes + archetype.offsets[c] + componentSizes[c] * lastRow, componentSizes[c]);
+            }
+        }
+        Entity moved = chunkEntities(archetype, last)[lastRow];
+        chunkEntities(archetype, chunk)[record.row] = moved;
+        chunkFlags(archetype, chunk)[record.row] = chunkFlags(archetype, last)[lastRow];
+
+        EntityRecord& movedRecord = world.records[moved.index];
+        movedRecord.chunk = record.chunk;
+        movedRecord.row = record.row;
+    }
+
+    last.count--;
+    if (last.count == 0) {
+        archetype.chunks.pop_back();
+    }
+
+    record.generation++;
+    record.archetype = UINT32_MAX;
+    world.freeIndices.push_back(entity.index);
+    world.entityCount--;
+}
+
+bool isEntityAlive(const SceneWorld& world, Entity entity) {
+    return findRecord(world, entity) != nullptr;
+}
+
+void* getComponent(SceneWorld& world, Entity entity, SceneComponent component) {
+    const EntityRecord* record = findRecord(world, entity);
+    if (record == nullptr) {
+        return nullptr;
+    }
+
+    const Archetype& archetype = world.archetypes[record->archetype];
+    if (!hasComponent(archetype, component)) {
+        return nullptr;
+    }
+    return archetype.chunks[record->chunk].memory->bytes + archetype.offsets[component] + componentSizes[component] * record->row;
+}
+
+static void markDirty(SceneWorld& world, Entity entity) {
+    const EntityRecord* record = findRecord(world, entity);
+    const Archetype& archetype = world.archetypes[record->archetype];
+    chunkFlags(archetype, archetype.chunks[record->chunk])[record->row] |= SceneEntityDirty;
+}
+
+void setLocalTransform(SceneWorld& world, Entity entity, const LocalTransform& transform) {
+    LocalTransform* local = static_cast<LocalTransform*>(getComponent(world, entity, SceneComponentLocalTransform));
+    if (local != nullptr) {
+        *local = transform;
+        markDirty(world, entity);
+    }
+}
+
+void setMesh(SceneWorld& world, Entity entity, uint32_t mesh, const Bounds& localBounds) {
+    uint32_t* meshIndex = static_cast<uint32_t*>(getComponent(world, entity, SceneComponentMesh));
+    Bounds* bounds = static_cast<Bounds*>(getComponent(world, entity, SceneComponentBounds));
+    if (meshIndex != nullptr) {
+        *meshIndex = mesh;
+    }
+    if (bounds != nullptr) {
+        *bounds = localBounds;
+        markDirty(world, entity);  // ΧҪ¼
+    }
+}
+
+void setMaterial(SceneWorld& world, Entity entity, MaterialKey material) {
+    MaterialKey* key = static_cast<MaterialKey*>(getComponent(world, entity, SceneComponentMaterial));
+    if (key != nullptr) {
+        *key = material;
+    }
+}
+
+const Mat4* getWorldTransform(SceneWorld& world, Entity entity) {
+    return static_cast<const Mat4*>(getComponent(world, entity, SceneComponentWorldTransform));
+}
+
+// ֲΧо world 任İΧУİ任볤Ԫصľֵ任
+static Bounds transformBounds(const Mat4& world, const Bounds& local) {
+    const float* m = world.m;
+    Bounds result;
+    result.center.x = m[0] * local.center.x + m[4] * local.center.y + m[8] * local.center.z + m[12];
+    result.center.y = m[1] * local.center.x + m[5] * local.center.y + m[9] * local.center.z + m[13];
+    result.center.z = m[2] * local.center.x + m[6] * local.center.y + m[10] * local.center.z + m[14];
+    result.extent.x = std::fabs(m[0]) * local.extent.x + std::fabs(m[4]) * local.extent.y + std::fabs(m[8]) * local.extent.z;
+    result.extent.y = std::fabs(m[1]) * local.extent.x + std::fabs(m[5]) * local.extent.y + std::fabs(m[9]) * local.extent.z;
+    result.extent.z = std::fabs(m[2]) * local.extent.x + std::fabs(m[6]) * local.extent.y + std::fabs(m[10]) * local.extent.z;
+    return result;
+}
+
+// һ飬¼ʵڵڸǳϣѾֻ꣬
+static uint32_t updateChunkTransforms(const SceneWorld& world, const Archetype& archetype, const SceneChunk& chunk) {
+    LocalTransform* locals = chunkArray<LocalTransform>(archetype, chunk, SceneComponentLocalTransform);
+    Mat4* worlds = chunkArray<Mat4>(archetype, chunk, SceneComponentWorldTransform);
+    uint8_t* flags = chunkFlags(archetype, chunk);
+    const Entity* parents = hasComponent(archetype, SceneComponentParent) ? chunkArray<Entity>(archetype, chunk, SceneComponentParent) : nullptr;
+    bool bounds = hasComponent(archetype, SceneComponentBounds) && hasComponent(archetype, SceneComponentWorldBounds);
+    const Bounds* localBounds = bounds ? chunkArray<Bounds>(archetype, chunk, SceneComponentBounds) : nullptr;
+    Bounds* worldBounds = bounds ? chunkArray<Bounds>(archetype, chunk, SceneComponentWorldBounds) : nullptr;
+
+    uint32_t updated = 0;
+    for (uint32_t row = 0; row < chunk.count; row++) {
+        bool changed = (flags[row] & SceneEntityDirty) != 0;
+
+        const Mat4* parentWorld = nullptr;
+        if (parents != nullptr) {
+            const EntityRecord* parent = findRecord(world, parents[row]);
+            if (parent != nullptr) {
+                const Archetype& parentArchetype = world.archetypes[parent->archetype];
+                if (hasComponent(parentArchetype, SceneComponentWorldTransform)) {
+                    const SceneChunk& parentChunk = parentArchetype.chunks[parent->chunk];
+                    parentWorld = &chunkArray<Mat4>(parentArchetype, parentChunk, SceneComponentWorldTransform)[parent->row];
+                    changed = changed || (chunkFlags(parentArchetype, parentChunk)[parent->row] & SceneEntityWorldChanged) != 0;
+                }
+            }
+        }
+
+        if (!changed) {
+            flags[row] = 0;
+            continue;
+        }
+
+        const LocalTransform& local = locals[row];
+        Mat4 model = mat4FromTransform(local.position, local.rotation, local.scale);
+        worlds[row] = parentWorld != nullptr ? mat4Multiply(*parentWorld, model) : model;
+        if (bounds) {
+            worldBounds[row] = transformBounds(worlds[row], localBounds[row]);
+        }
+        flags[row] = SceneEntityWorldChanged;
+        updated++;
+    }
+    return updated;
+}
+
+struct ChunkRef {
+    uint32_t archetype;
+    uint32_t chunk;
+};
+
+//  jobs ϴ [0, count)ÿ̷ּ߳ƽ⸺
+static void runChunkTasks(JobSystem* jobs, uint32_t count, uint32_t taskCount,
+    const std::function<void(uint32_t begin, uint32_t end, uint32_t task)>& fn) {
+    if (jobs == nullptr) {
+        fn(0, count, 0);
+        return;
+    }
+    parallelFor(*jobs, count, taskCount, [&](uint32_t begin, uint32_t end, uint32_t chunkIndex, uint32_t) {
+        fn(begin, end, chunkIndex);
+    });
+}
+
+static uint32_t getTaskCount(JobSystem* jobs) {
+    return jobs != nullptr ? getJobThreadCount(*jobs) * 4 : 1;
+}
+
+SceneUpdateStats updateSceneTransforms(SceneWorld& world, JobSystem* jobs) {
+    SceneUpdateStats stats;
+    std::vector<ChunkRef> work;
+
+    //  d ʵֻ d - 1 Ľ֮䴮УͬһڵĿ鲢
+    for (uint32_t depth = 0; depth <= world.maxDepth; depth++) {
+        work.clear();
+        for (uint32_t a = 0; a < world.archetypes.size(); a++) {
+            const Archetype& archetype = world.archetypes[a];
+            if (archetype.depth != depth || !hasComponent(archetype, SceneComponentLocalTransform)
+                || !hasComponent(archetype, SceneComponentWorldTransform)) {
+                continue;
+            }
+            for (uint32_t c = 0; c < archetype.chunks.size(); c++) {
+                work.push_back({ a, c });
+            }
+        }
+
+        std::atomic<uint32_t> updated(0);
+        runChunkTasks(jobs, static_cast<uint32_t>(work.size()), getTaskCount(jobs), [&](uint32_t begin, uint32_t end, uint32_t) {
+            uint32_t count = 0;
+            for (uint32_t i = begin; i < end; i++) {
+                const Archetype& archetype = world.archetypes[work[i].archetype];
+                count += updateChunkTransforms(world, archetype, archetype.chunks[work[i].chunk]);
+            }
+            updated += count;
+        });
+        stats.updated += updated;
+    }
+    return stats;
+}
+
+uint64_t makeDrawSortKey(MaterialKey material, float depth) {
+    // Ǹλģʽֵͬȡ 24 λΪ
+    uint32_t depthBits = 0;
+    if (depth > 0.0f) {
+        memcpy(&depthBits, &depth, sizeof(depthBits));
+    }
+    return (static_cast<uint64_t>(material.pipeline & 0xff) << 56)
+        | (static_cast<uint64_t>(material.material) << 40)
+        | (static_cast<uint64_t>(depthBits >> 8) << 16);
+}
+
+//  sortKey  LSD ÿ 8 λмһλͬʱ
+static void radixSortDraws(std::vector<SceneDraw>& draws, std::vector<SceneDraw>& scratch) {
+    if (draws.size() < 2) {
+        return;
+    }
+    scratch.resize(draws.size());
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const SceneDraw& draw : draws) {
+            counts[(draw.sortKey >> shift) & 0xff]++;
+        }
+        if (counts[(draws[0].sortKey >> shift) & 0xff] == draws.size()) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (size_t& count : counts) {
+            size_t bucket = count;
+            count = offset;
+            offset += bucket;
+        }
+        for (const SceneDraw& draw : draws) {
+            scratch[counts[(draw.sortKey >> shift) & 0xff]++] = draw;
+        }
+        draws.swap(scratch);
+    }
+}
+
+static bool outsideFrustum(const float planes[6][4], const Bounds& bounds) {
+    for (int p = 0; p < 6; p++) {
+        const float* plane = planes[p];
+        float distance = plane[0] * bounds.center.x + plane[1] * bounds.center.y + plane[2] * bounds.center.z + plane[3];
+        float radius = std::fabs(plane[0]) * bounds.extent.x + std::fabs(plane[1]) * bounds.extent.y + std::fabs(plane[2]) * bounds.extent.z;
+        if (distance + radius < 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void extractSceneDraws(SceneWorld& world, const Mat4& viewProjection, bool cull, JobSystem* jobs, SceneDrawList& out) {
+    float planes[6][4];
+    extractFrustumPlanes(viewProjection, planes);
+
+    std::vector<ChunkRef> work;
+    uint32_t renderable = 0;
+    for (uint32_t a = 0; a < world.archetypes.size(); a++) {
+        const Archetype& archetype = world.archetypes[a];
+        if ((archetype.mask & RENDERABLE_COMPONENTS) != RENDERABLE_COMPONENTS) {
+            continue;
+        }
+        for (uint32_t c = 0; c < archetype.chunks.size(); c++) {
+            work.push_back({ a, c });
+            renderable += archetype.chunks[c].count;
+        }
+    }
+
+    uint32_t taskCount = getTaskCount(jobs);
+    out.taskDraws.resize(taskCount);
+    out.taskTransforms.resize(taskCount);
+    for (uint32_t t = 0; t < taskCount; t++) {
+        out.taskDraws[t].clear();
+        out.taskTransforms[t].clear();
+    }
+
+    // ÿдԼбtransform ȼڵ±
+    runChunkTasks(jobs, static_cast<uint32_t>(work.size()), taskCount, [&](uint32_t begin, uint32_t end, uint32_t task) {
+        std::vector<SceneDraw>& draws = out.taskDraws[task];
+        std::vector<Mat4>& transforms = out.taskTransforms[task];
+
+        for (uint32_t i = begin; i < end; i++) {
+            const Archetype& archetype = world.archetypes[work[i].archetype];
+            const SceneChunk& chunk = archetype.chunks[work[i].chunk];
+            const Mat4* worlds = chunkArray<Mat4>(archetype, chunk, SceneComponentWorldTransform);
+            const uint32_t* meshes = chunkArray<uint32_t>(archetype, chunk, SceneComponentMesh);
+            const MaterialKey* materials = chunkArray<MaterialKey>(archetype, chunk, SceneComponentMaterial);
+            const Bounds* bounds = chunkArray<Bounds>(archetype, chunk, SceneComponentWorldBounds);
+
+            for (uint32_t row = 0; row < chunk.count; row++) {
+                if (cull && outsideFrustum(planes, bounds[row])) {
+                    continue;
+                }
+
+                const Vec3& c = bounds[row].center;
+                const float* m = viewProjection.m;
+                float depth = m[3] * c.x + m[7] * c.y + m[11] * c.z + m[15];
+
+                draws.push_back({ makeDrawSortKey(materials[row], depth), meshes[row], static_cast<uint32_t>(transforms.size()) });
+                transforms.push_back(worlds[row]);
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (const std::vector<SceneDraw>& draws : out.taskDraws) {
+        total += draws.size();
+    }
+    out.draws.resize(total);
+    out.transforms.resize(total);
+
+    size_t offset = 0;
+    for (uint32_t t = 0; t < taskCount; t++) {
+        const std::vector<SceneDraw>& draws = out.taskDraws[t];
+        for (size_t i = 0; i < draws.size(); i++) {
+            SceneDraw draw = draws[i];
+            draw.transform += static_cast<uint32_t>(offset);
+            out.draws[offset + i] = draw;
+        }
+        std::copy(out.taskTransforms[t].begin(), out.taskTransforms[t].end(), out.transforms.begin() + offset);
+        offset += draws.size();
+    }
+    out.culled = renderable - static_cast<uint32_t>(total);
+
+    radixSortDraws(out.draws, out.sortScratch);
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SimdMath.h"
+
+struct JobSystem;
+
+// ʵ/洢ϣԭͣͬ㼶ͬʵͬһ̶СĿУ
+// ÿһ飺ĳʱֻȡڴ棬֮Բд
+const uint32_t SCENE_CHUNK_BYTES = 16 * 1024;
+
+enum SceneComponent : uint32_t {
+    SceneComponentLocalTransform = 0,   // LocalTransform޸ĺΪ
+    SceneComponentWorldTransform,       // Mat4 updateSceneTransforms 
+    SceneComponentParent,               // Entityʱȷ
+    SceneComponentMesh,                 // uint32_t±
+    SceneComponentMaterial,             // MaterialKey
+    SceneComponentBounds,               // Boundsֲռ
+    SceneComponentWorldBounds,          // Bounds updateSceneTransforms 
+    SceneComponentCount,
+};
+
+typedef uint32_t ComponentMask;
+
+inline ComponentMask componentBit(SceneComponent component) {
+    return 1u << component;
+}
+
+// ɻʵҪڵѡ
+const ComponentMask RENDERABLE_COMPONENTS = (1u << SceneComponentLocalTransform) | (1u << SceneComponentWorldTransform)
+    | (1u << SceneComponentMesh) | (1u << SceneComponentMaterial) | (1u << SceneComponentBounds) | (1u << SceneComponentWorldBounds);
+
+// index ʵٺãgeneration ǰʵ
+struct Entity {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+struct LocalTransform {
+    Vec3 position;
+    Quat rotation;
+    Vec3 scale;
+};
+
+//  + 볤
+struct Bounds {
+    Vec3 center;
+    Vec3 extent;
+};
+
+// ǰߣ 8 λЧͲ
+struct MaterialKey {
+    uint16_t pipeline;
+    uint16_t material;
+};
+
+// ڵʵ
+enum SceneEntityFlags : uint8_t {
+    SceneEntityDirty = 1,           // ֲ任ı䣬´θʱ¼
+    SceneEntityWorldChanged = 2,    // һθ任ıˣӽڵݴ˸£
+};
+
+struct alignas(64) SceneChunkMemory {
+    uint8_t bytes[SCENE_CHUNK_BYTES];
+};
+
+struct SceneChunk {
+    std::unique_ptr<SceneChunkMemory> memory;
+    uint32_t count = 0;
+};
+
+struct Archetype {
+    ComponentMask mask = 0;
+    uint32_t depth = 0;             // 㼶ȣڵΪ 0
+    uint32_t capacity = 0;          // ÿʵ
+    uint32_t offsets[SceneComponentCount] = {}; // ڿڵƫƣûиʱ壩
+    uint32_t entityOffset = 0;      // Entity[capacity]
+    uint32_t flagsOffset = 0;       // uint8_t[capacity]SceneEntityFlags
+    std::vector<SceneChunk> chunks; // ֻһδ
+};
+
+inline bool hasComponent(const Archetype& archetype, SceneComponent component) {
+    return (archetype.mask & componentBit(component)) != 0;
+}
+
+// ڸ׵ַcomponent ڸԭ
+template <typename T>
+T* chunkArray(const Archetype& archetype, const SceneChunk& chunk, SceneComponent component) {
+    return reinterpret_cast<T*>(chunk.memory->bytes + archetype.offsets[component]);
+}
+
+inline Entity* chunkEntities(const Archetype& archetype, const SceneChunk& chunk) {
+    return reinterpret_cast<Entity*>(chunk.memory->bytes + archetype.entityOffset);
+}
+
+inline uint8_t* chunkFlags(const Archetype& archetype, const SceneChunk& chunk) {
+    return chunk.memory->bytes + archetype.flagsOffset;
+}
+
+// ʵڵλ
+struct EntityRecord {
+    uint32_t generation = 0;
+    uint32_t archetype = UINT32_MAX;    // UINT32_MAX ʾ
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+};
+
+struct SceneWorld {
+    std::vector<Archetype> archetypes;
+    std::vector<EntityRecord> records;
+    std::vector<uint32_t> freeIndices;
+    uint32_t entityCount = 0;
+    uint32_t maxDepth = 0;
+};
+
+void destroySceneWorld(SceneWorld& world);
+
+// ʵ壬㣬ֲ任Ϊλ任Ϊࡣparent ЧʱʵΪڵ + 1
+// Զ SceneComponentParentӹϵܸı
+Entity createEntity(SceneWorld& world, ComponentMask components, Entity parent = Entity());
+
+// һʵλӽڵ㲻֮٣Ǵ˺󰴸ڵ㴦
+// 任һαΪʱ
+void destroyEntity(SceneWorld& world, Entity entity);
+
+bool isEntityAlive(const SceneWorld& world, Entity entity);
+
+// ʵûиʱ nullptrָڴʵʧЧ
+void* getComponent(SceneWorld& world, Entity entity, SceneComponent component);
+
+void setLocalTransform(SceneWorld& world, Entity entity, const LocalTransform& transform);
+void setMesh(SceneWorld& world, Entity entity, uint32_t mesh, const Bounds& localBounds);
+void setMaterial(SceneWorld& world, Entity entity, MaterialKey material);
+const Mat4* getWorldTransform(SceneWorld& world, Entity entity);
+
+struct SceneUpdateStats {
+    uint32_t updated = 0;   // ¼任ʵ
+};
+
+// ȴӸҶ任ΧУֲ任Ϊ򸸽ڵ㱾θı˵ʵ¼㣬
+// ͬһȵĿ jobs ϲдjobs Ϊ nullptr ʱڵִ߳У
+SceneUpdateStats updateSceneTransforms(SceneWorld& world, JobSystem* jobs);
+
+// ȡеһλƣtransform Ϊ SceneDrawList::transforms ±
+struct SceneDraw {
+    uint64_t sortKey;       //  |  | ȣɽԶ
+    uint32_t mesh;
+    uint32_t transform;
+};
+
+struct SceneDrawList {
+    std::vector<SceneDraw> draws;       //  sortKey ź
+    std::vector<Mat4> transforms;       // 任ȡ˳򣨲ƶ
+    uint32_t culled = 0;
+
+    // ÿľֲõʱռ䣬֡
+    std::vector<std::vector<SceneDraw>> taskDraws;
+    std::vector<std::vector<Mat4>> taskTransforms;
+    std::vector<SceneDraw> sortScratch;
+};
+
+// ȡпɻʵ壨RENDERABLE_COMPONENTS viewProjection ׶ı޳cull Ϊ false ʱ
+// ȫȡüռ w jobs ϲд sortKey 
+void extractSceneDraws(SceneWorld& world, const Mat4& viewProjection, bool cull, JobSystem* jobs, SceneDrawList& out);
+
+// ɹߡʺ
+uint64_t makeDrawSortKey(MaterialKey material, float depth);
+
+// еĲʣMaterialKey::material
+inline uint16_t getDrawMaterial(const SceneDraw& draw) {
+    return static_cast<uint16_t>(draw.sortKey >> 40);
+}
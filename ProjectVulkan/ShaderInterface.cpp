@@ -0,0 +1,91 @@
+#include "ShaderInterface.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+static VkDescriptorSetLayout createSetLayout(const VkDescriptorSetLayoutBinding* bindings, uint32_t bindingCount) {
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = bindingCount;
+    layoutInfo.pBindings = bindings;
+
+    VkDescriptorSetLayout setLayout;
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+    return setLayout;
+}
+
+VkPipelineLayout createPipelineLayout(const PipelineInterface& pipelineInterface, std::vector<VkDescriptorSetLayout>& setLayouts,
+    VkDescriptorSetLayout constantsSet, VkDescriptorSetLayout bindlessSet) {
+    size_t firstSetLayout = setLayouts.size();
+
+    for (uint32_t i = 0; i < pipelineInterface.descriptorSetCount; i++) {
+        const DescriptorSetInterface& setInterface = pipelineInterface.descriptorSets[i];
+        while (setLayouts.size() - firstSetLayout < setInterface.set) {
+            setLayouts.push_back(createSetLayout(nullptr, 0));
+        }
+        setLayouts.push_back(createSetLayout(setInterface.bindings, setInterface.bindingCount));
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(setLayouts.begin() + firstSetLayout, setLayouts.end());
+    if (constantsSet != VK_NULL_HANDLE) {
+        layouts.push_back(constantsSet);
+    }
+    if (bindlessSet != VK_NULL_HANDLE) {
+        layouts.push_back(bindlessSet);
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(layouts.size());
+    pipelineLayoutInfo.pSetLayouts = layouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = pipelineInterface.pushConstantCount;
+    pipelineLayoutInfo.pPushConstantRanges = pipelineInterface.pushConstants;
+
+    VkPipelineLayout pipelineLayout;
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+    return pipelineLayout;
+}
+
+uint32_t getDescriptorSetCount(const PipelineInterface& pipelineInterface) {
+    if (pipelineInterface.descriptorSetCount == 0) {
+        return 0;
+    }
+    return pipelineInterface.descriptorSets[pipelineInterface.descriptorSetCount - 1].set + 1;
+}
+
+uint32_t getPushConstantSize(const PipelineInterface& pipelineInterface) {
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < pipelineInterface.pushConstantCount; i++) {
+        const VkPushConstantRange& range = pipelineInterface.pushConstants[i];
+        if (range.offset <= size) {
+            size = std::max(size, range.offset + range.size);
+        }
+    }
+    return size;
+}
+
+void applyVertexInput(const PipelineInterface& pipelineInterface, GraphicsPipelineDesc& desc) {
+    desc.bindings.assign(pipelineInterface.vertexBindings, pipelineInterface.vertexBindings + pipelineInterface.vertexBindingCount);
+    desc.attributes.assign(pipelineInterface.vertexAttributes, pipelineInterface.vertexAttributes + pipelineInterface.vertexAttributeCount);
+}
+
+VkPipeline createComputePipeline(VkShaderModule shaderModule, VkPipelineLayout pipelineLayout) {
+    VkComputePipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = pipelineLayout;
+
+    VkPipeline pipeline;
+    if (vkCreateComputePipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create compute pipeline!");
+    }
+    return pipeline;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "PipelineRegistry.h"
+
+const uint32_t MAX_PIPELINE_SHADERS = 2;
+
+struct DescriptorSetInterface {
+    uint32_t set;
+    const VkDescriptorSetLayoutBinding* bindings;
+    uint32_t bindingCount;
+};
+
+//  shader_build.py  SPIR-V ɣ ShaderReflection.hһߵɫӿ
+struct PipelineInterface {
+    const char* shaders[MAX_PIPELINE_SHADERS];  // .spv ļ׶˳
+    uint32_t shaderCount;
+
+    const VkVertexInputBindingDescription* vertexBindings;
+    uint32_t vertexBindingCount;
+    const VkVertexInputAttributeDescription* vertexAttributes;
+    uint32_t vertexAttributeCount;
+
+    const DescriptorSetInterface* descriptorSets;   //  set 򣬱ſԲ
+    uint32_t descriptorSetCount;
+    const VkPushConstantRange* pushConstants;
+    uint32_t pushConstantCount;
+};
+
+// ֺ͹߲֣ʧʱ׳쳣
+// δʹõ set ÿղ䣻setLayouts ɵٹֺ߲١
+// constantsSet Ϊʱ׷ڷļ֮󣨱Ϊ getDescriptorSetCount <>ConstantsSet
+// bindlessSetް󶨱 table.setLayout׷<>BindlessSet߶ setLayouts
+VkPipelineLayout createPipelineLayout(const PipelineInterface& pipelineInterface, std::vector<VkDescriptorSetLayout>& setLayouts,
+    VkDescriptorSetLayout constantsSet = VK_NULL_HANDLE, VkDescriptorSetLayout bindlessSet = VK_NULL_HANDLE);
+
+//  set  + 1
+uint32_t getDescriptorSetCount(const PipelineInterface& pipelineInterface);
+
+// ƫ 0 ʼõͳֽ
+uint32_t getPushConstantSize(const PipelineInterface& pipelineInterface);
+
+// ѷĶд
+void applyVertexInput(const PipelineInterface& pipelineInterface, GraphicsPipelineDesc& desc);
+
+// õɫߣʹȫֹ߻棩ʧʱ׳쳣
+VkPipeline createComputePipeline(VkShaderModule shaderModule, VkPipelineLayout pipelineLayout);
@@ -0,0 +1,189 @@
+#include "ShaderLibrary.h"
+#include "VulkanContext.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+static const uint32_t SPIRV_MAGIC = 0x07230203;
+static const size_t SPIRV_HEADER_SIZE = 5 * sizeof(uint32_t);
+
+//  SPIR-V ݣʧԭ
+static const char* validateSpirv(const uint8_t* data, size_t size) {
+    if (size < SPIRV_HEADER_SIZE) {
+        return "too small for a SPIR-V header";
+    }
+    if (size % sizeof(uint32_t) != 0) {
+        return "size is not a multiple of 4";
+    }
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint32_t) != 0) {
+        return "code is not 4-byte aligned";
+    }
+
+    uint32_t magic;
+    memcpy(&magic, data, sizeof(magic));
+    if (magic == 0x03022307) {
+        return "SPIR-V was written with the opposite endianness";
+    }
+    if (magic != SPIRV_MAGIC) {
+        return "bad SPIR-V magic number";
+    }
+
+    return nullptr;
+}
+
+static uint64_t hashCode(const ShaderCode& code) {
+    uint64_t hash = 14695981039346656037ull;
+    size_t wordCount = code.size / sizeof(uint32_t);
+    for (size_t i = 0; i < wordCount; i++) {
+        hash ^= code.code[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static void loadArchive(ShaderLibrary& library, const std::string& archivePath) {
+    if (!mapFile(archivePath, library.archive)) {
+        throw std::runtime_error("failed to open shader archive " + archivePath);
+    }
+
+    const MappedFile& archive = library.archive;
+    ShaderArchiveHeader header;
+    if (archive.size < sizeof(header)) {
+        throw std::runtime_error("shader archive " + archivePath + " is truncated");
+    }
+    memcpy(&header, archive.data, sizeof(header));
+
+    if (header.magic != SHADER_ARCHIVE_MAGIC || header.version != SHADER_ARCHIVE_VERSION) {
+        throw std::runtime_error("shader archive " + archivePath + " has an unknown format");
+    }
+    if (sizeof(header) + static_cast<uint64_t>(header.entryCount) * sizeof(ShaderArchiveEntry) > archive.size) {
+        throw std::runtime_error("shader archive " + archivePath + " is truncated");
+    }
+
+    for (uint32_t i = 0; i < header.entryCount; i++) {
+        ShaderArchiveEntry entry;
+        memcpy(&entry, archive.data + sizeof(header) + i * sizeof(ShaderArchiveEntry), sizeof(entry));
+        entry.name[sizeof(entry.name) - 1] = '\0';
+
+        if (static_cast<uint64_t>(entry.offset) + entry.size > archive.size) {
+            throw std::runtime_error(std::string("shader archive entry ") + entry.name + " is out of bounds");
+        }
+
+        ShaderCode code;
+        code.code = reinterpret_cast<const uint32_t*>(archive.data + entry.offset);
+        code.size = entry.size;
+        library.archiveEntries[entry.name] = code;
+    }
+}
+
+void createShaderLibrary(ShaderLibrary& library, const std::vector<std::string>& searchPaths, const std::string& archivePath) {
+    library.searchPaths = searchPaths;
+
+    if (!archivePath.empty()) {
+        loadArchive(library, archivePath);
+    }
+}
+
+void destroyShaderLibrary(ShaderLibrary& library) {
+    for (auto& cached : library.modulesByHash) {
+        vkDestroyShaderModule(device, cached.second.module, nullptr);
+    }
+    for (MappedFile& file : library.mappedFiles) {
+        unmapFile(file);
+    }
+    unmapFile(library.archive);
+
+    library = ShaderLibrary();
+}
+
+// Ȳɫٰ˳·ӳڴеĴ
+static ShaderCode findShaderCode(ShaderLibrary& library, const std::string& name, std::string& location) {
+    auto entry = library.archiveEntries.find(name);
+    if (entry != library.archiveEntries.end()) {
+        library.stats.archiveLoads++;
+        location = "archive:" + name;
+        return entry->second;
+    }
+
+    for (const std::string& directory : library.searchPaths) {
+        std::string path = directory.empty() ? name : directory + "/" + name;
+
+        MappedFile file;
+        if (!mapFile(path, file)) {
+            continue;
+        }
+
+        library.mappedFiles.push_back(file);
+        library.stats.filesMapped++;
+        location = path;
+
+        ShaderCode code;
+        code.code = reinterpret_cast<const uint32_t*>(file.data);
+        code.size = file.size;
+        return code;
+    }
+
+    std::string message = "shader " + name + " not found in:";
+    if (!library.archiveEntries.empty()) {
+        message += " <archive>";
+    }
+    for (const std::string& directory : library.searchPaths) {
+        message += " " + directory;
+    }
+    throw std::runtime_error(message);
+}
+
+VkShaderModule getShaderModule(ShaderLibrary& library, const std::string& name) {
+    auto found = library.modulesByName.find(name);
+    if (found != library.modulesByName.end()) {
+        return found->second;
+    }
+
+    std::string location;
+    ShaderCode code = findShaderCode(library, name, location);
+
+    const char* reason = validateSpirv(reinterpret_cast<const uint8_t*>(code.code), code.size);
+    if (reason != nullptr) {
+        throw std::runtime_error("invalid shader " + location + ": " + reason);
+    }
+
+    // ͬɫʹõĶɫֻһģ
+    uint64_t hash = hashCode(code);
+    auto range = library.modulesByHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const ShaderCode& cached = it->second.code;
+        if (cached.size == code.size && memcmp(cached.code, code.code, code.size) == 0) {
+            library.stats.contentHits++;
+            library.modulesByName[name] = it->second.module;
+            return it->second.module;
+        }
+    }
+
+    // ӳڴ水ҳ룬ֱӴҪ⸴
+    VkShaderModuleCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = code.size;
+    createInfo.pCode = code.code;
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create shader module from " + location);
+    }
+
+    CachedShaderModule cached;
+    cached.module = shaderModule;
+    cached.code = code;
+    library.modulesByHash.emplace(hash, cached);
+    library.modulesByName[name] = shaderModule;
+    library.stats.modulesCreated++;
+
+    return shaderModule;
+}
+
+void printShaderLibraryStats(const ShaderLibrary& library) {
+    std::cout << "Shaders     : " << library.stats.modulesCreated << " module(s) created, "
+        << library.stats.contentHits << " shared by content, "
+        << library.stats.filesMapped << " file(s) mapped, "
+        << library.stats.archiveLoads << " from archive" << std::endl;
+}
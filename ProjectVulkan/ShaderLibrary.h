@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+
+// ɫļ pack_shaders.py ɣͷ + Ŀ + 4 ֽڶ SPIR-V 
+const uint32_t SHADER_ARCHIVE_MAGIC = 0x4B415053; // "SPAK"
+const uint32_t SHADER_ARCHIVE_VERSION = 1;
+
+struct ShaderArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct ShaderArchiveEntry {
+    char name[56];      //  '\0' βļ "vert.spv"
+    uint32_t offset;    // ļͷ
+    uint32_t size;
+};
+
+struct ShaderCode {
+    const uint32_t* code = nullptr;     // ָӳڴ棬
+    size_t size = 0;                    // ֽ
+};
+
+struct CachedShaderModule {
+    VkShaderModule module = VK_NULL_HANDLE;
+    ShaderCode code;
+};
+
+struct ShaderLibraryStats {
+    uint32_t filesMapped = 0;
+    uint32_t archiveLoads = 0;      // ɫҵɫ
+    uint32_t modulesCreated = 0;
+    uint32_t contentHits = 0;       // ƲͬͬģĴ
+};
+
+// ɫ⣺·ɫ .spvӳ䵽ڴֱӴģ飬
+// ģ鰴ݹϣ棬ͬɫֻһ
+struct ShaderLibrary {
+    std::vector<std::string> searchPaths;
+    MappedFile archive;
+    std::unordered_map<std::string, ShaderCode> archiveEntries;
+    std::vector<MappedFile> mappedFiles;                            // ǰӳ
+    std::unordered_map<std::string, VkShaderModule> modulesByName;
+    std::unordered_multimap<uint64_t, CachedShaderModule> modulesByHash;
+    ShaderLibraryStats stats;
+};
+
+// archivePath Ϊʱֻʹ·ɫЧʱ׳쳣
+void createShaderLibrary(ShaderLibrary& library, const std::vector<std::string>& searchPaths, const std::string& archivePath);
+void destroyShaderLibrary(ShaderLibrary& library);
+
+// ƣ "vert.spv"ȡɫģ飬Ҳ SPIR-V Чʱ׳쳣
+// ģɿУdestroyShaderLibrary ʱ
+VkShaderModule getShaderModule(ShaderLibrary& library, const std::string& name);
+
+void printShaderLibraryStats(const ShaderLibrary& library);
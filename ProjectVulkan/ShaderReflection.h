@@ -0,0 +1,164 @@
+// Generated by shader_build.py from shaders.json. Do not edit.
+#pragma once
+
+#include "ShaderInterface.h"
+
+namespace ShaderReflection {
+
+// Triangle: vert.vert + frag.frag
+constexpr uint32_t TriangleVertexStride = 8;
+static const VkVertexInputBindingDescription TriangleVertexBindings[] = {
+    { 0, 8, VK_VERTEX_INPUT_RATE_VERTEX },
+};
+static const VkVertexInputAttributeDescription TriangleVertexAttributes[] = {
+    { 0, 0, VK_FORMAT_R32G32_SFLOAT, 0 }, // inPosition
+};
+static const PipelineInterface Triangle = {
+    { "vert.spv", "frag.spv" },
+    2,
+    TriangleVertexBindings, 1,
+    TriangleVertexAttributes, 1,
+    nullptr, 0,
+    nullptr, 0,
+};
+
+// Instanced: instanced.vert + material.frag
+constexpr uint32_t InstancedVertexStride = 8;
+constexpr uint32_t InstancedInstanceStride = 16;
+constexpr uint32_t InstancedConstantsSet = 0;
+constexpr uint32_t InstancedConstantsSize = 64;
+static const VkVertexInputBindingDescription InstancedVertexBindings[] = {
+    { 0, 8, VK_VERTEX_INPUT_RATE_VERTEX },
+    { 1, 16, VK_VERTEX_INPUT_RATE_INSTANCE },
+};
+static const VkVertexInputAttributeDescription InstancedVertexAttributes[] = {
+    { 0, 0, VK_FORMAT_R32G32_SFLOAT, 0 }, // inPosition
+    { 1, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 0 }, // instanceTransform
+};
+static const VkPushConstantRange InstancedPushConstants[] = {
+    { VK_SHADER_STAGE_VERTEX_BIT, 0, 20 },
+};
+static const PipelineInterface Instanced = {
+    { "instanced.spv", "material.spv" },
+    2,
+    InstancedVertexBindings, 2,
+    InstancedVertexAttributes, 2,
+    nullptr, 0,
+    InstancedPushConstants, 1,
+};
+
+// InstancedTextured: instanced.vert + textured.frag
+constexpr uint32_t InstancedTexturedVertexStride = 8;
+constexpr uint32_t InstancedTexturedInstanceStride = 16;
+constexpr uint32_t InstancedTexturedConstantsSet = 0;
+constexpr uint32_t InstancedTexturedConstantsSize = 64;
+constexpr uint32_t InstancedTexturedBindlessSet = 1;
+static const VkVertexInputBindingDescription InstancedTexturedVertexBindings[] = {
+    { 0, 8, VK_VERTEX_INPUT_RATE_VERTEX },
+    { 1, 16, VK_VERTEX_INPUT_RATE_INSTANCE },
+};
+static const VkVertexInputAttributeDescription InstancedTexturedVertexAttributes[] = {
+    { 0, 0, VK_FORMAT_R32G32_SFLOAT, 0 }, // inPosition
+    { 1, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 0 }, // instanceTransform
+};
+static const VkPushConstantRange InstancedTexturedPushConstants[] = {
+    { VK_SHADER_STAGE_VERTEX_BIT, 0, 20 },
+};
+static const PipelineInterface InstancedTextured = {
+    { "instanced.spv", "textured.spv" },
+    2,
+    InstancedTexturedVertexBindings, 2,
+    InstancedTexturedVertexAttributes, 2,
+    nullptr, 0,
+    InstancedTexturedPushConstants, 1,
+};
+
+// BuildDraws: build_draws.comp
+static const VkDescriptorSetLayoutBinding BuildDrawsSet0Bindings[] = {
+    { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Objects
+    { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Commands
+    { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Instances
+    { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // DrawCount
+};
+static const DescriptorSetInterface BuildDrawsDescriptorSets[] = {
+    { 0, BuildDrawsSet0Bindings, 4 },
+};
+static const VkPushConstantRange BuildDrawsPushConstants[] = {
+    { VK_SHADER_STAGE_COMPUTE_BIT, 0, 104 },
+};
+static const PipelineInterface BuildDraws = {
+    { "build_draws.spv" },
+    1,
+    nullptr, 0,
+    nullptr, 0,
+    BuildDrawsDescriptorSets, 1,
+    BuildDrawsPushConstants, 1,
+};
+
+// ParticleSimulate: particle_simulate.comp
+static const VkDescriptorSetLayoutBinding ParticleSimulateSet0Bindings[] = {
+    { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Particles
+    { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Counters
+    { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Instances
+    { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Draw
+};
+static const DescriptorSetInterface ParticleSimulateDescriptorSets[] = {
+    { 0, ParticleSimulateSet0Bindings, 4 },
+};
+static const VkPushConstantRange ParticleSimulatePushConstants[] = {
+    { VK_SHADER_STAGE_COMPUTE_BIT, 0, 80 },
+};
+static const PipelineInterface ParticleSimulate = {
+    { "particle_simulate.spv" },
+    1,
+    nullptr, 0,
+    nullptr, 0,
+    ParticleSimulateDescriptorSets, 1,
+    ParticleSimulatePushConstants, 1,
+};
+
+// ParticleScan: particle_scan.comp
+static const VkDescriptorSetLayoutBinding ParticleScanSet0Bindings[] = {
+    { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Particles
+    { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Counters
+    { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Instances
+    { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Draw
+};
+static const DescriptorSetInterface ParticleScanDescriptorSets[] = {
+    { 0, ParticleScanSet0Bindings, 4 },
+};
+static const VkPushConstantRange ParticleScanPushConstants[] = {
+    { VK_SHADER_STAGE_COMPUTE_BIT, 0, 80 },
+};
+static const PipelineInterface ParticleScan = {
+    { "particle_scan.spv" },
+    1,
+    nullptr, 0,
+    nullptr, 0,
+    ParticleScanDescriptorSets, 1,
+    ParticleScanPushConstants, 1,
+};
+
+// ParticleCompact: particle_compact.comp
+static const VkDescriptorSetLayoutBinding ParticleCompactSet0Bindings[] = {
+    { 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Particles
+    { 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Counters
+    { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Instances
+    { 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr }, // Draw
+};
+static const DescriptorSetInterface ParticleCompactDescriptorSets[] = {
+    { 0, ParticleCompactSet0Bindings, 4 },
+};
+static const VkPushConstantRange ParticleCompactPushConstants[] = {
+    { VK_SHADER_STAGE_COMPUTE_BIT, 0, 80 },
+};
+static const PipelineInterface ParticleCompact = {
+    { "particle_compact.spv" },
+    1,
+    nullptr, 0,
+    nullptr, 0,
+    ParticleCompactDescriptorSets, 1,
+    ParticleCompactPushConstants, 1,
+};
+
+}
@@ -0,0 +1,403 @@
+#include "SimdMath.h"
+
+#include <cmath>
+
+#if SIMD_MATH_SSE2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif SIMD_MATH_NEON
+#include <arm_neon.h>
+#endif
+
+Vec3 vec3Add(const Vec3& a, const Vec3& b) {
+    return { a.x + b.x, a.y + b.y, a.z + b.z };
+}
+
+Vec3 vec3Sub(const Vec3& a, const Vec3& b) {
+    return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+Vec3 vec3Scale(const Vec3& v, float s) {
+    return { v.x * s, v.y * s, v.z * s };
+}
+
+float vec3Dot(const Vec3& a, const Vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+Vec3 vec3Cross(const Vec3& a, const Vec3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+float vec3Length(const Vec3& v) {
+    return std::sqrt(vec3Dot(v, v));
+}
+
+Vec3 vec3Normalize(const Vec3& v) {
+    float length = vec3Length(v);
+    return length > 0.0f ? vec3Scale(v, 1.0f / length) : v;
+}
+
+Quat quatIdentity() {
+    return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+Quat quatFromAxisAngle(const Vec3& axis, float radians) {
+    Vec3 n = vec3Normalize(axis);
+    float s = std::sin(radians * 0.5f);
+    return { n.x * s, n.y * s, n.z * s, std::cos(radians * 0.5f) };
+}
+
+Quat quatMultiply(const Quat& a, const Quat& b) {
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    };
+}
+
+Quat quatNormalize(const Quat& q) {
+    float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length == 0.0f) {
+        return quatIdentity();
+    }
+    float inv = 1.0f / length;
+    return { q.x * inv, q.y * inv, q.z * inv, q.w * inv };
+}
+
+Vec3 quatRotate(const Quat& q, const Vec3& v) {
+    // v' = v + w * t + q  tt = 2 * (q  v)
+    Vec3 u = { q.x, q.y, q.z };
+    Vec3 t = vec3Scale(vec3Cross(u, v), 2.0f);
+    return vec3Add(vec3Add(v, vec3Scale(t, q.w)), vec3Cross(u, t));
+}
+
+Mat4 mat4Identity() {
+    return mat4Scale(1.0f, 1.0f, 1.0f);
+}
+
+Mat4 mat4Scale(float x, float y, float z) {
+    Mat4 result = {};
+    result.m[0] = x;
+    result.m[5] = y;
+    result.m[10] = z;
+    result.m[15] = 1.0f;
+    return result;
+}
+
+Mat4 mat4Multiply(const Mat4& a, const Mat4& b) {
+    Mat4 result;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            result.m[c * 4 + r] = a.m[r] * b.m[c * 4] + a.m[4 + r] * b.m[c * 4 + 1]
+                + a.m[8 + r] * b.m[c * 4 + 2] + a.m[12 + r] * b.m[c * 4 + 3];
+        }
+    }
+    return result;
+}
+
+Mat4 mat4FromTransform(const Vec3& position, const Quat& rotation, const Vec3& scale) {
+    const Quat& q = rotation;
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    Mat4 result;
+    result.m[0] = (1.0f - 2.0f * (yy + zz)) * scale.x;
+    result.m[1] = 2.0f * (xy + wz) * scale.x;
+    result.m[2] = 2.0f * (xz - wy) * scale.x;
+    result.m[3] = 0.0f;
+    result.m[4] = 2.0f * (xy - wz) * scale.y;
+    result.m[5] = (1.0f - 2.0f * (xx + zz)) * scale.y;
+    result.m[6] = 2.0f * (yz + wx) * scale.y;
+    result.m[7] = 0.0f;
+    result.m[8] = 2.0f * (xz + wy) * scale.z;
+    result.m[9] = 2.0f * (yz - wx) * scale.z;
+    result.m[10] = (1.0f - 2.0f * (xx + yy)) * scale.z;
+    result.m[11] = 0.0f;
+    result.m[12] = position.x;
+    result.m[13] = position.y;
+    result.m[14] = position.z;
+    result.m[15] = 1.0f;
+    return result;
+}
+
+Vec4 mat4Transform(const Mat4& m, const Vec4& v) {
+    return {
+        m.m[0] * v.x + m.m[4] * v.y + m.m[8] * v.z + m.m[12] * v.w,
+        m.m[1] * v.x + m.m[5] * v.y + m.m[9] * v.z + m.m[13] * v.w,
+        m.m[2] * v.x + m.m[6] * v.y + m.m[10] * v.z + m.m[14] * v.w,
+        m.m[3] * v.x + m.m[7] * v.y + m.m[11] * v.z + m.m[15] * v.w,
+    };
+}
+
+Mat4 mat4Perspective(float fovY, float aspect, float zNear, float zFar) {
+    float f = 1.0f / std::tan(fovY * 0.5f);
+    Mat4 result = {};
+    result.m[0] = f / aspect;
+    result.m[5] = -f;
+    result.m[10] = zFar / (zNear - zFar);
+    result.m[11] = -1.0f;
+    result.m[14] = zNear * zFar / (zNear - zFar);
+    return result;
+}
+
+Mat4 mat4LookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    Vec3 f = vec3Normalize(vec3Sub(target, eye));
+    Vec3 s = vec3Normalize(vec3Cross(f, up));
+    Vec3 u = vec3Cross(s, f);
+
+    Mat4 result = mat4Identity();
+    result.m[0] = s.x;
+    result.m[4] = s.y;
+    result.m[8] = s.z;
+    result.m[1] = u.x;
+    result.m[5] = u.y;
+    result.m[9] = u.z;
+    result.m[2] = -f.x;
+    result.m[6] = -f.y;
+    result.m[10] = -f.z;
+    result.m[12] = -vec3Dot(s, eye);
+    result.m[13] = -vec3Dot(u, eye);
+    result.m[14] = vec3Dot(f, eye);
+    return result;
+}
+
+void extractFrustumPlanes(const Mat4& viewProjection, float planes[6][4]) {
+    // üռĵ i Уrow(i) = (m[i], m[4 + i], m[8 + i], m[12 + i])
+    float rows[4][4];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            rows[i][j] = viewProjection.m[j * 4 + i];
+        }
+    }
+
+    // -w <= x <= w-w <= y <= w0 <= z <= wÿʽһƽ
+    const float zero[4] = { 0, 0, 0, 0 };
+    const float* lhs[6] = { rows[3], rows[3], rows[3], rows[3], zero, rows[3] };
+    const float* rhs[6] = { rows[0], rows[0], rows[1], rows[1], rows[2], rows[2] };
+    const float signs[6] = { 1, -1, 1, -1, 1, -1 };
+
+    for (int p = 0; p < 6; p++) {
+        float* plane = planes[p];
+        for (int j = 0; j < 4; j++) {
+            plane[j] = lhs[p][j] + signs[p] * rhs[p][j];
+        }
+
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            for (int j = 0; j < 4; j++) {
+                plane[j] /= length;
+            }
+        }
+    }
+}
+
+void resizeTransforms(TransformSoA& transforms, uint32_t count) {
+    for (std::vector<float>* component : { &transforms.positionX, &transforms.positionY, &transforms.positionZ,
+        &transforms.rotationX, &transforms.rotationY, &transforms.rotationZ,
+        &transforms.scaleX, &transforms.scaleY, &transforms.scaleZ }) {
+        component->resize(count, 0.0f);
+    }
+    transforms.rotationW.resize(count, 1.0f);
+    transforms.count = count;
+}
+
+void setTransform(TransformSoA& transforms, uint32_t index, const Vec3& position, const Quat& rotation, const Vec3& scale) {
+    transforms.positionX[index] = position.x;
+    transforms.positionY[index] = position.y;
+    transforms.positionZ[index] = position.z;
+    transforms.rotationX[index] = rotation.x;
+    transforms.rotationY[index] = rotation.y;
+    transforms.rotationZ[index] = rotation.z;
+    transforms.rotationW[index] = rotation.w;
+    transforms.scaleX[index] = scale.x;
+    transforms.scaleY[index] = scale.y;
+    transforms.scaleZ[index] = scale.z;
+}
+
+void resizeAabbs(AabbSoA& bounds, uint32_t count) {
+    for (std::vector<float>* component : { &bounds.centerX, &bounds.centerY, &bounds.centerZ,
+        &bounds.extentX, &bounds.extentY, &bounds.extentZ }) {
+        component->resize(count, 0.0f);
+    }
+    bounds.count = count;
+}
+
+// ---- ο汾Ҳڴ SIMD ֮β ----
+
+static Mat4 getModelMatrix(const TransformSoA& t, uint32_t i) {
+    return mat4FromTransform({ t.positionX[i], t.positionY[i], t.positionZ[i] },
+        { t.rotationX[i], t.rotationY[i], t.rotationZ[i], t.rotationW[i] }, { t.scaleX[i], t.scaleY[i], t.scaleZ[i] });
+}
+
+static void modelViewProjectionRange(const Mat4& viewProjection, const TransformSoA& transforms, Mat4* out, uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+        out[i] = mat4Multiply(viewProjection, getModelMatrix(transforms, i));
+    }
+}
+
+static void transformAabbsRange(const TransformSoA& transforms, const AabbSoA& local, AabbSoA& world, uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+        Mat4 m = getModelMatrix(transforms, i);
+        float cx = local.centerX[i], cy = local.centerY[i], cz = local.centerZ[i];
+        float ex = local.extentX[i], ey = local.extentY[i], ez = local.extentZ[i];
+
+        // İ任볤Ԫصľֵ任Arvo
+        world.centerX[i] = m.m[0] * cx + m.m[4] * cy + m.m[8] * cz + m.m[12];
+        world.centerY[i] = m.m[1] * cx + m.m[5] * cy + m.m[9] * cz + m.m[13];
+        world.centerZ[i] = m.m[2] * cx + m.m[6] * cy + m.m[10] * cz + m.m[14];
+        world.extentX[i] = std::fabs(m.m[0]) * ex + std::fabs(m.m[4]) * ey + std::fabs(m.m[8]) * ez;
+        world.extentY[i] = std::fabs(m.m[1]) * ex + std::fabs(m.m[5]) * ey + std::fabs(m.m[9]) * ez;
+        world.extentZ[i] = std::fabs(m.m[2]) * ex + std::fabs(m.m[6]) * ey + std::fabs(m.m[10]) * ez;
+    }
+}
+
+static uint32_t frustumTestRange(const float planes[6][4], const AabbSoA& bounds, uint8_t* visible, uint32_t begin, uint32_t end) {
+    uint32_t visibleCount = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; p++) {
+            const float* plane = planes[p];
+            float distance = plane[0] * bounds.centerX[i] + plane[1] * bounds.centerY[i] + plane[2] * bounds.centerZ[i] + plane[3];
+            float radius = std::fabs(plane[0]) * bounds.extentX[i] + std::fabs(plane[1]) * bounds.extentY[i]
+                + std::fabs(plane[2]) * bounds.extentZ[i];
+            inside = distance + radius >= 0.0f;
+        }
+        visible[i] = inside ? 1 : 0;
+        visibleCount += inside ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+void batchModelViewProjectionScalar(const Mat4& viewProjection, const TransformSoA& transforms, Mat4* out) {
+    modelViewProjectionRange(viewProjection, transforms, out, 0, transforms.count);
+}
+
+void batchTransformAabbsScalar(const TransformSoA& transforms, const AabbSoA& local, AabbSoA& world) {
+    transformAabbsRange(transforms, local, world, 0, local.count);
+}
+
+uint32_t batchFrustumTestScalar(const float planes[6][4], const AabbSoA& bounds, uint8_t* visible) {
+    return frustumTestRange(planes, bounds, visible, 0, bounds.count);
+}
+
+// ---- SIMD ں˺ʱѡ ----
+
+#if SIMD_MATH_AVX2
+namespace avx2 {
+#define SIMD_MATH_KERNEL_AVX2 1
+#include "SimdMathKernels.inl"
+#undef SIMD_MATH_KERNEL_AVX2
+}
+#endif
+
+#if SIMD_MATH_SSE2 || SIMD_MATH_NEON
+namespace baseline {
+#include "SimdMathKernels.inl"
+}
+#endif
+
+struct SimdMathKernels {
+    const char* isa = "scalar";
+    uint32_t width = 1;
+    uint32_t (*modelViewProjection)(const Mat4&, const TransformSoA&, Mat4*) = nullptr;
+    uint32_t (*transformAabbs)(const TransformSoA&, const AabbSoA&, AabbSoA&) = nullptr;
+    uint32_t (*frustumTest)(const float[6][4], const AabbSoA&, uint8_t*, uint32_t&) = nullptr;
+};
+
+#if SIMD_MATH_AVX2
+// CPU ֧ AVX2  FMAҲϵͳлʱ YMM Ĵ
+static bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const int osxsave = 1 << 27, avx = 1 << 28, fma = 1 << 12;
+    if ((info[2] & (osxsave | avx | fma)) != (osxsave | avx | fma) || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#endif
+
+static SimdMathKernels selectKernels(bool allowAvx2) {
+    SimdMathKernels kernels;
+#if SIMD_MATH_AVX2
+    if (allowAvx2 && cpuSupportsAvx2()) {
+        kernels.isa = "AVX2";
+        kernels.width = avx2::SIMD_WIDTH;
+        kernels.modelViewProjection = avx2::modelViewProjectionKernel;
+        kernels.transformAabbs = avx2::transformAabbsKernel;
+        kernels.frustumTest = avx2::frustumTestKernel;
+        return kernels;
+    }
+#endif
+#if SIMD_MATH_SSE2 || SIMD_MATH_NEON
+#if SIMD_MATH_SSE2
+    kernels.isa = "SSE2";
+#else
+    kernels.isa = "NEON";
+#endif
+    kernels.width = baseline::SIMD_WIDTH;
+    kernels.modelViewProjection = baseline::modelViewProjectionKernel;
+    kernels.transformAabbs = baseline::transformAabbsKernel;
+    kernels.frustumTest = baseline::frustumTestKernel;
+#endif
+    (void)allowAvx2;
+    return kernels;
+}
+
+static SimdMathKernels& getKernels() {
+    static SimdMathKernels kernels = selectKernels(true);
+    return kernels;
+}
+
+void batchModelViewProjection(const Mat4& viewProjection, const TransformSoA& transforms, Mat4* out) {
+    const SimdMathKernels& kernels = getKernels();
+    uint32_t i = kernels.modelViewProjection != nullptr ? kernels.modelViewProjection(viewProjection, transforms, out) : 0;
+    modelViewProjectionRange(viewProjection, transforms, out, i, transforms.count);
+}
+
+void batchTransformAabbs(const TransformSoA& transforms, const AabbSoA& local, AabbSoA& world) {
+    const SimdMathKernels& kernels = getKernels();
+    uint32_t i = kernels.transformAabbs != nullptr ? kernels.transformAabbs(transforms, local, world) : 0;
+    transformAabbsRange(transforms, local, world, i, local.count);
+}
+
+uint32_t batchFrustumTest(const float planes[6][4], const AabbSoA& bounds, uint8_t* visible) {
+    const SimdMathKernels& kernels = getKernels();
+    uint32_t visibleCount = 0;
+    uint32_t i = kernels.frustumTest != nullptr ? kernels.frustumTest(planes, bounds, visible, visibleCount) : 0;
+    return visibleCount + frustumTestRange(planes, bounds, visible, i, bounds.count);
+}
+
+bool isSimdMathAvx2Supported() {
+#if SIMD_MATH_AVX2
+    return cpuSupportsAvx2();
+#else
+    return false;
+#endif
+}
+
+void setSimdMathAvx2Enabled(bool enabled) {
+    getKernels() = selectKernels(enabled);
+}
+
+const char* getSimdMathIsa() {
+    return getKernels().isa;
+}
+
+uint32_t getSimdMathWidth() {
+    return getKernels().width;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Ԫ任 SoA ݡں˰ʱָѡ
+// SSE2 / NEON4 ·Ϊx86 һ AVX2 + FMA8 ·ںˣҪ /arch:AVX2
+// һεʱ CPU Ͳϵͳֲ֧ʹÿһο汾*ScalarУͻ׼
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_MATH_SSE2 1
+#define SIMD_MATH_AVX2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_MATH_NEON 1
+#endif
+
+// MSVC Ҫѡʹ AVX2 ڽGCC / Clang Ŀָ
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_MATH_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define SIMD_MATH_AVX2_TARGET
+#endif
+
+struct Vec3 {
+    float x, y, z;
+};
+
+struct Vec4 {
+    float x, y, z, w;
+};
+
+// λԪw Ϊʵ
+struct Quat {
+    float x, y, z, w;
+};
+
+//  GLSL һ£m[column * 4 + row]
+struct alignas(16) Mat4 {
+    float m[16];
+};
+
+Vec3 vec3Add(const Vec3& a, const Vec3& b);
+Vec3 vec3Sub(const Vec3& a, const Vec3& b);
+Vec3 vec3Scale(const Vec3& v, float s);
+float vec3Dot(const Vec3& a, const Vec3& b);
+Vec3 vec3Cross(const Vec3& a, const Vec3& b);
+float vec3Length(const Vec3& v);
+Vec3 vec3Normalize(const Vec3& v);
+
+Quat quatIdentity();
+Quat quatFromAxisAngle(const Vec3& axis, float radians);
+Quat quatMultiply(const Quat& a, const Quat& b);   //  b  a
+Quat quatNormalize(const Quat& q);
+Vec3 quatRotate(const Quat& q, const Vec3& v);
+
+Mat4 mat4Identity();
+Mat4 mat4Scale(float x, float y, float z);
+Mat4 mat4Multiply(const Mat4& a, const Mat4& b);   // a * b
+Mat4 mat4FromTransform(const Vec3& position, const Quat& rotation, const Vec3& scale);
+Vec4 mat4Transform(const Mat4& m, const Vec4& v);
+
+// ϵ -züռ y ¡z  [0, 1]Vulkan Լ
+Mat4 mat4Perspective(float fovY, float aspect, float zNear, float zFar);
+Mat4 mat4LookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+
+//  viewProjection ȡ 6 ׶ƽ棺xyz Ϊָڲĵλߣw Ϊ루üռ z  [0, w]
+void extractFrustumPlanes(const Mat4& viewProjection, float planes[6][4]);
+
+// 任 SoA 洢ÿһ飬һδ SIMD ȸ
+struct TransformSoA {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+    uint32_t count = 0;
+};
+
+// Χе SoA 洢 + 볤
+struct AabbSoA {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ;
+    uint32_t count = 0;
+};
+
+void resizeTransforms(TransformSoA& transforms, uint32_t count);
+void setTransform(TransformSoA& transforms, uint32_t index, const Vec3& position, const Quat& rotation, const Vec3& scale);
+void resizeAabbs(AabbSoA& bounds, uint32_t count);
+
+// out[i] = viewProjection * model(i)out ˳д룬ֱָӳϴڴ棨糣
+void batchModelViewProjection(const Mat4& viewProjection, const TransformSoA& transforms, Mat4* out);
+void batchModelViewProjectionScalar(const Mat4& viewProjection, const TransformSoA& transforms, Mat4* out);
+
+// ֲΧоԵı任ռΧУworld  local.count Ԫأ
+void batchTransformAabbs(const TransformSoA& transforms, const AabbSoA& local, AabbSoA& world);
+void batchTransformAabbsScalar(const TransformSoA& transforms, const AabbSoA& local, AabbSoA& world);
+
+// visible[i] Ϊ 1 ʾΧ׶ཻؿɼ
+uint32_t batchFrustumTest(const float planes[6][4], const AabbSoA& bounds, uint8_t* visible);
+uint32_t batchFrustumTestScalar(const float planes[6][4], const AabbSoA& bounds, uint8_t* visible);
+
+// CPU ͲϵͳǷ֧ AVX2 ں
+bool isSimdMathAvx2Supported();
+
+// رʱ˻ػںˣУͱȽںˣ֧ʱЧʱִ߳
+void setSimdMathAvx2Enabled(bool enabled);
+
+// ǰʹõָƺÿδ
+const char* getSimdMathIsa();
+uint32_t getSimdMathWidth();
@@ -0,0 +1,191 @@
+// SIMD ںˣ SimdMath.cpp ڸԵռа SIMD_MATH_KERNEL_AVX2 ʱ AVX2 + FMA8 ·汾
+// 򰴻ָSSE2 / NEON4 ·롣ָֻṩں˱ֻдһΡ
+// ںֻ SIMD_WIDTH 壬صһûд±꣬βɵñ汾
+
+#if SIMD_MATH_KERNEL_AVX2
+#define SIMD_KERNEL SIMD_MATH_AVX2_TARGET
+#else
+#define SIMD_KERNEL
+#endif
+
+#if SIMD_MATH_KERNEL_AVX2
+typedef __m256 vfloat;
+static const uint32_t SIMD_WIDTH = 8;
+SIMD_KERNEL static inline vfloat vload(const float* p) { return _mm256_loadu_ps(p); }
+SIMD_KERNEL static inline void vstore(float* p, vfloat v) { _mm256_storeu_ps(p, v); }
+SIMD_KERNEL static inline vfloat vset1(float x) { return _mm256_set1_ps(x); }
+SIMD_KERNEL static inline vfloat vadd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+SIMD_KERNEL static inline vfloat vsub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+SIMD_KERNEL static inline vfloat vmul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+SIMD_KERNEL static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return _mm256_fmadd_ps(a, b, c); }
+SIMD_KERNEL static inline vfloat vabs(vfloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+// С 0 ͨӦλ
+SIMD_KERNEL static inline uint32_t vnegativeMask(vfloat a) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_LT_OQ))); }
+
+// r0..r3  8 ĳһе 4 Уתúÿһ
+SIMD_KERNEL static inline void storeColumn(Mat4* out, int column, vfloat r0, vfloat r1, vfloat r2, vfloat r3) {
+    for (int half = 0; half < 2; half++) {
+        __m128 a = half == 0 ? _mm256_castps256_ps128(r0) : _mm256_extractf128_ps(r0, 1);
+        __m128 b = half == 0 ? _mm256_castps256_ps128(r1) : _mm256_extractf128_ps(r1, 1);
+        __m128 c = half == 0 ? _mm256_castps256_ps128(r2) : _mm256_extractf128_ps(r2, 1);
+        __m128 d = half == 0 ? _mm256_castps256_ps128(r3) : _mm256_extractf128_ps(r3, 1);
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+        Mat4* base = out + half * 4;
+        _mm_storeu_ps(base[0].m + column * 4, a);
+        _mm_storeu_ps(base[1].m + column * 4, b);
+        _mm_storeu_ps(base[2].m + column * 4, c);
+        _mm_storeu_ps(base[3].m + column * 4, d);
+    }
+}
+#elif SIMD_MATH_SSE2
+typedef __m128 vfloat;
+static const uint32_t SIMD_WIDTH = 4;
+static inline vfloat vload(const float* p) { return _mm_loadu_ps(p); }
+static inline void vstore(float* p, vfloat v) { _mm_storeu_ps(p, v); }
+static inline vfloat vset1(float x) { return _mm_set1_ps(x); }
+static inline vfloat vadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+static inline vfloat vabs(vfloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline uint32_t vnegativeMask(vfloat a) { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, _mm_setzero_ps()))); }
+
+static inline void storeColumn(Mat4* out, int column, vfloat r0, vfloat r1, vfloat r2, vfloat r3) {
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(out[0].m + column * 4, r0);
+    _mm_storeu_ps(out[1].m + column * 4, r1);
+    _mm_storeu_ps(out[2].m + column * 4, r2);
+    _mm_storeu_ps(out[3].m + column * 4, r3);
+}
+#elif SIMD_MATH_NEON
+typedef float32x4_t vfloat;
+static const uint32_t SIMD_WIDTH = 4;
+static inline vfloat vload(const float* p) { return vld1q_f32(p); }
+static inline void vstore(float* p, vfloat v) { vst1q_f32(p, v); }
+static inline vfloat vset1(float x) { return vdupq_n_f32(x); }
+static inline vfloat vadd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+static inline vfloat vsub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+static inline vfloat vmul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+static inline vfloat vmadd(vfloat a, vfloat b, vfloat c) { return vfmaq_f32(c, a, b); }
+static inline vfloat vabs(vfloat a) { return vabsq_f32(a); }
+static inline uint32_t vnegativeMask(vfloat a) {
+    static const uint32_t bits[4] = { 1, 2, 4, 8 };
+    uint32x4_t negative = vcltq_f32(a, vdupq_n_f32(0.0f));
+    return vaddvq_u32(vandq_u32(negative, vld1q_u32(bits)));
+}
+
+static inline void storeColumn(Mat4* out, int column, vfloat r0, vfloat r1, vfloat r2, vfloat r3) {
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    vst1q_f32(out[0].m + column * 4, vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+    vst1q_f32(out[1].m + column * 4, vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+    vst1q_f32(out[2].m + column * 4, vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+    vst1q_f32(out[3].m + column * 4, vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+}
+#endif
+
+// SIMD_WIDTH ģ; 3x3ת * ţm[column][row]
+struct ModelBasis {
+    vfloat m[3][3];
+};
+
+SIMD_KERNEL static inline ModelBasis loadModelBasis(const TransformSoA& t, uint32_t i) {
+    vfloat qx = vload(&t.rotationX[i]), qy = vload(&t.rotationY[i]), qz = vload(&t.rotationZ[i]), qw = vload(&t.rotationW[i]);
+    vfloat two = vset1(2.0f), one = vset1(1.0f);
+    vfloat xx = vmul(qx, qx), yy = vmul(qy, qy), zz = vmul(qz, qz);
+    vfloat xy = vmul(qx, qy), xz = vmul(qx, qz), yz = vmul(qy, qz);
+    vfloat wx = vmul(qw, qx), wy = vmul(qw, qy), wz = vmul(qw, qz);
+
+    vfloat sx = vload(&t.scaleX[i]), sy = vload(&t.scaleY[i]), sz = vload(&t.scaleZ[i]);
+    ModelBasis basis;
+    basis.m[0][0] = vmul(vsub(one, vmul(two, vadd(yy, zz))), sx);
+    basis.m[0][1] = vmul(vmul(two, vadd(xy, wz)), sx);
+    basis.m[0][2] = vmul(vmul(two, vsub(xz, wy)), sx);
+    basis.m[1][0] = vmul(vmul(two, vsub(xy, wz)), sy);
+    basis.m[1][1] = vmul(vsub(one, vmul(two, vadd(xx, zz))), sy);
+    basis.m[1][2] = vmul(vmul(two, vadd(yz, wx)), sy);
+    basis.m[2][0] = vmul(vmul(two, vadd(xz, wy)), sz);
+    basis.m[2][1] = vmul(vmul(two, vsub(yz, wx)), sz);
+    basis.m[2][2] = vmul(vsub(one, vmul(two, vadd(xx, yy))), sz);
+    return basis;
+}
+
+SIMD_KERNEL static uint32_t modelViewProjectionKernel(const Mat4& viewProjection, const TransformSoA& transforms, Mat4* out) {
+    vfloat vp[16];
+    for (int k = 0; k < 16; k++) {
+        vp[k] = vset1(viewProjection.m[k]);
+    }
+
+    uint32_t i = 0;
+    for (; i + SIMD_WIDTH <= transforms.count; i += SIMD_WIDTH) {
+        ModelBasis basis = loadModelBasis(transforms, i);
+        vfloat position[3] = { vload(&transforms.positionX[i]), vload(&transforms.positionY[i]), vload(&transforms.positionZ[i]) };
+
+        // ĵ c  = VP ǰаģ; c мȨģ; 4 Ϊ 0 0 0 1
+        for (int c = 0; c < 4; c++) {
+            const vfloat* column = c < 3 ? basis.m[c] : position;
+            vfloat rows[4];
+            for (int r = 0; r < 4; r++) {
+                vfloat value = vmadd(vp[8 + r], column[2], vmadd(vp[4 + r], column[1], vmul(vp[r], column[0])));
+                rows[r] = c < 3 ? value : vadd(value, vp[12 + r]);
+            }
+            storeColumn(out + i, c, rows[0], rows[1], rows[2], rows[3]);
+        }
+    }
+    return i;
+}
+
+SIMD_KERNEL static uint32_t transformAabbsKernel(const TransformSoA& transforms, const AabbSoA& local, AabbSoA& world) {
+    uint32_t i = 0;
+    for (; i + SIMD_WIDTH <= local.count; i += SIMD_WIDTH) {
+        ModelBasis basis = loadModelBasis(transforms, i);
+        vfloat center[3] = { vload(&local.centerX[i]), vload(&local.centerY[i]), vload(&local.centerZ[i]) };
+        vfloat extent[3] = { vload(&local.extentX[i]), vload(&local.extentY[i]), vload(&local.extentZ[i]) };
+        vfloat position[3] = { vload(&transforms.positionX[i]), vload(&transforms.positionY[i]), vload(&transforms.positionZ[i]) };
+        float* worldCenter[3] = { &world.centerX[i], &world.centerY[i], &world.centerZ[i] };
+        float* worldExtent[3] = { &world.extentX[i], &world.extentY[i], &world.extentZ[i] };
+
+        for (int r = 0; r < 3; r++) {
+            vfloat c = vmadd(basis.m[2][r], center[2], vmadd(basis.m[1][r], center[1], vmadd(basis.m[0][r], center[0], position[r])));
+            vfloat e = vmadd(vabs(basis.m[2][r]), extent[2], vmadd(vabs(basis.m[1][r]), extent[1], vmul(vabs(basis.m[0][r]), extent[0])));
+            vstore(worldCenter[r], c);
+            vstore(worldExtent[r], e);
+        }
+    }
+    return i;
+}
+
+// visibleCount ۼӱں˴пɼ
+SIMD_KERNEL static uint32_t frustumTestKernel(const float planes[6][4], const AabbSoA& bounds, uint8_t* visible, uint32_t& visibleCount) {
+    vfloat normal[6][3], absNormal[6][3], distance[6];
+    for (int p = 0; p < 6; p++) {
+        for (int k = 0; k < 3; k++) {
+            normal[p][k] = vset1(planes[p][k]);
+            absNormal[p][k] = vset1(std::fabs(planes[p][k]));
+        }
+        distance[p] = vset1(planes[p][3]);
+    }
+
+    uint32_t i = 0;
+    for (; i + SIMD_WIDTH <= bounds.count; i += SIMD_WIDTH) {
+        vfloat cx = vload(&bounds.centerX[i]), cy = vload(&bounds.centerY[i]), cz = vload(&bounds.centerZ[i]);
+        vfloat ex = vload(&bounds.extentX[i]), ey = vload(&bounds.extentY[i]), ez = vload(&bounds.extentZ[i]);
+
+        // κһƽľ + ͶӰ뾶 < 0 嶼׶
+        uint32_t outside = 0;
+        for (int p = 0; p < 6; p++) {
+            vfloat d = vmadd(normal[p][2], cz, vmadd(normal[p][1], cy, vmadd(normal[p][0], cx, distance[p])));
+            vfloat r = vmadd(absNormal[p][2], ez, vmadd(absNormal[p][1], ey, vmul(absNormal[p][0], ex)));
+            outside |= vnegativeMask(vadd(d, r));
+        }
+
+        for (uint32_t lane = 0; lane < SIMD_WIDTH; lane++) {
+            uint8_t inside = ((outside >> lane) & 1) == 0 ? 1 : 0;
+            visible[i + lane] = inside;
+            visibleCount += inside;
+        }
+    }
+    return i;
+}
+
+#undef SIMD_KERNEL
@@ -0,0 +1,894 @@
+#include "Streaming.h"
+#include "MappedFile.h"
+#include "ShaderReflection.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+// 񶥵ֻλãxy vert.vert / instanced.vert Ķ㲼һ
+static const VkDeviceSize STREAMED_VERTEX_SIZE = 2 * sizeof(float);
+static_assert(STREAMED_VERTEX_SIZE == ShaderReflection::TriangleVertexStride, "streamed mesh vertices must match vert.vert inputs");
+
+static const VkDeviceSize STAGING_ALIGNMENT = 16;
+
+// ǰȲĴСڷݴռ
+struct DecodedLayout {
+    VkDeviceSize bytes = 0;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// ---- .obj ----
+
+// бӳļûнβ '\0'ÿиƳٽ
+template <typename Fn>
+static void forEachLine(const uint8_t* data, size_t size, Fn fn) {
+    std::string line;
+    size_t start = 0;
+    while (start < size) {
+        size_t end = start;
+        while (end < size && data[end] != '\n') {
+            end++;
+        }
+        line.assign(reinterpret_cast<const char*>(data + start), end - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        fn(line);
+        start = end + 1;
+    }
+}
+
+// еһã"v""v/vt""v/vt/vn""v//vn"ش 0 ʼ±
+static bool parseFaceIndex(const char*& cursor, uint32_t vertexCount, uint32_t& index) {
+    char* end = nullptr;
+    long value = strtol(cursor, &end, 10);
+    if (end == cursor) {
+        return false;
+    }
+
+    // ͷ±
+    while (*end != '\0' && !isspace(static_cast<unsigned char>(*end))) {
+        end++;
+    }
+    cursor = end;
+
+    // ʾڵǰѶĶ
+    long resolved = value < 0 ? static_cast<long>(vertexCount) + value : value - 1;
+    if (resolved < 0 || resolved >= static_cast<long>(vertexCount)) {
+        return false;
+    }
+    index = static_cast<uint32_t>(resolved);
+    return true;
+}
+
+static uint32_t countFaceVertices(const char* cursor) {
+    uint32_t count = 0;
+    while (*cursor != '\0') {
+        while (isspace(static_cast<unsigned char>(*cursor))) {
+            cursor++;
+        }
+        if (*cursor == '\0') {
+            break;
+        }
+        count++;
+        while (*cursor != '\0' && !isspace(static_cast<unsigned char>(*cursor))) {
+            cursor++;
+        }
+    }
+    return count;
+}
+
+static bool measureObj(const MappedFile& file, DecodedLayout& layout) {
+    forEachLine(file.data, file.size, [&](const std::string& line) {
+        if (line.compare(0, 2, "v ") == 0) {
+            layout.vertexCount++;
+        }
+        else if (line.compare(0, 2, "f ") == 0) {
+            uint32_t corners = countFaceVertices(line.c_str() + 2);
+            if (corners >= 3) {
+                layout.indexCount += (corners - 2) * 3; // ΰβ
+            }
+        }
+    });
+
+    layout.bytes = layout.vertexCount * STREAMED_VERTEX_SIZE + layout.indexCount * sizeof(uint32_t);
+    return layout.vertexCount > 0 && layout.indexCount > 0;
+}
+
+static bool decodeObj(const MappedFile& file, const DecodedLayout& layout, uint8_t* dst) {
+    float* positions = reinterpret_cast<float*>(dst);
+    uint32_t* indices = reinterpret_cast<uint32_t*>(dst + layout.vertexCount * STREAMED_VERTEX_SIZE);
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    bool ok = true;
+
+    forEachLine(file.data, file.size, [&](const std::string& line) {
+        if (!ok) {
+            return;
+        }
+
+        if (line.compare(0, 2, "v ") == 0) {
+            char* cursor = const_cast<char*>(line.c_str() + 2);
+            positions[vertexCount * 2 + 0] = strtof(cursor, &cursor);
+            positions[vertexCount * 2 + 1] = strtof(cursor, &cursor);
+            vertexCount++;
+        }
+        else if (line.compare(0, 2, "f ") == 0) {
+            const char* cursor = line.c_str() + 2;
+            uint32_t corners = countFaceVertices(cursor);
+            uint32_t first = 0;
+            uint32_t previous = 0;
+            for (uint32_t i = 0; i < corners && ok; i++) {
+                uint32_t index;
+                ok = parseFaceIndex(cursor, vertexCount, index);
+                if (i == 0) {
+                    first = index;
+                }
+                else if (i >= 2) {
+                    indices[indexCount++] = first;
+                    indices[indexCount++] = previous;
+                    indices[indexCount++] = index;
+                }
+                previous = index;
+            }
+        }
+    });
+
+    return ok && vertexCount == layout.vertexCount && indexCount == layout.indexCount;
+}
+
+// ---- .tga ----
+
+static const size_t TGA_HEADER_SIZE = 18;
+
+static bool measureTga(const MappedFile& file, DecodedLayout& layout) {
+    if (file.size < TGA_HEADER_SIZE) {
+        return false;
+    }
+
+    const uint8_t* header = file.data;
+    uint8_t colorMapType = header[1];
+    uint8_t imageType = header[2];
+    uint8_t bitsPerPixel = header[16];
+
+    // ֻ֧δѹɫ2ͻҶȣ3
+    bool trueColor = imageType == 2 && (bitsPerPixel == 24 || bitsPerPixel == 32);
+    bool grayscale = imageType == 3 && bitsPerPixel == 8;
+    if (colorMapType != 0 || !(trueColor || grayscale)) {
+        return false;
+    }
+
+    layout.width = header[12] | (header[13] << 8);
+    layout.height = header[14] | (header[15] << 8);
+    size_t pixelOffset = TGA_HEADER_SIZE + header[0];
+    size_t pixelBytes = static_cast<size_t>(layout.width) * layout.height * (bitsPerPixel / 8);
+    if (layout.width == 0 || layout.height == 0 || file.size < pixelOffset + pixelBytes) {
+        return false;
+    }
+
+    layout.bytes = static_cast<VkDeviceSize>(layout.width) * layout.height * 4;
+    return true;
+}
+
+static bool decodeTga(const MappedFile& file, const DecodedLayout& layout, uint8_t* dst) {
+    const uint8_t* header = file.data;
+    uint32_t channels = header[16] / 8;
+    bool topDown = (header[17] & 0x20) != 0;    // Ĭԭ½
+    const uint8_t* pixels = file.data + TGA_HEADER_SIZE + header[0];
+
+    for (uint32_t y = 0; y < layout.height; y++) {
+        const uint8_t* src = pixels + static_cast<size_t>(topDown ? y : layout.height - 1 - y) * layout.width * channels;
+        uint8_t* row = dst + static_cast<size_t>(y) * layout.width * 4;
+        for (uint32_t x = 0; x < layout.width; x++, src += channels, row += 4) {
+            if (channels == 1) {
+                row[0] = row[1] = row[2] = src[0];
+                row[3] = 255;
+            }
+            else {
+                // BGR(A) -> RGBA
+                row[0] = src[2];
+                row[1] = src[1];
+                row[2] = src[0];
+                row[3] = channels == 4 ? src[3] : 255;
+            }
+        }
+    }
+    return true;
+}
+
+bool decodeTgaFile(const MappedFile& file, uint32_t& width, uint32_t& height, std::vector<uint8_t>& pixels) {
+    DecodedLayout layout;
+    if (!measureTga(file, layout)) {
+        return false;
+    }
+    width = layout.width;
+    height = layout.height;
+    pixels.resize(static_cast<size_t>(layout.bytes));
+    return decodeTga(file, layout, pixels.data());
+}
+
+static bool measureAsset(AssetKind kind, const MappedFile& file, DecodedLayout& layout) {
+    return kind == AssetKind::Mesh ? measureObj(file, layout) : measureTga(file, layout);
+}
+
+static bool decodeAsset(AssetKind kind, const MappedFile& file, const DecodedLayout& layout, uint8_t* dst) {
+    return kind == AssetKind::Mesh ? decodeObj(file, layout, dst) : decodeTga(file, layout, dst);
+}
+
+static VkDeviceSize decodedBytes(const StreamedAsset& asset) {
+    if (asset.kind == AssetKind::Mesh) {
+        return asset.vertexCount * STREAMED_VERTEX_SIZE + asset.indexCount * sizeof(uint32_t);
+    }
+    return static_cast<VkDeviceSize>(asset.width) * asset.height * 4;
+}
+
+// ---- ݴ滷 ----
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+//  UploadContext ݴ滷ͬռ䰴˳ύύ˳ա
+// ߳ loader.mutexreserved Ϊռõֽͻ˷ѣ
+static bool reserveStaging(StreamingLoader& loader, VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize& reserved) {
+    const VkDeviceSize capacity = loader.staging.size;
+
+    if (loader.used == 0) {
+        loader.head = 0;
+    }
+
+    VkDeviceSize start = alignUp(loader.head, STAGING_ALIGNMENT);
+    VkDeviceSize needed = start - loader.head + size;
+    if (start + size > capacity) {
+        start = 0;
+        needed = capacity - loader.head + size;
+    }
+
+    if (loader.used + needed > capacity) {
+        return false;
+    }
+
+    offset = start;
+    reserved = needed;
+    loader.head = start + size;
+    loader.used += needed;
+    return true;
+}
+
+// ---- I/O ߳ ----
+
+static void ioThreadMain(StreamingLoader* loader) {
+    for (;;) {
+        AssetHandle handle;
+        StreamedAsset* asset;
+        {
+            std::unique_lock<std::mutex> lock(loader->mutex);
+            loader->requestAvailable.wait(lock, [loader] { return loader->stopping || !loader->requests.empty(); });
+            if (loader->stopping) {
+                return;
+            }
+            handle = loader->requests.front();
+            loader->requests.pop_front();
+            asset = loader->assets[handle].get();
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        MappedFile file;
+        DecodedLayout layout;
+        bool ok = mapFile(asset->path, file) && file.data != nullptr && measureAsset(asset->kind, file, layout);
+
+        uint8_t* dst = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(loader->mutex);
+            if (ok && layout.bytes + STAGING_ALIGNMENT > loader->staging.size) {
+                std::cerr << "Streaming: " << asset->path << " does not fit in the staging buffer" << std::endl;
+                ok = false;
+            }
+
+            if (ok) {
+                // ݴ滷ʱȴȾ̻߳ɵ
+                VkDeviceSize offset = 0;
+                VkDeviceSize reserved = 0;
+                while (!reserveStaging(*loader, layout.bytes, offset, reserved)) {
+                    if (loader->stopping) {
+                        unmapFile(file);
+                        return;
+                    }
+                    loader->stats.stagingWaits++;
+                    loader->stagingAvailable.wait(lock);
+                }
+
+                asset->stagingOffset = offset;
+                asset->stagingBytes = reserved;
+                asset->vertexCount = layout.vertexCount;
+                asset->indexCount = layout.indexCount;
+                asset->width = layout.width;
+                asset->height = layout.height;
+                asset->state = AssetState::Decoding;
+
+                //  staged ˳ݴ˳ͬ
+                loader->staged.push_back(handle);
+                dst = static_cast<uint8_t*>(loader->staging.mapped) + offset;
+            }
+            else {
+                asset->state = AssetState::Failed;
+                loader->stats.failed++;
+            }
+        }
+
+        if (dst == nullptr) {
+            unmapFile(file);
+            continue;
+        }
+
+        // ֱӽ뵽ݴڴ棬м仺
+        ok = decodeAsset(asset->kind, file, layout, dst);
+        size_t fileBytes = file.size;
+        unmapFile(file);
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(loader->mutex);
+        asset->state = ok ? AssetState::Staged : AssetState::Failed;
+        loader->stats.bytesRead += fileBytes;
+        loader->stats.decodeMs += ms;
+        if (!ok) {
+            loader->stats.failed++;
+        }
+    }
+}
+
+// ----  ----
+
+void createStreamingLoader(StreamingLoader& loader, VkQueue queue, uint32_t queueFamilyIndex, uint32_t graphicsQueueFamilyIndex,
+    bool timelineSemaphores, uint32_t ioThreadCount, VkDeviceSize stagingSize, VkDeviceSize frameBudget) {
+    loader.queue = queue;
+    loader.queueFamilyIndex = queueFamilyIndex;
+    loader.frameBudget = frameBudget;
+    if (queueFamilyIndex != graphicsQueueFamilyIndex) {
+        loader.sharingFamilies = { graphicsQueueFamilyIndex, queueFamilyIndex };
+    }
+
+    createBuffer(loader.staging, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &loader.commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create streaming command pool!");
+    }
+
+    if (timelineSemaphores) {
+        loader.getSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValueKHR>(
+            vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValueKHR"));
+        loader.waitSemaphores = reinterpret_cast<PFN_vkWaitSemaphoresKHR>(vkGetDeviceProcAddr(device, "vkWaitSemaphoresKHR"));
+    }
+
+    if (loader.getSemaphoreCounterValue != nullptr && loader.waitSemaphores != nullptr) {
+        VkSemaphoreTypeCreateInfoKHR typeInfo = {};
+        typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        typeInfo.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphoreInfo = {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
+
+        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &loader.timeline) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create streaming timeline semaphore!");
+        }
+    }
+
+    for (uint32_t i = 0; i < std::max(ioThreadCount, 1u); i++) {
+        loader.ioThreads.emplace_back(ioThreadMain, &loader);
+    }
+    loader.enabled = true;
+}
+
+// עɾУް±ͼһ黹
+static void destroyAsset(StreamingLoader& loader, StreamedAsset& asset) {
+    if (asset.vertexBuffer != INVALID_RESOURCE) {
+        destroyRegistryBuffer(*loader.registry, asset.vertexBuffer);
+        asset.vertexBuffer = INVALID_RESOURCE;
+    }
+    if (asset.indexBuffer != INVALID_RESOURCE) {
+        destroyRegistryBuffer(*loader.registry, asset.indexBuffer);
+        asset.indexBuffer = INVALID_RESOURCE;
+    }
+    if (asset.image != INVALID_RESOURCE) {
+        destroyRegistryImage(*loader.registry, asset.image);
+        asset.image = INVALID_RESOURCE;
+        asset.textureIndex = INVALID_BINDLESS_INDEX;
+    }
+}
+
+void destroyStreamingLoader(StreamingLoader& loader) {
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        loader.stopping = true;
+    }
+    loader.requestAvailable.notify_all();
+    loader.stagingAvailable.notify_all();
+    for (std::thread& thread : loader.ioThreads) {
+        thread.join();
+    }
+
+    if (loader.enabled) {
+        waitForStreaming(loader);
+    }
+
+    for (std::unique_ptr<StreamedAsset>& asset : loader.assets) {
+        destroyAsset(loader, *asset);
+    }
+    for (TransferBatch& batch : loader.freeBatches) {
+        if (batch.fence != VK_NULL_HANDLE) {
+            vkDestroyFence(device, batch.fence, nullptr);
+        }
+    }
+    if (loader.timeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device, loader.timeline, nullptr);
+    }
+    if (loader.commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, loader.commandPool, nullptr);
+    }
+    destroyBuffer(loader.staging);
+
+    loader.ioThreads.clear();
+    loader.assets.clear();
+    loader.requests.clear();
+    loader.staged.clear();
+    loader.inFlight.clear();
+    loader.freeBatches.clear();
+    loader.enabled = false;
+}
+
+AssetHandle requestAsset(StreamingLoader& loader, const std::string& path) {
+    std::string extension = path.substr(std::min(path.size(), path.find_last_of('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+    AssetKind kind;
+    if (extension == ".obj") {
+        kind = AssetKind::Mesh;
+    }
+    else if (extension == ".tga") {
+        kind = AssetKind::Texture;
+    }
+    else {
+        return INVALID_ASSET;
+    }
+
+    std::unique_ptr<StreamedAsset> asset(new StreamedAsset());
+    asset->path = path;
+    asset->kind = kind;
+
+    AssetHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        handle = static_cast<AssetHandle>(loader.assets.size());
+        loader.assets.push_back(std::move(asset));
+        loader.requests.push_back(handle);
+        loader.stats.requested++;
+    }
+    loader.requestAvailable.notify_one();
+    return handle;
+}
+
+AssetState getAssetState(StreamingLoader& loader, AssetHandle handle) {
+    std::lock_guard<std::mutex> lock(loader.mutex);
+    return handle < loader.assets.size() ? loader.assets[handle]->state : AssetState::Failed;
+}
+
+static bool isBatchComplete(const StreamingLoader& loader, const TransferBatch& batch, uint64_t completedValue) {
+    if (loader.timeline != VK_NULL_HANDLE) {
+        return completedValue >= batch.value;
+    }
+    return vkGetFenceStatus(device, batch.fence) == VK_SUCCESS;
+}
+
+// εݴռ䣻ûʱźʱԴűΪ Ready
+static void retireTransfers(StreamingLoader& loader) {
+    uint64_t completedValue = 0;
+    if (loader.timeline != VK_NULL_HANDLE) {
+        loader.getSemaphoreCounterValue(device, loader.timeline, &completedValue);
+    }
+
+    bool freed = false;
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        while (!loader.inFlight.empty() && isBatchComplete(loader, loader.inFlight.front(), completedValue)) {
+            TransferBatch batch = loader.inFlight.front();
+            loader.inFlight.pop_front();
+
+            loader.used -= batch.stagingBytes;
+            for (AssetHandle handle : batch.assets) {
+                StreamedAsset& asset = *loader.assets[handle];
+                if (asset.state == AssetState::Uploading) {
+                    asset.state = AssetState::Ready;
+                    loader.stats.loaded++;
+                }
+            }
+
+            batch.assets.clear();
+            batch.stagingBytes = 0;
+            loader.freeBatches.push_back(batch);
+            freed = true;
+        }
+    }
+
+    if (freed) {
+        loader.stagingAvailable.notify_all();
+    }
+}
+
+// עֻ EXCLUSIVE Դͼ岻ͬʱԼ CONCURRENT Ļٽע
+static ResourceHandle createSharedBuffer(StreamingLoader& loader, VkDeviceSize size, VkBufferUsageFlags usage) {
+    GpuBuffer buffer;
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = loader.sharingFamilies.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+    bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(loader.sharingFamilies.size());
+    bufferInfo.pQueueFamilyIndices = loader.sharingFamilies.data();
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create streamed buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer.buffer, &memRequirements);
+    allocateMemory(gpuAllocator, memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear, buffer.allocation);
+    vkBindBufferMemory(device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+    buffer.size = size;
+    return adoptRegistryBuffer(*loader.registry, buffer);
+}
+
+// ¼ƵĿֽ
+static VkDeviceSize recordMeshUpload(StreamingLoader& loader, StreamedAsset& asset, VkCommandBuffer commandBuffer) {
+    VkDeviceSize vertexBytes = asset.vertexCount * STREAMED_VERTEX_SIZE;
+    VkDeviceSize indexBytes = asset.indexCount * sizeof(uint32_t);
+    asset.vertexBuffer = createSharedBuffer(loader, vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    asset.indexBuffer = createSharedBuffer(loader, indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+    VkBufferCopy region = {};
+    region.srcOffset = asset.stagingOffset;
+    region.size = vertexBytes;
+    vkCmdCopyBuffer(commandBuffer, loader.staging.buffer, getRegistryBuffer(*loader.registry, asset.vertexBuffer)->buffer, 1, &region);
+
+    region.srcOffset = asset.stagingOffset + vertexBytes;
+    region.size = indexBytes;
+    vkCmdCopyBuffer(commandBuffer, loader.staging.buffer, getRegistryBuffer(*loader.registry, asset.indexBuffer)->buffer, 1, &region);
+    return vertexBytes + indexBytes;
+}
+
+static void imageBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+    VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+// ¼ƵĿֽ
+static VkDeviceSize recordTextureUpload(StreamingLoader& loader, StreamedAsset& asset, VkCommandBuffer commandBuffer) {
+    RegisteredImage image;
+    image.format = VK_FORMAT_R8G8B8A8_UNORM;
+    image.extent = { asset.width, asset.height };
+    image.mipLevels = 1;
+
+    // ͻһҪ CONCURRENTԼ󽻸ע
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = image.format;
+    imageInfo.extent = { asset.width, asset.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = loader.sharingFamilies.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+    imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(loader.sharingFamilies.size());
+    imageInfo.pQueueFamilyIndices = loader.sharingFamilies.data();
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create streamed image!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, image.image, &memRequirements);
+    allocateMemory(gpuAllocator, memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal, image.memory);
+    vkBindImageMemory(device, image.image, image.memory.memory, image.memory.offset);
+
+    imageBarrier(commandBuffer, image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = asset.stagingOffset;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { asset.width, asset.height, 1 };
+    vkCmdCopyBufferToImage(commandBuffer, loader.staging.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // в֧ɫ׶Σֻת֣ɼͼζеȴʱź֤
+    imageBarrier(commandBuffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+
+    // ֻް󶨱Ҫͼ
+    BindlessTable* bindless = loader.registry->bindless;
+    if (bindless != nullptr && bindless->enabled) {
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = image.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = image.format;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(device, &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create streamed image view!");
+        }
+    }
+
+    // ڿǰд룺е±ֻԴ Ready Żύɫ
+    asset.image = adoptRegistryImage(*loader.registry, image);
+    asset.textureIndex = registerRegistryImageBindless(*loader.registry, asset.image, VK_NULL_HANDLE);
+    return static_cast<VkDeviceSize>(asset.width) * asset.height * 4;
+}
+
+static TransferBatch acquireBatch(StreamingLoader& loader) {
+    TransferBatch batch;
+    if (!loader.freeBatches.empty()) {
+        batch = loader.freeBatches.back();
+        loader.freeBatches.pop_back();
+        if (batch.fence != VK_NULL_HANDLE) {
+            vkResetFences(device, 1, &batch.fence);
+        }
+        return batch;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = loader.commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    if (vkAllocateCommandBuffers(device, &allocInfo, &batch.commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate streaming command buffer!");
+    }
+
+    if (loader.timeline == VK_NULL_HANDLE) {
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create streaming fence!");
+        }
+    }
+    return batch;
+}
+
+void admitStagedUploads(const std::deque<AssetHandle>& staged, const std::vector<std::unique_ptr<StreamedAsset>>& assets,
+    VkDeviceSize frameBudget, StreamingAdmission& admission) {
+    admission = StreamingAdmission();
+    for (AssetHandle handle : staged) {
+        const StreamedAsset& asset = *assets[handle];
+        if (asset.state == AssetState::Decoding || admission.oversized) {
+            break;
+        }
+
+        if (asset.state == AssetState::Staged) {
+            VkDeviceSize bytes = decodedBytes(asset);
+            if (admission.frameBytes + bytes > frameBudget) {
+                if (admission.frameBytes > 0) {
+                    break;
+                }
+                admission.oversized = true; // ԴԤ㣬ռһ֡
+            }
+            admission.frameBytes += bytes;
+            admission.uploads.push_back(handle);
+        }
+
+        admission.stagingBytes += asset.stagingBytes;
+        admission.consumed++;
+    }
+}
+
+bool isStreamingFrameOverBudget(VkDeviceSize recordedBytes, size_t uploadCount, VkDeviceSize frameBudget) {
+    return recordedBytes > frameBudget && uploadCount > 1;
+}
+
+void pumpStreaming(StreamingLoader& loader) {
+    if (!loader.enabled) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    retireTransfers(loader);
+
+    // ݴ˳ȡõԴֱ֡ԤꡣʧܵԴϴݴռ
+    // ҪͺԴһ˳
+    StreamingAdmission admission;
+    const std::vector<AssetHandle>& uploads = admission.uploads;
+    const VkDeviceSize& stagingBytes = admission.stagingBytes;
+    {
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        admitStagedUploads(loader.staged, loader.assets, loader.frameBudget, admission);
+        loader.staged.erase(loader.staged.begin(), loader.staged.begin() + admission.consumed);
+
+        if (uploads.empty() && stagingBytes > 0) {
+            // ֻʧܵԴһ;֮գû;ʱ
+            if (loader.inFlight.empty()) {
+                loader.used -= stagingBytes;
+            }
+            else {
+                loader.inFlight.back().stagingBytes += stagingBytes;
+            }
+        }
+    }
+    if (uploads.empty() && stagingBytes > 0 && loader.inFlight.empty()) {
+        loader.stagingAvailable.notify_all();
+    }
+
+    VkDeviceSize recordedBytes = 0;
+    if (!uploads.empty()) {
+        TransferBatch batch = acquireBatch(loader);
+
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS) {
+            throw std::runtime_error("failed to begin streaming command buffer!");
+        }
+
+        // ֻȾ̻߳޸ѳӵԴ¼ʱҪԤ㰴ʵ¼ƵĿֽ飬
+        // ׼
+        for (AssetHandle handle : uploads) {
+            StreamedAsset& asset = *loader.assets[handle];
+            if (asset.kind == AssetKind::Mesh) {
+                recordedBytes += recordMeshUpload(loader, asset, batch.commandBuffer);
+            }
+            else {
+                recordedBytes += recordTextureUpload(loader, asset, batch.commandBuffer);
+            }
+        }
+
+        if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to record streaming command buffer!");
+        }
+
+        batch.value = ++loader.submittedValue;
+
+        VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &batch.value;
+
+        VkSubmitInfo submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &batch.commandBuffer;
+        if (loader.timeline != VK_NULL_HANDLE) {
+            submitInfo.pNext = &timelineInfo;
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &loader.timeline;
+        }
+
+        if (vkQueueSubmit(loader.queue, 1, &submitInfo, batch.fence) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit streaming command buffer!");
+        }
+
+        batch.stagingBytes = stagingBytes;
+        batch.assets = uploads;
+
+        std::lock_guard<std::mutex> lock(loader.mutex);
+        for (AssetHandle handle : uploads) {
+            StreamedAsset& asset = *loader.assets[handle];
+            asset.readyValue = batch.value;
+            // ʱźʱͼζ GPU ϵȴԴύ󼴿ʹ
+            asset.state = loader.timeline != VK_NULL_HANDLE ? AssetState::Ready : AssetState::Uploading;
+            if (asset.state == AssetState::Ready) {
+                loader.stats.loaded++;
+            }
+        }
+        loader.inFlight.push_back(batch);
+        loader.stats.submitCount++;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(loader.mutex);
+    StreamingStats& stats = loader.stats;
+    stats.frames++;
+    stats.lastFrameBytes = recordedBytes;
+    stats.bytesUploaded += recordedBytes;
+    stats.maxFrameBytes = std::max(stats.maxFrameBytes, recordedBytes);
+    stats.pumpMs += ms;
+    stats.maxPumpMs = std::max(stats.maxPumpMs, ms);
+    if (recordedBytes > 0) {
+        stats.uploadFrames++;
+    }
+    if (isStreamingFrameOverBudget(recordedBytes, uploads.size(), loader.frameBudget)) {
+        stats.framesOverBudget++;
+    }
+    else if (recordedBytes > loader.frameBudget) {
+        stats.oversizedUploads++;
+    }
+}
+
+bool getStreamingWait(const StreamingLoader& loader, VkSemaphore& semaphore, uint64_t& value) {
+    if (loader.timeline == VK_NULL_HANDLE || loader.submittedValue == 0) {
+        return false;
+    }
+
+    // ֵȴһύɸ֮ǰеĿѾʱȴ
+    semaphore = loader.timeline;
+    value = loader.submittedValue;
+    return true;
+}
+
+bool isStreamingIdle(StreamingLoader& loader) {
+    std::lock_guard<std::mutex> lock(loader.mutex);
+    for (const std::unique_ptr<StreamedAsset>& asset : loader.assets) {
+        if (asset->state != AssetState::Ready && asset->state != AssetState::Failed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void waitForStreaming(StreamingLoader& loader) {
+    while (!loader.inFlight.empty()) {
+        const TransferBatch& batch = loader.inFlight.front();
+        if (loader.timeline != VK_NULL_HANDLE) {
+            VkSemaphoreWaitInfoKHR waitInfo = {};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &loader.timeline;
+            waitInfo.pValues = &batch.value;
+            loader.waitSemaphores(device, &waitInfo, UINT64_MAX);
+        }
+        else {
+            vkWaitForFences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        }
+        retireTransfers(loader);
+    }
+}
+
+void printStreamingStats(StreamingLoader& loader) {
+    std::lock_guard<std::mutex> lock(loader.mutex);
+    const StreamingStats& stats = loader.stats;
+
+    std::cout << "Streaming: " << stats.loaded << "/" << stats.requested << " assets loaded, " << stats.failed << " failed, "
+        << stats.bytesRead / 1024 << " KB read, " << stats.bytesUploaded / 1024 << " KB uploaded in "
+        << stats.submitCount << " submission(s) on " << (loader.sharingFamilies.empty() ? "the graphics" : "a dedicated")
+        << " queue family (" << (loader.timeline != VK_NULL_HANDLE ? "timeline semaphore" : "fences") << ")" << std::endl;
+    std::cout << "  budget " << loader.frameBudget / 1024 << " KB/frame, max " << stats.maxFrameBytes / 1024
+        << " KB over " << stats.uploadFrames << " upload frame(s), " << stats.oversizedUploads << " oversized, "
+        << stats.framesOverBudget << " over budget" << std::endl;
+    std::cout << "  decode " << stats.decodeMs << " ms on I/O threads, pump " << stats.pumpMs << " ms total ("
+        << stats.maxPumpMs << " ms max) on the render thread, " << stats.stagingWaits << " staging wait(s)" << std::endl;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ResourceRegistry.h"
+#include "Upload.h"
+
+enum class AssetKind {
+    Mesh,       // .objֻȡ xy vert.vert  inPosition һ£Ϊ uint32_t
+    Texture,    // .tgaδѹɫҶͼΪ R8G8B8A8_UNORM
+};
+
+enum class AssetState {
+    Queued,     // ȴ I/O ߳
+    Decoding,   // ѷݴռ䣬ڽ
+    Staged,     // ɣȴύ
+    Uploading,  // ύûʱźʱȴ fence
+    Ready,      // ʹãʱźʱͼζҪȴ readyValue
+    Failed,
+};
+
+typedef uint32_t AssetHandle;
+const AssetHandle INVALID_ASSET = UINT32_MAX;
+
+struct StreamedAsset {
+    std::string path;
+    AssetKind kind = AssetKind::Mesh;
+    AssetState state = AssetState::Queued;
+
+    // עеĻ
+    ResourceHandle vertexBuffer = INVALID_RESOURCE;
+    ResourceHandle indexBuffer = INVALID_RESOURCE;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+
+    // עеͼֻעᵽް󶨱ʱͼ
+    ResourceHandle image = INVALID_RESOURCE;
+    BindlessIndex textureIndex = INVALID_BINDLESS_INDEX;  //  imageΪ Ready ֮ǰɫܷ
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    VkDeviceSize stagingOffset = 0;     // ݴ滺еλ
+    VkDeviceSize stagingBytes = 0;      // ռõݴ滷ֽͻ˷ѣ
+    uint64_t readyValue = 0;            // ʱʱźֵ
+};
+
+struct StreamingStats {
+    uint64_t requested = 0;
+    uint64_t loaded = 0;
+    uint64_t failed = 0;
+    uint64_t bytesRead = 0;             // Ӵ̶ȡֽ
+    uint64_t bytesUploaded = 0;         // ϴֽ
+    uint64_t submitCount = 0;
+    uint64_t stagingWaits = 0;          // I/O ̵߳ȴݴռĴ
+    uint64_t frames = 0;                // pumpStreaming ĵô
+    uint64_t uploadFrames = 0;          // ϴ֡
+    VkDeviceSize lastFrameBytes = 0;
+    VkDeviceSize maxFrameBytes = 0;
+    uint64_t oversizedUploads = 0;      // Դÿ֡Ԥ㣬ռһ֡ϴ
+    uint64_t framesOverBudget = 0;      // ¼ƵĿֽԤҲǵԴ֡ӦʼΪ 0
+    double decodeMs = 0.0;              // I/O ̶߳ȡͽʱ
+    double pumpMs = 0.0;                // Ⱦ߳ pumpStreaming ʱ
+    double maxPumpMs = 0.0;
+};
+
+// һ֡ݴͷȡԴadmitStagedUploads Ľ
+struct StreamingAdmission {
+    size_t consumed = 0;                // ӵʧܵԴ
+    std::vector<AssetHandle> uploads;   // ҪϴԴ
+    VkDeviceSize frameBytes = 0;        // uploads ֽ
+    VkDeviceSize stagingBytes = 0;      // Ӹռõݴ滷ֽ
+    bool oversized = false;             // uploads ֻһԤԴ
+};
+
+// ϵһύ
+struct TransferBatch {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;     // ֻûʱźʱʹ
+    uint64_t value = 0;                 // ʱʱźֵ
+    VkDeviceSize stagingBytes = 0;
+    std::vector<AssetHandle> assets;
+};
+
+// ̨ʽأI/O ̶߳ȡֱӽ뵽ݴ滺壬Ⱦ߳ÿ֡ pumpStreaming
+// ԤڰѽõԴύСͼζʱʱźͬ
+// ֧ʱ˻ fenceԴڿɺűΪ Ready
+struct StreamingLoader {
+    bool enabled = false;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t queueFamilyIndex = 0;
+    std::vector<uint32_t> sharingFamilies;  // ͼ岻ͬʱԴ CONCURRENT ʽ
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkDeviceSize frameBudget = 0;           // ÿ֡ύֽ
+    ResourceRegistry* registry = nullptr;   // ͼд٣עް󶨱ʱעᵽ
+
+    VkSemaphore timeline = VK_NULL_HANDLE;
+    PFN_vkGetSemaphoreCounterValueKHR getSemaphoreCounterValue = nullptr;
+    PFN_vkWaitSemaphoresKHR waitSemaphores = nullptr;
+    uint64_t submittedValue = 0;            // һύҪдֵ
+    std::deque<TransferBatch> inFlight;
+    std::vector<TransferBatch> freeBatches;
+
+    std::vector<std::thread> ioThreads;
+    GpuBuffer staging;
+
+    std::mutex mutex;                       // ³Ա
+    // ݴ滷˳ύύ˳գֻҪ¼ͷռֽ
+    VkDeviceSize head = 0;
+    VkDeviceSize used = 0;
+    std::condition_variable requestAvailable;
+    std::condition_variable stagingAvailable;
+    std::deque<AssetHandle> requests;
+    std::deque<AssetHandle> staged;         // ݴ˳
+    std::vector<std::unique_ptr<StreamedAsset>> assets;
+    bool stopping = false;
+    StreamingStats stats;
+};
+
+// queue ΪУûרöʱԺͼζͬtimelineSemaphores ʾ豸
+// VK_KHR_timeline_semaphore
+void createStreamingLoader(StreamingLoader& loader, VkQueue queue, uint32_t queueFamilyIndex, uint32_t graphicsQueueFamilyIndex,
+    bool timelineSemaphores, uint32_t ioThreadCount, VkDeviceSize stagingSize, VkDeviceSize frameBudget);
+
+// ȴɣԴעɾУ destroyResourceRegistry ֮ǰ
+void destroyStreamingLoader(StreamingLoader& loader);
+
+// չжԴͣ޷ʶʱ INVALID_ASSET
+AssetHandle requestAsset(StreamingLoader& loader, const std::string& path);
+
+AssetState getAssetState(StreamingLoader& loader, AssetHandle handle);
+
+// ÿ֡Ⱦ߳ϵһΣɵΣԤύõԴ
+void pumpStreaming(StreamingLoader& loader);
+
+// ݴ˳ staged ͷ׼뱾֡ϴڽԴԤʱֹͣ
+// ԤΪʱԤԴֻȡԴ״̬ʹС߳ loader.mutex
+void admitStagedUploads(const std::deque<AssetHandle>& staged, const std::vector<std::unique_ptr<StreamedAsset>>& assets,
+    VkDeviceSize frameBudget, StreamingAdmission& admission);
+
+// һ֡ʵ¼ƵĿֽǷ񳬳Ԥ㣺ֻеԴ
+bool isStreamingFrameOverBudget(VkDeviceSize recordedBytes, size_t uploadCount, VkDeviceSize frameBudget);
+
+// ͼζʹʽԴǰҪȴʱźֵûҪȴʱ false
+bool getStreamingWait(const StreamingLoader& loader, VkSemaphore& semaphore, uint64_t& value);
+
+// ѽReady  Failed
+bool isStreamingIdle(StreamingLoader& loader);
+
+// ȴύĴ
+void waitForStreaming(StreamingLoader& loader);
+
+void printStreamingStats(StreamingLoader& loader);
+
+// δѹɫҶ .tga Ϊ R8G8B8A8һϣʽ֧ʱ false
+bool decodeTgaFile(const MappedFile& file, uint32_t& width, uint32_t& height, std::vector<uint8_t>& pixels);
@@ -0,0 +1,803 @@
+#include "Textures.h"
+#include "MemoryAllocator.h"
+#include "Streaming.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+
+// ݴÿһĶ룺пѹʽĿС bufferOffset  4 ıҪ
+static const VkDeviceSize TEXTURE_STAGING_ALIGNMENT = 16;
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// ----  ----
+
+template <typename T>
+static void appendKey(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void createSamplerCache(SamplerCache& cache, float maxAnisotropy) {
+    cache.maxAnisotropy = maxAnisotropy;
+}
+
+void destroySamplerCache(SamplerCache& cache) {
+    for (auto& entry : cache.samplers) {
+        vkDestroySampler(device, entry.second, nullptr);
+    }
+    cache.samplers.clear();
+}
+
+VkSampler acquireSampler(SamplerCache& cache, const SamplerDesc& desc) {
+    // Ȱ豸ضϣضϺͬһ
+    SamplerDesc resolved = desc;
+    bool anisotropy = cache.maxAnisotropy > 1.0f && desc.maxAnisotropy > 1.0f;
+    resolved.maxAnisotropy = anisotropy ? std::min(desc.maxAnisotropy, cache.maxAnisotropy) : 1.0f;
+
+    std::string key;
+    appendKey(key, resolved.magFilter);
+    appendKey(key, resolved.minFilter);
+    appendKey(key, resolved.mipmapMode);
+    appendKey(key, resolved.addressModeU);
+    appendKey(key, resolved.addressModeV);
+    appendKey(key, resolved.addressModeW);
+    appendKey(key, resolved.maxAnisotropy);
+    appendKey(key, resolved.mipLodBias);
+    appendKey(key, resolved.minLod);
+    appendKey(key, resolved.maxLod);
+    appendKey(key, resolved.borderColor);
+
+    cache.stats.requests++;
+    auto found = cache.samplers.find(key);
+    if (found != cache.samplers.end()) {
+        cache.stats.hits++;
+        return found->second;
+    }
+
+    VkSamplerCreateInfo samplerInfo = {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = resolved.magFilter;
+    samplerInfo.minFilter = resolved.minFilter;
+    samplerInfo.mipmapMode = resolved.mipmapMode;
+    samplerInfo.addressModeU = resolved.addressModeU;
+    samplerInfo.addressModeV = resolved.addressModeV;
+    samplerInfo.addressModeW = resolved.addressModeW;
+    samplerInfo.anisotropyEnable = anisotropy ? VK_TRUE : VK_FALSE;
+    samplerInfo.maxAnisotropy = resolved.maxAnisotropy;
+    samplerInfo.mipLodBias = resolved.mipLodBias;
+    samplerInfo.minLod = resolved.minLod;
+    samplerInfo.maxLod = resolved.maxLod;
+    samplerInfo.borderColor = resolved.borderColor;
+
+    VkSampler sampler;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create texture sampler!");
+    }
+    cache.samplers.emplace(std::move(key), sampler);
+    return sampler;
+}
+
+// ---- ʽ ----
+
+bool getFormatBlockInfo(VkFormat format, FormatBlockInfo& info) {
+    info = FormatBlockInfo();
+    switch (format) {
+    case VK_FORMAT_R8_UNORM:
+        info.bytes = 1;
+        return true;
+    case VK_FORMAT_R8G8_UNORM:
+        info.bytes = 2;
+        return true;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        info.bytes = 4;
+        return true;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+        info.bytes = 8;
+        return true;
+    default:
+        break;
+    }
+
+    // BC1 / BC4 ÿ 4x4  8 ֽڣ BCn 16 ֽ
+    if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK) {
+        bool halfBlock = format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+            || format == VK_FORMAT_BC4_UNORM_BLOCK || format == VK_FORMAT_BC4_SNORM_BLOCK;
+        info.width = 4;
+        info.height = 4;
+        info.bytes = halfBlock ? 8 : 16;
+        info.compressed = true;
+        return true;
+    }
+
+    // ASTC LDRÿ 16 ֽڣUNORM  SRGB ɶ
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+        static const uint8_t astcBlocks[][2] = {
+            { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 }, { 8, 8 },
+            { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 },
+        };
+        uint32_t index = (format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2;
+        info.width = astcBlocks[index][0];
+        info.height = astcBlocks[index][1];
+        info.bytes = 16;
+        info.compressed = true;
+        return true;
+    }
+    return false;
+}
+
+static bool isBcFormat(VkFormat format) {
+    return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK;
+}
+
+static bool isAstcFormat(VkFormat format) {
+    return format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+}
+
+static uint32_t levelExtent(uint32_t size, uint32_t level) {
+    return std::max(size >> level, 1u);
+}
+
+VkDeviceSize getTextureLevelBytes(const FormatBlockInfo& block, uint32_t width, uint32_t height, uint32_t level) {
+    VkDeviceSize blocksX = (levelExtent(width, level) + block.width - 1) / block.width;
+    VkDeviceSize blocksY = (levelExtent(height, level) + block.height - 1) / block.height;
+    return blocksX * blocksY * block.bytes;
+}
+
+uint32_t getTextureMipCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    while ((std::max(width, height) >> levels) > 0) {
+        levels++;
+    }
+    return levels;
+}
+
+uint32_t getTextureTailMip(uint32_t width, uint32_t height, uint32_t levelCount) {
+    uint32_t tailMip = levelCount - 1;
+    while (tailMip > 0 && std::max(levelExtent(width, tailMip - 1), levelExtent(height, tailMip - 1)) <= TEXTURE_TAIL_SIZE) {
+        tailMip--;
+    }
+    return tailMip;
+}
+
+// ---- KTX2 ----
+
+static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header does not match the KTX2 layout");
+static_assert(sizeof(Ktx2LevelIndex) == 24, "Ktx2LevelIndex does not match the KTX2 layout");
+
+bool parseKtx2(const uint8_t* data, size_t size, Ktx2Info& info, std::string& error) {
+    info = Ktx2Info();
+    Ktx2Header header;
+    if (size < sizeof(header)) {
+        error = "file too small";
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        error = "not a KTX2 file";
+        return false;
+    }
+    if (header.vkFormat == VK_FORMAT_UNDEFINED || header.supercompressionScheme != 0) {
+        error = "supercompressed (Basis / zstd) data is not supported";
+        return false;
+    }
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 || header.layerCount > 1 || header.faceCount != 1) {
+        error = "only 2D textures without layers or faces are supported";
+        return false;
+    }
+
+    FormatBlockInfo block;
+    info.format = static_cast<VkFormat>(header.vkFormat);
+    if (!getFormatBlockInfo(info.format, block)) {
+        error = "unsupported format " + std::to_string(header.vkFormat);
+        return false;
+    }
+
+    info.width = header.pixelWidth;
+    info.height = header.pixelHeight;
+    info.generateMips = header.levelCount == 0;
+    info.levelCount = std::max(header.levelCount, 1u);
+    if (info.levelCount > getTextureMipCount(info.width, info.height) || info.levelCount > MAX_TEXTURE_LEVELS) {
+        error = "too many mip levels";
+        return false;
+    }
+    if (size < sizeof(header) + info.levelCount * sizeof(Ktx2LevelIndex)) {
+        error = "truncated level index";
+        return false;
+    }
+
+    for (uint32_t level = 0; level < info.levelCount; level++) {
+        Ktx2LevelIndex index;
+        memcpy(&index, data + sizeof(header) + level * sizeof(index), sizeof(index));
+        VkDeviceSize expected = getTextureLevelBytes(block, info.width, info.height, level);
+        if (index.byteLength != expected) {
+            error = "level " + std::to_string(level) + " has " + std::to_string(index.byteLength)
+                + " bytes, expected " + std::to_string(expected);
+            return false;
+        }
+        if (index.byteOffset > size || index.byteLength > size - index.byteOffset) {
+            error = "level " + std::to_string(level) + " is outside the file";
+            return false;
+        }
+        info.levels.push_back({ index.byteOffset, index.byteLength });
+    }
+    return true;
+}
+
+// ---- ʹ÷Ԥ ----
+
+uint32_t textureMipForFootprint(uint32_t width, uint32_t height, float pixels) {
+    float ratio = static_cast<float>(std::max(width, height)) / std::max(pixels, 1.0f);
+    if (ratio <= 1.0f) {
+        return 0;
+    }
+    return std::min(static_cast<uint32_t>(std::floor(std::log2(ratio))), 31u);
+}
+
+VkDeviceSize getTextureBytesFrom(const ManagedTexture& texture, uint32_t first) {
+    VkDeviceSize bytes = 0;
+    for (uint32_t level = first; level < texture.levelCount; level++) {
+        bytes += texture.levelBytes[level];
+    }
+    return bytes;
+}
+
+uint32_t getWantedTextureMip(const ManagedTexture& texture, uint64_t frameNumber) {
+    if (!texture.used || frameNumber - texture.lastUsedFrame >= TEXTURE_FEEDBACK_FRAMES) {
+        return texture.tailMip;
+    }
+    return std::min(texture.requestedMip, texture.tailMip);
+}
+
+void reportTextureUsage(TextureManager& manager, TextureHandle handle, float pixels, uint64_t frameNumber) {
+    if (handle >= manager.textures.size()) {
+        return;
+    }
+
+    ManagedTexture& texture = manager.textures[handle];
+    uint32_t mip = std::min(textureMipForFootprint(texture.width, texture.height, pixels), texture.levelCount - 1);
+
+    // ϸЧֵ֮ǰںЧ֮ػ뻻
+    if (!texture.used || mip <= texture.requestedMip || frameNumber - texture.requestFrame >= TEXTURE_FEEDBACK_FRAMES) {
+        texture.requestedMip = mip;
+        texture.requestFrame = frameNumber;
+    }
+    texture.lastUsedFrame = frameNumber;
+    texture.used = true;
+}
+
+VkDeviceSize planTextureResidency(std::vector<ManagedTexture>& textures, uint64_t frameNumber, VkDeviceSize budget) {
+    VkDeviceSize total = 0;
+    for (ManagedTexture& texture : textures) {
+        texture.targetMip = getWantedTextureMip(texture, frameNumber);
+        total += getTextureBytesFrom(texture, texture.targetMip);
+    }
+    if (total <= budget) {
+        return total;
+    }
+
+    // ѶΪһҪȥϸһ
+    auto lowerPriority = [&textures](uint32_t a, uint32_t b) {
+        const ManagedTexture& x = textures[a];
+        const ManagedTexture& y = textures[b];
+        if (x.lastUsedFrame != y.lastUsedFrame) {
+            return x.lastUsedFrame > y.lastUsedFrame;
+        }
+        return x.levelBytes[x.targetMip] < y.levelBytes[y.targetMip];
+    };
+    std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(lowerPriority)> victims(lowerPriority);
+    for (uint32_t i = 0; i < textures.size(); i++) {
+        if (textures[i].targetMip < textures[i].tailMip) {
+            victims.push(i);
+        }
+    }
+
+    while (total > budget && !victims.empty()) {
+        ManagedTexture& texture = textures[victims.top()];
+        victims.pop();
+        total -= texture.levelBytes[texture.targetMip];
+        texture.targetMip++;
+        if (texture.targetMip < texture.tailMip) {
+            victims.push(static_cast<uint32_t>(&texture - textures.data()));
+        }
+    }
+    return total;
+}
+
+// ---- ͼ ----
+
+static void imageBarrier(VkCommandBuffer commandBuffer, VkImage image, uint32_t baseLevel, uint32_t levelCount,
+    VkImageLayout oldLayout, VkImageLayout newLayout,
+    VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = baseLevel;
+    barrier.subresourceRange.levelCount = levelCount;
+    barrier.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+static bool isFormatSupported(const TextureManager& manager, VkFormat format, bool blit) {
+    if ((isBcFormat(format) && !manager.textureCompressionBC) || (isAstcFormat(format) && !manager.textureCompressionASTC)) {
+        return false;
+    }
+
+    VkFormatFeatureFlags needed = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    if (blit) {
+        needed |= VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    }
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+    return (properties.optimalTilingFeatures & needed) == needed;
+}
+
+//  firstLevel ʼһͼ񣨵 0 ĵ firstLevel 
+static ResourceHandle createTextureImage(TextureManager& manager, const ManagedTexture& texture, uint32_t firstLevel) {
+    // 뻻ʱͼĸƵͼmip ʱ֮ blit
+    return createRegistryImage(*manager.registry, texture.format,
+        { levelExtent(texture.width, firstLevel), levelExtent(texture.height, firstLevel) }, texture.levelCount - firstLevel,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+}
+
+// ֡ݴʹ
+struct TextureUploadCursor {
+    uint8_t* base = nullptr;            // ֡ݴӳַ
+    VkDeviceSize baseOffset = 0;        // ֡ݴڻеƫ
+    VkDeviceSize head = 0;              // õݴֽ룩
+    VkDeviceSize frameBytes = 0;        // ѼԤֽ
+};
+
+//  mip һϴβÿ֡ԤʱֻҪ֡ûϴռһ֡
+static bool reserveUpload(const TextureManager& manager, TextureUploadCursor& cursor, VkDeviceSize bytes, VkDeviceSize stagingBytes) {
+    if (cursor.head + stagingBytes > manager.sliceSize) {
+        return false;
+    }
+    return cursor.frameBytes == 0 || cursor.frameBytes + bytes <= manager.frameBudget;
+}
+
+static VkDeviceSize stagedBytes(const ManagedTexture& texture, uint32_t first, uint32_t end) {
+    VkDeviceSize bytes = 0;
+    for (uint32_t level = first; level < end; level++) {
+        bytes += alignUp(texture.levelBytes[level], TEXTURE_STAGING_ALIGNMENT);
+    }
+    return bytes;
+}
+
+// һαŽͬһݴֽGenerated ĵ 0 KTX2 ββ֮ǰĵһ
+static VkDeviceSize largestUploadUnit(const ManagedTexture& texture) {
+    if (texture.source == TextureSource::Generated) {
+        return stagedBytes(texture, 0, 1);
+    }
+    VkDeviceSize largest = stagedBytes(texture, texture.tailMip, texture.levelCount);
+    for (uint32_t level = 0; level < texture.tailMip; level++) {
+        largest = std::max(largest, stagedBytes(texture, level, level + 1));
+    }
+    return largest;
+}
+
+static void copyLevelFromStaging(const TextureManager& manager, TextureUploadCursor& cursor, const ManagedTexture& texture,
+    VkCommandBuffer commandBuffer, VkImage image, uint32_t level, uint32_t imageLevel, const uint8_t* data) {
+    VkDeviceSize bytes = texture.levelBytes[level];
+    memcpy(cursor.base + cursor.head, data, static_cast<size_t>(bytes));
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = cursor.baseOffset + cursor.head;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = imageLevel;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { levelExtent(texture.width, level), levelExtent(texture.height, level), 1 };
+    vkCmdCopyBufferToImage(commandBuffer, manager.staging.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    cursor.head += alignUp(bytes, TEXTURE_STAGING_ALIGNMENT);
+}
+
+// 滻ͼ±꣬ͼͬ±ڱ֡ɺע
+static void replaceTextureImage(TextureManager& manager, ManagedTexture& texture, ResourceHandle image, uint32_t firstLevel) {
+    if (texture.image != INVALID_RESOURCE) {
+        destroyRegistryImage(*manager.registry, texture.image);
+        manager.stats.imageRebuilds++;
+    }
+
+    texture.image = image;
+    texture.residentMip = firstLevel;
+    texture.bindlessIndex = registerRegistryImageBindless(*manager.registry, image, texture.sampler);
+}
+
+// ؽ KTX2 ͼפΧΪ [firstLevel, levelCount)ͼȻҪĸ GPU ϸƣ
+// ϸĸݴϴݴռɵԤ
+static void rebuildTexture(TextureManager& manager, ManagedTexture& texture, VkCommandBuffer commandBuffer,
+    TextureUploadCursor& cursor, uint32_t firstLevel) {
+    ResourceHandle handle = createTextureImage(manager, texture, firstLevel);
+    VkImage image = getRegistryImage(*manager.registry, handle)->image;
+    uint32_t levels = texture.levelCount - firstLevel;
+    imageBarrier(commandBuffer, image, 0, levels, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+    // ûоͼʱ residentMip == levelCountȫϴ
+    uint32_t keptLevel = std::max(firstLevel, texture.residentMip);
+    for (uint32_t level = firstLevel; level < keptLevel; level++) {
+        copyLevelFromStaging(manager, cursor, texture, commandBuffer, image, level, level - firstLevel,
+            texture.file.data + texture.fileLevels[level].offset);
+    }
+
+    if (texture.image != INVALID_RESOURCE && keptLevel < texture.levelCount) {
+        // ֮ǰ֡ƬԪɫжȡͼ񣬸ǰȴ
+        VkImage oldImage = getRegistryImage(*manager.registry, texture.image)->image;
+        uint32_t oldLevels = texture.levelCount - texture.residentMip;
+        imageBarrier(commandBuffer, oldImage, 0, oldLevels, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+        std::vector<VkImageCopy> regions;
+        for (uint32_t level = keptLevel; level < texture.levelCount; level++) {
+            VkImageCopy region = {};
+            region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.srcSubresource.mipLevel = level - texture.residentMip;
+            region.srcSubresource.layerCount = 1;
+            region.dstSubresource = region.srcSubresource;
+            region.dstSubresource.mipLevel = level - firstLevel;
+            region.extent = { levelExtent(texture.width, level), levelExtent(texture.height, level), 1 };
+            regions.push_back(region);
+        }
+        vkCmdCopyImage(commandBuffer, oldImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    imageBarrier(commandBuffer, image, 0, levels, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+    if (firstLevel < texture.residentMip) {
+        manager.stats.levelsStreamedIn += std::min(texture.residentMip, texture.levelCount) - firstLevel;
+    }
+    else {
+        manager.stats.levelsEvicted += firstLevel - texture.residentMip;
+    }
+    replaceTextureImage(manager, texture, handle, firstLevel);
+}
+
+// ϴ 0  blit Թˣÿһһ룩
+static void generateTexture(TextureManager& manager, ManagedTexture& texture, VkCommandBuffer commandBuffer,
+    TextureUploadCursor& cursor) {
+    ResourceHandle handle = createTextureImage(manager, texture, 0);
+    VkImage image = getRegistryImage(*manager.registry, handle)->image;
+    imageBarrier(commandBuffer, image, 0, texture.levelCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    copyLevelFromStaging(manager, cursor, texture, commandBuffer, image, 0, 0, texture.pixels.data());
+
+    for (uint32_t level = 1; level < texture.levelCount; level++) {
+        imageBarrier(commandBuffer, image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+
+        VkImageBlit blit = {};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = level - 1;
+        blit.srcSubresource.layerCount = 1;
+        blit.srcOffsets[1] = { static_cast<int32_t>(levelExtent(texture.width, level - 1)),
+            static_cast<int32_t>(levelExtent(texture.height, level - 1)), 1 };
+        blit.dstSubresource = blit.srcSubresource;
+        blit.dstSubresource.mipLevel = level;
+        blit.dstOffsets[1] = { static_cast<int32_t>(levelExtent(texture.width, level)),
+            static_cast<int32_t>(levelExtent(texture.height, level)), 1 };
+        vkCmdBlitImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &blit, VK_FILTER_LINEAR);
+
+        imageBarrier(commandBuffer, image, level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    }
+    imageBarrier(commandBuffer, image, texture.levelCount - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+
+    manager.stats.mipsGenerated += texture.levelCount - 1;
+    std::vector<uint8_t>().swap(texture.pixels);
+    replaceTextureImage(manager, texture, handle, 0);
+}
+
+// ----  ----
+
+void createTextureManager(TextureManager& manager, VkDeviceSize memoryBudget, VkDeviceSize frameBudget,
+    bool bc, bool astc, float maxAnisotropy) {
+    manager.memoryBudget = memoryBudget;
+    manager.frameBudget = frameBudget;
+    manager.textureCompressionBC = bc;
+    manager.textureCompressionASTC = astc;
+    createSamplerCache(manager.samplers, maxAnisotropy);
+    manager.enabled = true;
+}
+
+void destroyTextureManager(TextureManager& manager) {
+    for (ManagedTexture& texture : manager.textures) {
+        if (texture.image != INVALID_RESOURCE) {
+            destroyRegistryImage(*manager.registry, texture.image);
+        }
+        unmapFile(texture.file);
+    }
+    manager.textures.clear();
+
+    destroyBuffer(manager.staging);
+    destroySamplerCache(manager.samplers);
+    manager.enabled = false;
+}
+
+static std::string lowerExtension(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    std::string extension = dot == std::string::npos ? "" : path.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return extension;
+}
+
+static TextureHandle skipTexture(TextureManager& manager, ManagedTexture& texture, const std::string& reason) {
+    std::cerr << "Textures: skipping " << texture.path << " (" << reason << ")" << std::endl;
+    unmapFile(texture.file);
+    manager.stats.unsupported++;
+    return INVALID_TEXTURE;
+}
+
+TextureHandle loadTexture(TextureManager& manager, const std::string& path, const SamplerDesc& sampler) {
+    ManagedTexture texture;
+    texture.path = path;
+
+    std::string extension = lowerExtension(path);
+    if (extension == ".ktx2") {
+        if (!mapFile(path, texture.file)) {
+            return skipTexture(manager, texture, "cannot open file");
+        }
+
+        Ktx2Info info;
+        std::string error;
+        if (!parseKtx2(texture.file.data, texture.file.size, info, error)) {
+            return skipTexture(manager, texture, error);
+        }
+
+        texture.format = info.format;
+        texture.width = info.width;
+        texture.height = info.height;
+        texture.levelCount = info.levelCount;
+        texture.fileLevels = info.levels;
+        getFormatBlockInfo(texture.format, texture.block);
+
+        // ֻһδѹ GPU  mip ѹʽ blitֻʹļеĸ
+        if (info.levelCount == 1 && !texture.block.compressed && isFormatSupported(manager, texture.format, true)) {
+            const uint8_t* level = texture.file.data + info.levels[0].offset;
+            texture.pixels.assign(level, level + info.levels[0].size);
+            texture.source = TextureSource::Generated;
+            unmapFile(texture.file);
+        }
+        else if (!isFormatSupported(manager, texture.format, false)) {
+            return skipTexture(manager, texture, "format " + std::to_string(texture.format) + " not supported by the device");
+        }
+    }
+    else if (extension == ".tga") {
+        MappedFile file;
+        bool decoded = mapFile(path, file) && decodeTgaFile(file, texture.width, texture.height, texture.pixels);
+        unmapFile(file);
+        if (!decoded) {
+            return skipTexture(manager, texture, "unsupported TGA file");
+        }
+        texture.format = VK_FORMAT_R8G8B8A8_UNORM;
+        texture.levelCount = 1;
+        texture.source = TextureSource::Generated;
+        getFormatBlockInfo(texture.format, texture.block);
+    }
+    else {
+        return skipTexture(manager, texture, "unsupported type");
+    }
+
+    if (texture.source == TextureSource::Generated) {
+        // ֧Թ˵ blit ʱֻе 0 
+        if (isFormatSupported(manager, texture.format, true)) {
+            texture.levelCount = std::min(getTextureMipCount(texture.width, texture.height), MAX_TEXTURE_LEVELS);
+        }
+        texture.tailMip = 0;
+    }
+    else {
+        texture.tailMip = getTextureTailMip(texture.width, texture.height, texture.levelCount);
+    }
+    for (uint32_t level = 0; level < texture.levelCount; level++) {
+        texture.levelBytes[level] = getTextureLevelBytes(texture.block, texture.width, texture.height, level);
+    }
+
+    // ݴڵһθʱѼص䣬֮صҪݴ
+    if (manager.staging.buffer != VK_NULL_HANDLE && largestUploadUnit(texture) > manager.sliceSize) {
+        return skipTexture(manager, texture, "mip level larger than the texture staging slice");
+    }
+
+    texture.sampler = acquireSampler(manager.samplers, sampler);
+    texture.targetMip = texture.tailMip;
+    texture.residentMip = texture.levelCount;
+
+    manager.stats.textures++;
+    if (texture.source == TextureSource::Generated) {
+        manager.stats.generatedTextures++;
+    }
+    else {
+        manager.stats.ktx2Textures++;
+    }
+    manager.stats.pinnedBytes += getTextureBytesFrom(texture, texture.tailMip);
+
+    manager.textures.push_back(std::move(texture));
+    return static_cast<TextureHandle>(manager.textures.size() - 1);
+}
+
+static void createTextureStaging(TextureManager& manager, uint32_t slotCount) {
+    manager.sliceSize = manager.frameBudget;
+    for (const ManagedTexture& texture : manager.textures) {
+        manager.sliceSize = std::max(manager.sliceSize, largestUploadUnit(texture));
+    }
+    manager.sliceSize = alignUp(manager.sliceSize, 256);
+    manager.sliceCount = slotCount;
+
+    // HOST_COHERENTдҪ vkFlushMappedMemoryRanges
+    createBuffer(manager.staging, manager.sliceSize * slotCount, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+void updateTextureResidency(TextureManager& manager, uint32_t slot, uint32_t slotCount,
+    uint64_t frameNumber, VkCommandBuffer commandBuffer) {
+    if (!manager.enabled || manager.textures.empty()) {
+        return;
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    TextureStats& stats = manager.stats;
+    stats.frames++;
+
+    if (manager.staging.buffer == VK_NULL_HANDLE) {
+        createTextureStaging(manager, slotCount);
+    }
+    if (slot >= manager.sliceCount) {
+        throw std::runtime_error("texture staging has no slice for this frame!");
+    }
+
+    stats.wantedBytes = 0;
+    for (const ManagedTexture& texture : manager.textures) {
+        stats.wantedBytes += getTextureBytesFrom(texture, getWantedTextureMip(texture, frameNumber));
+    }
+    planTextureResidency(manager.textures, frameNumber, manager.memoryBudget);
+    if (stats.pinnedBytes > manager.memoryBudget) {
+        stats.framesOverBudget++;
+    }
+
+    TextureUploadCursor cursor;
+    cursor.baseOffset = slot * manager.sliceSize;
+    cursor.base = static_cast<uint8_t*>(manager.staging.mapped) + cursor.baseOffset;
+
+    // ͼҪʹõȣͬʱȱļ
+    std::vector<uint32_t> streamIns;
+    for (uint32_t i = 0; i < manager.textures.size(); i++) {
+        ManagedTexture& texture = manager.textures[i];
+        if (texture.image == INVALID_RESOURCE) {
+            continue;
+        }
+        if (texture.targetMip > texture.residentMip) {
+            // ֻ GPU ϸƱĸռϴԤ
+            rebuildTexture(manager, texture, commandBuffer, cursor, texture.targetMip);
+        }
+        else if (texture.targetMip < texture.residentMip) {
+            streamIns.push_back(i);
+        }
+    }
+    std::sort(streamIns.begin(), streamIns.end(), [&manager](uint32_t a, uint32_t b) {
+        const ManagedTexture& x = manager.textures[a];
+        const ManagedTexture& y = manager.textures[b];
+        if (x.lastUsedFrame != y.lastUsedFrame) {
+            return x.lastUsedFrame > y.lastUsedFrame;
+        }
+        return x.residentMip - x.targetMip > y.residentMip - y.targetMip;
+    });
+
+    // һϴGenerated ĵ 0  KTX2 βŽݴ֮ͻһչ
+    for (ManagedTexture& texture : manager.textures) {
+        if (texture.image != INVALID_RESOURCE) {
+            continue;
+        }
+
+        uint32_t end = texture.source == TextureSource::Generated ? 1 : texture.levelCount;
+        VkDeviceSize bytes = 0;
+        for (uint32_t level = texture.tailMip; level < end; level++) {
+            bytes += texture.levelBytes[level];
+        }
+        VkDeviceSize staged = stagedBytes(texture, texture.tailMip, end);
+        if (!reserveUpload(manager, cursor, bytes, staged)) {
+            continue;
+        }
+        if (bytes > manager.frameBudget) {
+            stats.oversizedUploads++;
+        }
+        cursor.frameBytes += bytes;
+
+        if (texture.source == TextureSource::Generated) {
+            generateTexture(manager, texture, commandBuffer, cursor);
+            continue;
+        }
+
+        uint32_t firstLevel = texture.tailMip;
+        VkDeviceSize reserved = staged;
+        while (firstLevel > texture.targetMip && cursor.head + reserved + stagedBytes(texture, firstLevel - 1, firstLevel) <= manager.sliceSize
+            && cursor.frameBytes + texture.levelBytes[firstLevel - 1] <= manager.frameBudget) {
+            firstLevel--;
+            cursor.frameBytes += texture.levelBytes[firstLevel];
+            reserved += stagedBytes(texture, firstLevel, firstLevel + 1);
+        }
+        rebuildTexture(manager, texture, commandBuffer, cursor, firstLevel);
+    }
+
+    // 룺ʣԤڴפһϸķչ
+    for (uint32_t index : streamIns) {
+        ManagedTexture& texture = manager.textures[index];
+        uint32_t firstLevel = texture.residentMip;
+        VkDeviceSize reserved = 0;
+        while (firstLevel > texture.targetMip) {
+            VkDeviceSize bytes = texture.levelBytes[firstLevel - 1];
+            VkDeviceSize staged = stagedBytes(texture, firstLevel - 1, firstLevel);
+            if (cursor.head + reserved + staged > manager.sliceSize
+                || (cursor.frameBytes != 0 && cursor.frameBytes + bytes > manager.frameBudget)) {
+                break;
+            }
+            if (bytes > manager.frameBudget) {
+                stats.oversizedUploads++;
+            }
+            firstLevel--;
+            cursor.frameBytes += bytes;
+            reserved += staged;
+        }
+        if (firstLevel < texture.residentMip) {
+            rebuildTexture(manager, texture, commandBuffer, cursor, firstLevel);
+        }
+    }
+
+    if (cursor.frameBytes > 0) {
+        stats.uploadBytes += cursor.frameBytes;
+        stats.uploadFrames++;
+    }
+
+    stats.residentBytes = 0;
+    for (const ManagedTexture& texture : manager.textures) {
+        stats.residentBytes += getTextureBytesFrom(texture, texture.residentMip);
+    }
+    stats.peakResidentBytes = std::max(stats.peakResidentBytes, stats.residentBytes);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    stats.updateMs += ms;
+    stats.maxUpdateMs = std::max(stats.maxUpdateMs, ms);
+}
+
+BindlessIndex getTextureIndex(const TextureManager& manager, TextureHandle handle) {
+    if (handle >= manager.textures.size()) {
+        return INVALID_BINDLESS_INDEX;
+    }
+    return manager.textures[handle].bindlessIndex;
+}
+
+void printTextureStats(const TextureManager& manager) {
+    const TextureStats& stats = manager.stats;
+    std::cout << "Textures: " << stats.textures << " loaded (" << stats.ktx2Textures << " KTX2, " << stats.generatedTextures
+        << " with GPU mips), " << stats.unsupported << " skipped, " << manager.samplers.samplers.size() << " sampler(s) for "
+        << manager.samplers.stats.requests << " request(s)" << std::endl;
+    std::cout << "  resident " << stats.residentBytes / 1024 << " KB (peak " << stats.peakResidentBytes / 1024 << " KB, wanted "
+        << stats.wantedBytes / 1024 << " KB, pinned " << stats.pinnedBytes / 1024 << " KB) of a "
+        << manager.memoryBudget / 1024 << " KB budget, " << stats.framesOverBudget << " frame(s) over budget" << std::endl;
+    std::cout << "  " << stats.levelsStreamedIn << " level(s) streamed in, " << stats.levelsEvicted << " evicted, "
+        << stats.mipsGenerated << " generated, " << stats.imageRebuilds << " image rebuild(s); uploaded "
+        << stats.uploadBytes / 1024 << " KB over " << stats.uploadFrames << " frame(s) at " << manager.frameBudget / 1024
+        << " KB/frame, " << stats.oversizedUploads << " oversized" << std::endl;
+    std::cout << "  update " << stats.updateMs << " ms total (" << stats.maxUpdateMs << " ms max) over "
+        << stats.frames << " frame(s)" << std::endl;
+}
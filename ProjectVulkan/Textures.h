@@ -0,0 +1,245 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ResourceRegistry.h"
+#include "Upload.h"
+
+// KTX2 ļBCn / ASTC / δѹ mip ֱӴӳļϴֻһδѹ
+// .tga 򵥼 KTX2ϴ 0  GPU  blit  mip 
+//  mip Ļϵʹڹ̶ԴԤڻ뻻 mip ֻҪϸһ
+// Լֵĸפϴֵβ߳ TEXTURE_TAIL_SIZEפ
+// פΧıʱ ResourceRegistry ´ͼ񣬱ĸ GPU ϸƣĸÿ֡ݴϴ
+// ͼ񽻸עɾУڱ֡ fence ٣ƲҪȴ
+// Generated .tga ͵ KTX2ĵ 0 ϴͷţ޷ٻ룬 mip פ
+// ǼԤ㣬뻻Ԥȿ۳Ǻ͸βʣµĲַָ KTX2 ľϸ
+
+const uint32_t TEXTURE_TAIL_SIZE = 64;
+
+// һô֡ûʹ÷ʱ˻صβֵҲҪ֮ǰϸô֡Ч
+const uint32_t TEXTURE_FEEDBACK_FRAMES = 60;
+
+const uint32_t MAX_TEXTURE_LEVELS = 16;
+
+typedef uint32_t TextureHandle;
+const TextureHandle INVALID_TEXTURE = UINT32_MAX;
+
+// ״̬豸֧ʱԣ豸ʱض
+struct SamplerDesc {
+    VkFilter magFilter = VK_FILTER_LINEAR;
+    VkFilter minFilter = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    VkSamplerAddressMode addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    float maxAnisotropy = 1.0f;     //  1 ʱرոԹ
+    float mipLodBias = 0.0f;
+    float minLod = 0.0f;
+    float maxLod = VK_LOD_CLAMP_NONE;
+    VkBorderColor borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK;
+};
+
+struct SamplerCacheStats {
+    uint64_t requests = 0;
+    uint64_t hits = 0;
+};
+
+// ״̬ȥصĲ棺ͬǵõͬһ VkSamplerڻʱͳһ
+struct SamplerCache {
+    std::unordered_map<std::string, VkSampler> samplers;   // ΪضϺ״̬лֽ
+    float maxAnisotropy = 0.0f;     // 豸ޣ0 ʾû samplerAnisotropy
+    SamplerCacheStats stats;
+};
+
+// maxAnisotropy Ϊ 0 ʱвرոԹ
+void createSamplerCache(SamplerCache& cache, float maxAnisotropy);
+void destroySamplerCache(SamplerCache& cache);
+
+// ʧʱ׳쳣
+VkSampler acquireSampler(SamplerCache& cache, const SamplerDesc& desc);
+
+// ʽĿСδѹʽĿΪ 1x1 أֵ֧ĸʽ false
+struct FormatBlockInfo {
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t bytes = 0;
+    bool compressed = false;
+};
+
+bool getFormatBlockInfo(VkFormat format, FormatBlockInfo& info);
+
+//  level ֽУȡ
+VkDeviceSize getTextureLevelBytes(const FormatBlockInfo& block, uint32_t width, uint32_t height, uint32_t level);
+
+//  mip ļһֱ 1x1
+uint32_t getTextureMipCount(uint32_t width, uint32_t height);
+
+// ߳ TEXTURE_TAIL_SIZE ĸϸһûʱΪһ
+uint32_t getTextureTailMip(uint32_t width, uint32_t height, uint32_t levelCount);
+
+// KTX2 ļͷͼKTX 2.0 淶 3 ڣֶΪС
+const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+struct Ktx2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+
+struct Ktx2LevelIndex {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+// KTX2 ļͷõĲ֡levels ±Ϊ mip 0 ϸƫļͷ
+struct Ktx2Level {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct Ktx2Info {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;        // ļеļΪ 1
+    bool generateMips = false;      // ļͷ levelCount Ϊ 0ֻе 0 ɼط mip 
+    std::vector<Ktx2Level> levels;
+};
+
+// ֻ֧ 2D顢塢ûгѹ KTX2 ļСʽһ¡
+// ʧʱ false  error иԭ
+bool parseKtx2(const uint8_t* data, size_t size, Ktx2Info& info, std::string& error);
+
+// Ļռ pixels أ [0, 1] ǵĳȣʱҪϸ mip 
+uint32_t textureMipForFootprint(uint32_t width, uint32_t height, float pixels);
+
+enum class TextureSource {
+    Ktx2,       // ֱӴӳļϴԻ뻻
+    Generated,  // ϴ 0  GPU  mip פ
+};
+
+struct ManagedTexture {
+    std::string path;
+    TextureSource source = TextureSource::Ktx2;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    FormatBlockInfo block;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levelCount = 0;
+    uint32_t tailMip = 0;               // СĸפGenerated Ϊ 0פ
+    VkDeviceSize levelBytes[MAX_TEXTURE_LEVELS] = {};
+
+    MappedFile file;                    // Ktx2ӳԴļ
+    std::vector<Ktx2Level> fileLevels;
+    std::vector<uint8_t> pixels;        // Generated 0 ݣϴͷ
+
+    // ʹ÷
+    uint32_t requestedMip = 0;          // Ҫϸһ
+    uint64_t requestFrame = 0;          // requestedMip ֡
+    uint64_t lastUsedFrame = 0;
+    bool used = false;                  // յ
+
+    uint32_t targetMip = 0;             // ԤڼƻפϸһplanTextureResidency Ľ
+    uint32_t residentMip = 0;           // ǰפϸһûͼʱ levelCount
+
+    ResourceHandle image = INVALID_RESOURCE;    // עеͼͼפļ
+    VkSampler sampler = VK_NULL_HANDLE; // Բ
+    BindlessIndex bindlessIndex = INVALID_BINDLESS_INDEX;   //  imageÿؽͼ񶼻ỻһ±
+};
+
+struct TextureStats {
+    uint32_t textures = 0;
+    uint32_t ktx2Textures = 0;
+    uint32_t generatedTextures = 0;
+    uint32_t unsupported = 0;           // 豸ָ֧ʽļЧ
+    VkDeviceSize residentBytes = 0;     // ǰפĸֽʽ㣬ͼ룩
+    VkDeviceSize peakResidentBytes = 0;
+    VkDeviceSize pinnedBytes = 0;       // β Generated ܻ
+    VkDeviceSize wantedBytes = 0;       // ԤʱҪֽ
+    uint64_t levelsStreamedIn = 0;
+    uint64_t levelsEvicted = 0;
+    uint64_t mipsGenerated = 0;         //  GPU  blit ɵļ
+    uint64_t imageRebuilds = 0;
+    uint64_t uploadBytes = 0;
+    uint64_t uploadFrames = 0;
+    uint64_t oversizedUploads = 0;      //  mip ÿ֡Ԥ㣬ռһ֡ϴ
+    uint64_t framesOverBudget = 0;      // פѳԤ֡
+    uint64_t frames = 0;
+    double updateMs = 0.0;
+    double maxUpdateMs = 0.0;
+};
+
+struct TextureManager {
+    bool enabled = false;
+    VkDeviceSize memoryBudget = 0;      // פֽ
+    VkDeviceSize frameBudget = 0;       // ÿ֡ϴֽ
+    bool textureCompressionBC = false;
+    bool textureCompressionASTC = false;
+    ResourceRegistry* registry = nullptr;   // ͼд٣עް󶨱ʱעᵽ
+    SamplerCache samplers;
+
+    std::vector<ManagedTexture> textures;
+
+    // ÿ;֡һݴڸ֡ fence áһθʱһ䣬֮ٱ
+    GpuBuffer staging;
+    VkDeviceSize sliceSize = 0;
+    uint32_t sliceCount = 0;
+
+    TextureStats stats;
+};
+
+// bc / astc ʾ豸 textureCompressionBC / textureCompressionASTC_LDR
+// maxAnisotropy Ϊ 0 ʾû samplerAnisotropy
+void createTextureManager(TextureManager& manager, VkDeviceSize memoryBudget, VkDeviceSize frameBudget,
+    bool bc, bool astc, float maxAnisotropy);
+
+// ͼ񽻸עɾУ destroyResourceRegistry ֮ǰ
+void destroyTextureManager(TextureManager& manager);
+
+// չ .ktx2 / .tgaֻȡļͷ.tga 룩֮ updateTextureResidency ϴ
+// ޷ʶļЧ豸ָ֧øʽʱ INVALID_TEXTURE
+TextureHandle loadTexture(TextureManager& manager, const std::string& path, const SamplerDesc& sampler);
+
+// ֡Ļ pixels صĴСʹαȡϸһ
+void reportTextureUsage(TextureManager& manager, TextureHandle handle, float pixels, uint64_t frameNumber);
+
+//  mip  first һֽ
+VkDeviceSize getTextureBytesFrom(const ManagedTexture& texture, uint32_t first);
+
+// ҪϸһڣδʹãʱֻҪβ
+uint32_t getWantedTextureMip(const ManagedTexture& texture, uint64_t frameNumber);
+
+// ʹ÷ԤΪÿѡ targetMipؼƻפֽ CPUͼ񣩡
+// ԤʱȽûʹõͬʱȽϸһ
+// β Generated ᱻͣפֳԤʱֵ budget
+VkDeviceSize planTextureResidency(std::vector<ManagedTexture>& textures, uint64_t frameNumber, VkDeviceSize budget);
+
+// ÿ֡Ⱦ֮ͨǰbeginRegistryFrame ֮󣩵ã滮פΧڱ֡¼ƻϴ mip ɡ
+// slot Ϊ֡еĲλʹһݴʱòλһεύѾ
+void updateTextureResidency(TextureManager& manager, uint32_t slot, uint32_t slotCount,
+    uint64_t frameNumber, VkCommandBuffer commandBuffer);
+
+// ûκһפʱ INVALID_BINDLESS_INDEX±ͼؽı䣬ʱÿ֡»ȡ
+BindlessIndex getTextureIndex(const TextureManager& manager, TextureHandle handle);
+
+void printTextureStats(const TextureManager& manager);
@@ -0,0 +1,195 @@
+#include "UniformRing.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+void initUniformRingState(UniformRing& ring, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize range, uint32_t frameCount) {
+    ring.size = size;
+    ring.alignment = std::max<VkDeviceSize>(alignment, 1);
+    ring.range = range;
+    ring.head = 0;
+    ring.used = 0;
+    ring.frameUsed.assign(frameCount, 0);
+    ring.currentFrame = 0;
+    ring.stats = UniformRingStats();
+}
+
+void createUniformRing(UniformRing& ring, uint32_t frameCount, VkDeviceSize bytesPerFrame) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    // ͬһҲԷŴ洢ݣнϴĶ
+    VkDeviceSize alignment = std::max(properties.limits.minUniformBufferOffsetAlignment,
+        properties.limits.minStorageBufferOffsetAlignment);
+    VkDeviceSize range = std::min<VkDeviceSize>(UNIFORM_RING_RANGE, properties.limits.maxUniformBufferRange);
+    initUniformRingState(ring, bytesPerFrame * frameCount, alignment, range, frameCount);
+
+    createBuffer(ring.buffer, ring.size + ring.range,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    ring.mapped = static_cast<uint8_t*>(ring.buffer.mapped);
+
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_ALL;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &ring.setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create uniform ring descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &ring.descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create uniform ring descriptor pool!");
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = ring.descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &ring.setLayout;
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, &ring.set) != VK_SUCCESS) {
+        throw std::runtime_error("failed to allocate uniform ring descriptor set!");
+    }
+
+    // ֻдһΣ֮ÿΰֻı䶯̬ƫ
+    VkDescriptorBufferInfo bufferInfo = {};
+    bufferInfo.buffer = ring.buffer.buffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = ring.range;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = ring.set;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+}
+
+void destroyUniformRing(UniformRing& ring) {
+    if (ring.descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(device, ring.descriptorPool, nullptr);
+    }
+    if (ring.setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, ring.setLayout, nullptr);
+    }
+    destroyBuffer(ring.buffer);
+    ring = UniformRing();
+}
+
+void beginUniformRingFrame(UniformRing& ring, uint32_t frameIndex) {
+    // ֡λ˳ύɣ黹ǻһ
+    ring.used -= ring.frameUsed[frameIndex];
+    ring.frameUsed[frameIndex] = 0;
+    ring.currentFrame = frameIndex;
+
+    // û;ʱͷʼٻ
+    if (ring.used == 0) {
+        ring.head = 0;
+    }
+}
+
+bool allocateUniformRing(UniformRing& ring, VkDeviceSize size, VkDeviceSize& offset) {
+    if (size == 0 || size > ring.range) {
+        ring.stats.overruns++;
+        return false;
+    }
+
+    VkDeviceSize start = (ring.head + ring.alignment - 1) / ring.alignment * ring.alignment;
+    bool wrap = start + size > ring.size;
+    if (wrap) {
+        start = 0;
+    }
+
+    // ռõֽڰ䣻ʱβʣµĲҲڱ֡ڣ汾֡һ黹
+    VkDeviceSize consumed = wrap ? ring.size - ring.head + size : start - ring.head + size;
+    if (ring.used + consumed > ring.size) {
+        ring.stats.overruns++;
+        return false;
+    }
+
+    offset = start;
+    ring.head = start + size;
+    ring.used += consumed;
+    ring.frameUsed[ring.currentFrame] += consumed;
+
+    ring.stats.allocations++;
+    ring.stats.bytes += size;
+    ring.stats.wraps += wrap ? 1 : 0;
+    ring.stats.peakUsed = std::max(ring.stats.peakUsed, ring.used);
+    return true;
+}
+
+bool writeUniformRing(UniformRing& ring, const void* data, VkDeviceSize size, VkDeviceSize& offset) {
+    if (!allocateUniformRing(ring, size, offset)) {
+        return false;
+    }
+    memcpy(ring.mapped + offset, data, static_cast<size_t>(size));
+    return true;
+}
+
+bool prepareDrawConstants(UniformRing& ring, uint32_t pushConstantSize, const void* data, uint32_t size,
+    bool& push, uint32_t& dynamicOffset) {
+    push = size <= pushConstantSize;
+    if (push) {
+        ring.stats.pushes++;
+        return true;
+    }
+
+    VkDeviceSize offset;
+    if (!writeUniformRing(ring, data, size, offset)) {
+        return false;
+    }
+    dynamicOffset = static_cast<uint32_t>(offset);
+    return true;
+}
+
+bool setDrawConstants(UniformRing& ring, VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t set,
+    VkShaderStageFlags stages, uint32_t pushConstantSize, const void* data, uint32_t size) {
+    bool push = false;
+    uint32_t dynamicOffset = 0;
+    if (!prepareDrawConstants(ring, pushConstantSize, data, size, push, dynamicOffset)) {
+        return false;
+    }
+
+    if (push) {
+        vkCmdPushConstants(commandBuffer, layout, stages, 0, size, data);
+    }
+    else {
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, set, 1, &ring.set, 1, &dynamicOffset);
+    }
+    return true;
+}
+
+void printUniformRingStats(const UniformRing& ring) {
+    const UniformRingStats& stats = ring.stats;
+    std::cout << "Uniform ring: " << stats.allocations << " allocations (" << stats.bytes << " bytes), "
+        << stats.pushes << " push constant updates, " << stats.wraps << " wraps, peak "
+        << stats.peakUsed << "/" << ring.size << " bytes";
+    if (stats.overruns > 0) {
+        std::cout << ", " << stats.overruns << " FAILED allocations";
+    }
+    std::cout << std::endl;
+}
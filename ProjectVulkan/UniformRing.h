@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Upload.h"
+
+// ÿ;֡õĳֽ
+const VkDeviceSize UNIFORM_RING_FRAME_SIZE = 1024 * 1024;
+
+// ̬ UBO ķΧҲǵη
+const VkDeviceSize UNIFORM_RING_RANGE = 16 * 1024;
+
+struct UniformRingStats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t pushes = 0;            // ͳĴ
+    uint64_t wraps = 0;
+    uint64_t overruns = 0;          // ռ䱻;֡ռʧܵķ
+    VkDeviceSize peakUsed = 0;
+};
+
+// ÿ֡ʱ任ʲĻλ־ӳ䣬ֻƶ head
+// ʱö̬ƫƣҪд֡ڻβӣ
+// һ֡Ŀռڸ֡ fence beginUniformRingFrame黹
+struct UniformRing {
+    GpuBuffer buffer;
+    uint8_t* mapped = nullptr;
+    VkDeviceSize size = 0;          // ɷֽ range ֽڣĩβƫƼϷΧҲԽ
+    VkDeviceSize alignment = 1;     // ̬ƫƵĶ루minUniformBufferOffsetAlignment
+    VkDeviceSize range = 0;
+    VkDeviceSize head = 0;
+    VkDeviceSize used = 0;          // ;֡ռõֽڣͻ˷ѵĲ
+    std::vector<VkDeviceSize> frameUsed; // ÿ֡λռõֽ
+    uint32_t currentFrame = 0;
+
+    // set  binding 0 ָ UNIFORM_BUFFER_DYNAMIC
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    UniformRingStats stats;
+};
+
+// ֻʼ״̬ Vulkan 󣨲ʹã
+void initUniformRingState(UniformRing& ring, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize range, uint32_t frameCount);
+
+// ʧʱ׳쳣
+void createUniformRing(UniformRing& ring, uint32_t frameCount, VkDeviceSize bytesPerFrame);
+void destroyUniformRing(UniformRing& ring);
+
+// frameIndex λһ֡Ѿɣfence ѵȴ黹ռõĿռ
+void beginUniformRingFrame(UniformRing& ring, uint32_t frameIndex);
+
+//  size ֽڣ ring.alignment 룩ʣռḲ;֡ʱ false
+bool allocateUniformRing(UniformRing& ring, VkDeviceSize size, VkDeviceSize& offset);
+
+// 䲢ݣʧʱ false
+bool writeUniformRing(UniformRing& ring, const void* data, VkDeviceSize size, VkDeviceSize& offset);
+
+// ÿƵĳ pushConstantSize ʱͳƫ 0д뻷Զ̬ƫ
+// 󶨵 layout ĵ set λñ ring.setLayoutɫе binding 0  uniform 飬
+//  shaders.json  constantsSetֻ¼߳ϵ
+bool setDrawConstants(UniformRing& ring, VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t set,
+    VkShaderStageFlags stages, uint32_t pushConstantSize, const void* data, uint32_t size);
+
+// setDrawConstants в¼Ĳ֣push Ϊ true ʱӦֱͣд뻷dynamicOffset Ϊƫ
+bool prepareDrawConstants(UniformRing& ring, uint32_t pushConstantSize, const void* data, uint32_t size,
+    bool& push, uint32_t& dynamicOffset);
+
+void printUniformRingStats(const UniformRing& ring);
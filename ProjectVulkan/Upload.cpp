@@ -0,0 +1,260 @@
+#include "Upload.h"
+#include "VulkanContext.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+void createBuffer(GpuBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) {
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer.buffer, &memRequirements);
+
+    allocateMemory(gpuAllocator, memRequirements, properties, ResourceKind::Linear, buffer.allocation);
+    vkBindBufferMemory(device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+
+    buffer.size = size;
+    buffer.mapped = buffer.allocation.mapped; // ѳ־ӳ HOST_VISIBLE ڴ
+}
+
+void destroyBuffer(GpuBuffer& buffer) {
+    if (buffer.buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, buffer.buffer, nullptr);
+    }
+    freeMemory(gpuAllocator, buffer.allocation);
+
+    buffer = GpuBuffer();
+}
+
+void createDeviceLocalBuffer(GpuBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
+    createBuffer(buffer, size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+void createUploadContext(UploadContext& ctx, VkQueue queue, uint32_t queueFamilyIndex, VkDeviceSize stagingSize) {
+    // HOST_COHERENTдݴڴҪ vkFlushMappedMemoryRanges
+    createBuffer(ctx.staging, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+    ctx.queue = queue;
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &ctx.commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create upload command pool!");
+    }
+}
+
+void destroyUploadContext(UploadContext& ctx) {
+    waitForUploads(ctx);
+
+    for (UploadBatch& batch : ctx.freeBatches) {
+        vkDestroyFence(device, batch.fence, nullptr);
+    }
+    if (ctx.commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(device, ctx.commandPool, nullptr);
+    }
+    destroyBuffer(ctx.staging);
+
+    ctx = UploadContext();
+}
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// ݴ滷з size ֽڣռ䲻ʱ false
+static bool allocateStaging(UploadContext& ctx, VkDeviceSize size, VkDeviceSize& offset) {
+    const VkDeviceSize alignment = 16;
+    const VkDeviceSize capacity = ctx.staging.size;
+
+    if (ctx.used == 0) {
+        ctx.head = 0; // Ϊʱͷʼõռ
+    }
+
+    VkDeviceSize start = alignUp(ctx.head, alignment);
+    VkDeviceSize needed = start - ctx.head + size;
+    if (start + size > capacity) {
+        // βŲ£ƵͷβʣռΪ˷
+        start = 0;
+        needed = capacity - ctx.head + size;
+    }
+
+    if (ctx.used + needed > capacity) {
+        return false;
+    }
+
+    offset = start;
+    ctx.head = start + size;
+    ctx.used += needed;
+    ctx.batchBytes += needed;
+    return true;
+}
+
+void retireUploads(UploadContext& ctx) {
+    // ΰύ˳ɣֻĿʼգ֤ͷŵǻɵ
+    while (!ctx.inFlight.empty() && vkGetFenceStatus(device, ctx.inFlight.front().fence) == VK_SUCCESS) {
+        UploadBatch batch = ctx.inFlight.front();
+        ctx.inFlight.pop_front();
+
+        ctx.used -= batch.stagingBytes;
+        batch.stagingBytes = 0;
+        ctx.freeBatches.push_back(batch);
+    }
+}
+
+// ȴɲ
+static void waitOldestUpload(UploadContext& ctx) {
+    if (ctx.inFlight.empty()) {
+        return;
+    }
+
+    vkWaitForFences(device, 1, &ctx.inFlight.front().fence, VK_TRUE, UINT64_MAX);
+    ctx.stats.stagingWaits++;
+    retireUploads(ctx);
+}
+
+void enqueueBufferUpload(UploadContext& ctx, VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    while (size > 0) {
+        VkDeviceSize chunk = std::min(size, ctx.staging.size);
+
+        VkDeviceSize stagingOffset = 0;
+        while (!allocateStaging(ctx, chunk, stagingOffset)) {
+            // ݴ滷ȰŶӵĿύٵȴ
+            if (!ctx.pendingCopies.empty()) {
+                flushUploads(ctx);
+            }
+            else if (ctx.inFlight.empty()) {
+                throw std::runtime_error("staging ring is too small for upload!");
+            }
+            else {
+                waitOldestUpload(ctx);
+            }
+        }
+
+        memcpy(static_cast<uint8_t*>(ctx.staging.mapped) + stagingOffset, bytes, static_cast<size_t>(chunk));
+
+        PendingCopy copy;
+        copy.dstBuffer = dstBuffer;
+        copy.region.srcOffset = stagingOffset;
+        copy.region.dstOffset = dstOffset;
+        copy.region.size = chunk;
+        ctx.pendingCopies.push_back(copy);
+
+        bytes += chunk;
+        dstOffset += chunk;
+        size -= chunk;
+        ctx.stats.bytesUploaded += chunk;
+    }
+}
+
+void flushUploads(UploadContext& ctx) {
+    if (ctx.pendingCopies.empty()) {
+        return;
+    }
+
+    retireUploads(ctx);
+
+    UploadBatch batch;
+    if (!ctx.freeBatches.empty()) {
+        batch = ctx.freeBatches.back();
+        ctx.freeBatches.pop_back();
+        vkResetFences(device, 1, &batch.fence);
+    }
+    else {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = ctx.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &batch.commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate upload command buffer!");
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+        if (vkCreateFence(device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create upload fence!");
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to begin upload command buffer!");
+    }
+
+    // ͬһĿ껺Ŀϲһ vkCmdCopyBuffer
+    std::stable_sort(ctx.pendingCopies.begin(), ctx.pendingCopies.end(),
+        [](const PendingCopy& a, const PendingCopy& b) { return a.dstBuffer < b.dstBuffer; });
+
+    std::vector<VkBufferCopy> regions;
+    size_t first = 0;
+    while (first < ctx.pendingCopies.size()) {
+        VkBuffer dst = ctx.pendingCopies[first].dstBuffer;
+
+        regions.clear();
+        size_t last = first;
+        while (last < ctx.pendingCopies.size() && ctx.pendingCopies[last].dstBuffer == dst) {
+            regions.push_back(ctx.pendingCopies[last].region);
+            last++;
+        }
+
+        vkCmdCopyBuffer(batch.commandBuffer, ctx.staging.buffer, dst, static_cast<uint32_t>(regions.size()), regions.data());
+        ctx.stats.copyCount += regions.size();
+        first = last;
+    }
+
+    // ֮ύͬһежȡɼ㡢ɫȡȣ
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+    if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to record upload command buffer!");
+    }
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+
+    if (vkQueueSubmit(ctx.queue, 1, &submitInfo, batch.fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit upload command buffer!");
+    }
+
+    batch.stagingBytes = ctx.batchBytes;
+    ctx.batchBytes = 0;
+    ctx.inFlight.push_back(batch);
+    ctx.pendingCopies.clear();
+    ctx.stats.submitCount++;
+}
+
+void waitForUploads(UploadContext& ctx) {
+    flushUploads(ctx);
+
+    while (!ctx.inFlight.empty()) {
+        vkWaitForFences(device, 1, &ctx.inFlight.front().fence, VK_TRUE, UINT64_MAX);
+        retireUploads(ctx);
+    }
+}
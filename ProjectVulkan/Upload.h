@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "MemoryAllocator.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// ڴ
+struct GpuBuffer {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    Allocation allocation;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;     // HOST_VISIBLE ڴ־ӳĵַ
+};
+
+void createBuffer(GpuBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+void destroyBuffer(GpuBuffer& buffer);
+
+// λ DEVICE_LOCAL ϵĻֻͨݴϴд
+void createDeviceLocalBuffer(GpuBuffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage);
+
+// һύ + fence + ռõݴֽ
+struct UploadBatch {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    VkDeviceSize stagingBytes = 0;
+};
+
+struct PendingCopy {
+    VkBuffer dstBuffer;
+    VkBufferCopy region;
+};
+
+struct UploadStats {
+    uint64_t bytesUploaded = 0;
+    uint64_t copyCount = 0;
+    uint64_t submitCount = 0;
+    uint64_t stagingWaits = 0;  // ݴ滷ȴ GPU Ĵ
+};
+
+// ݴ滷λ + пŶӵ flushUploads ʱϲһύ
+// ݴռ䰴ύ˳ fence 
+struct UploadContext {
+    GpuBuffer staging;
+    VkDeviceSize head = 0;      // һηλ
+    VkDeviceSize used = 0;      // Ŷ/ִеռõֽ˷ѣ
+    VkDeviceSize batchBytes = 0;
+
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    std::vector<PendingCopy> pendingCopies;
+    std::deque<UploadBatch> inFlight;
+    std::vector<UploadBatch> freeBatches;
+
+    UploadStats stats;
+};
+
+void createUploadContext(UploadContext& ctx, VkQueue queue, uint32_t queueFamilyIndex, VkDeviceSize stagingSize);
+void destroyUploadContext(UploadContext& ctx);
+
+// ݸƽݴ滷ŶһλݿԴݴ滷ᱻ
+void enqueueBufferUpload(UploadContext& ctx, VkBuffer dstBuffer, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+
+// ŶӵĿϲһύʹ֮ύͬһеɼ
+void flushUploads(UploadContext& ctx);
+
+// ռõݴռ䣨
+void retireUploads(UploadContext& ctx);
+
+void waitForUploads(UploadContext& ctx);
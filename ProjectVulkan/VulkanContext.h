@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+// main.cpp жȫ Vulkan 󣬹ģʹ
+extern VkInstance instance;
+extern VkDevice device;
+extern VkPhysicalDevice physicalDevice;
+extern VkQueue graphicsQueue;
+extern VkRenderPass renderPass;
+extern VkPipelineCache pipelineCache;
+
+// лͼڴ涼з
+struct GpuAllocator;
+extern GpuAllocator gpuAllocator;
+
+// Ҫڴ
+uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
@@ -2,18 +2,94 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.h>
 #include <iostream>
-#include <fstream>
 #include <vector>
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <filesystem>
+#include <random>
+
+#include "AssetPack.h"
+#include "Config.h"
+#include "Descriptors.h"
+#include "FrameRing.h"
+#include "FrameStats.h"
+#include "IndirectDraw.h"
+#include "JobSystem.h"
+#include "MemoryAllocator.h"
+#include "MeshProcessing.h"
+#include "Offscreen.h"
+#include "Particles.h"
+#include "PipelineCache.h"
+#include "PipelineRegistry.h"
+#include "Presenter.h"
+#include "Profiler.h"
+#include "Readback.h"
+#include "RenderGraph.h"
+#include "ResourceRegistry.h"
+#include "Scene.h"
+#include "ShaderInterface.h"
+#include "ShaderLibrary.h"
+#include "ShaderReflection.h"
+#include "SimdMath.h"
+#include "Streaming.h"
+#include "Textures.h"
+#include "Upload.h"
+#include "VulkanContext.h"
 
 VkInstance instance;
 VkDevice device;
 VkPhysicalDevice physicalDevice;
 VkQueue graphicsQueue;
+VkQueue transferQueue;
+VkQueue computeQueue;                           // ֻҪģʱȡ
 VkRenderPass renderPass;
 VkPipelineLayout pipelineLayout;
-VkPipeline graphicsPipeline;
+std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+ShaderLibrary shaderLibrary;
+PipelineRegistry pipelineRegistry;
+PipelineHandle trianglePipeline = INVALID_PIPELINE;
+VkPipelineLayout instancedPipelineLayout;
+PipelineHandle instancedPipeline = INVALID_PIPELINE;
+VkPipelineCache pipelineCache;
 VkDebugUtilsMessengerEXT debugMessenger;
 VkQueue presentQueue;
+GLFWwindow* window;
+VkSurfaceKHR surface;
+Presenter presenter;                            // ޴ģʽΪĿ
+FramePacer framePacer;
+VkFormat colorFormat = VK_FORMAT_B8G8R8A8_SRGB;
+GpuAllocator gpuAllocator;
+VkPhysicalDeviceFeatures deviceFeatures = {};   // 豸ʱõĿѡ
+Profiler profiler;
+FrameRing frameRing;
+IndirectDrawFeatures indirectFeatures;
+bool physicalDeviceProperties2 = false;         //  VK_KHR_get_physical_device_properties2ʱź
+bool timelineSemaphores = false;                //  VK_KHR_timeline_semaphore
+DescriptorIndexingSupport descriptorIndexing;   // supported ʱ VK_EXT_descriptor_indexing
+BindlessTable bindlessTable;
+StreamingLoader streamingLoader;
+FrameReadback frameReadback;                    // --captureȾдͼ
+ParticleSystem particleSystem;                  // --particlesGPU ӣжʱ첽ģ
+TextureManager textureManager;                  // --texturesʹ÷Ԥڻ뻻 mip 
+ResourceRegistry resourceRegistry;              // дٵԴƳٵ֡ fence ֮
+const VkDeviceSize STREAMING_STAGING_SIZE = 32 * 1024 * 1024;
+
+struct QueueFamilyIndices {
+    uint32_t graphics = UINT32_MAX;
+    uint32_t present = UINT32_MAX;
+    uint32_t transfer = UINT32_MAX;
+    uint32_t transferQueueIndex = 0;    // е±꣨ͼͬʱΪڶУ
+    uint32_t compute = UINT32_MAX;
+    uint32_t computeQueueIndex = 0;     // е±꣬ͼͬΪ 0 ʱͼζ
+};
+
+QueueFamilyIndices queueFamilies;
 
 const std::vector<const char*> validationLayers = {
     "VK_LAYER_KHRONOS_validation"
@@ -73,35 +149,6 @@ void setupDebugMessenger() {
     }
 }
 
-//  SPIR-V ɫ
-VkShaderModule loadShader(const std::string& filePath) {
-    std::ifstream file(filePath, std::ios::ate | std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open shader file!" << std::endl;
-        exit(1);
-    }
-
-    size_t fileSize = (size_t)file.tellg();
-    std::vector<char> buffer(fileSize);
-    file.seekg(0);
-    file.read(buffer.data(), fileSize);
-    file.close();
-
-    VkShaderModuleCreateInfo createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = buffer.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(buffer.data());
-
-    VkShaderModule shaderModule;
-    if (vkCreateShaderModule(device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
-        std::cerr << "Failed to create shader module!" << std::endl;
-        exit(1);
-    }
-
-    return shaderModule;
-}
-
-
 //  Vulkan ʵ
 void createInstance() {
     if (checkValidationLayerSupport()) {
@@ -139,12 +186,24 @@ void createInstance() {
     vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, availableExtensions.data());
 
 
+    // ģʽҪ GLFW ҪıչVK_KHR_surface ƽ̨صչ
     std::vector<const char*> enabledExtensions;
-    enabledExtensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+    if (!appConfig.headless) {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        if (glfwExtensions == nullptr) {
+            throw std::runtime_error("failed to find the instance extensions required for window surfaces!");
+        }
+        enabledExtensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
     for (const auto& extension : availableExtensions) {
         if (strcmp(extension.extensionName, VK_EXT_DEBUG_UTILS_EXTENSION_NAME) == 0) {
             enabledExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
         }
+        if (strcmp(extension.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0) {
+            enabledExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            physicalDeviceProperties2 = true;
+        }
     }
 
     createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
@@ -156,6 +215,125 @@ void createInstance() {
     }
 }
 
+// ڱҪѡ豸֮ǰҳֶҪ
+void createSurface() {
+    if (glfwCreateWindowSurface(instance, window, nullptr, &surface) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create window surface!");
+    }
+}
+
+// ͼκͳʹͬһ塣ѡִֻ֧壨 DMA 棩
+// ͼεļ塢ͼĵڶУûʱͼιͬһС
+// 첽ѡ񣺲ͼεļ塢ͼûռõĶУûʱͼιͬһ
+QueueFamilyIndices findQueueFamilies(VkPhysicalDevice dev) {
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(dev, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(dev, &familyCount, families.data());
+
+    QueueFamilyIndices indices;
+    for (uint32_t i = 0; i < familyCount; i++) {
+        if (families[i].queueCount > 0 && (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.graphics = i;
+            break;
+        }
+    }
+    if (indices.graphics == UINT32_MAX) {
+        return indices;
+    }
+
+    // ûдڱʱ޴ģʽҪ֣ͼ
+    indices.present = indices.graphics;
+    if (surface != VK_NULL_HANDLE) {
+        VkBool32 supported = VK_FALSE;
+        vkGetPhysicalDeviceSurfaceSupportKHR(dev, indices.graphics, surface, &supported);
+        for (uint32_t i = 0; i < familyCount && !supported; i++) {
+            vkGetPhysicalDeviceSurfaceSupportKHR(dev, i, surface, &supported);
+            if (supported) {
+                indices.present = i;
+            }
+        }
+        if (!supported) {
+            indices.present = UINT32_MAX;
+        }
+    }
+
+    for (uint32_t i = 0; i < familyCount && indices.transfer == UINT32_MAX; i++) {
+        VkQueueFlags flags = families[i].queueFlags;
+        if (families[i].queueCount > 0 && (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            indices.transfer = i;
+        }
+    }
+    for (uint32_t i = 0; i < familyCount && indices.transfer == UINT32_MAX; i++) {
+        VkQueueFlags flags = families[i].queueFlags;
+        if (families[i].queueCount > 0 && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.transfer = i;
+        }
+    }
+    if (indices.transfer == UINT32_MAX) {
+        indices.transfer = indices.graphics;
+        indices.transferQueueIndex = families[indices.graphics].queueCount > 1 ? 1 : 0;
+    }
+
+    for (uint32_t i = 0; i < familyCount && indices.compute == UINT32_MAX; i++) {
+        VkQueueFlags flags = families[i].queueFlags;
+        if (families[i].queueCount > 0 && (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            indices.compute = i;
+        }
+    }
+    if (indices.compute == UINT32_MAX) {
+        indices.compute = indices.graphics;
+    }
+
+    // ͬѱͼΣ 0 ʹռõĶУвʱͼͼιã봫乲
+    uint32_t firstFree = indices.compute == indices.graphics ? 1 : 0;
+    if (indices.compute == indices.transfer) {
+        firstFree = std::max(firstFree, indices.transferQueueIndex + 1);
+    }
+    if (firstFree < families[indices.compute].queueCount) {
+        indices.computeQueueIndex = firstFree;
+    }
+    else {
+        indices.computeQueueIndex = indices.compute == indices.graphics ? 0 : indices.transferQueueIndex;
+    }
+
+    return indices;
+}
+
+// ͼζͬһʱ첽ύļȾȻִ
+bool isComputeQueueShared() {
+    return queueFamilies.compute == queueFamilies.graphics && queueFamilies.computeQueueIndex == 0;
+}
+
+std::string describeComputeQueue() {
+    if (queueFamilies.compute != queueFamilies.graphics) {
+        return "dedicated family";
+    }
+    return isComputeQueueShared() ? "shared with graphics" : "graphics queue " + std::to_string(queueFamilies.computeQueueIndex);
+}
+
+// ģʽ豸֧ VK_KHR_swapchainҶһָʽͳģʽ
+bool supportsSwapchain(VkPhysicalDevice dev) {
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(dev, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(dev, nullptr, &extensionCount, extensions.data());
+
+    bool hasSwapchain = false;
+    for (const VkExtensionProperties& extension : extensions) {
+        hasSwapchain = hasSwapchain || strcmp(extension.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0;
+    }
+    if (!hasSwapchain) {
+        return false;
+    }
+
+    uint32_t formatCount = 0;
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(dev, surface, &formatCount, nullptr);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(dev, surface, &modeCount, nullptr);
+    return formatCount > 0 && modeCount > 0;
+}
+
 void pickPhysicalDevice() {
     uint32_t deviceCount = 0;
     vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
@@ -169,8 +347,19 @@ void pickPhysicalDevice() {
     vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
 
     for (const auto& dev : devices) {
-        if (true /* ѡʺϵ GPU֧ͼζ */) {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(dev, &props);
+
+        // ָ豸ʱѡ CI ϵ lavapipe"llvmpipe"
+        if (!appConfig.deviceName.empty() && strstr(props.deviceName, appConfig.deviceName.c_str()) == nullptr) {
+            continue;
+        }
+
+        QueueFamilyIndices indices = findQueueFamilies(dev);
+        if (indices.graphics != UINT32_MAX && indices.present != UINT32_MAX
+            && (surface == VK_NULL_HANDLE || supportsSwapchain(dev))) {
             physicalDevice = dev;
+            queueFamilies = indices;
             break;
         }
     }
@@ -179,29 +368,138 @@ void pickPhysicalDevice() {
         std::cerr << "Failed to find a suitable GPU!" << std::endl;
         exit(1);
     }
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    std::cout << "Using device: " << props.deviceName << std::endl;
+
+    const char* transferKind = queueFamilies.transfer != queueFamilies.graphics ? "dedicated family"
+        : queueFamilies.transferQueueIndex > 0 ? "second graphics queue" : "shared with graphics";
+    std::cout << "Queue families: graphics " << queueFamilies.graphics << ", present " << queueFamilies.present
+        << ", transfer " << queueFamilies.transfer << " (" << transferKind << ")"
+        << ", compute " << queueFamilies.compute << " (" << describeComputeQueue() << ")" << std::endl;
 }
 
 void createLogicalDevice() {
-    VkDeviceQueueCreateInfo queueCreateInfo = {};
-    queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    queueCreateInfo.queueFamilyIndex = 0; // ĬѡΪ 0ʵӦʱҪѯ壩
-    queueCreateInfo.queueCount = 1;
-    float queuePriority = 1.0f;
-    queueCreateInfo.pQueuePriorities = &queuePriority;
+    // ÿõһϢͬĶкϲͼͬʱṩͼУ
+    const float queuePriorities[] = { 1.0f, 0.5f, 0.5f };
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+    auto addQueue = [&](uint32_t family, uint32_t queueCount) {
+        for (VkDeviceQueueCreateInfo& info : queueCreateInfos) {
+            if (info.queueFamilyIndex == family) {
+                info.queueCount = std::max(info.queueCount, queueCount);
+                return;
+            }
+        }
 
-    // г豸չ
-    std::vector<const char*> deviceExtensions = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME//  swapchain չ
+        VkDeviceQueueCreateInfo queueCreateInfo = {};
+        queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queueCreateInfo.queueFamilyIndex = family;
+        queueCreateInfo.queueCount = queueCount;
+        queueCreateInfo.pQueuePriorities = queuePriorities;
+        queueCreateInfos.push_back(queueCreateInfo);
+    };
+    addQueue(queueFamilies.graphics, 1);
+    addQueue(queueFamilies.present, 1);
+    addQueue(queueFamilies.transfer, queueFamilies.transferQueueIndex + 1);
+
+    bool particles = appConfig.particleCount > 0 || appConfig.benchmarkParticles;
+    if (particles) {
+        addQueue(queueFamilies.compute, queueFamilies.computeQueueIndex + 1);
+    }
+
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+    auto hasExtension = [&](const char* name) {
+        for (const VkExtensionProperties& extension : extensions) {
+            if (strcmp(extension.extensionName, name) == 0) {
+                return true;
+            }
+        }
+        return false;
     };
 
+    // г豸չ
+    std::vector<const char*> deviceExtensions;
+    if (!appConfig.headless) {
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME); //  swapchain չ
+    }
+
+    // ܷĹͳƲѯǿѡԣֻҪ֧ʱ
+    if (!appConfig.tracePath.empty() && appConfig.pipelineStatistics) {
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+        deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+        deviceFeatures.inheritedQueries = supportedFeatures.inheritedQueries;
+        if (!supportedFeatures.pipelineStatisticsQuery) {
+            std::cerr << "Pipeline statistics queries not supported, collecting timestamps only" << std::endl;
+        }
+    }
+
+    // ļӻƣһύе firstInstanceGPU չǿѡ
+    bool drawIndirectCount = false;
+    if (appConfig.objectCount > 0 || appConfig.benchmarkDraws) {
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+        deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+        deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+
+        if (hasExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) {
+            deviceExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+            drawIndirectCount = true;
+        }
+    }
+
+    // Ŀѹʽ͸Թǿѡԣ֧ʱã豸ֵ֧ĸʽڼʱ
+    if (!appConfig.texturePaths.empty()) {
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
+        deviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    }
+
+    // ʽʱźѴеĿͼζУ֧ʱ˻ fence
+    // ӵ첽Ҳͼζлȴ֧ʱСչҪ֧ timelineSemaphore 
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures = {};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+    if ((!appConfig.streamPaths.empty() || particles) && physicalDeviceProperties2 && hasExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+        deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+        timelineSemaphores = true;
+    }
+
+    // ްVulkan 1.2 ֮ǰչ maintenance3
+    if (hasExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) && hasExtension(VK_KHR_MAINTENANCE3_EXTENSION_NAME)) {
+        queryDescriptorIndexing(physicalDevice, physicalDeviceProperties2, descriptorIndexing);
+        if (descriptorIndexing.supported) {
+            deviceExtensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        }
+    }
+
+    // õչԽṹ pNext 
+    void* featureChain = nullptr;
+    if (timelineSemaphores) {
+        timelineFeatures.pNext = featureChain;
+        featureChain = &timelineFeatures;
+    }
+    if (descriptorIndexing.supported) {
+        descriptorIndexing.features.pNext = featureChain;
+        featureChain = &descriptorIndexing.features;
+    }
+
     // 豸ʱȷ VK_KHR_swapchain չ
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    createInfo.pNext = nullptr;
-    createInfo.queueCreateInfoCount = 1; // дϢ
-    createInfo.pQueueCreateInfos = &queueCreateInfo;
+    createInfo.pNext = featureChain;
+    createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
+    createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.pEnabledFeatures = &deviceFeatures;
     createInfo.enabledLayerCount = 0;
 
     if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS)
@@ -210,20 +508,32 @@ void createLogicalDevice() {
         exit(1);
     }
 
-    vkGetDeviceQueue(device, 0, 0, &graphicsQueue);
-    vkGetDeviceQueue(device, 0, 0, &presentQueue); // ֶͼζͬ
+    vkGetDeviceQueue(device, queueFamilies.graphics, 0, &graphicsQueue);
+    vkGetDeviceQueue(device, queueFamilies.present, 0, &presentQueue);
+    vkGetDeviceQueue(device, queueFamilies.transfer, queueFamilies.transferQueueIndex, &transferQueue);
+    if (particles) {
+        vkGetDeviceQueue(device, queueFamilies.compute, queueFamilies.computeQueueIndex, &computeQueue);
+    }
+
+    indirectFeatures.multiDrawIndirect = deviceFeatures.multiDrawIndirect == VK_TRUE;
+    indirectFeatures.drawIndirectFirstInstance = deviceFeatures.drawIndirectFirstInstance == VK_TRUE;
+    if (drawIndirectCount) {
+        indirectFeatures.drawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(device, "vkCmdDrawIndexedIndirectCountKHR"));
+    }
 }
 
 void createRenderPass() {
     VkAttachmentDescription colorAttachment = {};
-    colorAttachment.format = VK_FORMAT_B8G8R8A8_SRGB; // ʹýͼʽ
+    colorAttachment.format = colorFormat; // ʹýͼʽ
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;  // ʹ VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+    // תǰ PRESENT_SRC_KHRص TRANSFER_SRC_OPTIMAL֡ͼ
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorAttachmentRef = {};
     colorAttachmentRef.attachment = 0;
@@ -249,211 +559,463 @@ void createRenderPass() {
     }
 }
 
-// ͼιߣPSO
-void createGraphicsPipeline() {
-
-    //// һ VkDescriptorSetLayout 
-    //VkDescriptorSetLayout descriptorSetLayout = /* Ѵ */;
-
-    // ͳΧУ
-    VkPushConstantRange pushConstantRange = {};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT; // ǶƬɫ
-    pushConstantRange.offset = 0;
-    //pushConstantRange.size = sizeof(glm::mat4); // һ 4x4 
-
-    //  VkPipelineLayoutCreateInfo
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 0; // û
-    pipelineLayoutInfo.pSetLayouts = nullptr; // û
-    pipelineLayoutInfo.pushConstantRangeCount = 0; // ûͳΧ
-    pipelineLayoutInfo.pPushConstantRanges = nullptr; // ûͳΧ
-
-    ////  PipelineLayoutCreateInfo
-    //pipelineLayoutInfo.setLayoutCount = 1;
-    //pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-    //pipelineLayoutInfo.pushConstantRangeCount = 1;
-    //pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-
-    // ͳ pipeline layout
-    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
-        std::cerr << "Failed to create pipeline layout with descriptor set and push constants!" << std::endl;
-        return ;
-    }
-
-    VkShaderModule vertShaderModule = loadShader("F:/TEMP/ProjectVulkan/vert.spv");
-    VkShaderModule fragShaderModule = loadShader("F:/TEMP/ProjectVulkan/frag.spv");
-
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
-
-    VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
-
-    VkVertexInputBindingDescription bindingDescription = {};
-    bindingDescription.binding = 0;                    // 󶨵㣬 vertexAttributeDescription еİһ
-    bindingDescription.stride = 4;        // ÿݴС
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;  // ʣ VK_VERTEX_INPUT_RATE_VERTEX  VK_VERTEX_INPUT_RATE_INSTANCE
-
-    std::vector<VkVertexInputBindingDescription> bindingDescriptions = { bindingDescription };
-
-    VkVertexInputAttributeDescription attributeDescription = {};
-    attributeDescription.location = 0; // ɫе Location 0 Ӧ
-    attributeDescription.binding = 0;  // 󶨵㣬ʵ
-    attributeDescription.format = VK_FORMAT_R32G32B32_SFLOAT; // ʽӦ붥ɫеݸʽһ
-    //attributeDescription.offset = offsetof(Vertex, position); // ƫĶݽṹ
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.pNext = nullptr;
-    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
-    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
-    vertexInputInfo.pVertexAttributeDescriptions = &attributeDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = 1;
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+VkExtent2D swapChainExtent;
+size_t pipelineCacheLoadedBytes = 0;
+AssetPack scenePack;    // ʱԴΪԴѹ
+
+// õɫӿһߣlayout ɵߴ
+PipelineHandle requestReflectedPipeline(const PipelineInterface& shaders, VkPipelineLayout layout) {
+    GraphicsPipelineDesc desc;
+    desc.vertexShader = getShaderModule(shaderLibrary, shaders.shaders[0]);
+    desc.fragmentShader = getShaderModule(shaderLibrary, shaders.shaders[1]);
+    applyVertexInput(shaders, desc);
+    if (scenePack.header) {
+        applyPackVertexInput(scenePack, desc);
+    }
 
-    VkViewport viewport = {};
-    viewport.width = 800.0f;
-    viewport.height = 600.0f;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
+    desc.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    desc.polygonMode = VK_POLYGON_MODE_FILL;
+    desc.cullMode = VK_CULL_MODE_BACK_BIT;
+    desc.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    desc.layout = layout;
+    desc.renderPass = renderPass;
+    desc.subpass = 0;
 
-    VkRect2D scissor = {};
-    scissor.extent = { 800, 600 };
-
-    VkPipelineViewportStateCreateInfo viewportState = {};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer = {};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    rasterizer.lineWidth = 1.0f;
-
-    VkPipelineMultisampleStateCreateInfo multisampling = {};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-    colorBlendAttachment.blendEnable = VK_FALSE;
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending = {};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    VkGraphicsPipelineCreateInfo pipelineInfo = {};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.layout = pipelineLayout;
-    pipelineInfo.renderPass = renderPass;
-    pipelineInfo.subpass = 0;
-
-    VkResult result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline);
+    // ڹ߳ϱ룬¼ʱδĻƻᱻ
+    return requestGraphicsPipeline(pipelineRegistry, desc);
+}
 
-    if (result != VK_SUCCESS) {
-        std::cerr << "Failed to create graphics pipeline!" << std::endl;
-        exit(1);
+// ͼιߣPSO
+void createGraphicsPipeline() {
+    // 롢ͳ SPIR-V 䣨shader_build.py  ShaderReflection.h
+    pipelineLayout = createPipelineLayout(ShaderReflection::Triangle, descriptorSetLayouts);
+    trianglePipeline = requestReflectedPipeline(ShaderReflection::Triangle, pipelineLayout);
+
+    // ӵĻʹʵߣ 1 Ϊÿʵݡinstanced.vert ӳжȡ
+    // ļ׷ڷļ֮󣨱Ϊ InstancedConstantsSetÿƵɫ±ͳ
+    // ް󶨱ʱ textured.frag±ļ׷ڳ֮InstancedTexturedBindlessSet
+    if (appConfig.objectCount > 0 || appConfig.benchmarkDraws || appConfig.particleCount > 0 || appConfig.benchmarkParticles) {
+        if (bindlessTable.enabled) {
+            instancedPipelineLayout = createPipelineLayout(ShaderReflection::InstancedTextured, descriptorSetLayouts,
+                frameRing.uniforms.setLayout, bindlessTable.setLayout);
+            instancedPipeline = requestReflectedPipeline(ShaderReflection::InstancedTextured, instancedPipelineLayout);
+        }
+        else {
+            instancedPipelineLayout = createPipelineLayout(ShaderReflection::Instanced, descriptorSetLayouts, frameRing.uniforms.setLayout);
+            instancedPipeline = requestReflectedPipeline(ShaderReflection::Instanced, instancedPipelineLayout);
+        }
     }
-
-    vkDestroyShaderModule(device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(device, vertShaderModule, nullptr);
 }
 
-GLFWwindow* window;
+bool framebufferResized = false;   // ڴСıһ֡ȡͼǰؽ
+
+void onFramebufferResize(GLFWwindow*, int, int) {
+    framebufferResized = true;
+}
 
+// û OpenGL ģֱͬɽĳģʽ--present-mode
 void initWindow() {
     if (!glfwInit()) {
         throw std::runtime_error("failed to initialize GLFW!");
     }
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);  // Vulkan  OpenGL
-    window = glfwCreateWindow(800, 600, "Vulkan Triangle", nullptr, nullptr);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+    window = glfwCreateWindow(static_cast<int>(appConfig.width), static_cast<int>(appConfig.height), "Vulkan Triangle", nullptr, nullptr);
     if (!window) {
         glfwTerminate();
         throw std::runtime_error("failed to create GLFW window!");
     }
 
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);  // ôֱͬ
+    glfwSetFramebufferSizeCallback(window, onFramebufferResize);
 }
 
-const std::vector<float> vertices = {
+struct Vertex {
+    float position[2];
+};
+
+// ɫıɵĲʧ
+static_assert(sizeof(Vertex) == ShaderReflection::TriangleVertexStride, "Vertex does not match vert.vert inputs");
+
+std::vector<Vertex> vertices = {
     // Vertex data for a triangle
-    0.0f,  0.5f, 0.0f, // Vertex 1
-   -0.5f, -0.5f, 0.0f, // Vertex 2
-    0.5f, -0.5f, 0.0f  // Vertex 3
+    { {  0.0f,  0.5f } }, // Vertex 1
+    { { -0.5f, -0.5f } }, // Vertex 2
+    { {  0.5f, -0.5f } }, // Vertex 3
+    // 
+    { { -0.5f, -0.5f } },
+    { {  0.5f, -0.5f } },
+    { {  0.5f,  0.5f } },
+    { { -0.5f,  0.5f } },
+    // 
+    { {  0.0f, -0.5f } },
+    { {  0.5f,  0.0f } },
+    { {  0.0f,  0.5f } },
+    { { -0.5f,  0.0f } },
 };
 
-VkCommandBuffer commandBuffer;
-VkBuffer vertexBuffer;
-VkDeviceMemory vertexBufferMemory;
-VkFramebuffer framebuffer;
-VkExtent2D swapChainExtent;
+// ÿ 0 ʼͨ vertexOffset λԼĶ
+std::vector<uint16_t> indices = {
+    0, 1, 2,
+    0, 1, 2, 0, 2, 3,
+    0, 1, 2, 0, 2, 3,
+};
+
+std::vector<MeshRange> sceneMeshes = {
+    { 3, 0, 0, 0.7072f },   // 
+    { 6, 3, 3, 0.7072f },   // 
+    { 6, 9, 7, 0.5f },      // 
+};
+
+VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+
+// ÿ LOD  sceneMeshes ţ 0 Ϊԭ񣩣ʵõ±
+struct SceneMeshLods {
+    uint32_t firstRange;
+    std::vector<MeshLod> lods;  // firstIndex Ϊλ
+};
+
+std::vector<SceneMeshLods> sceneMeshLods;
+uint32_t sceneFullTriangles = 0;    // һδĳȫõ 0 ʱ
+uint32_t sceneLodTriangles = 0;     //  LOD ѡ
+
+// ֻһΣû LODһν϶Բ̣ LOD 
+// Ż㻺Ͷȡ˳׷ӵõĶݡԴеֻһ
+void buildSceneMeshLods() {
+    sceneMeshLods.clear();
+    for (uint32_t i = 0; i < sceneMeshes.size(); i++) {
+        sceneMeshLods.push_back({ i, { { sceneMeshes[i].firstIndex, sceneMeshes[i].indexCount, 0.0f } } });
+    }
+    if (scenePack.header) {
+        return;
+    }
+
+    std::vector<Vec3> positions;
+    std::vector<uint32_t> discIndices;
+    buildDiscMesh(0.5f, 16, 64, positions, discIndices);
+
+    std::vector<uint32_t> lodIndices;
+    std::vector<MeshLod> lods = buildMeshLods(positions, discIndices, 8, 0.5f, lodIndices);
+    std::vector<uint32_t> remap = optimizeVertexFetch(lodIndices, static_cast<uint32_t>(positions.size()));
+    positions = remapVertices(positions, remap);
+
+    int32_t vertexOffset = static_cast<int32_t>(vertices.size());
+    uint32_t firstIndex = static_cast<uint32_t>(indices.size());
+    for (const Vec3& p : positions) {
+        vertices.push_back({ { p.x, p.y } });
+    }
+    for (uint32_t index : lodIndices) {
+        indices.push_back(static_cast<uint16_t>(index));
+    }
+
+    SceneMeshLods disc;
+    disc.firstRange = static_cast<uint32_t>(sceneMeshes.size());
+    for (MeshLod lod : lods) {
+        lod.firstIndex += firstIndex;
+        sceneMeshes.push_back({ lod.indexCount, lod.firstIndex, vertexOffset, 0.5f });
+        disc.lods.push_back(lod);
+    }
+    sceneMeshLods.push_back(disc);
+
+    std::cout << "Disc mesh LODs:";
+    for (const MeshLod& lod : lods) {
+        std::cout << " " << lod.indexCount / 3;
+    }
+    std::cout << " triangles" << std::endl;
+}
+
+GpuBuffer vertexBuffer;
+GpuBuffer indexBuffer;
+UploadContext uploadContext;
+
+uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("failed to find suitable memory type!");
+}
 
 void createVertexBuffer()
 {
-    // Create vertex buffer for triangle
+    // ԴĶξǶ㻺ݣӳֱӸƵݴ滷
+    if (scenePack.header) {
+        uploadPackSection(uploadContext, scenePack, PackSectionType::Vertices, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer);
+        return;
+    }
+
+    // ݷ DEVICE_LOCAL ϣͨݴ滷ϴ
     VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+    createDeviceLocalBuffer(vertexBuffer, bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    enqueueBufferUpload(uploadContext, vertexBuffer.buffer, 0, vertices.data(), bufferSize);
+}
+
+void createIndexBuffer()
+{
+    if (scenePack.header) {
+        uploadPackSection(uploadContext, scenePack, PackSectionType::Indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer);
+        return;
+    }
+
+    VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
+    createDeviceLocalBuffer(indexBuffer, bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    enqueueBufferUpload(uploadContext, indexBuffer.buffer, 0, indices.data(), bufferSize);
+}
 
-    VkBufferCreateInfo bufferInfo = {};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = bufferSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+// һλƣǰлƹͬһ
+struct DrawItem {
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+};
+
+std::vector<DrawItem> drawList;
+JobSystem jobSystem;
+
+void buildDrawList(uint32_t drawCount) {
+    const MeshRange& triangle = sceneMeshes[0];
+    drawList.assign(drawCount, DrawItem{ triangle.indexCount, triangle.firstIndex, triangle.vertexOffset });
+}
+
+IndirectScene scene;
+SceneDrawMode sceneDrawMode = SceneDrawMode::Indirect;
+uint32_t sceneDrawCalls = 0;    // һ¼ƳĻƵ
+
+// ԭΪİ cameraZoom ţ
+Mat4 viewProjection;
+static_assert(sizeof(Mat4) == ShaderReflection::InstancedConstantsSize, "viewProjection does not match instanced.vert constants");
+
+void buildViewProjection(float zoom) {
+    viewProjection = mat4Scale(zoom, zoom, 1.0f);
+}
 
-    if (vkCreateBuffer(device, &bufferInfo, nullptr, &vertexBuffer) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create vertex buffer!");
+// instanced.vert ͳ飺ÿƵĲ
+struct DrawParams {
+    float color[4];
+    BindlessIndex textureIndex;     // ֻ textured.frag ʹãINVALID_BINDLESS_INDEX ʱ
+};
+static_assert(sizeof(DrawParams) == 20, "DrawParams must match instanced.vert");
+static_assert(ShaderReflection::InstancedConstantsSet == ShaderReflection::InstancedTexturedConstantsSet,
+    "both instanced pipelines bind the uniform ring at the same set");
+
+// ͳд볣󶨶̬ƫƣƲŵ£ֱ͡;֡ռʱ false
+bool setInstancedConstants(VkCommandBuffer commandBuffer, const DrawParams& params) {
+    uint32_t pushConstantSize = getPushConstantSize(ShaderReflection::Instanced);
+    return setDrawConstants(frameRing.uniforms, commandBuffer, instancedPipelineLayout, ShaderReflection::InstancedConstantsSet,
+            VK_SHADER_STAGE_VERTEX_BIT, pushConstantSize, viewProjection.m, sizeof(viewProjection))
+        && setDrawConstants(frameRing.uniforms, commandBuffer, instancedPipelineLayout, ShaderReflection::InstancedConstantsSet,
+            VK_SHADER_STAGE_VERTEX_BIT, pushConstantSize, &params, sizeof(params));
+}
+
+SceneWorld sceneWorld;
+SceneDrawList sceneDrawList;
+SceneDrawList textureFeedbackDraws;     // ÿ֡޳Ŀɼ壬ֻʹ÷
+std::vector<float> textureFeedbackPixels;   // ÿ֡ͶӰСأ
+
+// ųĻʹãʱʾ±꣬ʹüصǳеʵ壬
+// ȡĻƣ//źãͶӰСѡ LOD תΪ GPU ϵ SceneObject
+std::vector<SceneObject> buildSceneObjects(uint32_t objectCount) {
+    uint32_t columns = 1;
+    while (columns * columns < objectCount) {
+        columns++;
+    }
+    float cell = 2.0f / columns;
+
+    destroySceneWorld(sceneWorld);
+    for (uint32_t i = 0; i < objectCount; i++) {
+        uint32_t mesh = i % static_cast<uint32_t>(sceneMeshLods.size());
+        float radius = sceneMeshes[sceneMeshLods[mesh].firstRange].radius;
+
+        Entity entity = createEntity(sceneWorld, RENDERABLE_COMPONENTS);
+        LocalTransform local;
+        local.position = { -1.0f + cell * (i % columns + 0.5f), -1.0f + cell * (i / columns + 0.5f), 0.0f };
+        local.rotation = quatIdentity();
+        local.scale = { cell * 0.8f, cell * 0.8f, 1.0f };
+        setLocalTransform(sceneWorld, entity, local);
+        setMesh(sceneWorld, entity, mesh, { { 0.0f, 0.0f, 0.0f }, { radius, radius, radius } });
+        uint32_t material = textureManager.textures.empty() ? mesh : i % static_cast<uint32_t>(textureManager.textures.size());
+        setMaterial(sceneWorld, entity, { 0, static_cast<uint16_t>(material) });
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(device, vertexBuffer, &memRequirements);
+    // ޳ɼӻƵļɫÿ֡ɣﱣ
+    updateSceneTransforms(sceneWorld, jobSystem.workers.empty() ? nullptr : &jobSystem);
+    extractSceneDraws(sceneWorld, viewProjection, false, jobSystem.workers.empty() ? nullptr : &jobSystem, sceneDrawList);
+
+    // һλĻϵ =  *  * ӿڸ߶ / 2
+    float viewportScale = std::fabs(viewProjection.m[5]) * presenter.extent.height * 0.5f;
+    sceneFullTriangles = 0;
+    sceneLodTriangles = 0;
+
+    std::vector<SceneObject> objects(sceneDrawList.draws.size());
+    for (size_t i = 0; i < objects.size(); i++) {
+        const SceneDraw& draw = sceneDrawList.draws[i];
+        const Mat4& world = sceneDrawList.transforms[draw.transform];
+        const SceneMeshLods& meshLods = sceneMeshLods[draw.mesh];
+        uint32_t lod = selectMeshLod(meshLods.lods, std::fabs(world.m[5]) * viewportScale, appConfig.lodPixelError);
+        sceneFullTriangles += meshLods.lods[0].indexCount / 3;
+        sceneLodTriangles += meshLods.lods[lod].indexCount / 3;
+
+        SceneObject& object = objects[i];
+        object.transform[0] = world.m[12];
+        object.transform[1] = world.m[13];
+        object.transform[2] = world.m[0];
+        object.transform[3] = world.m[5];
+        object.mesh = meshLods.firstRange + lod;
+        object.radius = 0.0f;
+        object.padding[0] = object.padding[1] = 0;
+    }
+    return objects;
+}
 
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
+void createScene(uint32_t objectCount) {
+    createIndirectScene(scene, uploadContext, sceneMeshes, buildSceneObjects(objectCount), indirectFeatures,
+        getShaderModule(shaderLibrary, ShaderReflection::BuildDraws.shaders[0]), static_cast<uint32_t>(frameRing.frames.size()));
+    flushUploads(uploadContext);
+
+    scene.culling = appConfig.culling;
+    setSceneView(scene, viewProjection);
+}
 
-    if (vkAllocateMemory(device, &allocInfo, nullptr, &vertexBufferMemory) != VK_SUCCESS) {
-        throw std::runtime_error("failed to allocate vertex buffer memory!");
+// ;֡waitForAllFramesãÿλʣ޳
+void collectCullingCounts() {
+    for (uint32_t i = 0; i < frameRing.frames.size(); i++) {
+        readCullingCounts(scene, i);
     }
+}
+
+void setViewportAndScissor(VkCommandBuffer commandBuffer) {
+    VkViewport viewport = {};
+    viewport.width = static_cast<float>(swapChainExtent.width);
+    viewport.height = static_cast<float>(swapChainExtent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    vkBindBufferMemory(device, vertexBuffer, vertexBufferMemory, 0);
+    VkRect2D scissor = {};
+    scissor.extent = swapChainExtent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
 
-void recordCommandBuffer() {
-    VkCommandBufferBeginInfo beginInfo = {};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+// ¼ drawList[begin, end)Ͷ嶼ʹ
+// ̬״̬̳Уÿ嶼Ҫ
+void recordDraws(VkCommandBuffer commandBuffer, uint32_t begin, uint32_t end) {
+    setViewportAndScissor(commandBuffer);
 
-    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
-        throw std::runtime_error("failed to begin recording command buffer!");
+    // ڱʱֻ
+    VkPipeline pipeline = getPipeline(pipelineRegistry, trianglePipeline);
+    if (pipeline == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    VkBuffer vertexBuffers[] = { vertexBuffer.buffer };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0, indexType);
+
+    for (uint32_t i = begin; i < end; i++) {
+        const DrawItem& draw = drawList[i];
+        vkCmdDrawIndexed(commandBuffer, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+    }
+}
+
+// ¼Ƴе壬Ʒʽ sceneDrawMode 
+void recordScene(VkCommandBuffer commandBuffer) {
+    setViewportAndScissor(commandBuffer);
+
+    VkPipeline pipeline = getPipeline(pipelineRegistry, instancedPipeline);
+    if (pipeline == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0, indexType);
+    // ĲʻûдʵݣһûмʱΪЧ±꣩
+    // ;֡ռʱ֡ĳʧܴڳͳб
+    DrawParams params = { { 1.0f, 1.0f, 1.0f, 1.0f }, getTextureIndex(textureManager, 0) };
+    if (!setInstancedConstants(commandBuffer, params)) {
+        return;
+    }
+
+    sceneDrawCalls = recordSceneDraws(scene, commandBuffer, sceneDrawMode);
+}
+
+// ¼ӣ볡ʵߺʵݺʵɼɫд룬һμӻ
+void recordParticles(VkCommandBuffer commandBuffer) {
+    setViewportAndScissor(commandBuffer);
+
+    VkPipeline pipeline = getPipeline(pipelineRegistry, instancedPipeline);
+    if (pipeline == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer.buffer, 0, indexType);
+    DrawParams params = { { 1.0f, 0.6f, 0.2f, 1.0f }, INVALID_BINDLESS_INDEX };
+    if (!setInstancedConstants(commandBuffer, params)) {
+        return;
     }
 
+    recordParticleDraw(particleSystem, commandBuffer);
+}
+
+// ѻбָ recordThreads ̣߳¼ƵԼصĶ
+void recordDrawsParallel(FrameContext& frame, VkCommandBuffer primary, VkFramebuffer targetFramebuffer) {
+    std::vector<VkCommandBuffer> secondaries(appConfig.recordThreads, VK_NULL_HANDLE);
+
+    parallelFor(jobSystem, static_cast<uint32_t>(drawList.size()), appConfig.recordThreads,
+        [&](uint32_t begin, uint32_t end, uint32_t chunkIndex, uint32_t threadIndex) {
+            ProfileScope scope(profiler, "Record chunk");
+            VkCommandBuffer commandBuffer = acquireSecondaryCommandBuffer(frame, threadIndex);
+
+            VkCommandBufferInheritanceInfo inheritanceInfo = {};
+            inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.renderPass = renderPass;
+            inheritanceInfo.subpass = 0;
+            inheritanceInfo.framebuffer = targetFramebuffer;
+            inheritanceInfo.pipelineStatistics = getInheritedStatistics(profiler);
+
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+            beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+            // ߳׳쳣 parallelFor жνڱ߳׳
+            if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+                throw std::runtime_error("failed to begin secondary command buffer!");
+            }
+            recordDraws(commandBuffer, begin, end);
+            if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+                throw std::runtime_error("failed to record secondary command buffer!");
+            }
+
+            secondaries[chunkIndex] = commandBuffer;
+        });
+
+    // ߳ʱֶΪ
+    uint32_t count = 0;
+    for (VkCommandBuffer commandBuffer : secondaries) {
+        if (commandBuffer != VK_NULL_HANDLE) {
+            secondaries[count++] = commandBuffer;
+        }
+    }
+    vkCmdExecuteCommands(primary, count, secondaries.data());
+}
+
+// Ⱦͨбڹ߳¼ƶ壬֮
+void recordMainPass(FrameContext& frame, VkCommandBuffer commandBuffer, VkFramebuffer targetFramebuffer) {
     VkClearValue clearColor = {};
     clearColor.color.float32[0] = 0.0f;
     clearColor.color.float32[1] = 0.0f;
@@ -463,126 +1025,874 @@ void recordCommandBuffer() {
     VkRenderPassBeginInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = framebuffer;
+    renderPassInfo.framebuffer = targetFramebuffer;
     renderPassInfo.renderArea.offset = { 0, 0 };
     renderPassInfo.renderArea.extent = swapChainExtent;
     renderPassInfo.clearValueCount = 1;
     renderPassInfo.pClearValues = &clearColor;
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // ӵĻƵú٣ֻһμӵãֱ¼Ƶ
+    bool drawScene = scene.objectCount > 0;
+    bool drawParticles = particleSystem.enabled;
+    bool inlineDraws = drawScene || drawParticles || appConfig.recordThreads == 0;
+
+    // ͳƲѯִҪ inheritedQueries 
+    bool passStatistics = inlineDraws || profiler.inheritedQueries;
+    uint32_t passScope = beginGpuScope(profiler, commandBuffer, "Main pass", passStatistics);
+
+    if (inlineDraws) {
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        uint32_t drawScope = beginGpuScope(profiler, commandBuffer, "Draws");
+        // ֻһΣӹãߺͰ󶨳ļϲʹʧЧ
+        if (bindlessTable.enabled && (drawScene || drawParticles) && instancedPipelineLayout != VK_NULL_HANDLE) {
+            bindBindlessTable(bindlessTable, commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, instancedPipelineLayout,
+                ShaderReflection::InstancedTexturedBindlessSet);
+        }
+        if (drawScene) {
+            recordScene(commandBuffer);
+        }
+        else {
+            recordDraws(commandBuffer, 0, static_cast<uint32_t>(drawList.size()));
+        }
+        if (drawParticles) {
+            recordParticles(commandBuffer);
+        }
+        endGpuScope(profiler, commandBuffer, drawScope);
+    }
+    else {
+        // Ϊͨвдʱֻͨ
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        recordDrawsParallel(frame, commandBuffer, targetFramebuffer);
+    }
+
+    vkCmdEndRenderPass(commandBuffer);
+    endGpuScope(profiler, commandBuffer, passScope);
+}
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+// ֡ͼѡļӻƹͨģʽµģͨ + ȾͨͼĽṹֻڼ·ء
+// Ӷģʽл򳡾ؽʱı䣬ֻ֡ĿͼֱӸñõ
+RenderGraph frameGraph;
+RGResourceHandle frameBackbuffer = INVALID_RG_RESOURCE;
+bool frameGraphBuildDraws = false;
+bool frameGraphSimulateParticles = false;
+VkBuffer frameGraphParticleBuffer = VK_NULL_HANDLE;
+VkBuffer frameGraphSceneBuffer = VK_NULL_HANDLE;
+bool frameGraphPrinted = false;
+
+// ͨ¼ƺִʱȡ
+FrameContext* recordingFrame = nullptr;
+VkFramebuffer recordingFramebuffer = VK_NULL_HANDLE;
+
+void buildFrameGraph(bool buildDraws, bool simulateParticles) {
+    destroyRenderGraph(frameGraph);
+
+    // ĿתΪز֣ͼתΪֲ֣
+    // ʼĽ׶ acquire źĵȴ׶ͬϽź֮
+    RGState initialState = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED };
+    RGState finalState = { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+    if (appConfig.headless) {
+        finalState = { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL };
+    }
+    frameBackbuffer = importImage(frameGraph, "Backbuffer", VK_NULL_HANDLE, colorFormat, initialState, finalState);
+
+    RGResourceHandle sceneDraws = INVALID_RG_RESOURCE;
+    if (buildDraws) {
+        // ʵͼͬһͨһд
+        sceneDraws = importBuffer(frameGraph, "Scene draws", scene.drawCommands.buffer, true);
+
+        uint32_t build = addPass(frameGraph, "Build draws", [](VkCommandBuffer commandBuffer) {
+            uint32_t buildScope = beginGpuScope(profiler, commandBuffer, "Build draws", true);
+            recordBuildDraws(scene, commandBuffer, frameRing.currentFrame);
+            endGpuScope(profiler, commandBuffer, buildScope);
+        });
+        useResource(frameGraph, build, sceneDraws, RGUsage::TransferWrite);
+        useResource(frameGraph, build, sceneDraws, RGUsage::StorageWrite);
+    }
 
-    VkBuffer vertexBuffers[] = { vertexBuffer };
-    VkDeviceSize offsets[] = { 0 };
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+    // 첽ģʽڼģ⣬ʱźͬͼ
+    RGResourceHandle particleOutputs = INVALID_RG_RESOURCE;
+    if (simulateParticles) {
+        // зÿ֡дһݣ֮϶ȫڴ
+        particleOutputs = importBuffer(frameGraph, "Particles", particleSystem.outputs[0].buffer.buffer, true);
+
+        uint32_t simulate = addPass(frameGraph, "Simulate particles", [](VkCommandBuffer commandBuffer) {
+            uint32_t simulateScope = beginGpuScope(profiler, commandBuffer, "Simulate particles", true);
+            recordParticleSimulation(particleSystem, commandBuffer);
+            endGpuScope(profiler, commandBuffer, simulateScope);
+        });
+        useResource(frameGraph, simulate, particleOutputs, RGUsage::StorageWrite);
+    }
+
+    uint32_t mainPass = addPass(frameGraph, "Main pass", [](VkCommandBuffer commandBuffer) {
+        recordMainPass(*recordingFrame, commandBuffer, recordingFramebuffer);
+    });
+    useResource(frameGraph, mainPass, frameBackbuffer, RGUsage::ColorAttachment);
+    if (sceneDraws != INVALID_RG_RESOURCE) {
+        useResource(frameGraph, mainPass, sceneDraws, RGUsage::IndirectRead);
+    }
+    if (particleOutputs != INVALID_RG_RESOURCE) {
+        useResource(frameGraph, mainPass, particleOutputs, RGUsage::IndirectRead);
+    }
 
-    vkCmdDraw(commandBuffer, static_cast<uint32_t>(vertices.size()) / 3, 1, 0, 0);
+    compileRenderGraph(frameGraph);
+    frameGraphBuildDraws = buildDraws;
+    frameGraphSimulateParticles = simulateParticles;
+    frameGraphParticleBuffer = particleSystem.outputs[0].buffer.buffer;
+    frameGraphSceneBuffer = scene.drawCommands.buffer;
 
-    vkCmdEndRenderPass(commandBuffer);
+    if (!frameGraphPrinted) {
+        printRenderGraph(frameGraph);
+        frameGraphPrinted = true;
+    }
+}
+
+// --benchmark-resourcesÿ֡ͨעһͼڱ֡д룬پԴ䡣
+// ٵԴܸڱ֡;֡ʹãֻƳٵ fence ɾŲᱻ GPU ͷŵĶ
+struct ResourceChurn {
+    bool enabled = false;
+    uint32_t buffersPerFrame = 0;
+    uint32_t imagesPerFrame = 0;
+    uint32_t liveBuffers = 0;           // ÿ֡ʱ
+    uint32_t liveImages = 0;
+    std::vector<ResourceHandle> buffers;
+    std::vector<ResourceHandle> images;
+    std::vector<ResourceHandle> destroyedBuffers;   // پʱǶʧЧ
+    std::vector<ResourceHandle> destroyedImages;
+    std::vector<VkImageMemoryBarrier> barriers;
+    std::mt19937 rng;
+    uint64_t operations = 0;            // ٵĴ
+    std::vector<double> churnMs;        // ÿ֡дٵ CPU ʱ
+};
+
+ResourceChurn resourceChurn;
+
+//  handles еԴֱʣ keep 
+void retireChurnHandles(std::vector<ResourceHandle>& handles, uint32_t keep, bool images,
+    std::vector<ResourceHandle>& destroyed) {
+    while (handles.size() > keep) {
+        size_t pick = resourceChurn.rng() % handles.size();
+        ResourceHandle handle = handles[pick];
+        if (images) {
+            destroyRegistryImage(resourceRegistry, handle);
+        }
+        else {
+            destroyRegistryBuffer(resourceRegistry, handle);
+        }
+        if (destroyed.size() < 1024) {
+            destroyed.push_back(handle);
+        }
+        handles[pick] = handles.back();
+        handles.pop_back();
+        resourceChurn.operations++;
+    }
+}
+
+void churnResources(VkCommandBuffer commandBuffer) {
+    auto start = std::chrono::high_resolution_clock::now();
+    ResourceChurn& churn = resourceChurn;
+
+    // 256 B  32 KB Ļڱ֡
+    for (uint32_t i = 0; i < churn.buffersPerFrame; i++) {
+        VkDeviceSize size = VkDeviceSize(256) << (churn.rng() % 8);
+        ResourceHandle handle = createRegistryBuffer(resourceRegistry, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        vkCmdFillBuffer(commandBuffer, getRegistryBuffer(resourceRegistry, handle)->buffer, 0, VK_WHOLE_SIZE, i);
+        churn.buffers.push_back(handle);
+        churn.operations++;
+    }
+
+    // 32  128 صͼת TRANSFER_DST_OPTIMAL 
+    size_t firstImage = churn.images.size();
+    churn.barriers.clear();
+    for (uint32_t i = 0; i < churn.imagesPerFrame; i++) {
+        uint32_t size = 32u << (churn.rng() % 3);
+        ResourceHandle handle = createRegistryImage(resourceRegistry, VK_FORMAT_R8G8B8A8_UNORM, { size, size }, 1,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+        churn.images.push_back(handle);
+        churn.operations++;
+
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = getRegistryImage(resourceRegistry, handle)->image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        churn.barriers.push_back(barrier);
+    }
+    if (!churn.barriers.empty()) {
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+            0, nullptr, 0, nullptr, static_cast<uint32_t>(churn.barriers.size()), churn.barriers.data());
+
+        VkClearColorValue color = { { 0.25f, 0.5f, 0.75f, 1.0f } };
+        VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        for (size_t i = firstImage; i < churn.images.size(); i++) {
+            vkCmdClearColorImage(commandBuffer, getRegistryImage(resourceRegistry, churn.images[i])->image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+        }
+    }
+
+    // ʱ¾ɣ֡дԴҲܱѡ
+    retireChurnHandles(churn.buffers, churn.liveBuffers, false, churn.destroyedBuffers);
+    retireChurnHandles(churn.images, churn.liveImages, true, churn.destroyedImages);
+
+    churn.churnMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+}
+
+// ʹ÷гʱÿ֡ǰ޳壬ɼ尴ʶӦͶӰС
+// texcoord ꣬һλĻһλȳ
+// ûгʱӿڵĸ߶ȼ
+void reportTextureFeedback() {
+    if (textureManager.textures.empty()) {
+        return;
+    }
+    if (sceneWorld.entityCount == 0) {
+        for (uint32_t i = 0; i < textureManager.textures.size(); i++) {
+            reportTextureUsage(textureManager, i, static_cast<float>(presenter.extent.height), frameRing.frameNumber);
+        }
+        return;
+    }
+
+    JobSystem* jobs = jobSystem.workers.empty() ? nullptr : &jobSystem;
+    updateSceneTransforms(sceneWorld, jobs);
+    extractSceneDraws(sceneWorld, viewProjection, true, jobs, textureFeedbackDraws);
+
+    //  buildSceneObjects ѡ LOD ʱͬͶӰС
+    float viewportScale = std::fabs(viewProjection.m[5]) * presenter.extent.height * 0.5f;
+    textureFeedbackPixels.assign(textureManager.textures.size(), 0.0f);
+    for (const SceneDraw& draw : textureFeedbackDraws.draws) {
+        uint32_t texture = getDrawMaterial(draw);
+        if (texture < textureFeedbackPixels.size()) {
+            float pixels = std::fabs(textureFeedbackDraws.transforms[draw.transform].m[5]) * viewportScale;
+            textureFeedbackPixels[texture] = std::max(textureFeedbackPixels[texture], pixels);
+        }
+    }
+
+    // ֡ɼ棬TEXTURE_FEEDBACK_FRAMES ֡˻صβ
+    for (uint32_t i = 0; i < textureFeedbackPixels.size(); i++) {
+        if (textureFeedbackPixels[i] > 0.0f) {
+            reportTextureUsage(textureManager, i, textureFeedbackPixels[i], frameRing.frameNumber);
+        }
+    }
+}
+
+void recordCommandBuffer(FrameContext& frame, VkImage targetImage, VkFramebuffer targetFramebuffer) {
+    VkCommandBuffer commandBuffer = frame.commandBuffer;
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT; // ÿ֡¼
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to begin recording command buffer!");
+    }
+
+    profilerResetQueries(profiler, commandBuffer);
+    writeFrameStartTimestamp(frame);
+
+    if (resourceChurn.enabled) {
+        ProfileScope scope(profiler, "Resource churn");
+        churnResources(commandBuffer);
+    }
+
+    // Ļ뻻 mip ¼֡ͼ֮ǰ֡Ļʹøº±
+    if (textureManager.enabled) {
+        ProfileScope scope(profiler, "Textures");
+        reportTextureFeedback();
+        updateTextureResidency(textureManager, frameRing.currentFrame, static_cast<uint32_t>(frameRing.frames.size()),
+            frameRing.frameNumber, commandBuffer);
+    }
+
+    // ļӻɼɫȾ֮ͨǰ޳
+    bool buildDraws = scene.objectCount > 0 && resolveSceneDrawMode(scene, sceneDrawMode) == SceneDrawMode::Indirect;
+    bool simulateParticles = needsParticleSimulationPass(particleSystem);
+    if (!frameGraph.compiled || buildDraws != frameGraphBuildDraws || simulateParticles != frameGraphSimulateParticles
+        || (buildDraws && scene.drawCommands.buffer != frameGraphSceneBuffer)
+        || (simulateParticles && particleSystem.outputs[0].buffer.buffer != frameGraphParticleBuffer)) {
+        buildFrameGraph(buildDraws, simulateParticles);
+    }
+
+    recordingFrame = &frame;
+    recordingFramebuffer = targetFramebuffer;
+    setImportedImage(frameGraph, frameBackbuffer, targetImage);
+    executeRenderGraph(frameGraph, commandBuffer);
+
+    // Ŀ֡ͼʱתΪ TRANSFER_SRC_OPTIMALػ壬fence 󽻸߳
+    if (frameReadback.enabled && presenter.kind == PresenterKind::Offscreen) {
+        recordFrameReadback(frameReadback, resourceRegistry, commandBuffer, targetImage, colorFormat, presenter.extent, frameRing.frameNumber);
+    }
+
+    writeFrameEndTimestamp(frame);
 
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to record command buffer!");
     }
 }
 
-VkSemaphore imageAvailableSemaphore;
-VkSemaphore renderFinishedSemaphore;
-VkFence fence;
+// ʼµһ֡ȴλУظòλһܷ֡ѯ޳
+FrameContext& beginProfiledFrame(FrameStats* stats) {
+    FrameContext* frame;
+    {
+        ProfileScope scope(profiler, "Wait for frame");
+        frame = &beginFrame(frameRing, stats);
+    }
+    beginRegistryFrame(resourceRegistry, frameRing.currentFrame);
+    profilerBeginFrame(profiler, frameRing.currentFrame, frameRing.frameNumber);
+    readCullingCounts(scene, frameRing.currentFrame);
+    return *frame;
+}
 
-void initSyncObjects() {
-    VkSemaphoreCreateInfo semaphoreInfo = {};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+// ύĵȴʹźʽԴڴϿӿڼģ⣬ʱźʱ
+// ׷ӶǵĵȴʱߵĴʱҪΪÿźֵֵźֵԣ
+// 鶼ҪȴĸԪ
+void setSubmitSync(VkSubmitInfo& submitInfo, VkTimelineSemaphoreSubmitInfoKHR& timelineInfo,
+    VkSemaphore* waitSemaphores, VkPipelineStageFlags* waitStages, uint64_t* waitValues, uint32_t waitCount,
+    VkSemaphore* signalSemaphores, uint64_t* signalValues, uint32_t signalCount) {
+    bool timeline = false;
+    VkSemaphore streamingSemaphore;
+    uint64_t streamingValue;
+    if (getStreamingWait(streamingLoader, streamingSemaphore, streamingValue)) {
+        waitSemaphores[waitCount] = streamingSemaphore;
+        waitStages[waitCount] = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        waitValues[waitCount] = streamingValue;
+        waitCount++;
+        timeline = true;
+    }
 
-    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphore) != VK_SUCCESS ||
-        vkCreateSemaphore(device, &semaphoreInfo, nullptr, &renderFinishedSemaphore) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create semaphores!");
+    uint32_t particleWaits = getParticleWaits(particleSystem, waitSemaphores + waitCount, waitValues + waitCount, waitStages + waitCount);
+    uint32_t particleSignals = getParticleSignals(particleSystem, signalSemaphores + signalCount, signalValues + signalCount);
+    waitCount += particleWaits;
+    signalCount += particleSignals;
+
+    if (timeline || particleWaits > 0 || particleSignals > 0) {
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+        timelineInfo.waitSemaphoreValueCount = waitCount;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+        timelineInfo.signalSemaphoreValueCount = signalCount;
+        timelineInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineInfo;
     }
 
-    VkFenceCreateInfo fenceInfo = {};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // ʼ״̬Ϊź
+    submitInfo.waitSemaphoreCount = waitCount;
+    submitInfo.pWaitSemaphores = waitSemaphores;
+    submitInfo.pWaitDstStageMask = waitStages;
+    submitInfo.signalSemaphoreCount = signalCount;
+    submitInfo.pSignalSemaphores = signalSemaphores;
+}
+
+// ѽõʽԴύУ
+void pumpStreamingFrame() {
+    if (streamingLoader.enabled) {
+        ProfileScope scope(profiler, "Stream");
+        pumpStreaming(streamingLoader);
+    }
+}
 
-    if (vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create fence!");
+// ǰɻĴССʱΪ 0޴ģʽģĴСıõĳߴ 3/4 ֮л
+VkExtent2D getDrawableExtent() {
+    if (window == nullptr) {
+        VkExtent2D configured = { appConfig.width, appConfig.height };
+        if (presenter.extent.width == configured.width && presenter.extent.height == configured.height) {
+            return { std::max(1u, configured.width * 3 / 4), std::max(1u, configured.height * 3 / 4) };
+        }
+        return configured;
     }
+
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(window, &width, &height);
+    return { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
 }
 
-void drawFrame() {
-    // ȴ豸Уͬ
-    vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
-    vkResetFences(device, 1, &fence);
+// ǰСؽĿ꣬ɵĶڵǰ֡ɺע١Сʱȵȴָ
+// ȴڼ䴰ڱرʱ false
+bool recreateFrameTarget() {
+    VkExtent2D extent = getDrawableExtent();
+    while (extent.width == 0 || extent.height == 0) {
+        if (glfwWindowShouldClose(window)) {
+            return false;
+        }
+        glfwWaitEvents();
+        extent = getDrawableExtent();
+    }
+
+    framebufferResized = false;
+    recreatePresenter(presenter, extent, resourceRegistry);
+    swapChainExtent = presenter.extent;
+    return true;
+}
+
+// ȡ֡Ŀͼ񣺴ڴСıϴγֱʱؽȡʱؽ
+bool acquireFrameImage(FrameContext& frame, uint32_t& imageIndex) {
+    if ((framebufferResized || presenter.needsRecreate) && !recreateFrameTarget()) {
+        return false;
+    }
+
+    while (!acquirePresenterImage(presenter, frame.imageAvailableSemaphore, imageIndex)) {
+        if (!recreateFrameTarget()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ⱦһ֡Ŀͬһ·ʱû acquire/present ź
+void drawFrame(FrameStats* stats) {
+    ProfileScope frameScope(profiler, "Frame");
+
+    // ֻȴǰλ fence;֡ GPU ִ
+    FrameContext& frame = beginProfiledFrame(stats);
+    pumpStreamingFrame();
 
-    uint32_t imageIndex;
-    vkAcquireNextImageKHR(device, swapChain, UINT64_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    uint32_t imageIndex = 0;
+    bool acquired;
+    {
+        ProfileScope scope(profiler, "Acquire");
+        acquired = acquireFrameImage(frame, imageIndex);
+    }
+
+    // Сʱرգύfence ִ״̬λһ beginFrame
+    if (!acquired) {
+        return;
+    }
+
+    auto cpuStart = std::chrono::high_resolution_clock::now();
+
+    // 첽ģʽһģύУ뱾֡¼ƺȾص
+    if (particleSystem.enabled) {
+        ProfileScope scope(profiler, "Simulate");
+        beginParticleStep(particleSystem);
+    }
+
+    {
+        ProfileScope scope(profiler, "Record");
+        recordCommandBuffer(frame, getPresenterImage(presenter, imageIndex), getPresenterFramebuffer(presenter, imageIndex));
+    }
+    if (stats != nullptr) {
+        stats->recordMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - cpuStart).count());
+    }
+
+    bool swapchain = presenter.kind == PresenterKind::Swapchain;
 
-    // Record command buffer (submit commands to draw the triangle)
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = { imageAvailableSemaphore };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = waitSemaphores;
-    submitInfo.pWaitDstStageMask = waitStages;
+    VkSemaphore waitSemaphores[4] = { frame.imageAvailableSemaphore };
+    VkPipelineStageFlags waitStages[4] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    uint64_t waitValues[4] = {};
+    VkSemaphore signalSemaphores[3] = { getPresenterRenderFinished(presenter, imageIndex) };
+    uint64_t signalValues[3] = {};
+    VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+    setSubmitSync(submitInfo, timelineInfo, waitSemaphores, waitStages, waitValues, swapchain ? 1 : 0,
+        signalSemaphores, signalValues, swapchain ? 1 : 0);
 
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.pCommandBuffers = &frame.commandBuffer;
 
-    VkSemaphore signalSemaphores[] = { renderFinishedSemaphore };
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphores;
+    {
+        ProfileScope scope(profiler, "Submit");
+        submitFrame(frame, graphicsQueue, submitInfo);
+    }
+    endParticleStep(particleSystem);
+
+    auto cpuEnd = std::chrono::high_resolution_clock::now();
+    if (stats != nullptr) {
+        stats->cpuFrameMs.push_back(std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count());
+    }
+
+    {
+        ProfileScope scope(profiler, "Present");
+        presentPresenterImage(presenter, presentQueue, imageIndex);
+    }
+
+    endFrame(frameRing);
+}
+
+void runHeadless() {
+    std::cout << "Headless: rendering " << appConfig.frameCount << " frames at "
+        << swapChainExtent.width << "x" << swapChainExtent.height
+        << ", " << frameRing.frames.size() << " frames in flight" << std::endl;
+
+    for (uint32_t i = 0; i < appConfig.warmupFrames; i++) {
+        drawFrame(nullptr);
+    }
+    waitForAllFrames(frameRing, nullptr);
+
+    FrameStats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < appConfig.frameCount; i++) {
+        paceFrame(framePacer);
+        drawFrame(&stats);
+    }
+
+    // ռ֡ GPU ʱ
+    waitForAllFrames(frameRing, &stats);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    stats.frameCount = appConfig.frameCount;
+    stats.totalSeconds = std::chrono::duration<double>(end - start).count();
+    printFrameStats(stats);
+}
+
+// --stream ĲļĿ¼Ŀ¼ļ޷ʶ requestAsset ˣ
+std::vector<std::string> collectStreamFiles(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (const std::string& path : paths) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(path, error)) {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> entries;
+        for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+            if (entry.is_regular_file(error)) {
+                entries.push_back(entry.path().string());
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+        files.insert(files.end(), entries.begin(), entries.end());
+    }
+    return files;
+}
 
-    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
-        throw std::runtime_error("failed to submit draw command buffer!");
+// ޴ʽأһֱȾ֡ʱβӳضȾ̵߳Ӱ졣
+// ֡ϴԤʱ false
+bool runStreaming() {
+    std::cout << "Streaming: rendering until all assets are loaded, upload budget "
+        << streamingLoader.frameBudget / 1024 << " KB/frame" << std::endl;
+
+    FrameStats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+    while (!isStreamingIdle(streamingLoader)) {
+        drawFrame(&stats);
+        stats.frameCount++;
     }
 
-    VkPresentInfoKHR presentInfo = {};
-    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    presentInfo.waitSemaphoreCount = 1;
-    presentInfo.pWaitSemaphores = signalSemaphores;
+    waitForAllFrames(frameRing, &stats);
+    waitForStreaming(streamingLoader);
+    stats.totalSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    printFrameStats(stats);
+
+    return streamingLoader.stats.framesOverBudget == 0;
+}
+
+// ¼ʱ߳ͻı仯ÿȾһ֡¼ʱ p50/p99
+void runRecordingBenchmark() {
+    const uint32_t drawCounts[] = { 1000, 10000, 100000 };
+    const uint32_t framesPerRun = std::max(1u, std::min(appConfig.frameCount, 200u));
+
+    // 0 ʾֱ¼Ƶ壬Ϊ׼
+    std::vector<uint32_t> threadCounts = { 0 };
+    for (uint32_t threads = 1; threads < getJobThreadCount(jobSystem); threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(getJobThreadCount(jobSystem));
+
+    std::cout << "Recording benchmark: " << framesPerRun << " frames per run, "
+        << getJobThreadCount(jobSystem) << " thread(s) available" << std::endl;
+    std::cout << "  draws  threads  record p50 ms  record p99 ms  speedup" << std::endl;
+
+    for (uint32_t draws : drawCounts) {
+        buildDrawList(draws);
+        double inlineP50 = 0.0;
+
+        for (uint32_t threads : threadCounts) {
+            appConfig.recordThreads = threads;
+
+            for (uint32_t i = 0; i < appConfig.warmupFrames; i++) {
+                drawFrame(nullptr);
+            }
+            waitForAllFrames(frameRing, nullptr);
+
+            FrameStats stats;
+            for (uint32_t i = 0; i < framesPerRun; i++) {
+                drawFrame(&stats);
+            }
+            waitForAllFrames(frameRing, &stats);
+
+            double p50 = percentile(stats.recordMs, 50.0);
+            double p99 = percentile(stats.recordMs, 99.0);
+            if (threads == 0) {
+                inlineP50 = p50;
+            }
+
+            std::cout << std::fixed << std::setprecision(3)
+                << std::setw(7) << draws << "  "
+                << std::setw(7) << (threads == 0 ? std::string("inline") : std::to_string(threads)) << "  "
+                << std::setw(13) << p50 << "  "
+                << std::setw(13) << p99 << "  "
+                << std::setw(6) << (p50 > 0.0 ? inlineP50 / p50 : 0.0) << "x" << std::endl;
+            std::cout << std::defaultfloat;
+        }
+    }
+}
+
+// ȽֳƷʽÿһλơÿһʵơɫɵļӻ
+void runDrawBenchmark() {
+    const uint32_t objectCounts[] = { 1000, 10000, 100000 };
+    const SceneDrawMode modes[] = { SceneDrawMode::PerObject, SceneDrawMode::Instanced, SceneDrawMode::Indirect };
+    const uint32_t framesPerRun = std::max(1u, std::min(appConfig.frameCount, 200u));
+
+    std::cout << "Draw benchmark: " << framesPerRun << " frames per run" << std::endl;
+    std::cout << "  objects  mode        draws  visible  record p50 ms  CPU p50 ms  GPU p50 ms" << std::endl;
+
+    for (uint32_t objectCount : objectCounts) {
+        if (scene.objectCount > 0) {
+            waitForAllFrames(frameRing, nullptr);
+            destroyIndirectScene(scene);
+        }
+        createScene(objectCount);
+
+        for (SceneDrawMode mode : modes) {
+            sceneDrawMode = mode;
 
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = &swapChain;
-    presentInfo.pImageIndices = &imageIndex;
+            for (uint32_t i = 0; i < appConfig.warmupFrames; i++) {
+                drawFrame(nullptr);
+            }
+            waitForAllFrames(frameRing, nullptr);
 
-    vkQueuePresentKHR(graphicsQueue, &presentInfo);
+            FrameStats stats;
+            for (uint32_t i = 0; i < framesPerRun; i++) {
+                drawFrame(&stats);
+            }
+            waitForAllFrames(frameRing, &stats);
+            collectCullingCounts();
+
+            // CPU ·޳ǻ
+            uint32_t visible = resolveSceneDrawMode(scene, mode) == SceneDrawMode::Indirect
+                ? scene.cullingStats.lastVisible : objectCount;
+
+            std::cout << std::fixed << std::setprecision(3) << std::left
+                << "  " << std::setw(7) << objectCount << "  "
+                << std::setw(10) << sceneDrawModeName(resolveSceneDrawMode(scene, mode)) << std::right
+                << std::setw(7) << sceneDrawCalls << "  "
+                << std::setw(7) << visible << "  "
+                << std::setw(13) << percentile(stats.recordMs, 50.0) << "  "
+                << std::setw(10) << percentile(stats.cpuFrameMs, 50.0) << "  "
+                << std::setw(10) << percentile(stats.gpuFrameMs, 50.0) << std::endl;
+            std::cout << std::defaultfloat;
+        }
+    }
 }
 
+// õһƣõλԴĵһ
+void createParticles(uint32_t particleCount) {
+    createParticleSystem(particleSystem, particleCount, sceneMeshes[0], computeQueue, queueFamilies.compute,
+        queueFamilies.graphics, isComputeQueueShared(), timelineSemaphores,
+        getShaderModule(shaderLibrary, ShaderReflection::ParticleSimulate.shaders[0]),
+        getShaderModule(shaderLibrary, ShaderReflection::ParticleScan.shaders[0]),
+        getShaderModule(shaderLibrary, ShaderReflection::ParticleCompact.shaders[0]));
+    if (appConfig.particlesSerial) {
+        setParticleQueueMode(particleSystem, ParticleQueueMode::Serialized);
+    }
+}
 
-int main() {
-    initWindow();
+// ȽģύʽУ¼ͼУصģһ֡ҪƵĽ
+// ֡ʱȡǽʱ䣨GPU £GPU ʱֻͼζϵ
+void runParticleBenchmark() {
+    const uint32_t particleCounts[] = { 1000000, 2000000 };
+    const ParticleQueueMode modes[] = { ParticleQueueMode::Serialized, ParticleQueueMode::Async };
+    const uint32_t framesPerRun = std::max(1u, std::min(appConfig.frameCount, 200u));
+
+    std::cout << "Particle benchmark: " << framesPerRun << " frames per run, compute queue family "
+        << queueFamilies.compute << " (" << describeComputeQueue() << ")";
+    if (!timelineSemaphores) {
+        std::cout << ", no timeline semaphores: serialized only";
+    }
+    std::cout << std::endl;
+    std::cout << "  particles  mode        frame ms  frames/s  GPU p50 ms  speedup" << std::endl;
+
+    for (uint32_t particleCount : particleCounts) {
+        if (particleSystem.enabled) {
+            waitForAllFrames(frameRing, nullptr);
+            waitForParticles(particleSystem);
+            destroyParticleSystem(particleSystem);
+        }
+        createParticles(particleCount);
+        double serializedMs = 0.0;
 
-    createInstance();
+        for (ParticleQueueMode mode : modes) {
+            waitForAllFrames(frameRing, nullptr);
+            if (setParticleQueueMode(particleSystem, mode) != mode) {
+                continue;
+            }
 
-    setupDebugMessenger();
+            for (uint32_t i = 0; i < appConfig.warmupFrames; i++) {
+                drawFrame(nullptr);
+            }
+            waitForAllFrames(frameRing, nullptr);
 
-    pickPhysicalDevice();
+            FrameStats stats;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint32_t i = 0; i < framesPerRun; i++) {
+                drawFrame(&stats);
+            }
+            waitForAllFrames(frameRing, &stats);
+            waitForParticles(particleSystem);
+            double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
 
-    createLogicalDevice();
+            double frameMs = seconds * 1000.0 / framesPerRun;
+            if (mode == ParticleQueueMode::Serialized) {
+                serializedMs = frameMs;
+            }
 
-    initSyncObjects();
+            std::cout << std::fixed << std::setprecision(3) << std::left
+                << "  " << std::setw(9) << particleCount << "  "
+                << std::setw(10) << particleQueueModeName(mode) << std::right
+                << std::setw(9) << frameMs << "  "
+                << std::setw(8) << (seconds > 0.0 ? framesPerRun / seconds : 0.0) << "  "
+                << std::setw(10) << percentile(stats.gpuFrameMs, 50.0) << "  "
+                << std::setw(6) << (frameMs > 0.0 ? serializedMs / frameMs : 0.0) << "x" << std::endl;
+            std::cout << std::defaultfloat;
+        }
+    }
+}
 
-    std::cout << "Vulkan application initialized!" << std::endl;
+// ÿ֡ǧԴº֡ʱ䣬ɾʧЧڴй©мʧʱ false
+bool runResourceBenchmark() {
+    // Ļ뻻ʽϴҲעдԴй©ֻûʱ
+    if (textureManager.enabled || streamingLoader.enabled) {
+        std::cout << "Resource benchmark: textures and streamed assets share the resource registry, "
+            "run it without --textures and --stream" << std::endl;
+        return false;
+    }
 
-    createRenderPass();
+    const uint32_t framesPerRun = std::max(1u, std::min(appConfig.frameCount, 1000u));
+    ResourceChurn& churn = resourceChurn;
+    churn.buffersPerFrame = 1000;
+    churn.imagesPerFrame = 32;
+    churn.liveBuffers = 4000;
+    churn.liveImages = 256;
+    churn.rng.seed(5);
+
+    std::cout << "Resource benchmark: " << framesPerRun << " frames, " << churn.buffersPerFrame << " buffers and "
+        << churn.imagesPerFrame << " images created and destroyed per frame, " << frameRing.frames.size()
+        << " frames in flight" << std::endl;
+
+    // ׼ʼǰķ䣬ʱԴٺӦص
+    waitForAllFrames(frameRing, nullptr);
+    flushRegistryDeletions(resourceRegistry);
+    AllocatorStats before = getAllocatorStats(gpuAllocator);
+    RegistryStats registryBefore = resourceRegistry.stats;
+    uint32_t buffersBefore = getPoolSize(resourceRegistry.buffers);
+    uint32_t imagesBefore = getPoolSize(resourceRegistry.images);
+
+    churn.enabled = true;
+    FrameStats stats;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < framesPerRun; i++) {
+        drawFrame(&stats);
+    }
+    waitForAllFrames(frameRing, &stats);
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    churn.enabled = false;
+
+    stats.frameCount = framesPerRun;
+    stats.totalSeconds = seconds;
+    printFrameStats(stats);
+    std::cout << std::fixed << std::setprecision(3) << "  churn: " << (seconds > 0.0 ? churn.operations / seconds : 0.0)
+        << " creates+destroys/s, CPU p50 " << percentile(churn.churnMs, 50.0) << " ms, p99 "
+        << percentile(churn.churnMs, 99.0) << " ms per frame" << std::defaultfloat << std::endl;
+    printRegistryStats(resourceRegistry);
+
+    std::vector<const char*> failures;
+    if (getPoolSize(resourceRegistry.buffers) != buffersBefore + churn.liveBuffers ||
+        getPoolSize(resourceRegistry.images) != imagesBefore + churn.liveImages) {
+        failures.push_back("live resource counts");
+    }
 
-    createGraphicsPipeline();
+    // ȴٵĶ󲻳;֡ٵÿ֡λʼʱԼĶ
+    uint32_t perFrame = churn.buffersPerFrame + churn.imagesPerFrame;
+    if (resourceRegistry.stats.peakPending > perFrame * static_cast<uint32_t>(frameRing.frames.size())) {
+        failures.push_back("deletion queue outgrew the frames in flight");
+    }
 
-    createVertexBuffer();
+    uint64_t staleBefore = resourceRegistry.stats.staleHandles;
+    bool stale = true;
+    for (ResourceHandle handle : churn.destroyedBuffers) {
+        stale = stale && getRegistryBuffer(resourceRegistry, handle) == nullptr && !destroyRegistryBuffer(resourceRegistry, handle);
+    }
+    for (ResourceHandle handle : churn.destroyedImages) {
+        stale = stale && getRegistryImage(resourceRegistry, handle) == nullptr && !destroyRegistryImage(resourceRegistry, handle);
+    }
+    uint64_t staleUses = 2 * (churn.destroyedBuffers.size() + churn.destroyedImages.size());
+    if (!stale || resourceRegistry.stats.staleHandles - staleBefore != staleUses) {
+        failures.push_back("stale handles were accepted");
+    }
 
-    recordCommandBuffer();
+    // ֡ɣʣԴɾ
+    retireChurnHandles(churn.buffers, 0, false, churn.destroyedBuffers);
+    retireChurnHandles(churn.images, 0, true, churn.destroyedImages);
+    flushRegistryDeletions(resourceRegistry);
+    AllocatorStats after = getAllocatorStats(gpuAllocator);
+    uint64_t created = resourceRegistry.stats.buffersCreated - registryBefore.buffersCreated +
+        resourceRegistry.stats.imagesCreated - registryBefore.imagesCreated;
+    uint64_t destroyed = resourceRegistry.stats.buffersDestroyed - registryBefore.buffersDestroyed +
+        resourceRegistry.stats.imagesDestroyed - registryBefore.imagesDestroyed;
+    if (created != destroyed || resourceRegistry.pending != 0 ||
+        after.allocationCount != before.allocationCount || after.usedBytes != before.usedBytes) {
+        failures.push_back("resources or memory leaked");
+    }
 
-    // Main loop (simplified)
-    while (!glfwWindowShouldClose(window)) {
-        drawFrame();
-        glfwPollEvents();
+    for (const char* failure : failures) {
+        std::cout << "  FAILED: " << failure << std::endl;
     }
+    churn = ResourceChurn();
+    return failures.empty();
+}
+
+void cleanup() {
+    if (device != VK_NULL_HANDLE)
+    {
+        vkDeviceWaitIdle(device);
+    }
+
+    // ̳߳˳ǰִʣĹ߱룬֮עвне
+    destroyJobSystem(jobSystem);
+    destroySceneWorld(sceneWorld);
+
+    // ؽʱ۵ĽǼעɾУ destroyResourceRegistry 
+    destroyPresenter(presenter);
+
+    destroyRenderGraph(frameGraph);
+    destroyParticleSystem(particleSystem);
+
+    // ʽԴɾУעʱһͷţް±ڱ֮ǰ黹
+    destroyTextureManager(textureManager);
+    destroyStreamingLoader(streamingLoader);
+    destroyResourceRegistry(resourceRegistry);
+    destroyBindlessTable(bindlessTable);
+    destroyIndirectScene(scene);
+    destroyBuffer(indexBuffer);
+    destroyBuffer(vertexBuffer);
+    closeAssetPack(scenePack);
+    destroyUploadContext(uploadContext);
 
+    destroyProfiler(profiler);
 
-    if (graphicsPipeline != VK_NULL_HANDLE) 
+    // غͬ豸֮ǰ
+    destroyFrameRing(frameRing);
+
+    // δĶػ destroyResourceRegistry н̣֮߳ٵȴд
+    destroyFrameReadback(frameReadback);
+
+    // лͼ٣黹ڴҳ
+    destroyAllocator(gpuAllocator);
+
+    // ȴ̨ٹߣ֮󱣴ĻŰȫ
+    destroyPipelineRegistry(pipelineRegistry);
+
+    // ɫģɿУ߱ȫ
+    destroyShaderLibrary(shaderLibrary);
+
+    if (pipelineCache != VK_NULL_HANDLE)
     {
-        vkDestroyPipeline(device, graphicsPipeline, nullptr);
+        // ˳ʱ棬´ɫ
+        savePipelineCache(pipelineCache, appConfig.pipelineCachePath);
+        vkDestroyPipelineCache(device, pipelineCache, nullptr);
     }
 
     if (pipelineLayout != VK_NULL_HANDLE)
@@ -590,6 +1900,16 @@ int main() {
         vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
     }
 
+    if (instancedPipelineLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineLayout(device, instancedPipelineLayout, nullptr);
+    }
+
+    for (VkDescriptorSetLayout setLayout : descriptorSetLayouts)
+    {
+        vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    }
+
     if (renderPass != VK_NULL_HANDLE)
     {
         vkDestroyRenderPass(device, renderPass, nullptr);
@@ -609,22 +1929,299 @@ int main() {
         }
     }
 
+    if (surface != VK_NULL_HANDLE)
+    {
+        vkDestroySurfaceKHR(instance, surface, nullptr); // ڱ
+    }
+
     if (instance != VK_NULL_HANDLE) 
     {
         vkDestroyInstance(instance, nullptr);
     }
 
-    vkDestroySemaphore(device, imageAvailableSemaphore, nullptr);
-    vkDestroySemaphore(device, renderFinishedSemaphore, nullptr);
-    vkDestroyFence(device, fence, nullptr);
-    // Դ
-    vkDestroyWindowSurface(instance, surface, nullptr); // ڱ
-    vkDestroyDevice(device, nullptr);
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    if (window != nullptr)
+    {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+}
+
+int main(int argc, char** argv) {
+    if (!parseCommandLine(argc, argv, appConfig)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int exitCode = 0;   // ʽسÿ֡ϴԤԴ׼ļʧʱΪ 1
+    initFramePacer(framePacer, appConfig.targetFps);
+
+    try {
+        if (!appConfig.headless) {
+            initWindow();
+        }
+
+        createInstance();
+
+        setupDebugMessenger();
+
+        if (!appConfig.headless) {
+            createSurface();
+        }
+
+        pickPhysicalDevice();
+
+        createLogicalDevice();
+
+        createAllocator(gpuAllocator);
+
+        createBindlessTable(bindlessTable, descriptorIndexing);
+
+        // ¼߳ = ߳ + ̣߳׼ģʽʹкġ߱Ҳͬһ̳߳ϣ
+        // ٰ̳߳
+        uint32_t recordingThreads = appConfig.recordThreads;
+        if (appConfig.benchmarkRecording) {
+            recordingThreads = std::max({ recordingThreads, std::thread::hardware_concurrency(), 1u });
+        }
+        createJobSystem(jobSystem, std::max({ recordingThreads, std::thread::hardware_concurrency(), 1u }) - 1);
+
+        createFrameRing(frameRing, appConfig.framesInFlight, queueFamilies.graphics, recordingThreads > 0 ? getJobThreadCount(jobSystem) : 0);
+        createResourceRegistry(resourceRegistry, static_cast<uint32_t>(frameRing.frames.size()));
+        resourceRegistry.bindless = &bindlessTable;
+
+        if (!appConfig.tracePath.empty()) {
+            createProfiler(profiler, static_cast<uint32_t>(frameRing.frames.size()), queueFamilies.graphics,
+                deviceFeatures.pipelineStatisticsQuery == VK_TRUE, deviceFeatures.inheritedQueries == VK_TRUE);
+        }
+
+        std::cout << "Vulkan application initialized!" << std::endl;
+
+        // Ŀ꣩ĸʽȾͨɫĸʽ
+        VkSurfaceFormatKHR surfaceFormat = {};
+        if (appConfig.headless) {
+            colorFormat = chooseOffscreenFormat(colorFormat);
+        }
+        else {
+            surfaceFormat = chooseSurfaceFormat(physicalDevice, surface);
+            colorFormat = surfaceFormat.format;
+        }
+
+        createRenderPass();
+
+        if (appConfig.headless) {
+            createOffscreenPresenter(presenter, colorFormat, static_cast<uint32_t>(frameRing.frames.size()),
+                { appConfig.width, appConfig.height }, renderPass);
+            presenter.simulateOutOfDateEvery = appConfig.resizeEvery;
+        }
+        else {
+            VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+            parsePresentMode(appConfig.presentMode, presentMode);
+            createSwapchainPresenter(presenter, surface, surfaceFormat, presentMode, appConfig.swapchainImages,
+                { queueFamilies.graphics, queueFamilies.present }, getDrawableExtent(), renderPass);
+        }
+        swapChainExtent = presenter.extent;
+        printPresenterInfo(presenter);
+
+        if (!appConfig.captureDir.empty()) {
+            if (!isReadbackFormatSupported(colorFormat)) {
+                throw std::runtime_error("offscreen format does not support readback!");
+            }
+            ImageFileFormat captureFormat = ImageFileFormat::Png;
+            parseImageFileFormat(appConfig.captureFormat, captureFormat);
+            createFrameReadback(frameReadback, appConfig.captureDir, captureFormat, appConfig.captureEvery,
+                appConfig.captureBuffers, appConfig.captureThreads, appConfig.captureWait);
+        }
+
+        // ʱΪգߴҪɫ
+        pipelineCache = loadPipelineCache(appConfig.pipelineCachePath, pipelineCacheLoadedBytes);
+        std::cout << "Pipeline cache: " << pipelineCacheLoadedBytes << " bytes loaded" << std::endl;
+
+        createPipelineRegistry(pipelineRegistry, jobSystem);
+        createShaderLibrary(shaderLibrary, appConfig.shaderSearchPaths, appConfig.shaderArchive);
+
+        // Դڹߴǰ򿪣ʽȡԴĲ
+        if (!appConfig.packPath.empty()) {
+            openAssetPack(scenePack, appConfig.packPath);
+            if (scenePack.header->meshCount == 0) {
+                throw std::runtime_error("asset pack " + appConfig.packPath + " contains no meshes!");
+            }
+            printAssetPackInfo(scenePack);
+            sceneMeshes = getPackMeshRanges(scenePack);
+            indexType = getPackIndexType(scenePack);
+        }
+        buildSceneMeshLods();
+
+        // ں̨룬ͬʱмϴ
+        auto pipelineStart = std::chrono::high_resolution_clock::now();
+        createGraphicsPipeline();
+
+        // мݵĿϲһύ
+        createUploadContext(uploadContext, graphicsQueue, queueFamilies.graphics, 4 * 1024 * 1024);
+        createVertexBuffer();
+        createIndexBuffer();
+        flushUploads(uploadContext);
+
+        buildDrawList(appConfig.drawCount);
+
+        // ڳ֮ǰأ尴˳ʹãÿ֡¼ʱԤϴ
+        if (!appConfig.texturePaths.empty()) {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+            createTextureManager(textureManager, static_cast<VkDeviceSize>(appConfig.textureBudgetMB) * 1024 * 1024,
+                static_cast<VkDeviceSize>(appConfig.textureUploadKB) * 1024, deviceFeatures.textureCompressionBC == VK_TRUE,
+                deviceFeatures.textureCompressionASTC_LDR == VK_TRUE,
+                deviceFeatures.samplerAnisotropy == VK_TRUE ? properties.limits.maxSamplerAnisotropy : 0.0f);
+            textureManager.registry = &resourceRegistry;
+
+            SamplerDesc sampler;
+            sampler.maxAnisotropy = 16.0f;
+            for (const std::string& path : collectStreamFiles(appConfig.texturePaths)) {
+                loadTexture(textureManager, path, sampler);
+            }
+            std::cout << "Textures: " << textureManager.textures.size() << " loaded, BC "
+                << (textureManager.textureCompressionBC ? "on" : "off") << ", ASTC "
+                << (textureManager.textureCompressionASTC ? "on" : "off") << ", budget " << appConfig.textureBudgetMB << " MB" << std::endl;
+        }
+
+        parseSceneDrawMode(appConfig.sceneDrawMode, sceneDrawMode);
+        buildViewProjection(appConfig.cameraZoom);
+        if (appConfig.objectCount > 0 && !appConfig.benchmarkDraws) {
+            createScene(appConfig.objectCount);
+
+            SceneDrawMode resolved = resolveSceneDrawMode(scene, sceneDrawMode);
+            std::cout << "Scene: " << appConfig.objectCount << " objects, " << sceneDrawModeName(resolved) << " draws";
+            if (resolved != sceneDrawMode) {
+                std::cout << " (" << sceneDrawModeName(sceneDrawMode) << " needs drawIndirectFirstInstance)";
+            }
+            std::cout << std::endl;
+            std::cout << "Scene LOD: " << sceneLodTriangles << " of " << sceneFullTriangles << " triangles ("
+                << std::fixed << std::setprecision(1) << 100.0 * sceneLodTriangles / std::max(sceneFullTriangles, 1u)
+                << "%) within " << appConfig.lodPixelError << " px" << std::defaultfloat << std::endl;
+        }
+
+        if (appConfig.particleCount > 0 && !appConfig.benchmarkParticles) {
+            createParticles(appConfig.particleCount);
+            std::cout << "Particles: " << appConfig.particleCount << " particles, "
+                << particleQueueModeName(particleSystem.mode) << " simulation";
+            if (particleSystem.mode == ParticleQueueMode::Async) {
+                std::cout << " on compute queue family " << queueFamilies.compute << " (" << describeComputeQueue() << ")";
+            }
+            std::cout << std::endl;
+        }
+
+        // ʽԴ I/O ߳϶ȡͽ룬Ⱦ߳ÿ֡Ԥύ
+        if (!appConfig.streamPaths.empty()) {
+            createStreamingLoader(streamingLoader, transferQueue, queueFamilies.transfer, queueFamilies.graphics,
+                timelineSemaphores, appConfig.ioThreads, STREAMING_STAGING_SIZE,
+                static_cast<VkDeviceSize>(appConfig.uploadBudgetKB) * 1024);
+            streamingLoader.registry = &resourceRegistry;
+            for (const std::string& path : collectStreamFiles(appConfig.streamPaths)) {
+                if (requestAsset(streamingLoader, path) == INVALID_ASSET) {
+                    std::cerr << "Streaming: skipping " << path << " (unsupported type)" << std::endl;
+                }
+            }
+        }
+
+        std::cout << "Uploaded " << uploadContext.stats.bytesUploaded << " bytes in "
+            << uploadContext.stats.copyCount << " copies, "
+            << uploadContext.stats.submitCount << " submission(s)" << std::endl;
+
+        if (appConfig.headless) {
+            // ׼ֻȶ״̬ȵй߾
+            waitForPipelines(pipelineRegistry);
+            auto pipelineEnd = std::chrono::high_resolution_clock::now();
+            std::cout << "Pipeline creation: " << std::chrono::duration<double, std::milli>(pipelineEnd - pipelineStart).count()
+                << " ms (" << (pipelineCacheLoadedBytes != 0 ? "warm" : "cold") << " cache)" << std::endl;
+
+            if (appConfig.benchmarkRecording) {
+                runRecordingBenchmark();
+            }
+            else if (appConfig.benchmarkDraws) {
+                runDrawBenchmark();
+            }
+            else if (appConfig.benchmarkParticles) {
+                runParticleBenchmark();
+            }
+            else if (appConfig.benchmarkResources) {
+                if (!runResourceBenchmark()) {
+                    exitCode = 1;
+                }
+            }
+            else if (streamingLoader.enabled) {
+                if (!runStreaming()) {
+                    exitCode = 1;
+                }
+            }
+            else {
+                runHeadless();
+            }
+        }
+        else {
+            FrameStats stats;
+            auto start = std::chrono::high_resolution_clock::now();
+
+            // ȴڲ֮ǰ뵽ʾӳٲȴʱ
+            while (!glfwWindowShouldClose(window)) {
+                paceFrame(framePacer);
+                glfwPollEvents();
+                drawFrame(&stats);
+                stats.frameCount++;
+            }
+
+            waitForAllFrames(frameRing, &stats);
+            stats.totalSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            printFrameStats(stats);
+        }
+
+        if (scene.objectCount > 0) {
+            collectCullingCounts();
+            printCullingStats(scene);
+        }
+
+        // ֡ѽwaitForAllFramesʣĲѯ󵼳
+        if (profiler.enabled) {
+            flushProfiler(profiler);
+            printProfilerStats(profiler);
+            exportChromeTrace(profiler, appConfig.tracePath);
+        }
+
+        if (streamingLoader.enabled) {
+            printStreamingStats(streamingLoader);
+        }
+
+        if (particleSystem.enabled) {
+            printParticleStats(particleSystem);
+        }
+
+        if (textureManager.enabled) {
+            printTextureStats(textureManager);
+        }
+
+        // ֡ѻգɾУǼеĶػ֮߳
+        flushRegistryDeletions(resourceRegistry);
+        if (frameReadback.enabled) {
+            flushFrameReadback(frameReadback);
+            printReadbackStats(frameReadback);
+        }
+
+        printPresenterStats(presenter);
+        if (framePacer.started) {
+            printFramePacerStats(framePacer);
+        }
+        printBindlessStats(bindlessTable);
+        printUniformRingStats(frameRing.uniforms);
+        printShaderLibraryStats(shaderLibrary);
+        printPipelineRegistryStats(pipelineRegistry);
+        printAllocatorStats(gpuAllocator);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        cleanup();
+        return 1;
+    }
 
+    cleanup();
 
     std::cout << "Vulkan application uninitialized!" << std::endl;
 
-    return 0;
+    return exitCode;
 }
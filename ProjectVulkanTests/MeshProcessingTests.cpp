@@ -0,0 +1,281 @@
+#include "MeshProcessing.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// λһ㣬ûнӷ죻γ
+static void buildSphereMesh(uint32_t rings, uint32_t segments, std::vector<Vec3>& positions, std::vector<uint32_t>& indices) {
+    positions.clear();
+    indices.clear();
+
+    positions.push_back({ 0.0f, 1.0f, 0.0f });
+    for (uint32_t r = 1; r < rings; r++) {
+        float polar = 3.14159265f * r / rings;
+        for (uint32_t s = 0; s < segments; s++) {
+            float azimuth = 6.2831853f * s / segments;
+            positions.push_back({ std::sin(polar) * std::cos(azimuth), std::cos(polar), std::sin(polar) * std::sin(azimuth) });
+        }
+    }
+    positions.push_back({ 0.0f, -1.0f, 0.0f });
+
+    uint32_t bottom = static_cast<uint32_t>(positions.size() - 1);
+    auto ring = [&](uint32_t r, uint32_t s) {
+        return 1 + (r - 1) * segments + s % segments;
+    };
+    for (uint32_t s = 0; s < segments; s++) {
+        indices.insert(indices.end(), { 0u, ring(1, s), ring(1, s + 1) });
+        indices.insert(indices.end(), { bottom, ring(rings - 1, s + 1), ring(rings - 1, s) });
+    }
+    for (uint32_t r = 1; r + 1 < rings; r++) {
+        for (uint32_t s = 0; s < segments; s++) {
+            indices.insert(indices.end(), { ring(r, s), ring(r + 1, s), ring(r + 1, s + 1) });
+            indices.insert(indices.end(), { ring(r, s), ring(r + 1, s + 1), ring(r, s + 1) });
+        }
+    }
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        Vec3 n = triangleNormal(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]]);
+        if (vec3Dot(n, positions[indices[i]]) < 0.0f) {
+            std::swap(indices[i + 1], indices[i + 2]);
+        }
+    }
+}
+
+// С±ǰ򣩺ȽǷͬ
+static std::vector<uint64_t> canonicalTriangles(const std::vector<uint32_t>& indices) {
+    std::vector<uint64_t> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        while (a > b || a > c) {
+            uint32_t t = a;
+            a = b;
+            b = c;
+            c = t;
+        }
+        triangles.push_back((static_cast<uint64_t>(a) << 42) | (static_cast<uint64_t>(b) << 21) | c);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// ԭÿ㵽루 Hausdorff Ķƣ
+static float maxDeviation(const std::vector<Vec3>& positions, const std::vector<uint32_t>& original, const std::vector<uint32_t>& simplified) {
+    std::vector<uint8_t> used(positions.size(), 0);
+    for (uint32_t index : original) {
+        used[index] = 1;
+    }
+
+    float result = 0.0f;
+    for (size_t v = 0; v < positions.size(); v++) {
+        if (!used[v]) {
+            continue;
+        }
+        float nearest = FLT_MAX;
+        for (size_t i = 0; i < simplified.size() && nearest > result; i += 3) {
+            nearest = std::min(nearest, pointTriangleDistance(positions[v],
+                positions[simplified[i]], positions[simplified[i + 1]], positions[simplified[i + 2]]));
+        }
+        result = std::max(result, nearest);
+    }
+    return result;
+}
+
+static float meshArea(const std::vector<Vec3>& positions, const std::vector<uint32_t>& indices, uint32_t first, uint32_t count) {
+    float area = 0.0f;
+    for (uint32_t i = first; i < first + count; i += 3) {
+        area += 0.5f * triangleNormal(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]]).z;
+    }
+    return area;
+}
+
+bool runMeshProcessingTests() {
+    bool ok = true;
+
+    std::vector<Vec3> sphere;
+    std::vector<uint32_t> sphereIndices;
+    buildSphereMesh(32, 64, sphere, sphereIndices);
+    uint32_t sphereVertices = static_cast<uint32_t>(sphere.size());
+    uint32_t sphereTriangles = static_cast<uint32_t>(sphereIndices.size() / 3);
+
+    // 򻯣Ŀ£ԭ񵽽ľ벻 10% 
+    {
+        bool valid = true;
+        const float targets[] = { 0.5f, 0.25f, 0.1f };
+        for (float fraction : targets) {
+            uint32_t target = static_cast<uint32_t>(sphereTriangles * fraction) * 3;
+            float error = 0.0f;
+            std::vector<uint32_t> simplified = simplifyMesh(sphere, sphereIndices, target, FLT_MAX, &error);
+            float deviation = maxDeviation(sphere, sphereIndices, simplified);
+            valid = valid && !simplified.empty() && simplified.size() <= target && deviation <= error + 1e-5f;
+        }
+        ok = check("simplify reaches target within error bound", valid) && ok;
+
+        // ޣԽϣԽࡢԽС
+        bool monotonic = true;
+        size_t previousSize = 0;
+        float previousError = FLT_MAX;
+        const float limits[] = { 0.05f, 0.01f, 0.002f };
+        for (float limit : limits) {
+            float error = 0.0f;
+            std::vector<uint32_t> limited = simplifyMesh(sphere, sphereIndices, 0, limit, &error);
+            monotonic = monotonic && limited.size() > previousSize && limited.size() < sphereIndices.size() && error <= previousError
+                && maxDeviation(sphere, sphereIndices, limited) <= error + 1e-5f;
+            previousSize = limited.size();
+            previousError = error;
+        }
+        ok = check("simplify stops at error limit", monotonic) && ok;
+    }
+
+    // LOD ÿһһ룬һԭ 10%
+    {
+        std::vector<uint32_t> lodIndices;
+        std::vector<MeshLod> lods = buildMeshLods(sphere, sphereIndices, 6, 0.5f, lodIndices);
+        bool valid = lods.size() == 6 && lods[0].indexCount == sphereIndices.size() && lods[0].error == 0.0f;
+        std::cout << "  level  triangles  percent  error     ACMR" << std::endl;
+        for (uint32_t l = 0; l < lods.size(); l++) {
+            if (l > 0) {
+                valid = valid && lods[l].indexCount <= lods[l - 1].indexCount / 2 + 3 && lods[l].error >= lods[l - 1].error;
+            }
+            std::vector<uint32_t> level(lodIndices.begin() + lods[l].firstIndex, lodIndices.begin() + lods[l].firstIndex + lods[l].indexCount);
+            std::cout << std::fixed << std::setprecision(4)
+                << "  " << std::setw(5) << l << "  "
+                << std::setw(9) << lods[l].indexCount / 3 << "  "
+                << std::setw(6) << std::setprecision(1) << 100.0f * lods[l].indexCount / sphereIndices.size() << "%  "
+                << std::setw(6) << std::setprecision(4) << lods[l].error << "  "
+                << std::setw(6) << std::setprecision(3) << analyzeVertexCache(level, sphereVertices) << std::endl;
+            std::cout << std::defaultfloat;
+        }
+        valid = valid && lods.back().indexCount * 10 < sphereIndices.size();
+        ok = check("lod chain halves triangles with monotonic error", valid) && ok;
+    }
+
+    // ƽԲ̣ڲ۵ûڱ߽Уֻ߽۵ļ
+    {
+        std::vector<Vec3> disc;
+        std::vector<uint32_t> discIndices;
+        buildDiscMesh(0.5f, 16, 64, disc, discIndices);
+        std::vector<uint32_t> lodIndices;
+        std::vector<MeshLod> lods = buildMeshLods(disc, discIndices, 8, 0.5f, lodIndices);
+
+        float area = meshArea(disc, discIndices, 0, static_cast<uint32_t>(discIndices.size()));
+        bool valid = lods.size() > 4 && lods.back().indexCount * 10 < discIndices.size();
+        for (const MeshLod& lod : lods) {
+            float lodArea = meshArea(disc, lodIndices, lod.firstIndex, lod.indexCount);
+            // ļٲܳ
+            float allowed = lod.error * 6.2831853f * 0.5f + area * 1e-4f;
+            valid = valid && lodArea <= area * 1.0001f && area - lodArea <= allowed;
+        }
+        ok = check("flat mesh keeps its outline", valid) && ok;
+    }
+
+    // 㻺棺˳Żμϲ䣬ACMR ½
+    {
+        std::vector<uint32_t> shuffled = sphereIndices;
+        std::mt19937 rng(3);
+        for (size_t i = shuffled.size() / 3; i > 1; i--) {
+            size_t j = rng() % i;
+            for (uint32_t k = 0; k < 3; k++) {
+                std::swap(shuffled[(i - 1) * 3 + k], shuffled[j * 3 + k]);
+            }
+        }
+        float before = analyzeVertexCache(shuffled, sphereVertices);
+        std::vector<uint32_t> optimized = shuffled;
+        optimizeVertexCache(optimized, sphereVertices);
+        float after = analyzeVertexCache(optimized, sphereVertices);
+        std::cout << "  ACMR " << before << " -> " << after << std::endl;
+        ok = check("vertex cache order", canonicalTriangles(optimized) == canonicalTriangles(shuffled) && after < before && after < 0.8f) && ok;
+    }
+
+    // ȡ㰴״ʹõ˳ţźÿελò
+    {
+        std::vector<uint32_t> remapped = sphereIndices;
+        optimizeVertexCache(remapped, sphereVertices);
+        std::vector<uint32_t> original = remapped;
+        std::vector<uint32_t> remap = optimizeVertexFetch(remapped, sphereVertices);
+        std::vector<Vec3> positions = remapVertices(sphere, remap);
+
+        bool valid = true;
+        uint32_t next = 0;
+        for (size_t i = 0; i < remapped.size() && valid; i++) {
+            valid = remapped[i] <= next && positions[remapped[i]].x == sphere[original[i]].x
+                && positions[remapped[i]].y == sphere[original[i]].y && positions[remapped[i]].z == sphere[original[i]].z;
+            next = std::max(next, remapped[i] + 1);
+        }
+        ok = check("vertex fetch order", valid) && ok;
+    }
+
+    // MeshletޣÿǡóһΣΧж㣬׶жΪʱȷʵȫǱ
+    {
+        std::vector<uint32_t> optimized = sphereIndices;
+        optimizeVertexCache(optimized, sphereVertices);
+        MeshletData meshlets;
+        buildMeshlets(sphere, optimized, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, meshlets);
+
+        bool limits = !meshlets.meshlets.empty();
+        bool bounds = true;
+        std::vector<uint32_t> rebuilt;
+        for (size_t m = 0; m < meshlets.meshlets.size(); m++) {
+            const Meshlet& meshlet = meshlets.meshlets[m];
+            limits = limits && meshlet.vertexCount <= MESHLET_MAX_VERTICES && meshlet.triangleCount <= MESHLET_MAX_TRIANGLES
+                && meshlet.triangleOffset % 4 == 0;
+            for (uint32_t t = 0; t < meshlet.triangleCount * 3; t++) {
+                rebuilt.push_back(meshlets.vertices[meshlet.vertexOffset + meshlets.triangles[meshlet.triangleOffset + t]]);
+            }
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+                const MeshletBounds& b = meshlets.bounds[m];
+                bounds = bounds && vec3Length(vec3Sub(sphere[meshlets.vertices[meshlet.vertexOffset + i]], b.center)) <= b.radius * 1.0001f + 1e-6f;
+            }
+        }
+        ok = check("meshlet limits and coverage", limits && canonicalTriangles(rebuilt) == canonicalTriangles(optimized)) && ok;
+        ok = check("meshlet bounding spheres", bounds) && ok;
+
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        bool conservative = true;
+        uint64_t culled = 0;
+        uint64_t tested = 0;
+        for (uint32_t c = 0; c < 64; c++) {
+            Vec3 camera = vec3Scale(vec3Normalize({ unit(rng), unit(rng), unit(rng) }), 1.5f + 3.0f * (unit(rng) + 1.0f));
+            for (size_t m = 0; m < meshlets.meshlets.size(); m++) {
+                tested++;
+                if (!isMeshletBackfacing(meshlets.bounds[m], camera)) {
+                    continue;
+                }
+                culled++;
+                const Meshlet& meshlet = meshlets.meshlets[m];
+                for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+                    const uint8_t* local = &meshlets.triangles[meshlet.triangleOffset + t * 3];
+                    const Vec3& a = sphere[meshlets.vertices[meshlet.vertexOffset + local[0]]];
+                    const Vec3& b = sphere[meshlets.vertices[meshlet.vertexOffset + local[1]]];
+                    const Vec3& cc = sphere[meshlets.vertices[meshlet.vertexOffset + local[2]]];
+                    conservative = conservative && vec3Dot(triangleNormal(a, b, cc), vec3Sub(camera, a)) <= 1e-6f;
+                }
+            }
+        }
+        std::cout << "  " << meshlets.meshlets.size() << " meshlets, " << 100.0 * culled / tested << "% cone-culled from random views" << std::endl;
+        ok = check("meshlet cones are conservative", conservative && culled * 5 > tested) && ok;
+    }
+
+    // LOD ѡͶӰ󲻳ֵһԽԶԽ
+    {
+        std::vector<MeshLod> lods = { { 0, 300, 0.0f }, { 0, 150, 0.001f }, { 0, 75, 0.01f }, { 0, 36, 0.1f } };
+        bool valid = selectMeshLod(lods, 10000.0f, 1.0f) == 0 && selectMeshLod(lods, 100.0f, 1.0f) == 2
+            && selectMeshLod(lods, 1.0f, 1.0f) == 3 && selectMeshLod(lods, 1.0f, 0.0f) == 0;
+
+        uint32_t previous = 0;
+        for (float distance = 0.5f; distance < 1000.0f; distance *= 1.5f) {
+            uint32_t level = selectMeshLod(lods, perspectivePixelsPerUnit(distance, 1.0f, 1080.0f), 1.0f);
+            valid = valid && level >= previous;
+            previous = level;
+        }
+        ok = check("lod selection by projected error", valid && previous == 3) && ok;
+    }
+
+    return ok;
+}
@@ -0,0 +1,309 @@
+#include "Readback.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+// һִֻ֧洢͹̶Ľѹ֤ PNG дһݣ
+
+static const uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+struct BitReader {
+    const uint8_t* data;
+    size_t size;
+    size_t position = 0;    // λΪλ
+
+    uint32_t get(uint32_t n) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < n; i++, position++) {
+            if (position / 8 >= size) {
+                throw std::runtime_error("truncated deflate stream!");
+            }
+            value |= ((data[position / 8] >> (position % 8)) & 1u) << i;
+        }
+        return value;
+    }
+
+    // λʼλȡ
+    uint32_t getCode(uint32_t n) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            value = (value << 1) | get(1);
+        }
+        return value;
+    }
+};
+
+static uint32_t readFixedLiteral(BitReader& reader) {
+    uint32_t code = reader.getCode(7);
+    if (code <= 0x17) {
+        return code + 256;
+    }
+    code = (code << 1) | reader.get(1);
+    if (code >= 0x30 && code <= 0xBF) {
+        return code - 0x30;
+    }
+    if (code >= 0xC0 && code <= 0xC7) {
+        return code - 0xC0 + 280;
+    }
+    code = (code << 1) | reader.get(1);
+    return code - 0x190 + 144;
+}
+
+static bool zlibDecompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    if (size < 6 || (data[0] * 256 + data[1]) % 31 != 0 || (data[0] & 0x0F) != 8) {
+        return false;
+    }
+
+    BitReader reader = { data + 2, size - 6 };
+    bool last = false;
+    while (!last) {
+        last = reader.get(1) != 0;
+        uint32_t type = reader.get(2);
+        if (type == 0) {
+            reader.position = (reader.position + 7) & ~size_t(7);
+            uint32_t length = reader.get(16);
+            uint32_t inverse = reader.get(16);
+            if ((length ^ inverse) != 0xFFFF) {
+                return false;
+            }
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(static_cast<uint8_t>(reader.get(8)));
+            }
+            continue;
+        }
+        if (type != 1) {
+            return false;
+        }
+
+        for (;;) {
+            uint32_t symbol = readFixedLiteral(reader);
+            if (symbol < 256) {
+                out.push_back(static_cast<uint8_t>(symbol));
+                continue;
+            }
+            if (symbol == 256) {
+                break;
+            }
+            uint32_t lengthIndex = symbol - 257;
+            if (lengthIndex >= 29) {
+                return false;
+            }
+            uint32_t length = LENGTH_BASE[lengthIndex] + reader.get(LENGTH_EXTRA[lengthIndex]);
+            uint32_t distanceIndex = reader.getCode(5);
+            if (distanceIndex >= 30) {
+                return false;
+            }
+            uint32_t distance = DISTANCE_BASE[distanceIndex] + reader.get(DISTANCE_EXTRA[distanceIndex]);
+            if (distance > out.size()) {
+                return false;
+            }
+            for (uint32_t i = 0; i < length; i++) {
+                out.push_back(out[out.size() - distance]);
+            }
+        }
+    }
+
+    const uint8_t* trailer = data + size - 4;
+    uint32_t expected = (uint32_t(trailer[0]) << 24) | (trailer[1] << 16) | (trailer[2] << 8) | trailer[3];
+    return expected == adler32(out.data(), out.size());
+}
+
+static uint32_t readBigEndian32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+//  encodePng  CRCѹˣõ RGBA 
+static bool decodePng(const std::vector<uint8_t>& file, uint32_t& width, uint32_t& height, std::vector<uint8_t>& pixels) {
+    if (file.size() < 8 || memcmp(file.data(), "\x89PNG\r\n\x1A\n", 8) != 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> idat;
+    size_t position = 8;
+    bool ended = false;
+    while (!ended && position + 12 <= file.size()) {
+        uint32_t length = readBigEndian32(&file[position]);
+        if (position + 12 + length > file.size()) {
+            return false;
+        }
+        const uint8_t* type = &file[position + 4];
+        const uint8_t* data = type + 4;
+        if (crc32(type, length + 4) != readBigEndian32(data + length)) {
+            return false;
+        }
+        if (memcmp(type, "IHDR", 4) == 0) {
+            width = readBigEndian32(data);
+            height = readBigEndian32(data + 4);
+            if (data[8] != 8 || data[9] != 6) {
+                return false;
+            }
+        }
+        else if (memcmp(type, "IDAT", 4) == 0) {
+            idat.insert(idat.end(), data, data + length);
+        }
+        else if (memcmp(type, "IEND", 4) == 0) {
+            ended = true;
+        }
+        position += 12 + length;
+    }
+
+    std::vector<uint8_t> filtered;
+    if (!ended || !zlibDecompress(idat.data(), idat.size(), filtered)) {
+        return false;
+    }
+    size_t rowBytes = size_t(width) * 4;
+    if (filtered.size() != (rowBytes + 1) * height) {
+        return false;
+    }
+
+    pixels.assign(rowBytes * height, 0);
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* src = &filtered[y * (rowBytes + 1)];
+        uint8_t* row = &pixels[y * rowBytes];
+        const uint8_t* up = y > 0 ? row - rowBytes : nullptr;
+        for (size_t i = 0; i < rowBytes; i++) {
+            int a = i >= 4 ? row[i - 4] : 0;
+            int b = up != nullptr ? up[i] : 0;
+            int c = (up != nullptr && i >= 4) ? up[i - 4] : 0;
+            uint8_t predicted = 0;
+            switch (src[0]) {
+            case 0: break;
+            case 1: predicted = static_cast<uint8_t>(a); break;
+            case 2: predicted = static_cast<uint8_t>(b); break;
+            case 3: predicted = static_cast<uint8_t>((a + b) / 2); break;
+            case 4: predicted = paethPredictor(a, b, c); break;
+            default: return false;
+            }
+            row[i] = static_cast<uint8_t>(src[i + 1] + predicted);
+        }
+    }
+    return true;
+}
+
+static bool pngRoundTrip(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, size_t* encodedSize) {
+    std::vector<uint8_t> file;
+    encodePng(pixels.data(), width, height, true, file);
+    *encodedSize = file.size();
+
+    uint32_t decodedWidth = 0;
+    uint32_t decodedHeight = 0;
+    std::vector<uint8_t> decoded;
+    return decodePng(file, decodedWidth, decodedHeight, decoded)
+        && decodedWidth == width && decodedHeight == height && decoded == pixels;
+}
+
+bool runReadbackTests() {
+    bool ok = true;
+
+    // ׼
+    const char* digits = "123456789";
+    ok &= check("crc32 of \"123456789\" is cbf43926", crc32(reinterpret_cast<const uint8_t*>(digits), 9) == 0xCBF43926u);
+    const char* word = "Wikipedia";
+    ok &= check("adler32 of \"Wikipedia\" is 11e60398", adler32(reinterpret_cast<const uint8_t*>(word), 9) == 0x11E60398u);
+    std::vector<uint8_t> ones(100000, 0xFF);
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (uint8_t byte : ones) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    ok &= check("adler32 defers the modulo without overflow", adler32(ones.data(), ones.size()) == ((b << 16) | a));
+
+    ok &= check("half: exact values", floatToHalf(1.0f) == 0x3C00 && floatToHalf(0.5f) == 0x3800 && floatToHalf(-2.0f) == 0xC000
+        && floatToHalf(0.0f) == 0x0000 && floatToHalf(65504.0f) == 0x7BFF);
+    ok &= check("half: overflow, denormals and rounding", floatToHalf(1.0e6f) == 0x7C00 && floatToHalf(std::ldexp(1.0f, -24)) == 0x0001
+        && floatToHalf(std::ldexp(1.0f, -26)) == 0x0000 && floatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00
+        && floatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3C02);
+
+    // 䣨˺߶ظɫѹҪ
+    const uint32_t width = 97;
+    const uint32_t height = 61;
+    std::vector<uint8_t> gradient(width * height * 4);
+    std::vector<uint8_t> flat(width * height * 4);
+    std::vector<uint8_t> noise(width * height * 4);
+    std::mt19937 random(7);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t* p = &gradient[(y * width + x) * 4];
+            p[0] = static_cast<uint8_t>(x * 255 / (width - 1));
+            p[1] = static_cast<uint8_t>(y * 255 / (height - 1));
+            p[2] = static_cast<uint8_t>((x + y) & 0xFF);
+            p[3] = 255;
+            uint8_t* q = &flat[(y * width + x) * 4];
+            q[0] = 32; q[1] = 64; q[2] = 96; q[3] = 255;
+        }
+    }
+    for (uint8_t& value : noise) {
+        value = static_cast<uint8_t>(random());
+    }
+
+    size_t gradientSize = 0;
+    size_t flatSize = 0;
+    size_t noiseSize = 0;
+    ok &= check("png round trip: gradient", pngRoundTrip(gradient, width, height, &gradientSize));
+    ok &= check("png round trip: flat color", pngRoundTrip(flat, width, height, &flatSize));
+    ok &= check("png round trip: noise", pngRoundTrip(noise, width, height, &noiseSize));
+    std::cout << "  png sizes: gradient " << gradientSize << ", flat " << flatSize << ", noise " << noiseSize
+        << " bytes (raw " << width * height * 4 << ")" << std::endl;
+    ok &= check("png compresses flat and gradient images", flatSize * 20 < flat.size() && gradientSize * 4 < gradient.size());
+    ok &= check("png noise stays within fixed-code overhead", noiseSize < noise.size() * 9 / 8 + 1024);
+
+    // EXRͷƫƱһ
+    std::vector<uint8_t> exr;
+    encodeExr(gradient.data(), width, height, true, exr);
+    uint32_t magic = 0;
+    memcpy(&magic, exr.data(), 4);
+    // Ϊơͣ 0 βСֵΪձʾͷ
+    size_t headerEnd = 8;
+    uint32_t attributeCount = 0;
+    while (headerEnd < exr.size() && exr[headerEnd] != 0) {
+        const char* name = reinterpret_cast<const char*>(&exr[headerEnd]);
+        const char* type = name + strlen(name) + 1;
+        uint32_t size = 0;
+        memcpy(&size, type + strlen(type) + 1, 4);
+        headerEnd = (type + strlen(type) + 1 + 4 + size) - reinterpret_cast<const char*>(exr.data());
+        attributeCount++;
+    }
+    headerEnd++;
+    bool offsetsValid = attributeCount == 8;
+    uint32_t lineBytes = width * 8;
+    for (uint32_t y = 0; offsetsValid && y < height; y++) {
+        uint64_t offset = 0;
+        memcpy(&offset, &exr[headerEnd + y * 8], 8);
+        int32_t line = -1;
+        uint32_t size = 0;
+        offsetsValid = offset + 8 + lineBytes <= exr.size();
+        if (offsetsValid) {
+            memcpy(&line, &exr[offset], 4);
+            memcpy(&size, &exr[offset + 4], 4);
+            offsetsValid = line == static_cast<int32_t>(y) && size == lineBytes;
+        }
+    }
+    ok &= check("exr magic, offset table and scanline blocks", magic == 20000630 && offsetsValid
+        && exr.size() == headerEnd + size_t(height) * (8 + 8 + lineBytes));
+
+    // һұߵأR = 255 1.0A ͨ B ֮ǰ
+    uint64_t lastOffset = 0;
+    memcpy(&lastOffset, &exr[headerEnd + (height - 1) * 8], 8);
+    uint16_t alpha = 0;
+    uint16_t red = 0;
+    memcpy(&alpha, &exr[lastOffset + 8 + (width - 1) * 2], 2);
+    memcpy(&red, &exr[lastOffset + 8 + 3 * width * 2 + (width - 1) * 2], 2);
+    uint16_t green = 0;
+    memcpy(&green, &exr[lastOffset + 8 + 2 * width * 2], 2);
+    ok &= check("exr channels are alphabetical and sRGB decoded", alpha == 0x3C00 && red == 0x3C00 && green == 0x3C00);
+
+    std::cout << (ok ? "All readback tests passed" : "Readback tests FAILED") << std::endl;
+    return ok;
+}
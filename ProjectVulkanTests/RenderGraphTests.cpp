@@ -0,0 +1,170 @@
+#include "RenderGraph.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <iostream>
+
+struct RenderGraphExpectation {
+    uint32_t culledPasses;
+    uint32_t barrierBatches;
+    uint32_t imageBarriers;
+    uint32_t memoryBarriers;
+    uint32_t transientImages;
+    bool aliased;               // ڴӦڵ
+};
+
+// ͼ񣬰ÿֽڴ󣬶ȡ 64 KB
+static VkMemoryRequirements estimateRequirements(RGResource& resource) {
+    const VkDeviceSize alignment = 64 * 1024;
+    VkDeviceSize texelBytes = resource.desc.format == VK_FORMAT_R16G16B16A16_SFLOAT ? 8 : 4;
+    VkDeviceSize bytes = texelBytes * resource.desc.extent.width * resource.desc.extent.height;
+
+    VkMemoryRequirements requirements = {};
+    requirements.size = (bytes + alignment - 1) / alignment * alignment;
+    requirements.alignment = alignment;
+    requirements.memoryTypeBits = 1;
+    return requirements;
+}
+
+static bool checkRenderGraph(const char* name, RenderGraph& graph, const RenderGraphExpectation& expected) {
+    planRenderGraph(graph, estimateRequirements);
+    const RenderGraphStats& stats = graph.stats;
+
+    bool ok = check(name, stats.culledPasses == expected.culledPasses && stats.barrierBatches == expected.barrierBatches
+        && stats.imageBarriers == expected.imageBarriers && stats.memoryBarriers == expected.memoryBarriers
+        && stats.transientImages == expected.transientImages
+        && (!expected.aliased || stats.allocatedBytes < stats.transientBytes));
+
+    printRenderGraph(graph);
+    if (!ok) {
+        std::cout << "  expected " << expected.culledPasses << " culled, " << expected.barrierBatches << " batches ("
+            << expected.imageBarriers << " image, " << expected.memoryBarriers << " memory), "
+            << expected.transientImages << " transient images" << (expected.aliased ? ", aliased" : "") << std::endl;
+    }
+
+    destroyRenderGraph(graph);
+    return ok;
+}
+
+static void noRecord(VkCommandBuffer) {
+}
+
+bool runRenderGraphTests() {
+    const RGState presentInitial = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED };
+    const RGState presentFinal = { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+    const RGState readbackFinal = { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL };
+    const VkExtent2D full = { 1280, 720 };
+    const VkExtent2D half = { 640, 360 };
+    bool ok = true;
+
+    // ӳɫG-buffer ڹ֮ʹãͼڴ棻ͨû˶޳
+    {
+        RenderGraph graph;
+        RGResourceHandle albedo = createTransientImage(graph, "Albedo", { VK_FORMAT_R8G8B8A8_UNORM, full });
+        RGResourceHandle normal = createTransientImage(graph, "Normal", { VK_FORMAT_R16G16B16A16_SFLOAT, full });
+        RGResourceHandle depth = createTransientImage(graph, "Depth", { VK_FORMAT_D32_SFLOAT, full });
+        RGResourceHandle hdr = createTransientImage(graph, "HDR", { VK_FORMAT_R16G16B16A16_SFLOAT, full });
+        RGResourceHandle bloomDown = createTransientImage(graph, "Bloom down", { VK_FORMAT_R16G16B16A16_SFLOAT, half });
+        RGResourceHandle bloomBlur = createTransientImage(graph, "Bloom blur", { VK_FORMAT_R16G16B16A16_SFLOAT, half });
+        RGResourceHandle debug = createTransientImage(graph, "Debug view", { VK_FORMAT_R8G8B8A8_UNORM, full });
+        RGResourceHandle backbuffer = importImage(graph, "Backbuffer", VK_NULL_HANDLE, VK_FORMAT_B8G8R8A8_UNORM, presentInitial, presentFinal);
+
+        uint32_t pass = addPass(graph, "G-buffer", noRecord);
+        useResource(graph, pass, albedo, RGUsage::ColorAttachment);
+        useResource(graph, pass, normal, RGUsage::ColorAttachment);
+        useResource(graph, pass, depth, RGUsage::DepthAttachment);
+        pass = addPass(graph, "Lighting", noRecord);
+        useResource(graph, pass, albedo, RGUsage::SampledRead);
+        useResource(graph, pass, normal, RGUsage::SampledRead);
+        useResource(graph, pass, depth, RGUsage::SampledRead);
+        useResource(graph, pass, hdr, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Debug", noRecord);
+        useResource(graph, pass, depth, RGUsage::SampledRead);
+        useResource(graph, pass, debug, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Bloom downsample", noRecord);
+        useResource(graph, pass, hdr, RGUsage::SampledRead);
+        useResource(graph, pass, bloomDown, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Bloom blur", noRecord);
+        useResource(graph, pass, bloomDown, RGUsage::SampledRead);
+        useResource(graph, pass, bloomBlur, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Tonemap", noRecord);
+        useResource(graph, pass, hdr, RGUsage::SampledRead);
+        useResource(graph, pass, bloomBlur, RGUsage::SampledRead);
+        useResource(graph, pass, backbuffer, RGUsage::ColorAttachment);
+
+        // G-buffer 3 +  4 + ² 2 + ģ 2 + ɫӳ 2HDR Ѿɼ+  1
+        ok = checkRenderGraph("deferred", graph, { 1, 6, 14, 0, 6, true }) && ok;
+    }
+
+    // ɼӻƣ֡ãʼ״̬һ֡ʱ״̬
+    {
+        RenderGraph graph;
+        RGResourceHandle particles = importBuffer(graph, "Particles", VK_NULL_HANDLE, true);
+        RGResourceHandle drawArgs = importBuffer(graph, "Draw arguments", VK_NULL_HANDLE, true);
+        RGResourceHandle backbuffer = importImage(graph, "Backbuffer", VK_NULL_HANDLE, VK_FORMAT_B8G8R8A8_UNORM, presentInitial, readbackFinal);
+
+        uint32_t pass = addPass(graph, "Simulate", noRecord);
+        useResource(graph, pass, particles, RGUsage::StorageWrite);
+        pass = addPass(graph, "Build arguments", noRecord);
+        useResource(graph, pass, particles, RGUsage::StorageRead);
+        useResource(graph, pass, drawArgs, RGUsage::StorageWrite);
+        pass = addPass(graph, "Draw particles", noRecord);
+        useResource(graph, pass, particles, RGUsage::IndirectRead);
+        useResource(graph, pass, drawArgs, RGUsage::IndirectRead);
+        useResource(graph, pass, backbuffer, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Draw trails", noRecord);
+        useResource(graph, pass, drawArgs, RGUsage::IndirectRead);
+        useResource(graph, pass, backbuffer, RGUsage::ColorAttachment);
+
+        // ģ⣨һ֡ддɲƣڴ + ֣βддز
+        ok = checkRenderGraph("compute to indirect", graph, { 0, 5, 3, 3, 0, false }) && ok;
+    }
+
+    // ޳ǵдûжߵ˲̬ͼ񶼲ִУҲڴ棻иõĶر
+    {
+        RenderGraph graph;
+        RGResourceHandle target = importImage(graph, "Target", VK_NULL_HANDLE, VK_FORMAT_R8G8B8A8_UNORM, presentInitial, readbackFinal);
+        RGResourceHandle unused = createTransientImage(graph, "Unused", { VK_FORMAT_R8G8B8A8_UNORM, full });
+
+        uint32_t pass = addPass(graph, "Clear", noRecord);
+        useResource(graph, pass, target, RGUsage::TransferWrite);
+        pass = addPass(graph, "Copy", noRecord);
+        useResource(graph, pass, target, RGUsage::TransferWrite);
+        pass = addPass(graph, "Unused output", noRecord);
+        useResource(graph, pass, unused, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Readback", noRecord);
+        useResource(graph, pass, target, RGUsage::TransferRead);
+        setPassSideEffects(graph, pass);
+
+        // غѾ finalState Ĳ֣ʱҪ
+        ok = checkRenderGraph("culling", graph, { 2, 2, 2, 0, 0, false }) && ok;
+    }
+
+    // ִУ;֡˲̬ڴ棺һͼһִдǰҪһִԼĶȡ
+    // ͹ͬһڴ桢ʹõͼĶȡд
+    {
+        RenderGraph graph;
+        RGResourceHandle first = createTransientImage(graph, "First", { VK_FORMAT_R8G8B8A8_UNORM, full });
+        RGResourceHandle second = createTransientImage(graph, "Second", { VK_FORMAT_R8G8B8A8_UNORM, full });
+        RGResourceHandle backbuffer = importImage(graph, "Backbuffer", VK_NULL_HANDLE, VK_FORMAT_B8G8R8A8_UNORM, presentInitial, presentFinal);
+
+        uint32_t firstWrite = addPass(graph, "Draw first", noRecord);
+        useResource(graph, firstWrite, first, RGUsage::ColorAttachment);
+        uint32_t pass = addPass(graph, "Copy first", noRecord);
+        useResource(graph, pass, first, RGUsage::TransferRead);
+        useResource(graph, pass, backbuffer, RGUsage::TransferWrite);
+        pass = addPass(graph, "Draw second", noRecord);
+        useResource(graph, pass, second, RGUsage::ColorAttachment);
+        pass = addPass(graph, "Composite second", noRecord);
+        useResource(graph, pass, second, RGUsage::SampledRead);
+        useResource(graph, pass, backbuffer, RGUsage::ColorAttachment);
+
+        planRenderGraph(graph, estimateRequirements);
+        VkPipelineStageFlags waited = graph.passes[firstWrite].barriers.srcStages;
+        ok = check("transients across executions", graph.resources[second].memoryOffset == graph.resources[first].memoryOffset
+            && (waited & VK_PIPELINE_STAGE_TRANSFER_BIT) != 0 && (waited & VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT) != 0) && ok;
+        destroyRenderGraph(graph);
+    }
+
+    return ok;
+}
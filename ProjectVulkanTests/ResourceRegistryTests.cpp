@@ -0,0 +1,208 @@
+#include "ResourceRegistry.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+// ֻ size Ļ¼û Vulkan ʱ豸
+static GpuBuffer fakeBuffer(VkDeviceSize size) {
+    GpuBuffer buffer;
+    buffer.size = size;
+    return buffer;
+}
+
+bool runResourceRegistryTests() {
+    bool ok = true;
+
+    // ɾмԪغһλȻָԭֵ
+    {
+        DensePool<int> pool;
+        ResourceHandle a = insertPoolItem(pool, 10);
+        ResourceHandle b = insertPoolItem(pool, 20);
+        ResourceHandle c = insertPoolItem(pool, 30);
+        int removed = 0;
+        bool erased = removePoolItem(pool, a, removed) && removed == 10;
+        bool dense = getPoolSize(pool) == 2 && pool.items[0] == 30 && pool.items[1] == 20;
+        bool lookups = getPoolItem(pool, a) == nullptr && *getPoolItem(pool, b) == 20 && *getPoolItem(pool, c) == 30;
+        ok = check("dense removal", erased && dense && lookups && a != INVALID_RESOURCE) && ok;
+    }
+
+    // õĲλһɾ鵽ԴҲɾһ
+    {
+        DensePool<int> pool;
+        ResourceHandle a = insertPoolItem(pool, 1);
+        int removed = 0;
+        removePoolItem(pool, a, removed);
+        ResourceHandle b = insertPoolItem(pool, 2);
+        bool reused = resourceHandleSlot(a) == resourceHandleSlot(b) &&
+            resourceHandleGeneration(b) == resourceHandleGeneration(a) + 1;
+        bool stale = getPoolItem(pool, a) == nullptr && !removePoolItem(pool, a, removed) && *getPoolItem(pool, b) == 2;
+        ok = check("generation on reuse", reused && stale) && ok;
+    }
+
+    // ʱ 0ЧԽĲλ鲻
+    {
+        DensePool<int> pool;
+        insertPoolItem(pool, 1);
+        pool.generations[0] = UINT32_MAX;
+        ResourceHandle a = makeResourceHandle(0, UINT32_MAX);
+        int removed = 0;
+        bool removedMax = removePoolItem(pool, a, removed);
+        ResourceHandle b = insertPoolItem(pool, 2);
+        bool wrapped = removedMax && resourceHandleGeneration(b) == 1 && b != INVALID_RESOURCE;
+        bool invalid = getPoolItem(pool, INVALID_RESOURCE) == nullptr && getPoolItem(pool, makeResourceHandle(7, 1)) == nullptr;
+        ok = check("generation wraparound", wrapped && invalid) && ok;
+    }
+
+    // ɾοӳȽϣλͬʱڵ
+    {
+        DensePool<uint32_t> pool;
+        std::unordered_map<ResourceHandle, uint32_t> live;
+        std::vector<ResourceHandle> handles;
+        std::vector<ResourceHandle> dead;
+        std::mt19937 rng(7);
+        size_t peakLive = 0;
+        bool consistent = true;
+        for (uint32_t i = 0; i < 200000; i++) {
+            if (handles.empty() || rng() % 100 < 52) {
+                ResourceHandle handle = insertPoolItem(pool, i);
+                consistent = consistent && live.count(handle) == 0;
+                live[handle] = i;
+                handles.push_back(handle);
+            }
+            else {
+                size_t pick = rng() % handles.size();
+                ResourceHandle handle = handles[pick];
+                uint32_t value = 0;
+                consistent = consistent && removePoolItem(pool, handle, value) && value == live[handle];
+                live.erase(handle);
+                handles[pick] = handles.back();
+                handles.pop_back();
+                if (dead.size() < 4096) {
+                    dead.push_back(handle);
+                }
+            }
+            peakLive = std::max(peakLive, live.size());
+        }
+        for (const auto& entry : live) {
+            const uint32_t* value = getPoolItem(pool, entry.first);
+            consistent = consistent && value != nullptr && *value == entry.second;
+        }
+        bool staleRejected = true;
+        for (ResourceHandle handle : dead) {
+            staleRejected = staleRejected && (live.count(handle) != 0 || getPoolItem(pool, handle) == nullptr);
+        }
+        bool bounded = getPoolSize(pool) == live.size() && pool.generations.size() == peakLive;
+        ok = check("random churn", consistent && staleRejected && bounded) && ok;
+    }
+
+    // ɾĶڵǰ֡ĶУֱͬһλٴοʼ
+    {
+        ResourceRegistry registry;
+        createResourceRegistry(registry, 3);
+        beginRegistryFrame(registry, 0);
+        std::vector<ResourceHandle> handles;
+        for (uint32_t i = 0; i < 5; i++) {
+            handles.push_back(adoptRegistryBuffer(registry, fakeBuffer(256)));
+        }
+        for (ResourceHandle handle : handles) {
+            destroyRegistryBuffer(registry, handle);
+        }
+        bool invalidated = getRegistryBuffer(registry, handles[0]) == nullptr && !destroyRegistryBuffer(registry, handles[1]);
+        beginRegistryFrame(registry, 1);
+        beginRegistryFrame(registry, 2);
+        bool held = registry.pending == 5 && registry.stats.buffersDestroyed == 0;
+        beginRegistryFrame(registry, 0);
+        bool released = registry.pending == 0 && registry.stats.buffersDestroyed == 5;
+        ok = check("deferred deletion", invalidated && held && released && registry.stats.staleHandles == 2) && ok;
+        destroyResourceRegistry(registry);
+    }
+
+    // ͼް±ͼʱŹ黹ǼǵͷŲͬȵòλٴοʼҲ pending
+    {
+        BindlessTable table;
+        table.stats.textures = 1;
+        ResourceRegistry registry;
+        createResourceRegistry(registry, 2);
+        registry.bindless = &table;
+        beginRegistryFrame(registry, 0);
+        RegisteredImage image;
+        image.bindlessIndex = 7;
+        destroyRegistryImage(registry, adoptRegistryImage(registry, image));
+        uint32_t released = 0;
+        deferRegistryRelease(registry, [&released]() { released++; });
+        beginRegistryFrame(registry, 1);
+        bool held = table.freeTextures.empty() && released == 0 && registry.pending == 1;
+        beginRegistryFrame(registry, 0);
+        bool freed = table.freeTextures.size() == 1 && table.freeTextures[0] == 7 && table.stats.textures == 0 &&
+            released == 1 && registry.pending == 0;
+        ok = check("bindless index and releases wait for the frame", held && freed) && ok;
+        destroyResourceRegistry(registry);
+    }
+
+    // ûٵԴעʱΪй©
+    {
+        ResourceRegistry registry;
+        createResourceRegistry(registry, 2);
+        ResourceHandle kept = adoptRegistryBuffer(registry, fakeBuffer(64));
+        ResourceHandle freed = adoptRegistryBuffer(registry, fakeBuffer(64));
+        adoptRegistryBuffer(registry, fakeBuffer(64));
+        destroyRegistryBuffer(registry, freed);
+        bool live = getRegistryBuffer(registry, kept) != nullptr && registry.pending == 1;
+        destroyResourceRegistry(registry);
+        ok = check("leak accounting", live && registry.stats.leaked == 2 && registry.pending == 0 &&
+            registry.stats.buffersDestroyed == 1) && ok;
+    }
+
+    // ÿ֡ǧԴȴٵĶ󲻳;֡ٵλȶ
+    {
+        const uint32_t frameCount = 3;
+        const uint32_t frames = 1000;
+        const uint32_t perFrame = 4000;
+        ResourceRegistry registry;
+        createResourceRegistry(registry, frameCount);
+        std::vector<ResourceHandle> handles;
+        std::mt19937 rng(11);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            beginRegistryFrame(registry, frame % frameCount);
+            for (uint32_t i = 0; i < perFrame; i++) {
+                handles.push_back(adoptRegistryBuffer(registry, fakeBuffer(256)));
+            }
+            // ȶ״̬± perFrame Դఴ˳
+            while (handles.size() > perFrame) {
+                size_t pick = rng() % handles.size();
+                destroyRegistryBuffer(registry, handles[pick]);
+                handles[pick] = handles.back();
+                handles.pop_back();
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        bool counts = getPoolSize(registry.buffers) == perFrame &&
+            registry.stats.buffersCreated == static_cast<uint64_t>(frames) * perFrame &&
+            registry.stats.buffersDestroyed + registry.pending + perFrame == registry.stats.buffersCreated;
+        uint32_t peakPending = registry.stats.peakPending;
+        bool bounded = peakPending <= frameCount * perFrame &&
+            registry.buffers.generations.size() <= (frameCount + 2) * perFrame &&
+            registry.stats.staleHandles == 0;
+        for (ResourceHandle handle : handles) {
+            destroyRegistryBuffer(registry, handle);
+        }
+        flushRegistryDeletions(registry);
+        bool drained = registry.pending == 0 && registry.stats.buffersDestroyed == registry.stats.buffersCreated;
+        destroyResourceRegistry(registry);
+
+        std::cout << "  " << frames << " frames x " << perFrame << " creates/destroys: "
+            << (seconds > 0.0 ? 2.0 * frames * perFrame / seconds / 1e6 : 0.0) << " M ops/s, peak pending "
+            << peakPending << std::endl;
+        ok = check("frame churn", counts && bounded && drained && registry.stats.leaked == 0) && ok;
+    }
+
+    return ok;
+}
@@ -0,0 +1,181 @@
+#include "Scene.h"
+#include "JobSystem.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// ÿ 4 ʵ壺ӽڵ㡢һӽڵӽڵ㣨 0 ~ 2
+static std::vector<Entity> buildBenchmarkWorld(SceneWorld& world, uint32_t entityCount) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const Bounds unitBounds = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+    std::vector<Entity> roots;
+    uint32_t created = 0;
+    while (created < entityCount) {
+        Entity parent;
+        for (uint32_t k = 0; k < 4 && created < entityCount; k++, created++) {
+            // k = 0 Ϊ1  3 ڸ£2  1 
+            Entity attachTo = k == 0 ? Entity() : (k == 2 ? parent : roots.back());
+            Entity entity = createEntity(world, RENDERABLE_COMPONENTS, attachTo);
+            if (k == 0) {
+                roots.push_back(entity);
+            }
+            if (k == 1) {
+                parent = entity;
+            }
+
+            LocalTransform local;
+            local.position = k == 0 ? Vec3{ position(rng), position(rng) * 0.2f, position(rng) } : Vec3{ unit(rng) * 3.0f, 1.0f, unit(rng) * 3.0f };
+            local.rotation = quatFromAxisAngle({ 0.0f, 1.0f, 0.0f }, unit(rng) * 3.14159f);
+            local.scale = { 1.0f, 1.0f, 1.0f };
+            setLocalTransform(world, entity, local);
+            setMesh(world, entity, created % 3, unitBounds);
+            setMaterial(world, entity, { static_cast<uint16_t>(created % 2), static_cast<uint16_t>((created / 7) % 64) });
+        }
+    }
+    return roots;
+}
+
+static void markAllDirty(SceneWorld& world) {
+    for (const Archetype& archetype : world.archetypes) {
+        for (const SceneChunk& chunk : archetype.chunks) {
+            memset(chunkFlags(archetype, chunk), SceneEntityDirty, chunk.count);
+        }
+    }
+}
+
+// дڵʵ任ڸڵ任Լľֲ任
+static bool validateHierarchy(SceneWorld& world) {
+    for (const Archetype& archetype : world.archetypes) {
+        if (!hasComponent(archetype, SceneComponentParent)) {
+            continue;
+        }
+        for (const SceneChunk& chunk : archetype.chunks) {
+            const Entity* parents = chunkArray<Entity>(archetype, chunk, SceneComponentParent);
+            const LocalTransform* locals = chunkArray<LocalTransform>(archetype, chunk, SceneComponentLocalTransform);
+            const Mat4* worlds = chunkArray<Mat4>(archetype, chunk, SceneComponentWorldTransform);
+
+            for (uint32_t row = 0; row < chunk.count; row++) {
+                const Mat4* parentWorld = getWorldTransform(world, parents[row]);
+                if (parentWorld == nullptr) {
+                    return false;
+                }
+                Mat4 expected = mat4Multiply(*parentWorld, mat4FromTransform(locals[row].position, locals[row].rotation, locals[row].scale));
+                for (int k = 0; k < 16; k++) {
+                    if (std::fabs(expected.m[k] - worlds[row].m[k]) > 1e-3f * std::max(1.0f, std::fabs(expected.m[k]))) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// setup ʱֻ fn
+template <typename Setup, typename Fn>
+static double medianMs(uint32_t repeats, Setup setup, Fn fn) {
+    std::vector<double> samples;
+    for (uint32_t i = 0; i < repeats; i++) {
+        setup();
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+bool runSceneTests() {
+    const uint32_t entityCounts[] = { 10000, 100000, 1000000 };
+    bool ok = true;
+
+    // ȡزʣߺȲӰ
+    SceneDraw keyed = { makeDrawSortKey({ 0x1ff, 0xbeef }, 123.5f), 0, 0 };
+    ok = check("sort key keeps the material", getDrawMaterial(keyed) == 0xbeef) && ok;
+
+    Mat4 viewProjection = mat4Multiply(mat4Perspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f),
+        mat4LookAt({ 0.0f, 80.0f, 300.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }));
+
+    // Ӧͬһ߳Ӳ߳߳Ҳִ
+    JobSystem jobs;
+    createJobSystem(jobs, std::max(1u, std::thread::hardware_concurrency()) - 1);
+
+    std::vector<JobSystem*> variants = { nullptr };
+    if (getJobThreadCount(jobs) > 1) {
+        variants.push_back(&jobs);
+    }
+
+    std::cout << "Scene benchmark: " << SCENE_CHUNK_BYTES / 1024 << " KB chunks" << std::endl;
+    std::cout << "  entities  threads  update all ms  update 1% ms  extract ms  visible" << std::endl;
+
+    for (uint32_t entityCount : entityCounts) {
+        SceneWorld world;
+        std::vector<Entity> roots = buildBenchmarkWorld(world, entityCount);
+        updateSceneTransforms(world, nullptr);
+        bool valid = validateHierarchy(world);
+
+        uint32_t repeats = std::max(3u, 200000u / entityCount);
+        uint32_t moved = static_cast<uint32_t>(roots.size() / 100 + 1);
+        uint32_t round = 0;
+        SceneDrawList drawList;
+
+        for (JobSystem* variant : variants) {
+            SceneUpdateStats stats;
+            double updateAllMs = medianMs(repeats, [&]() { markAllDirty(world); }, [&]() {
+                stats = updateSceneTransforms(world, variant);
+            });
+            valid = valid && stats.updated == entityCount;
+
+            // ƶ 1% ĸڵ㣨ֻͬǺǵҪ
+            double updatePartialMs = medianMs(repeats, [&]() {
+                updateSceneTransforms(world, nullptr);  // һֵ WorldChanged
+                for (uint32_t i = 0; i < moved; i++) {
+                    Entity root = roots[(static_cast<size_t>(i + round) * 7919u) % roots.size()];
+                    LocalTransform local = *static_cast<LocalTransform*>(getComponent(world, root, SceneComponentLocalTransform));
+                    local.position.y += (round & 1) ? -0.01f : 0.01f;
+                    setLocalTransform(world, root, local);
+                }
+                round++;
+            }, [&]() {
+                stats = updateSceneTransforms(world, variant);
+            });
+            valid = valid && stats.updated == moved * 4;
+
+            double extractMs = medianMs(repeats, []() {}, [&]() {
+                extractSceneDraws(world, viewProjection, true, variant, drawList);
+            });
+
+            valid = valid && validateHierarchy(world) && drawList.draws.size() + drawList.culled == entityCount;
+            for (size_t i = 1; i < drawList.draws.size() && valid; i++) {
+                valid = drawList.draws[i - 1].sortKey <= drawList.draws[i].sortKey;
+            }
+
+            std::cout << std::fixed << std::setprecision(3)
+                << "  " << std::setw(8) << entityCount << "  "
+                << std::setw(7) << (variant != nullptr ? getJobThreadCount(*variant) : 1) << "  "
+                << std::setw(13) << updateAllMs << "  "
+                << std::setw(12) << updatePartialMs << "  "
+                << std::setw(10) << extractMs << "  "
+                << std::setw(7) << drawList.draws.size() << std::endl;
+            std::cout << std::defaultfloat;
+        }
+
+        if (!valid) {
+            std::cout << "  FAILED: world transforms, update counts or draw order are inconsistent" << std::endl;
+        }
+        ok = ok && valid;
+    }
+
+    destroyJobSystem(jobs);
+    return ok;
+}
@@ -0,0 +1,132 @@
+#include "SimdMath.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+// ظ fnصεúʱλ룩
+template <typename Fn>
+static double measureMs(uint32_t repeats, Fn fn) {
+    std::vector<double> samples;
+    for (uint32_t i = 0; i < repeats; i++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+static void printBenchmarkRow(uint32_t count, const char* kernel, double scalarMs, double simdMs, bool match) {
+    std::cout << std::fixed << std::setprecision(3) << std::left
+        << "  " << std::setw(7) << count << "  " << std::setw(16) << kernel << std::right
+        << std::setw(10) << scalarMs << "  " << std::setw(8) << simdMs << "  "
+        << std::setw(6) << std::setprecision(2) << (simdMs > 0.0 ? scalarMs / simdMs : 0.0) << "x"
+        << (match ? "" : "  MISMATCH") << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+// һ£FMA ֿĳ˼벻ͬ
+static bool nearlyEqual(float a, float b) {
+    return std::fabs(a - b) <= 1e-4f * std::max(1.0f, std::max(std::fabs(a), std::fabs(b)));
+}
+
+// õǰѡں汾Ƚϲʱ
+static bool benchmarkSimdKernels() {
+    const uint32_t objectCounts[] = { 1000, 10000, 100000 };
+    bool ok = true;
+
+    std::cout << "Math benchmark: " << getSimdMathIsa() << " (" << getSimdMathWidth() << " objects per iteration)" << std::endl;
+    std::cout << "  objects  kernel             scalar ms   SIMD ms  speedup" << std::endl;
+
+    Mat4 viewProjection = mat4Multiply(mat4Perspective(1.0f, 16.0f / 9.0f, 0.1f, 500.0f),
+        mat4LookAt({ 0.0f, 20.0f, 60.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }));
+    float planes[6][4];
+    extractFrustumPlanes(viewProjection, planes);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+
+    for (uint32_t count : objectCounts) {
+        TransformSoA transforms;
+        AabbSoA local;
+        resizeTransforms(transforms, count);
+        resizeAabbs(local, count);
+        for (uint32_t i = 0; i < count; i++) {
+            Quat rotation = quatNormalize({ unit(rng), unit(rng), unit(rng), unit(rng) });
+            setTransform(transforms, i, { position(rng), position(rng) * 0.1f, position(rng) }, rotation, { scale(rng), scale(rng), scale(rng) });
+            local.centerX[i] = unit(rng);
+            local.centerY[i] = unit(rng);
+            local.centerZ[i] = unit(rng);
+            local.extentX[i] = std::fabs(unit(rng)) + 0.1f;
+            local.extentY[i] = std::fabs(unit(rng)) + 0.1f;
+            local.extentZ[i] = std::fabs(unit(rng)) + 0.1f;
+        }
+
+        // ÿںܹԼ 200 
+        uint32_t repeats = std::max(5u, 2000000u / count);
+
+        std::vector<Mat4> scalarMvp(count), simdMvp(count);
+        double scalarMs = measureMs(repeats, [&]() { batchModelViewProjectionScalar(viewProjection, transforms, scalarMvp.data()); });
+        double simdMs = measureMs(repeats, [&]() { batchModelViewProjection(viewProjection, transforms, simdMvp.data()); });
+        bool match = true;
+        for (uint32_t i = 0; i < count && match; i++) {
+            for (int k = 0; k < 16 && match; k++) {
+                match = nearlyEqual(scalarMvp[i].m[k], simdMvp[i].m[k]);
+            }
+        }
+        printBenchmarkRow(count, "MVP", scalarMs, simdMs, match);
+        ok = ok && match;
+
+        AabbSoA scalarWorld, simdWorld;
+        resizeAabbs(scalarWorld, count);
+        resizeAabbs(simdWorld, count);
+        scalarMs = measureMs(repeats, [&]() { batchTransformAabbsScalar(transforms, local, scalarWorld); });
+        simdMs = measureMs(repeats, [&]() { batchTransformAabbs(transforms, local, simdWorld); });
+        match = true;
+        for (uint32_t i = 0; i < count && match; i++) {
+            match = nearlyEqual(scalarWorld.centerX[i], simdWorld.centerX[i]) && nearlyEqual(scalarWorld.centerY[i], simdWorld.centerY[i])
+                && nearlyEqual(scalarWorld.centerZ[i], simdWorld.centerZ[i]) && nearlyEqual(scalarWorld.extentX[i], simdWorld.extentX[i])
+                && nearlyEqual(scalarWorld.extentY[i], simdWorld.extentY[i]) && nearlyEqual(scalarWorld.extentZ[i], simdWorld.extentZ[i]);
+        }
+        printBenchmarkRow(count, "AABB transform", scalarMs, simdMs, match);
+        ok = ok && match;
+
+        // ޳߶ʹñ汾ΧУֻȽϲԱ
+        std::vector<uint8_t> scalarVisible(count), simdVisible(count);
+        uint32_t scalarCount = 0, simdCount = 0;
+        scalarMs = measureMs(repeats, [&]() { scalarCount = batchFrustumTestScalar(planes, scalarWorld, scalarVisible.data()); });
+        simdMs = measureMs(repeats, [&]() { simdCount = batchFrustumTest(planes, scalarWorld, simdVisible.data()); });
+
+        // ǡƽϵ벻֮ͬͬһ
+        uint32_t mismatches = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            mismatches += scalarVisible[i] != simdVisible[i] ? 1 : 0;
+        }
+        match = mismatches <= count / 10000 && (scalarCount > simdCount ? scalarCount - simdCount : simdCount - scalarCount) == mismatches;
+        printBenchmarkRow(count, "Frustum test", scalarMs, simdMs, match);
+        std::cout << "           " << simdCount << "/" << count << " visible" << std::endl;
+        ok = ok && match;
+    }
+
+    return ok;
+}
+
+bool runSimdMathTests() {
+    bool ok = benchmarkSimdKernels();
+
+    // ʱѡ AVX2 ʱں˲ᱻõУһ
+    if (isSimdMathAvx2Supported()) {
+        setSimdMathAvx2Enabled(false);
+        ok = benchmarkSimdKernels() && ok;
+        setSimdMathAvx2Enabled(true);
+    }
+    return ok;
+}
@@ -0,0 +1,104 @@
+#include "Streaming.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <iostream>
+
+// ֻ׼õֶΣ״̬ͽĴСΪ width * height * 4 ֽڣݴռð 16 ֽڶ
+static AssetHandle addStagedTexture(std::vector<std::unique_ptr<StreamedAsset>>& assets, std::deque<AssetHandle>& staged,
+    uint32_t size, AssetState state) {
+    std::unique_ptr<StreamedAsset> asset(new StreamedAsset());
+    asset->kind = AssetKind::Texture;
+    asset->state = state;
+    asset->width = size;
+    asset->height = size;
+    asset->stagingBytes = (static_cast<VkDeviceSize>(size) * size * 4 + 15) / 16 * 16;
+
+    AssetHandle handle = static_cast<AssetHandle>(assets.size());
+    assets.push_back(std::move(asset));
+    staged.push_back(handle);
+    return handle;
+}
+
+//  pumpStreaming һ֡׼벢ӣֱΪգÿ֡ϴֽԴ
+static void drainStaged(std::vector<std::unique_ptr<StreamedAsset>>& assets, std::deque<AssetHandle>& staged, VkDeviceSize frameBudget,
+    std::vector<VkDeviceSize>& frameBytes, std::vector<size_t>& frameUploads) {
+    while (!staged.empty()) {
+        StreamingAdmission admission;
+        admitStagedUploads(staged, assets, frameBudget, admission);
+        if (admission.consumed == 0) {
+            break;
+        }
+        staged.erase(staged.begin(), staged.begin() + admission.consumed);
+        for (AssetHandle handle : admission.uploads) {
+            assets[handle]->state = AssetState::Ready;
+        }
+        frameBytes.push_back(admission.frameBytes);
+        frameUploads.push_back(admission.uploads.size());
+    }
+}
+
+bool runStreamingTests() {
+    const VkDeviceSize budget = 64 * 1024;
+    bool ok = true;
+
+    // ʮ 16 KB  64 KB Ԥ·֡ϴԤʱһ֡ͻȫύ
+    {
+        std::vector<std::unique_ptr<StreamedAsset>> assets;
+        std::deque<AssetHandle> staged;
+        for (uint32_t i = 0; i < 10; i++) {
+            addStagedTexture(assets, staged, 64, AssetState::Staged);
+        }
+
+        std::vector<VkDeviceSize> frameBytes;
+        std::vector<size_t> frameUploads;
+        drainStaged(assets, staged, budget, frameBytes, frameUploads);
+
+        bool withinBudget = frameBytes.size() == 3 && frameUploads[0] == 4 && frameUploads[1] == 4 && frameUploads[2] == 2;
+        for (size_t i = 0; i < frameBytes.size(); i++) {
+            withinBudget = withinBudget && frameBytes[i] <= budget
+                && !isStreamingFrameOverBudget(frameBytes[i], frameUploads[i], budget);
+        }
+        ok &= check("uploads are spread over frames within the budget", withinBudget);
+    }
+
+    // ʧܵԴϴݴռͬһ֡ӣڽԴסѾõԴ
+    {
+        std::vector<std::unique_ptr<StreamedAsset>> assets;
+        std::deque<AssetHandle> staged;
+        AssetHandle first = addStagedTexture(assets, staged, 64, AssetState::Staged);
+        addStagedTexture(assets, staged, 64, AssetState::Failed);
+        addStagedTexture(assets, staged, 64, AssetState::Decoding);
+        addStagedTexture(assets, staged, 64, AssetState::Staged);
+
+        StreamingAdmission admission;
+        admitStagedUploads(staged, assets, budget, admission);
+        ok &= check("failed assets release staging in order, decoding assets block", admission.consumed == 2
+            && admission.uploads.size() == 1 && admission.uploads[0] == first
+            && admission.frameBytes == 16 * 1024 && admission.stagingBytes == 2 * 16 * 1024 && !admission.oversized);
+    }
+
+    // ԤԴǰԴϴռһ֮֡Դ˳ӵһ֡
+    {
+        std::vector<std::unique_ptr<StreamedAsset>> assets;
+        std::deque<AssetHandle> staged;
+        addStagedTexture(assets, staged, 64, AssetState::Staged);
+        addStagedTexture(assets, staged, 256, AssetState::Staged);
+        addStagedTexture(assets, staged, 64, AssetState::Staged);
+
+        StreamingAdmission admission;
+        admitStagedUploads(staged, assets, budget, admission);
+        bool waits = admission.uploads.size() == 1 && !admission.oversized;
+        staged.erase(staged.begin(), staged.begin() + admission.consumed);
+        admitStagedUploads(staged, assets, budget, admission);
+        bool alone = admission.uploads.size() == 1 && admission.oversized && admission.frameBytes == 256 * 1024;
+        ok &= check("an oversized asset takes a frame of its own", waits && alone
+            && !isStreamingFrameOverBudget(admission.frameBytes, admission.uploads.size(), budget));
+    }
+
+    // ¼ֽļ飺ԴԳԤ㣬ԴϼƳʱԤ
+    ok &= check("recorded bytes over budget are reported", isStreamingFrameOverBudget(budget + 1, 2, budget)
+        && !isStreamingFrameOverBudget(budget, 8, budget) && !isStreamingFrameOverBudget(4 * budget, 1, budget));
+
+    return ok;
+}
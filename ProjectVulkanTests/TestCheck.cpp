@@ -0,0 +1,8 @@
+#include "TestCheck.h"
+
+#include <iostream>
+
+bool check(const char* name, bool condition) {
+    std::cout << "[" << (condition ? "PASS" : "FAIL") << "] " << name << std::endl;
+    return condition;
+}
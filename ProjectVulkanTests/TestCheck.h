@@ -0,0 +1,4 @@
+#pragma once
+
+// һ [PASS] / [FAIL] ͼƣ conditionд ok = check(...) && okʧܺ
+bool check(const char* name, bool condition);
@@ -0,0 +1,18 @@
+#include "MemoryAllocator.h"
+#include "VulkanContext.h"
+
+#include <stdexcept>
+
+// ģõȫֶӦ main.cpp 壩Բʵ豸
+// Щ󱣳Ϊգֻò豸ĺ
+VkInstance instance = VK_NULL_HANDLE;
+VkDevice device = VK_NULL_HANDLE;
+VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+VkQueue graphicsQueue = VK_NULL_HANDLE;
+VkRenderPass renderPass = VK_NULL_HANDLE;
+VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+GpuAllocator gpuAllocator;
+
+uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
+    throw std::runtime_error("tests run without a device!");
+}
@@ -0,0 +1,66 @@
+#include "Tests.h"
+
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+struct TestSuite {
+    const char* name;
+    bool (*run)();
+};
+
+static const TestSuite testSuites[] = {
+    { "render-graph", runRenderGraphTests },
+    { "uniform-ring", runUniformRingTests },
+    { "simd-math", runSimdMathTests },
+    { "scene", runSceneTests },
+    { "mesh-processing", runMeshProcessingTests },
+    { "readback", runReadbackTests },
+    { "textures", runTextureTests },
+    { "streaming", runStreamingTests },
+    { "resource-registry", runResourceRegistryTests },
+};
+
+// ʱȫԣֻͬĲԡвʧʱ 1
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        bool known = false;
+        for (const TestSuite& suite : testSuites) {
+            known = known || strcmp(argv[i], suite.name) == 0;
+        }
+        if (!known) {
+            std::cerr << "Unknown test: " << argv[i] << "\nAvailable tests:";
+            for (const TestSuite& suite : testSuites) {
+                std::cerr << " " << suite.name;
+            }
+            std::cerr << std::endl;
+            return 1;
+        }
+    }
+
+    uint32_t failed = 0;
+    uint32_t run = 0;
+    for (const TestSuite& suite : testSuites) {
+        bool selected = argc == 1;
+        for (int i = 1; i < argc; i++) {
+            selected = selected || strcmp(argv[i], suite.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        std::cout << "== " << suite.name << std::endl;
+        bool ok = false;
+        try {
+            ok = suite.run();
+        }
+        catch (const std::exception& e) {
+            std::cout << "[FAIL] " << suite.name << " threw: " << e.what() << std::endl;
+        }
+        failed += ok ? 0 : 1;
+        run++;
+    }
+
+    std::cout << (run - failed) << "/" << run << " test suites passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
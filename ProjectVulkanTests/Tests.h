@@ -0,0 +1,30 @@
+#pragma once
+
+// ģ鲻Ҫ豸Ĳԣȫͨʱ true
+
+// ʾͼ޳˲̬ͼڴ
+bool runRenderGraphTests();
+
+// Ķ롢ƺͲḲ;֡
+bool runUniformRingTests();
+
+// SIMD 汾任Χк׶Խһ£ߵĺʱ
+bool runSimdMathTests();
+
+// 㼶任¼ͻ򣨵̺̳߳߳ϲУһʵڵĺʱ
+bool runSceneTests();
+
+// 򻯵Ͻ硢㻺Ͷȡ˳Żmeshlet ޺ͰΧ׶LOD ѡ
+bool runMeshProcessingTests();
+
+// PNG ѹУ͡EXR ͷͰ뾫ת
+bool runReadbackTests();
+
+// KTX2 Сʹ÷פԤ滮
+bool runTextureTests();
+
+// ʽÿ֡ϴ׼룺Ԥ㡢ʧܺڽԴԤԴ
+bool runStreamingTests();
+
+// صĽԡλúɾеӳ
+bool runResourceRegistryTests();
@@ -0,0 +1,204 @@
+#include "Textures.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+// ֻԤ滮õֶΣߴ硢ֽβͷ
+static ManagedTexture makeTestTexture(uint32_t size, VkFormat format) {
+    ManagedTexture texture;
+    texture.format = format;
+    getFormatBlockInfo(format, texture.block);
+    texture.width = size;
+    texture.height = size;
+    texture.levelCount = getTextureMipCount(size, size);
+    for (uint32_t level = 0; level < texture.levelCount; level++) {
+        texture.levelBytes[level] = getTextureLevelBytes(texture.block, size, size, level);
+    }
+    texture.tailMip = getTextureTailMip(size, size, texture.levelCount);
+    texture.residentMip = texture.levelCount;
+    return texture;
+}
+
+static void appendBytes(std::vector<uint8_t>& out, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+// С KTX2 ļû DFD ͼֵԣСڼ֮
+static std::vector<uint8_t> makeTestKtx2(VkFormat format, uint32_t width, uint32_t height, uint32_t levelCount) {
+    FormatBlockInfo block;
+    getFormatBlockInfo(format, block);
+
+    Ktx2Header header = {};
+    memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat = format;
+    header.typeSize = 1;
+    header.pixelWidth = width;
+    header.pixelHeight = height;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+
+    uint32_t levels = std::max(levelCount, 1u);
+    std::vector<Ktx2LevelIndex> index(levels);
+    uint64_t offset = sizeof(header) + levels * sizeof(Ktx2LevelIndex);
+    for (uint32_t level = levels; level-- > 0;) {
+        index[level].byteOffset = offset;
+        index[level].byteLength = getTextureLevelBytes(block, width, height, level);
+        index[level].uncompressedByteLength = index[level].byteLength;
+        offset += index[level].byteLength;
+    }
+
+    std::vector<uint8_t> file;
+    appendBytes(file, &header, sizeof(header));
+    appendBytes(file, index.data(), index.size() * sizeof(Ktx2LevelIndex));
+    file.resize(static_cast<size_t>(offset), 0x5A);
+    return file;
+}
+
+static VkDeviceSize plannedBytes(const std::vector<ManagedTexture>& textures) {
+    VkDeviceSize bytes = 0;
+    for (const ManagedTexture& texture : textures) {
+        bytes += getTextureBytesFrom(texture, texture.targetMip);
+    }
+    return bytes;
+}
+
+bool runTextureTests() {
+    bool ok = true;
+
+    FormatBlockInfo bc1, bc7, astc, rgba;
+    ok &= check("format: block sizes", getFormatBlockInfo(VK_FORMAT_BC1_RGBA_SRGB_BLOCK, bc1) && bc1.bytes == 8 && bc1.width == 4
+        && getFormatBlockInfo(VK_FORMAT_BC7_UNORM_BLOCK, bc7) && bc7.bytes == 16
+        && getFormatBlockInfo(VK_FORMAT_ASTC_10x8_SRGB_BLOCK, astc) && astc.width == 10 && astc.height == 8 && astc.bytes == 16
+        && getFormatBlockInfo(VK_FORMAT_R8G8B8A8_UNORM, rgba) && rgba.bytes == 4 && !rgba.compressed
+        && !getFormatBlockInfo(VK_FORMAT_D32_SFLOAT, rgba));
+    getFormatBlockInfo(VK_FORMAT_R8G8B8A8_UNORM, rgba);
+    ok &= check("format: level sizes round up to whole blocks", getTextureLevelBytes(bc1, 256, 256, 0) == 64 * 64 * 8
+        && getTextureLevelBytes(bc1, 256, 256, 7) == 8 && getTextureLevelBytes(bc1, 256, 256, 8) == 8
+        && getTextureLevelBytes(astc, 100, 100, 0) == 10 * 13 * 16 && getTextureLevelBytes(rgba, 5, 3, 1) == 2 * 1 * 4);
+
+    std::vector<uint8_t> file = makeTestKtx2(VK_FORMAT_BC1_RGB_UNORM_BLOCK, 256, 128, 9);
+    Ktx2Info info;
+    std::string error;
+    bool parsed = parseKtx2(file.data(), file.size(), info, error);
+    ok &= check("ktx2: parse BC1 mip chain", parsed && info.format == VK_FORMAT_BC1_RGB_UNORM_BLOCK && info.width == 256
+        && info.height == 128 && info.levelCount == 9 && !info.generateMips && info.levels[0].size == 64 * 32 * 8
+        && info.levels[8].offset == sizeof(Ktx2Header) + 9 * sizeof(Ktx2LevelIndex));
+
+    std::vector<uint8_t> single = makeTestKtx2(VK_FORMAT_R8G8B8A8_SRGB, 64, 64, 0);
+    ok &= check("ktx2: levelCount 0 requests mip generation", parseKtx2(single.data(), single.size(), info, error)
+        && info.generateMips && info.levelCount == 1 && info.levels[0].size == 64 * 64 * 4);
+
+    std::vector<uint8_t> truncated(file.begin(), file.end() - 1);
+    std::vector<uint8_t> badMagic = file;
+    badMagic[1] = 'X';
+    std::vector<uint8_t> tooMany = makeTestKtx2(VK_FORMAT_BC7_UNORM_BLOCK, 16, 16, 5);
+    tooMany[offsetof(Ktx2Header, levelCount)] = 6;
+    std::vector<uint8_t> supercompressed = file;
+    supercompressed[offsetof(Ktx2Header, supercompressionScheme)] = 2;
+    ok &= check("ktx2: reject truncated, foreign and inconsistent files", !parseKtx2(truncated.data(), truncated.size(), info, error)
+        && !parseKtx2(badMagic.data(), badMagic.size(), info, error) && !parseKtx2(tooMany.data(), tooMany.size(), info, error)
+        && !parseKtx2(supercompressed.data(), supercompressed.size(), info, error) && !parseKtx2(file.data(), 40, info, error));
+
+    ok &= check("feedback: mip from screen footprint", textureMipForFootprint(1024, 1024, 1024.0f) == 0
+        && textureMipForFootprint(1024, 1024, 2048.0f) == 0 && textureMipForFootprint(1024, 512, 256.0f) == 2
+        && textureMipForFootprint(1024, 1024, 300.0f) == 1 && textureMipForFootprint(1024, 1024, 0.0f) == 10);
+
+    // ϸЧֵȹںЧʱ䲻˻β
+    TextureManager manager;
+    manager.textures.push_back(makeTestTexture(1024, VK_FORMAT_BC7_UNORM_BLOCK));
+    ManagedTexture& hysteresis = manager.textures[0];
+    reportTextureUsage(manager, 0, 256.0f, 100);
+    bool coarseFirst = hysteresis.requestedMip == 2;
+    reportTextureUsage(manager, 0, 1024.0f, 101);
+    bool finer = hysteresis.requestedMip == 0;
+    reportTextureUsage(manager, 0, 128.0f, 110);
+    bool held = hysteresis.requestedMip == 0;
+    reportTextureUsage(manager, 0, 128.0f, 101 + TEXTURE_FEEDBACK_FRAMES);
+    bool expired = hysteresis.requestedMip == 3;
+    bool tail = getWantedTextureMip(hysteresis, 101 + 2 * TEXTURE_FEEDBACK_FRAMES) == hysteresis.tailMip;
+    ok &= check("feedback: finer requests win, coarser ones wait, unused textures drop to the tail",
+        coarseFirst && finer && held && expired && tail && hysteresis.tailMip == 4);
+
+    // Ԥ㣺˸ 1024  BC7 Ҫ 0 Լ 1.33 MBԤֻһ
+    std::vector<ManagedTexture> textures;
+    for (uint32_t i = 0; i < 8; i++) {
+        textures.push_back(makeTestTexture(1024, VK_FORMAT_BC7_UNORM_BLOCK));
+        textures.back().used = true;
+        textures.back().requestedMip = 0;
+        textures.back().lastUsedFrame = 1000 - (i < 4 ? 0 : 10);   // ĸϾûʹ
+    }
+    textures.push_back(makeTestTexture(2048, VK_FORMAT_R8G8B8A8_UNORM));   // ûʹãֻβ
+
+    VkDeviceSize unlimited = planTextureResidency(textures, 1000, ~0ull);
+    bool allFull = true;
+    for (uint32_t i = 0; i < 8; i++) {
+        allFull &= textures[i].targetMip == 0;
+    }
+    ok &= check("budget: everything fits without pressure", allFull && textures[8].targetMip == textures[8].tailMip
+        && unlimited == plannedBytes(textures));
+
+    VkDeviceSize budget = 6 * 1024 * 1024;
+    VkDeviceSize planned = planTextureResidency(textures, 1000, budget);
+    bool recentKept = true;
+    bool staleDropped = true;
+    bool tailsKept = true;
+    for (uint32_t i = 0; i < 8; i++) {
+        if (i < 4) {
+            recentKept &= textures[i].targetMip == 0;
+        }
+        else {
+            staleDropped &= textures[i].targetMip > 0;
+        }
+        tailsKept &= textures[i].targetMip <= textures[i].tailMip;
+    }
+    ok &= check("budget: least recently used textures lose detail first", planned <= budget && planned == plannedBytes(textures)
+        && recentKept && staleDropped && tailsKept);
+
+    // ͬʱ͵ϸһľһ
+    for (ManagedTexture& texture : textures) {
+        texture.lastUsedFrame = 1000;
+    }
+    planned = planTextureResidency(textures, 1000, 3 * 1024 * 1024);
+    uint32_t finest = UINT32_MAX;
+    uint32_t coarsest = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+        finest = std::min(finest, textures[i].targetMip);
+        coarsest = std::max(coarsest, textures[i].targetMip);
+    }
+    ok &= check("budget: equally recent textures are reduced evenly", planned <= 3 * 1024 * 1024 && coarsest - finest <= 1);
+
+    // ԤСڳפֻ֣ܽβĲֱ
+    planned = planTextureResidency(textures, 1000, 1024);
+    bool allTails = true;
+    VkDeviceSize pinned = 0;
+    for (const ManagedTexture& texture : textures) {
+        allTails &= texture.targetMip == texture.tailMip;
+        pinned += getTextureBytesFrom(texture, texture.tailMip);
+    }
+    ok &= check("budget: pinned tails are never evicted", allTails && planned == pinned && planned > 1024);
+
+    // Generated פԤ㣺ռõֽڴ KTX2 õĲп۳
+    std::vector<ManagedTexture> mixed;
+    for (uint32_t i = 0; i < 2; i++) {
+        mixed.push_back(makeTestTexture(1024, VK_FORMAT_BC7_UNORM_BLOCK));
+        mixed.back().used = true;
+        mixed.back().lastUsedFrame = 1000;
+    }
+    mixed.push_back(makeTestTexture(1024, VK_FORMAT_R8G8B8A8_UNORM));
+    mixed.back().source = TextureSource::Generated;
+    mixed.back().tailMip = 0;
+    VkDeviceSize generatedBytes = getTextureBytesFrom(mixed.back(), 0);
+    VkDeviceSize ktx2Full = getTextureBytesFrom(mixed[0], 0);
+    budget = generatedBytes + ktx2Full;
+    planned = planTextureResidency(mixed, 1000, budget);
+    ok &= check("budget: generated textures are pinned but counted", mixed[2].targetMip == 0 && planned <= budget
+        && planned == plannedBytes(mixed) && mixed[0].targetMip + mixed[1].targetMip > 0);
+
+    std::cout << (ok ? "All texture tests passed" : "Some texture tests FAILED") << std::endl;
+    return ok;
+}
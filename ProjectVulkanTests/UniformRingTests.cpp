@@ -0,0 +1,139 @@
+#include "UniformRing.h"
+#include "TestCheck.h"
+#include "Tests.h"
+
+#include <cstring>
+#include <iostream>
+#include <random>
+
+// [offset, offset + size) Ƿص
+static bool rangesOverlap(VkDeviceSize a, VkDeviceSize aSize, VkDeviceSize b, VkDeviceSize bSize) {
+    return a < b + bSize && b < a + aSize;
+}
+
+bool runUniformRingTests() {
+    bool ok = true;
+
+    // 룺СķҲռһ뵥λ
+    {
+        UniformRing ring;
+        initUniformRingState(ring, 1024, 256, 512, 2);
+        VkDeviceSize a = 0, b = 0;
+        bool allocated = allocateUniformRing(ring, 10, a) && allocateUniformRing(ring, 10, b);
+        ok = check("alignment", allocated && a == 0 && b == 256 && ring.used == 266) && ok;
+    }
+
+    // ƣβŲʱ 0 ʼβĿռڵǰ֡ϣʱֻһ֡;Ḳ
+    {
+        UniformRing ring;
+        initUniformRingState(ring, 1024, 256, 512, 2);
+        VkDeviceSize offset = 0;
+        beginUniformRingFrame(ring, 0);
+        bool frame0 = allocateUniformRing(ring, 512, offset) && offset == 0;
+        beginUniformRingFrame(ring, 1);
+        bool frame1 = allocateUniformRing(ring, 256, offset) && offset == 512;
+        beginUniformRingFrame(ring, 0);
+        bool wrapped = allocateUniformRing(ring, 512, offset) && offset == 0 && ring.stats.wraps == 1;
+        ok = check("wraparound", frame0 && frame1 && wrapped && ring.used == 1024) && ok;
+
+        // ֡ 1  [512, 768) ;κη䶼ʧ
+        bool full = !allocateUniformRing(ring, 16, offset) && ring.stats.overruns == 1;
+        ok = check("overrun guard", full) && ok;
+
+        // ֡ 1 ɺĿռԸ
+        beginUniformRingFrame(ring, 1);
+        bool reused = allocateUniformRing(ring, 256, offset) && offset == 512;
+        ok = check("reuse after retire", reused) && ok;
+    }
+
+    // Χķ޷ö̬ƫƷ
+    {
+        UniformRing ring;
+        initUniformRingState(ring, 4096, 256, 512, 2);
+        VkDeviceSize offset = 0;
+        ok = check("range limit", !allocateUniformRing(ring, 513, offset) && allocateUniformRing(ring, 512, offset)) && ok;
+    }
+
+    // ͳֵ pushConstantSize ֱͣռûд뻷ض̬ƫ
+    {
+        UniformRing ring;
+        initUniformRingState(ring, 4096, 256, 512, 2);
+        std::vector<uint8_t> memory(static_cast<size_t>(ring.size + ring.range));
+        ring.mapped = memory.data();
+
+        float constants[32];
+        for (uint32_t i = 0; i < 32; i++) {
+            constants[i] = static_cast<float>(i);
+        }
+
+        bool push = false;
+        uint32_t dynamicOffset = UINT32_MAX;
+        bool atLimit = prepareDrawConstants(ring, 16, constants, 16, push, dynamicOffset)
+            && push && ring.stats.pushes == 1 && ring.stats.allocations == 0 && ring.used == 0;
+        ok = check("push at the size limit", atLimit) && ok;
+
+        bool aboveLimit = prepareDrawConstants(ring, 16, constants, 20, push, dynamicOffset)
+            && !push && dynamicOffset == 0 && ring.stats.pushes == 1 && ring.stats.allocations == 1
+            && memcmp(memory.data(), constants, 20) == 0;
+        ok = check("ring above the size limit", aboveLimit) && ok;
+
+        bool noPushBlock = prepareDrawConstants(ring, 0, constants, sizeof(constants), push, dynamicOffset)
+            && !push && dynamicOffset == 256 && memcmp(memory.data() + 256, constants, sizeof(constants)) == 0;
+        ok = check("ring without push constants", noPushBlock) && ok;
+
+        // ʱȻɹд뻷ʧ
+        initUniformRingState(ring, 512, 256, 512, 2);
+        VkDeviceSize offset = 0;
+        bool filled = allocateUniformRing(ring, 512, offset);
+        bool pushWhenFull = prepareDrawConstants(ring, 16, constants, 16, push, dynamicOffset) && push;
+        bool ringWhenFull = !prepareDrawConstants(ring, 16, constants, 64, push, dynamicOffset) && ring.stats.overruns == 1;
+        ok = check("push unaffected by a full ring", filled && pushWhenFull && ringWhenFull) && ok;
+    }
+
+    // أ3 ֡;ÿη䶼;֡صҲԽβ
+    {
+        const uint32_t frameCount = 3;
+        UniformRing ring;
+        initUniformRingState(ring, 64 * 1024, 256, 4096, frameCount);
+
+        struct Range { VkDeviceSize offset, size; };
+        std::vector<std::vector<Range>> live(frameCount);
+        std::mt19937 rng(12345);
+        bool valid = true;
+        uint64_t failures = 0;
+
+        for (uint32_t frame = 0; frame < 2000 && valid; frame++) {
+            uint32_t slot = frame % frameCount;
+            beginUniformRingFrame(ring, slot);
+            live[slot].clear();
+
+            // żһ֡ñƽ࣬ʹ
+            uint32_t allocations = (frame % 97 == 0) ? 64 : rng() % 24;
+            for (uint32_t i = 0; i < allocations && valid; i++) {
+                VkDeviceSize size = 16 + rng() % 4000;
+                VkDeviceSize offset = 0;
+                if (!allocateUniformRing(ring, size, offset)) {
+                    failures++;
+                    continue;
+                }
+
+                valid = offset % ring.alignment == 0 && offset + size <= ring.size;
+                for (uint32_t other = 0; other < frameCount && valid; other++) {
+                    for (const Range& range : live[other]) {
+                        if (rangesOverlap(offset, size, range.offset, range.size)) {
+                            valid = false;
+                            break;
+                        }
+                    }
+                }
+                live[slot].push_back({ offset, size });
+            }
+        }
+
+        // ʱʧܴҪͳһ
+        ok = check("in-flight frames never overwritten", valid && ring.stats.wraps > 0
+            && failures == ring.stats.overruns && ring.used <= ring.size) && ok;
+    }
+
+    return ok;
+}
@@ -1,4 +1,3 @@
-"C:\VulkanSDK\1.3.296.0\Bin\glslangValidator.exe"  -V "F:\TEMP\ProjectVulkan\vert.vert" -o "F:\TEMP\ProjectVulkan\vert.spv"
-"C:\VulkanSDK\1.3.296.0\Bin\glslangValidator.exe"  -V "F:\TEMP\ProjectVulkan\frag.frag" -o "F:\TEMP\ProjectVulkan\frag.spv"
-"C:\VulkanSDK\1.3.296.0\Bin\glslangValidator.exe"  -V "F:\TEMP\ProjectVulkan\frag.frag" -o "F:\TEMP\ProjectVulkan\frag-ok.spv"
-"C:\VulkanSDK\1.3.296.0\Bin\glslangValidator.exe"  -V "F:\TEMP\ProjectVulkan\frag.frag" -o "F:\TEMP\ProjectVulkan\frag-err.spv"
\ No newline at end of file
+@echo off
+rem Compiles every shader listed in shaders.json and regenerates ProjectVulkan\ShaderReflection.h
+python "%~dp0shader_build.py" %*
@@ -0,0 +1,27 @@
+#version 450
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec4 instanceTransform; // xy 偏移，zw 缩放
+
+layout(location = 1) out vec2 texcoord;
+layout(location = 2) out vec4 color;
+layout(location = 3) flat out uint textureIndex;
+
+// 每帧的常量从常量环中以动态偏移读取（shaders.json 的 constantsSet）
+layout(set = 0, binding = 0) uniform Camera {
+    mat4 viewProjection;
+} camera;
+
+// 每个绘制的参数，小于推送常量的大小，setDrawConstants 直接推送而不写入常量环
+layout(push_constant) uniform DrawParams {
+    vec4 color;
+    uint textureIndex;  // 无绑定纹理表中的下标，0xFFFFFFFF 表示不采样
+} draw;
+
+void main() {
+    vec2 position = inPosition * instanceTransform.zw + instanceTransform.xy;
+    gl_Position = camera.viewProjection * vec4(position, 0.0, 1.0);
+    texcoord = inPosition;
+    color = draw.color;
+    textureIndex = draw.textureIndex;
+}
@@ -0,0 +1,314 @@
+"""Pack meshes and textures into a GPU-ready asset pack read by AssetPack.
+
+Usage: python pack_assets.py [--meshlets] [--no-mips] scene.apak mesh.obj texture.tga ...
+
+Meshes are stored in input order in one vertex section and one index section,
+exactly as the vertex and index buffers consume them:
+    vertex  : position half4 (w = 1), normal octahedral snorm16x2 (12 bytes)
+    index   : uint16 when every mesh has at most 65536 vertices, else uint32,
+              relative to the mesh's vertexOffset
+Textures are RGBA8 with a box-filtered mip chain, levels packed back to back.
+
+Layout (little endian):
+    header   : magic "APAK", version, section count, mesh count, texture count,
+               vertex stride, index size, flags (8 x uint32)
+    sections : type, reserved, offset, size (2 x uint32 + 2 x uint64)
+    meshes   : name (32 bytes), firstIndex, indexCount, vertexOffset, vertexCount,
+               firstMeshlet, meshletCount, bounding sphere center xyz + radius
+    textures : name (32 bytes), format, width, height, mip levels, offset, size
+    data     : sections, each aligned to 256 bytes
+"""
+
+import math
+import os
+import struct
+import sys
+
+MAGIC = 0x4B415041
+VERSION = 1
+NAME_SIZE = 32
+SECTION_ALIGNMENT = 256
+MIP_ALIGNMENT = 16
+
+SECTION_VERTICES = 1
+SECTION_INDICES = 2
+SECTION_MESHLETS = 3
+SECTION_MESHLET_VERTICES = 4
+SECTION_MESHLET_TRIANGLES = 5
+SECTION_TEXTURES = 6
+
+FLAG_MESHLETS = 1
+
+# 与 mesh shader 常用的上限一致
+MESHLET_MAX_VERTICES = 64
+MESHLET_MAX_TRIANGLES = 124
+
+VK_FORMAT_R8G8B8A8_UNORM = 37
+
+
+def align(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def read_obj(path):
+    """Return (vertices, indices): vertices are (position, normal) tuples, indices a flat triangle list."""
+    positions = []
+    normals = []
+    corners = {}
+    vertices = []
+    indices = []
+
+    def resolve(index, count):
+        index = int(index)
+        return index - 1 if index > 0 else count + index
+
+    with open(path, "r") as f:
+        for line in f:
+            parts = line.split()
+            if not parts:
+                continue
+            if parts[0] == "v":
+                positions.append(tuple(float(x) for x in parts[1:4]) + (0.0,) * (4 - len(parts)))
+            elif parts[0] == "vn":
+                normals.append(tuple(float(x) for x in parts[1:4]))
+            elif parts[0] == "f":
+                face = []
+                for corner in parts[1:]:
+                    fields = corner.split("/")
+                    v = resolve(fields[0], len(positions))
+                    n = resolve(fields[2], len(normals)) if len(fields) > 2 and fields[2] else None
+                    # 位置和法线相同的角共享一个顶点
+                    key = (v, n)
+                    if key not in corners:
+                        corners[key] = len(vertices)
+                        vertices.append([v, n])
+                    face.append(corners[key])
+                for i in range(1, len(face) - 1):
+                    indices += [face[0], face[i], face[i + 1]]
+
+    # 没有法线时用相邻三角形的面法线（按面积加权）平均
+    accumulated = [[0.0, 0.0, 0.0] for _ in vertices]
+    for t in range(0, len(indices), 3):
+        a, b, c = (positions[vertices[i][0]] for i in indices[t:t + 3])
+        e1 = [b[k] - a[k] for k in range(3)]
+        e2 = [c[k] - a[k] for k in range(3)]
+        n = [e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]]
+        for i in indices[t:t + 3]:
+            for k in range(3):
+                accumulated[i][k] += n[k]
+
+    result = []
+    for i, (v, n) in enumerate(vertices):
+        normal = normals[n] if n is not None else accumulated[i]
+        length = math.sqrt(sum(x * x for x in normal))
+        normal = tuple(x / length for x in normal) if length > 0 else (0.0, 0.0, 1.0)
+        result.append((positions[v], normal))
+    return result, indices
+
+
+def encode_octahedral(normal):
+    x, y, z = normal
+    s = abs(x) + abs(y) + abs(z)
+    x, y, z = x / s, y / s, z / s
+    if z < 0:
+        x, y = (1 - abs(y)) * (1 if x >= 0 else -1), (1 - abs(x)) * (1 if y >= 0 else -1)
+    return tuple(int(round(max(-1.0, min(1.0, c)) * 32767)) for c in (x, y))
+
+
+def encode_vertex(position, normal):
+    return struct.pack("<4e2h", position[0], position[1], position[2], 1.0, *encode_octahedral(normal))
+
+
+def bounding_sphere(vertices):
+    lo = [min(p[k] for p, _ in vertices) for k in range(3)]
+    hi = [max(p[k] for p, _ in vertices) for k in range(3)]
+    center = [(lo[k] + hi[k]) * 0.5 for k in range(3)]
+    radius = max(math.sqrt(sum((p[k] - center[k]) ** 2 for k in range(3))) for p, _ in vertices)
+    return center, radius
+
+
+def build_meshlets(indices):
+    """Greedy split in index order. Returns (meshlets, vertex list, triangle bytes) for one mesh."""
+    meshlets = []
+    meshlet_vertices = []
+    meshlet_triangles = b""
+    local = {}
+    triangles = []
+
+    def flush():
+        nonlocal meshlet_triangles
+        if not triangles:
+            return
+        meshlets.append((len(meshlet_vertices), len(meshlet_triangles), len(local), len(triangles)))
+        meshlet_vertices.extend(sorted(local, key=local.get))
+        data = b"".join(struct.pack("<3B", *t) for t in triangles)
+        # 每个 meshlet 的三角形按 4 字节对齐，便于着色器按 uint 读取
+        meshlet_triangles += data + b"\0" * (align(len(data), 4) - len(data))
+        local.clear()
+        triangles.clear()
+
+    for t in range(0, len(indices), 3):
+        tri = indices[t:t + 3]
+        new = len(set(v for v in tri if v not in local))
+        if len(local) + new > MESHLET_MAX_VERTICES or len(triangles) + 1 > MESHLET_MAX_TRIANGLES:
+            flush()
+        for v in tri:
+            if v not in local:
+                local[v] = len(local)
+        triangles.append(tuple(local[v] for v in tri))
+    flush()
+    return meshlets, meshlet_vertices, meshlet_triangles
+
+
+def read_tga(path):
+    """Uncompressed true color (24/32 bpp) or grayscale TGA to RGBA8 rows, top row first."""
+    with open(path, "rb") as f:
+        data = f.read()
+    id_length, color_map, image_type = data[0], data[1], data[2]
+    width, height = struct.unpack_from("<HH", data, 12)
+    bpp, descriptor = data[16], data[17]
+    if color_map != 0 or (image_type, bpp) not in ((2, 24), (2, 32), (3, 8)):
+        raise ValueError("unsupported TGA (only uncompressed true color or grayscale): " + path)
+
+    channels = bpp // 8
+    pixels = data[18 + id_length:18 + id_length + width * height * channels]
+    rows = []
+    for y in range(height):
+        src = y if descriptor & 0x20 else height - 1 - y
+        row = bytearray()
+        for x in range(width):
+            p = pixels[(src * width + x) * channels:(src * width + x + 1) * channels]
+            if channels == 1:
+                row += bytes((p[0], p[0], p[0], 255))
+            else:
+                row += bytes((p[2], p[1], p[0], p[3] if channels == 4 else 255))
+        rows.append(row)
+    return width, height, b"".join(rows)
+
+
+def downsample(width, height, pixels):
+    w, h = max(1, width // 2), max(1, height // 2)
+    out = bytearray(w * h * 4)
+    for y in range(h):
+        for x in range(w):
+            for c in range(4):
+                total = 0
+                for dy in (0, 1):
+                    for dx in (0, 1):
+                        sx, sy = min(x * 2 + dx, width - 1), min(y * 2 + dy, height - 1)
+                        total += pixels[(sy * width + sx) * 4 + c]
+                out[(y * w + x) * 4 + c] = (total + 2) // 4
+    return w, h, bytes(out)
+
+
+def main():
+    args = sys.argv[1:]
+    meshlets_enabled = "--meshlets" in args
+    mips_enabled = "--no-mips" not in args
+    args = [a for a in args if a not in ("--meshlets", "--no-mips")]
+    if len(args) < 2:
+        print(__doc__)
+        return 1
+
+    output = args[0]
+    meshes = []
+    textures = []
+    for path in args[1:]:
+        name = os.path.splitext(os.path.basename(path))[0]
+        if len(name.encode("utf-8")) >= NAME_SIZE:
+            print("name too long: " + name)
+            return 1
+        extension = os.path.splitext(path)[1].lower()
+        if extension == ".obj":
+            vertices, indices = read_obj(path)
+            if not indices:
+                print("no triangles in " + path)
+                return 1
+            meshes.append((name, vertices, indices))
+        elif extension == ".tga":
+            textures.append((name,) + read_tga(path))
+        else:
+            print("unsupported input: " + path)
+            return 1
+
+    index_format = "H" if all(len(v) <= 65536 for _, v, _ in meshes) else "I"
+
+    vertex_data = b""
+    index_data = b""
+    meshlet_data = b""
+    meshlet_vertex_data = b""
+    meshlet_triangle_data = b""
+    mesh_entries = b""
+    meshlet_count = 0
+    first_index = 0
+    vertex_offset = 0
+    for name, vertices, indices in meshes:
+        vertex_data += b"".join(encode_vertex(p, n) for p, n in vertices)
+        index_data += struct.pack("<%d%s" % (len(indices), index_format), *indices)
+
+        first_meshlet, mesh_meshlets = meshlet_count, 0
+        if meshlets_enabled:
+            meshlets, local_vertices, triangles = build_meshlets(indices)
+            vertex_base = len(meshlet_vertex_data) // 4
+            triangle_base = len(meshlet_triangle_data)
+            for v_offset, t_offset, v_count, t_count in meshlets:
+                meshlet_data += struct.pack("<4I", vertex_base + v_offset, triangle_base + t_offset, v_count, t_count)
+            meshlet_vertex_data += struct.pack("<%dI" % len(local_vertices), *local_vertices)
+            meshlet_triangle_data += triangles
+            mesh_meshlets = len(meshlets)
+            meshlet_count += mesh_meshlets
+
+        center, radius = bounding_sphere(vertices)
+        mesh_entries += struct.pack("<%dsIIiIII4f" % NAME_SIZE, name.encode("utf-8"), first_index, len(indices),
+                                    vertex_offset, len(vertices), first_meshlet, mesh_meshlets, *center, radius)
+        first_index += len(indices)
+        vertex_offset += len(vertices)
+
+    texture_data = b""
+    texture_entries = b""
+    for name, base_width, base_height, pixels in textures:
+        offset = len(texture_data)
+        width, height = base_width, base_height
+        levels = 0
+        while True:
+            texture_data += pixels + b"\0" * (align(len(pixels), MIP_ALIGNMENT) - len(pixels))
+            levels += 1
+            if not mips_enabled or (width == 1 and height == 1):
+                break
+            width, height, pixels = downsample(width, height, pixels)
+        texture_entries += struct.pack("<%dsIIIIQQ" % NAME_SIZE, name.encode("utf-8"), VK_FORMAT_R8G8B8A8_UNORM,
+                                       base_width, base_height, levels, offset, len(texture_data) - offset)
+
+    sections = [(SECTION_VERTICES, vertex_data), (SECTION_INDICES, index_data)]
+    if meshlets_enabled:
+        sections += [(SECTION_MESHLETS, meshlet_data), (SECTION_MESHLET_VERTICES, meshlet_vertex_data),
+                     (SECTION_MESHLET_TRIANGLES, meshlet_triangle_data)]
+    if textures:
+        sections.append((SECTION_TEXTURES, texture_data))
+    sections = [(t, d) for t, d in sections if d]
+
+    header_size = 32 + len(sections) * 24 + len(mesh_entries) + len(texture_entries)
+    offset = align(header_size, SECTION_ALIGNMENT)
+    section_entries = b""
+    payload = b""
+    for section_type, data in sections:
+        section_entries += struct.pack("<IIQQ", section_type, 0, offset + len(payload), len(data))
+        payload += data + b"\0" * (align(len(data), SECTION_ALIGNMENT) - len(data))
+
+    flags = FLAG_MESHLETS if meshlets_enabled else 0
+    with open(output, "wb") as f:
+        f.write(struct.pack("<8I", MAGIC, VERSION, len(sections), len(meshes), len(textures), 12,
+                            struct.calcsize(index_format), flags))
+        f.write(section_entries)
+        f.write(mesh_entries)
+        f.write(texture_entries)
+        f.write(b"\0" * (offset - header_size))
+        f.write(payload)
+
+    print("packed %d mesh(es), %d texture(s), %d meshlet(s) into %s (%d bytes)"
+          % (len(meshes), len(textures), meshlet_count, output, offset + len(payload)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+"""Pack .spv files into a single shader archive read by ShaderLibrary.
+
+Usage: python pack_shaders.py shaders.pak vert.spv frag.spv ...
+
+Layout (little endian):
+    header  : magic "SPAK", version, entry count, reserved (4 x uint32)
+    entries : name (56 bytes, NUL terminated), offset, size
+    data    : SPIR-V blobs, each aligned to 16 bytes
+"""
+
+import os
+import struct
+import sys
+
+MAGIC = 0x4B415053
+VERSION = 1
+NAME_SIZE = 56
+ALIGNMENT = 16
+SPIRV_MAGIC = 0x07230203
+
+
+def align(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def main():
+    if len(sys.argv) < 3:
+        print(__doc__)
+        return 1
+
+    output = sys.argv[1]
+    inputs = sys.argv[2:]
+
+    blobs = []
+    for path in inputs:
+        name = os.path.basename(path)
+        if len(name.encode("utf-8")) >= NAME_SIZE:
+            print("name too long: " + name)
+            return 1
+
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) < 20 or len(data) % 4 != 0 or struct.unpack_from("<I", data)[0] != SPIRV_MAGIC:
+            print("not a SPIR-V module: " + path)
+            return 1
+        blobs.append((name, data))
+
+    header_size = 16 + len(blobs) * (NAME_SIZE + 8)
+    offset = align(header_size, ALIGNMENT)
+
+    entries = b""
+    payload = b""
+    for name, data in blobs:
+        entries += struct.pack("<%dsII" % NAME_SIZE, name.encode("utf-8"), offset + len(payload), len(data))
+        payload += data + b"\0" * (align(len(data), ALIGNMENT) - len(data))
+
+    with open(output, "wb") as f:
+        f.write(struct.pack("<IIII", MAGIC, VERSION, len(blobs), 0))
+        f.write(entries)
+        f.write(b"\0" * (offset - header_size))
+        f.write(payload)
+
+    print("packed %d shader(s) into %s" % (len(blobs), output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
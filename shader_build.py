@@ -0,0 +1,687 @@
+"""Compile GLSL to SPIR-V and generate ProjectVulkan/ShaderReflection.h.
+
+Usage: python shader_build.py [--reflect-only] [--manifest shaders.json]
+
+Every shader listed in the manifest is compiled with glslangValidator (or
+glslc) and checked with spirv-val, both found on PATH or under
+%VULKAN_SDK%/Bin; a missing tool is a build error. The .spv files are build
+output and are not checked in. --reflect-only skips compilation and reflects
+the existing .spv files, failing if any is missing or older than its source.
+The resulting SPIR-V is then reflected: vertex inputs become a tightly packed interleaved vertex layout
+(locations listed in a pipeline's "instanceLocations" go to an instance-rate
+binding 1), descriptor bindings and push constants from all stages are merged per
+pipeline, and vertex outputs are checked against fragment inputs. A pipeline's
+"constantsSet" names the set holding the per-frame constant ring's uniform
+block; it is left out of the reflected sets and only its number and size are
+emitted, because the application binds the ring's own dynamic set there. A
+pipeline's "bindlessSet" likewise names the set holding the global bindless
+texture table (one unsized sampler array at binding 0, right after the
+constants set); only its number is emitted and the application appends the
+table's layout there. Unsized descriptor arrays anywhere else are rejected. Any
+mismatch is reported and the script exits with status 1, which fails the
+Visual Studio pre-build step.
+"""
+
+import json
+import os
+import shutil
+import struct
+import subprocess
+import sys
+
+ROOT = os.path.dirname(os.path.abspath(__file__))
+
+# SPIR-V opcodes / enums used by the reflection
+OP_NAME = 5
+OP_MEMBER_NAME = 6
+OP_ENTRY_POINT = 15
+OP_TYPE_VOID = 19
+OP_TYPE_BOOL = 20
+OP_TYPE_INT = 21
+OP_TYPE_FLOAT = 22
+OP_TYPE_VECTOR = 23
+OP_TYPE_MATRIX = 24
+OP_TYPE_IMAGE = 25
+OP_TYPE_SAMPLER = 26
+OP_TYPE_SAMPLED_IMAGE = 27
+OP_TYPE_ARRAY = 28
+OP_TYPE_RUNTIME_ARRAY = 29
+OP_TYPE_STRUCT = 30
+OP_TYPE_POINTER = 32
+OP_CONSTANT = 43
+OP_VARIABLE = 59
+OP_DECORATE = 71
+OP_MEMBER_DECORATE = 72
+
+DECORATION_BLOCK = 2
+DECORATION_BUFFER_BLOCK = 3
+DECORATION_ARRAY_STRIDE = 6
+DECORATION_MATRIX_STRIDE = 7
+DECORATION_BUILTIN = 11
+DECORATION_LOCATION = 30
+DECORATION_BINDING = 33
+DECORATION_DESCRIPTOR_SET = 34
+DECORATION_OFFSET = 35
+
+STORAGE_UNIFORM_CONSTANT = 0
+STORAGE_INPUT = 1
+STORAGE_UNIFORM = 2
+STORAGE_OUTPUT = 3
+STORAGE_PUSH_CONSTANT = 9
+STORAGE_STORAGE_BUFFER = 12
+
+STAGES = {
+    0: "VK_SHADER_STAGE_VERTEX_BIT",
+    4: "VK_SHADER_STAGE_FRAGMENT_BIT",
+    5: "VK_SHADER_STAGE_COMPUTE_BIT",
+}
+
+STAGE_BY_EXTENSION = {
+    ".vert": "VK_SHADER_STAGE_VERTEX_BIT",
+    ".frag": "VK_SHADER_STAGE_FRAGMENT_BIT",
+    ".comp": "VK_SHADER_STAGE_COMPUTE_BIT",
+}
+
+
+class BuildError(Exception):
+    pass
+
+
+def read_string(words, start):
+    data = b"".join(struct.pack("<I", w) for w in words[start:])
+    end = data.index(b"\0")
+    return data[:end].decode("utf-8"), start + end // 4 + 1
+
+
+class SpirvModule:
+    """Minimal SPIR-V parser: types, decorations and interface variables."""
+
+    def __init__(self, path):
+        self.path = path
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) < 20 or len(data) % 4 != 0:
+            raise BuildError("%s: not a SPIR-V module" % path)
+
+        words = struct.unpack("<%dI" % (len(data) // 4), data)
+        if words[0] != 0x07230203:
+            raise BuildError("%s: bad SPIR-V magic number" % path)
+
+        self.names = {}
+        self.member_names = {}
+        self.decorations = {}
+        self.member_decorations = {}
+        self.types = {}
+        self.constants = {}
+        self.variables = []
+        self.execution_model = None
+
+        i = 5
+        while i < len(words):
+            opcode = words[i] & 0xFFFF
+            count = words[i] >> 16
+            if count == 0:
+                raise BuildError("%s: corrupt instruction stream" % path)
+            args = words[i + 1:i + count]
+            self.parse_instruction(opcode, args)
+            i += count
+
+    def parse_instruction(self, op, args):
+        if op == OP_NAME:
+            self.names[args[0]] = read_string(args, 1)[0]
+        elif op == OP_MEMBER_NAME:
+            self.member_names[(args[0], args[1])] = read_string(args, 2)[0]
+        elif op == OP_ENTRY_POINT:
+            if self.execution_model is None:
+                self.execution_model = args[0]
+        elif op == OP_DECORATE:
+            self.decorations.setdefault(args[0], {})[args[1]] = args[2] if len(args) > 2 else True
+        elif op == OP_MEMBER_DECORATE:
+            self.member_decorations.setdefault((args[0], args[1]), {})[args[2]] = args[3] if len(args) > 3 else True
+        elif op == OP_TYPE_VOID:
+            self.types[args[0]] = ("void",)
+        elif op == OP_TYPE_BOOL:
+            self.types[args[0]] = ("bool",)
+        elif op == OP_TYPE_INT:
+            self.types[args[0]] = ("int", args[1], args[2])
+        elif op == OP_TYPE_FLOAT:
+            self.types[args[0]] = ("float", args[1])
+        elif op == OP_TYPE_VECTOR:
+            self.types[args[0]] = ("vector", args[1], args[2])
+        elif op == OP_TYPE_MATRIX:
+            self.types[args[0]] = ("matrix", args[1], args[2])
+        elif op == OP_TYPE_IMAGE:
+            # sampledType, dim, depth, arrayed, ms, sampled, format
+            self.types[args[0]] = ("image", args[2], args[6])
+        elif op == OP_TYPE_SAMPLER:
+            self.types[args[0]] = ("sampler",)
+        elif op == OP_TYPE_SAMPLED_IMAGE:
+            self.types[args[0]] = ("sampled_image", args[1])
+        elif op == OP_TYPE_ARRAY:
+            self.types[args[0]] = ("array", args[1], args[2])
+        elif op == OP_TYPE_RUNTIME_ARRAY:
+            self.types[args[0]] = ("runtime_array", args[1])
+        elif op == OP_TYPE_STRUCT:
+            self.types[args[0]] = ("struct", list(args[1:]))
+        elif op == OP_TYPE_POINTER:
+            self.types[args[0]] = ("pointer", args[1], args[2])
+        elif op == OP_CONSTANT:
+            self.constants[args[1]] = args[2] if len(args) > 2 else 0
+        elif op == OP_VARIABLE:
+            self.variables.append((args[1], args[0], args[2]))
+
+    @property
+    def stage(self):
+        if self.execution_model not in STAGES:
+            raise BuildError("%s: unsupported execution model %s" % (self.path, self.execution_model))
+        return STAGES[self.execution_model]
+
+    def name(self, id):
+        return self.names.get(id, "_%d" % id)
+
+    def pointee(self, pointer_type):
+        return self.types[pointer_type][2]
+
+    def type_name(self, type_id):
+        t = self.types[type_id]
+        if t[0] == "float":
+            return "float" if t[1] == 32 else "double"
+        if t[0] == "int":
+            return ("int" if t[2] else "uint") + ("" if t[1] == 32 else str(t[1]))
+        if t[0] == "vector":
+            return "%s%d" % (self.type_name(t[1]), t[2])
+        if t[0] == "matrix":
+            return "mat%d<%s>" % (t[2], self.type_name(t[1]))
+        if t[0] == "array":
+            return "%s[%d]" % (self.type_name(t[1]), self.constants[t[2]])
+        if t[0] == "struct":
+            return "struct %s" % self.name(type_id)
+        return t[0]
+
+    def type_size(self, type_id, decorations=None):
+        """Byte size of a type laid out with explicit Offset/ArrayStride/MatrixStride decorations."""
+        t = self.types[type_id]
+        if t[0] in ("float", "int"):
+            return t[1] // 8
+        if t[0] == "bool":
+            return 4
+        if t[0] == "vector":
+            return self.type_size(t[1]) * t[2]
+        if t[0] == "matrix":
+            stride = (decorations or {}).get(DECORATION_MATRIX_STRIDE)
+            return (stride or self.type_size(t[1])) * t[2]
+        if t[0] == "array":
+            stride = self.decorations.get(type_id, {}).get(DECORATION_ARRAY_STRIDE) or self.type_size(t[1])
+            return stride * self.constants[t[2]]
+        if t[0] == "struct":
+            size = 0
+            for index, member in enumerate(t[1]):
+                member_decorations = self.member_decorations.get((type_id, index), {})
+                offset = member_decorations.get(DECORATION_OFFSET, size)
+                size = max(size, offset + self.type_size(member, member_decorations))
+            return size
+        raise BuildError("%s: cannot compute the size of %s" % (self.path, t[0]))
+
+    def interface(self, storage_class):
+        """Non built-in Input/Output variables as {location: (name, type)}."""
+        result = {}
+        for var_id, pointer_type, storage in self.variables:
+            if storage != storage_class:
+                continue
+            decorations = self.decorations.get(var_id, {})
+            type_id = self.pointee(pointer_type)
+            if DECORATION_BUILTIN in decorations or DECORATION_BUILTIN in self.decorations.get(type_id, {}):
+                continue
+            if self.types[type_id][0] == "struct":
+                # gl_PerVertex 之类的块：成员全部是内置变量时忽略
+                members = self.types[type_id][1]
+                if all(DECORATION_BUILTIN in self.member_decorations.get((type_id, m), {}) for m in range(len(members))):
+                    continue
+                raise BuildError("%s: interface block %s is not supported" % (self.path, self.name(var_id)))
+            if DECORATION_LOCATION not in decorations:
+                raise BuildError("%s: %s has no location" % (self.path, self.name(var_id)))
+            result[decorations[DECORATION_LOCATION]] = (self.name(var_id), type_id)
+        return result
+
+    def descriptors(self):
+        """Descriptor bindings as {(set, binding): (name, descriptorType, count)}."""
+        result = {}
+        for var_id, pointer_type, storage in self.variables:
+            if storage not in (STORAGE_UNIFORM_CONSTANT, STORAGE_UNIFORM, STORAGE_STORAGE_BUFFER):
+                continue
+            decorations = self.decorations.get(var_id, {})
+            type_id = self.pointee(pointer_type)
+
+            count = 1
+            t = self.types[type_id]
+            if t[0] == "array":
+                count = self.constants[t[2]]
+                type_id = t[1]
+            elif t[0] == "runtime_array":
+                # 数量为 0 表示不定长数组，只允许出现在 bindlessSet 中
+                count = 0
+                type_id = t[1]
+
+            t = self.types[type_id]
+            type_decorations = self.decorations.get(type_id, {})
+            if storage == STORAGE_STORAGE_BUFFER or DECORATION_BUFFER_BLOCK in type_decorations:
+                descriptor_type = "VK_DESCRIPTOR_TYPE_STORAGE_BUFFER"
+            elif storage == STORAGE_UNIFORM:
+                descriptor_type = "VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER"
+            elif t[0] == "sampled_image":
+                image = self.types[t[1]]
+                descriptor_type = ("VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER" if image[1] == 5
+                                   else "VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER")
+            elif t[0] == "image":
+                if t[1] == 5:
+                    descriptor_type = ("VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER" if t[2] == 1
+                                       else "VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER")
+                elif t[1] == 6:
+                    descriptor_type = "VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT"
+                else:
+                    descriptor_type = ("VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE" if t[2] == 1
+                                       else "VK_DESCRIPTOR_TYPE_STORAGE_IMAGE")
+            elif t[0] == "sampler":
+                descriptor_type = "VK_DESCRIPTOR_TYPE_SAMPLER"
+            else:
+                continue
+
+            key = (decorations.get(DECORATION_DESCRIPTOR_SET, 0), decorations.get(DECORATION_BINDING, 0))
+            # 没有实例名的块变量名为空，用块类型名代替
+            name = self.names.get(var_id) or self.name(self.pointee(pointer_type))
+            result[key] = (name, descriptor_type, count)
+        return result
+
+    def block_size(self, key):
+        """Byte size of the buffer block bound at (set, binding)."""
+        for var_id, pointer_type, storage in self.variables:
+            decorations = self.decorations.get(var_id, {})
+            if (decorations.get(DECORATION_DESCRIPTOR_SET, 0), decorations.get(DECORATION_BINDING, 0)) == key \
+                    and storage in (STORAGE_UNIFORM, STORAGE_STORAGE_BUFFER):
+                return self.type_size(self.pointee(pointer_type))
+        return 0
+
+    def push_constant_size(self):
+        for var_id, pointer_type, storage in self.variables:
+            if storage == STORAGE_PUSH_CONSTANT:
+                return self.type_size(self.pointee(pointer_type))
+        return 0
+
+
+# 顶点输入格式：(标量类型, 分量数) -> (VkFormat, 字节数)
+def vertex_format(module, type_id, where):
+    t = module.types[type_id]
+    components = 1
+    if t[0] == "vector":
+        components = t[2]
+        t = module.types[t[1]]
+
+    if t[0] == "float" and t[1] == 32:
+        base, size = "SFLOAT", 4
+    elif t[0] == "int" and t[1] == 32:
+        base, size = ("SINT" if t[2] else "UINT"), 4
+    else:
+        raise BuildError("%s: unsupported vertex input type %s" % (where, module.type_name(type_id)))
+
+    channels = "RGBA"[:components]
+    name = "".join("%s32" % c for c in channels)
+    return "VK_FORMAT_%s_%s" % (name, base), size * components
+
+
+VERTEX_BINDING = 0
+INSTANCE_BINDING = 1
+
+
+def vertex_layout(module, instance_locations):
+    """Interleaved, tightly packed layout in location order.
+
+    Per-vertex inputs go to binding 0; inputs whose location is listed in
+    instance_locations go to binding 1 with VK_VERTEX_INPUT_RATE_INSTANCE.
+    Returns the attributes as (location, binding, format, offset, name) and
+    the stride of each binding.
+    """
+    inputs = module.interface(STORAGE_INPUT)
+    attributes = []
+    strides = {}
+    for location in sorted(inputs):
+        name, type_id = inputs[location]
+        binding = INSTANCE_BINDING if location in instance_locations else VERTEX_BINDING
+        t = module.types[type_id]
+        columns = [(location, type_id)]
+        if t[0] == "matrix":
+            # 矩阵输入占用连续的多个 location，每列一个属性
+            columns = [(location + c, t[1]) for c in range(t[2])]
+        for column_location, column_type in columns:
+            fmt, size = vertex_format(module, column_type, "%s: %s" % (module.path, name))
+            offset = strides.get(binding, 0)
+            attributes.append((column_location, binding, fmt, offset, name))
+            strides[binding] = offset + size
+
+    unknown = set(instance_locations) - set(inputs)
+    if unknown:
+        raise BuildError("%s: instance locations %s are not vertex inputs" % (module.path, sorted(unknown)))
+    return attributes, strides
+
+
+def check_stage_interface(producer, consumer):
+    outputs = producer.interface(STORAGE_OUTPUT)
+    inputs = consumer.interface(STORAGE_INPUT)
+    errors = []
+    for location, (name, type_id) in sorted(inputs.items()):
+        if location not in outputs:
+            errors.append("%s: input %s (location %d) is not written by %s"
+                          % (consumer.path, name, location, producer.path))
+            continue
+        output_name, output_type = outputs[location]
+        if producer.type_name(output_type) != consumer.type_name(type_id):
+            errors.append("%s: input %s (location %d) is %s but %s writes %s as %s"
+                          % (consumer.path, name, location, consumer.type_name(type_id),
+                             producer.path, output_name, producer.type_name(output_type)))
+    return errors
+
+
+def reflect_pipeline(name, modules, instance_locations, constants_set=None, bindless_set=None):
+    errors = []
+
+    stages = [m.stage for m in modules]
+    vertex = next((m for m in modules if m.stage == "VK_SHADER_STAGE_VERTEX_BIT"), None)
+    fragment = next((m for m in modules if m.stage == "VK_SHADER_STAGE_FRAGMENT_BIT"), None)
+    if vertex is not None and fragment is not None:
+        errors += check_stage_interface(vertex, fragment)
+
+    attributes, strides = vertex_layout(vertex, instance_locations) if vertex is not None else ([], {})
+
+    # 各阶段的描述符合并；同一个 set/binding 的类型和数量必须一致
+    descriptors = {}
+    for module in modules:
+        for key, (var_name, descriptor_type, count) in module.descriptors().items():
+            if key in descriptors:
+                existing = descriptors[key]
+                if existing[1] != descriptor_type or existing[2] != count:
+                    errors.append("%s: set %d binding %d is %s[%d] here but %s[%d] in another stage"
+                                  % (module.path, key[0], key[1], descriptor_type, count, existing[1], existing[2]))
+                existing[3].append(module.stage)
+            else:
+                descriptors[key] = [var_name, descriptor_type, count, [module.stage]]
+
+    # 常量环的集合：只能有 binding 0 一个 uniform 块，并且紧跟在其余集合之后（应用在那里追加环的集合）
+    constants_size = 0
+    if constants_set is not None:
+        key = (constants_set, 0)
+        others = [k for k in descriptors if k[0] != constants_set and k[0] != bindless_set]
+        if [k for k in descriptors if k[0] == constants_set] != [key] or descriptors[key][1] != "VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER" \
+                or descriptors[key][2] != 1:
+            errors.append("%s: constants set %d must hold exactly one uniform block at binding 0" % (name, constants_set))
+        elif constants_set != (max(k[0] for k in others) + 1 if others else 0):
+            errors.append("%s: constants set %d must follow the other descriptor sets" % (name, constants_set))
+        else:
+            constants_size = max(m.block_size(key) for m in modules)
+            del descriptors[key]
+
+    # 无绑定纹理表的集合：binding 0 是一个不定长的组合图像采样器数组，紧跟在常量环的集合之后
+    if bindless_set is not None:
+        key = (bindless_set, 0)
+        others = [k[0] for k in descriptors if k[0] != bindless_set]
+        expected = constants_set + 1 if constants_set is not None else (max(others) + 1 if others else 0)
+        if [k for k in descriptors if k[0] == bindless_set] != [key] \
+                or descriptors[key][1] != "VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER" or descriptors[key][2] != 0:
+            errors.append("%s: bindless set %d must hold exactly one unsized sampler array at binding 0" % (name, bindless_set))
+        elif bindless_set != expected:
+            errors.append("%s: bindless set %d must be set %d, after the other descriptor sets" % (name, bindless_set, expected))
+        else:
+            del descriptors[key]
+
+    for (set_index, binding), (var_name, descriptor_type, count, stages) in descriptors.items():
+        if count == 0:
+            errors.append("%s: %s (set %d binding %d) is an unsized descriptor array outside the bindless set"
+                          % (name, var_name, set_index, binding))
+
+    push_constant_size = 0
+    push_constant_stages = []
+    for module in modules:
+        size = module.push_constant_size()
+        if size:
+            push_constant_size = max(push_constant_size, size)
+            push_constant_stages.append(module.stage)
+
+    if errors:
+        raise BuildError("\n".join("error: " + e for e in errors))
+
+    return {
+        "name": name,
+        "stages": stages,
+        "attributes": attributes,
+        "strides": strides,
+        "descriptors": descriptors,
+        "push_constant_size": push_constant_size,
+        "push_constant_stages": push_constant_stages,
+        "constants_set": constants_set,
+        "constants_size": constants_size,
+        "bindless_set": bindless_set,
+    }
+
+
+def find_tool(candidates):
+    sdk = os.environ.get("VULKAN_SDK")
+    for candidate in candidates:
+        path = shutil.which(candidate)
+        if path is None and sdk:
+            for directory in ("Bin", "bin"):
+                path = shutil.which(candidate, path=os.path.join(sdk, directory))
+                if path:
+                    break
+        if path:
+            return path
+    return None
+
+
+def find_compiler():
+    return find_tool(["glslangValidator", "glslc"])
+
+
+def find_validator():
+    return find_tool(["spirv-val"])
+
+
+def compile_shader(compiler, source, output):
+    if os.path.basename(compiler).lower().startswith("glslc"):
+        command = [compiler, source, "-o", output]
+    else:
+        command = [compiler, "-V", source, "-o", output]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        raise BuildError("%s failed to compile:\n%s" % (source, result.stdout))
+
+
+def validate_shader(validator, source, output):
+    # 与 appInfo.apiVersion 一致；描述符索引等扩展由模块自己声明
+    command = [validator, "--target-env", "vulkan1.0", output]
+    result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if result.returncode != 0:
+        raise BuildError("%s: spirv-val rejected the compiled module:\n%s" % (source, result.stdout))
+
+
+def check_up_to_date(source, output):
+    # --reflect-only 不编译，只能反射已有的 .spv；比源文件旧的模块会生成与源文件不符的头文件
+    if os.path.exists(output) and os.path.getmtime(output) < os.path.getmtime(source):
+        raise BuildError("%s is older than %s, run the build without --reflect-only" %
+                         (os.path.basename(output), os.path.basename(source)))
+
+
+def spv_name(source):
+    return os.path.splitext(source)[0] + ".spv"
+
+
+def generate_header(pipelines, manifest_name):
+    lines = [
+        "// Generated by shader_build.py from %s. Do not edit." % manifest_name,
+        "#pragma once",
+        "",
+        "#include \"ShaderInterface.h\"",
+        "",
+        "namespace ShaderReflection {",
+    ]
+
+    for p in pipelines:
+        name = p["name"]
+        lines.append("")
+        lines.append("// %s: %s" % (name, " + ".join(p["sources"])))
+        if VERTEX_BINDING in p["strides"]:
+            lines.append("constexpr uint32_t %sVertexStride = %d;" % (name, p["strides"][VERTEX_BINDING]))
+        if INSTANCE_BINDING in p["strides"]:
+            lines.append("constexpr uint32_t %sInstanceStride = %d;" % (name, p["strides"][INSTANCE_BINDING]))
+        if p["constants_set"] is not None:
+            lines.append("constexpr uint32_t %sConstantsSet = %d;" % (name, p["constants_set"]))
+            lines.append("constexpr uint32_t %sConstantsSize = %d;" % (name, p["constants_size"]))
+        if p["bindless_set"] is not None:
+            lines.append("constexpr uint32_t %sBindlessSet = %d;" % (name, p["bindless_set"]))
+
+        bindings = "nullptr"
+        attributes = "nullptr"
+        if p["attributes"]:
+            lines.append("static const VkVertexInputBindingDescription %sVertexBindings[] = {" % name)
+            for binding in sorted(p["strides"]):
+                rate = "VK_VERTEX_INPUT_RATE_INSTANCE" if binding == INSTANCE_BINDING else "VK_VERTEX_INPUT_RATE_VERTEX"
+                lines.append("    { %d, %d, %s }," % (binding, p["strides"][binding], rate))
+            lines.append("};")
+            lines.append("static const VkVertexInputAttributeDescription %sVertexAttributes[] = {" % name)
+            for location, binding, fmt, offset, attribute_name in p["attributes"]:
+                lines.append("    { %d, %d, %s, %d }, // %s" % (location, binding, fmt, offset, attribute_name))
+            lines.append("};")
+            bindings = "%sVertexBindings" % name
+            attributes = "%sVertexAttributes" % name
+
+        sets = sorted(set(key[0] for key in p["descriptors"]))
+        for set_index in sets:
+            lines.append("static const VkDescriptorSetLayoutBinding %sSet%dBindings[] = {" % (name, set_index))
+            for (s, binding), (var_name, descriptor_type, count, stages) in sorted(p["descriptors"].items()):
+                if s == set_index:
+                    lines.append("    { %d, %s, %d, %s, nullptr }, // %s"
+                                 % (binding, descriptor_type, count, " | ".join(sorted(set(stages))), var_name))
+            lines.append("};")
+        descriptor_sets = "nullptr"
+        if sets:
+            lines.append("static const DescriptorSetInterface %sDescriptorSets[] = {" % name)
+            for set_index in sets:
+                count = sum(1 for key in p["descriptors"] if key[0] == set_index)
+                lines.append("    { %d, %sSet%dBindings, %d }," % (set_index, name, set_index, count))
+            lines.append("};")
+            descriptor_sets = "%sDescriptorSets" % name
+
+        push_constants = "nullptr"
+        if p["push_constant_size"]:
+            lines.append("static const VkPushConstantRange %sPushConstants[] = {" % name)
+            lines.append("    { %s, 0, %d }," % (" | ".join(sorted(set(p["push_constant_stages"]))), p["push_constant_size"]))
+            lines.append("};")
+            push_constants = "%sPushConstants" % name
+
+        lines.append("static const PipelineInterface %s = {" % name)
+        lines.append("    { %s }," % ", ".join('"%s"' % os.path.basename(spv_name(s)) for s in p["sources"]))
+        lines.append("    %d," % len(p["sources"]))
+        lines.append("    %s, %d," % (bindings, len(p["strides"])))
+        lines.append("    %s, %d," % (attributes, len(p["attributes"])))
+        lines.append("    %s, %d," % (descriptor_sets, len(sets)))
+        lines.append("    %s, %d," % (push_constants, 1 if p["push_constant_size"] else 0))
+        lines.append("};")
+
+    lines.append("")
+    lines.append("}")
+    lines.append("")
+    return "\n".join(lines)
+
+
+def main():
+    args = sys.argv[1:]
+    reflect_only = "--reflect-only" in args
+    manifest_path = os.path.join(ROOT, "shaders.json")
+    if "--manifest" in args:
+        manifest_path = os.path.abspath(args[args.index("--manifest") + 1])
+
+    with open(manifest_path, "r", encoding="utf-8") as f:
+        manifest = json.load(f)
+    base = os.path.dirname(manifest_path)
+
+    sources = []
+    for pipeline in manifest["pipelines"].values():
+        for source in pipeline["shaders"]:
+            if source not in sources:
+                sources.append(source)
+
+    try:
+        compiler = None
+        validator = None
+        if not reflect_only:
+            compiler = find_compiler()
+            if compiler is None:
+                raise BuildError("glslangValidator/glslc not found on PATH or under %VULKAN_SDK%/Bin")
+            validator = find_validator()
+            if validator is None:
+                raise BuildError("spirv-val not found on PATH or under %VULKAN_SDK%/Bin")
+
+        for source in sources:
+            if os.path.splitext(source)[1] not in STAGE_BY_EXTENSION:
+                raise BuildError("%s: unknown shader stage" % source)
+            source_path = os.path.join(base, source)
+            output = os.path.join(base, spv_name(source))
+            if reflect_only:
+                check_up_to_date(source_path, output)
+            else:
+                compile_shader(compiler, source_path, output)
+                validate_shader(validator, source, output)
+
+        modules = {}
+        for source in sources:
+            path = os.path.join(base, spv_name(source))
+            if not os.path.exists(path):
+                raise BuildError("%s has not been compiled" % source)
+            modules[source] = SpirvModule(path)
+            if modules[source].stage != STAGE_BY_EXTENSION[os.path.splitext(source)[1]]:
+                raise BuildError("%s: SPIR-V stage does not match the file extension" % source)
+
+        pipelines = []
+        failures = 0
+        for name, pipeline in manifest["pipelines"].items():
+            expect_failure = pipeline.get("expectFailure", False)
+            try:
+                reflected = reflect_pipeline(name, [modules[s] for s in pipeline["shaders"]],
+                                             pipeline.get("instanceLocations", []), pipeline.get("constantsSet"),
+                                             pipeline.get("bindlessSet"))
+            except BuildError as e:
+                if expect_failure:
+                    continue
+                print("%s:\n%s" % (name, e))
+                failures += 1
+                continue
+
+            if expect_failure:
+                # 用于确认检查本身有效的反例
+                print("error: %s was expected to fail the interface check but passed" % name)
+                failures += 1
+                continue
+
+            reflected["sources"] = pipeline["shaders"]
+            pipelines.append(reflected)
+
+        if failures:
+            return 1
+
+        output = os.path.join(base, manifest["output"])
+        header = generate_header(pipelines, os.path.basename(manifest_path))
+        existing = None
+        if os.path.exists(output):
+            with open(output, "r", encoding="utf-8") as f:
+                existing = f.read()
+        # 内容不变时不写文件，避免触发整个工程重新编译
+        if existing != header:
+            with open(output, "w", encoding="utf-8", newline="\n") as f:
+                f.write(header)
+            print("wrote " + os.path.relpath(output, base))
+    except BuildError as e:
+        print("error: %s" % e)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,22 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 1) in vec2 texcoord;
+layout(location = 2) in vec4 color;
+layout(location = 3) flat in uint textureIndex;
+
+layout(location = 0) out vec4 outColor;
+
+// 全局无绑定纹理表（shaders.json 的 bindlessSet），按下标访问，不需要逐绘制绑定
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+const uint INVALID_TEXTURE = 0xFFFFFFFFu;
+
+void main() {
+    vec4 base = vec4(texcoord, 0.0, 1.0);
+    if (textureIndex != INVALID_TEXTURE) {
+        // 网格坐标在 [-1, 1]，映射到 [0, 1] 的纹理坐标
+        base = texture(textures[nonuniformEXT(textureIndex)], texcoord * 0.5 + 0.5);
+    }
+    outColor = base * color;
+}